@@ -27,19 +27,79 @@
 #  include "config.h"
 #endif
 
-#include <cmath>
+#include <memory>
+#include <ostream>
+#include <vector>
 
-#include <string>
+#include "oct-kdtree.h"
 
+#include "Cell.h"
 #include "defun.h"
 #include "error.h"
+#include "ov-base.h"
 #include "ovl.h"
 
+// A k-d tree built by __kdtree_build__.  The tree is freed with the last
+// copy of the value that refers to it, like the data of any other value.
+
+class octave_kdtree : public octave_base_value
+{
+public:
+
+  octave_kdtree () : octave_base_value (), m_tree () { }
+
+  octave_kdtree (const Matrix& x)
+    : octave_base_value (), m_tree (std::make_shared<octave::kdtree> (x))
+  { }
+
+  octave_kdtree (const octave_kdtree& t)
+    : octave_base_value (), m_tree (t.m_tree)
+  { }
+
+  ~octave_kdtree () = default;
+
+  octave_base_value * clone () const { return new octave_kdtree (*this); }
+
+  octave_base_value * empty_clone () const { return new octave_kdtree (); }
+
+  bool is_defined () const { return true; }
+
+  bool is_constant () const { return true; }
+
+  dim_vector dims () const
+  {
+    static dim_vector dv (1, 1);
+    return dv;
+  }
+
+  void print (std::ostream& os, bool pr_as_read_syntax = false)
+  {
+    print_raw (os, pr_as_read_syntax);
+    newline (os);
+  }
+
+  void print_raw (std::ostream& os, bool = false) const
+  {
+    indent (os);
+    os << "<k-d tree>";
+  }
+
+  const octave::kdtree& tree () const { return *m_tree; }
+
+private:
+
+  std::shared_ptr<const octave::kdtree> m_tree;
+
+  DECLARE_OV_TYPEID_FUNCTIONS_AND_DATA
+};
+
+DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA (octave_kdtree, "kdtree", "kdtree");
+
 OCTAVE_BEGIN_NAMESPACE(octave)
 
 DEFUN (__dsearchn__, args, ,
        doc: /* -*- texinfo -*-
-@deftypefn {} {[@var{idx}, @var{d}] =} dsearch (@var{x}, @var{xi})
+@deftypefn {} {[@var{idx}, @var{d}] =} __dsearchn__ (@var{x}, @var{xi})
 Undocumented internal function.
 @end deftypefn */)
 {
@@ -52,55 +112,272 @@ Undocumented internal function.
   if (x.rows () != xi.rows () || x.columns () < 1)
     error ("__dsearchn__: number of rows of X and XI must match");
 
-  octave_idx_type n = x.rows ();
-  octave_idx_type nx = x.columns ();
+  octave_idx_type n = xi.rows ();
   octave_idx_type nxi = xi.columns ();
 
+  // Build the k-d tree once per call.  Each query then costs
+  // O(log (nx)) on average instead of O(nx).
+
+  kdtree tree (x);
+
   ColumnVector idx (nxi);
   double *pidx = idx.fortran_vec ();
   ColumnVector dist (nxi);
   double *pdist = dist.fortran_vec ();
 
-#define DIST(dd, y, yi, m)                      \
-  dd = 0.0;                                     \
-  for (octave_idx_type k = 0; k < m; k++)       \
-    {                                           \
-      double yd = y[k] - yi[k];                 \
-      dd += yd * yd;                            \
-    }                                           \
-  dd = sqrt (dd)
+  const double *pxi = xi.data ();
+  for (octave_idx_type i = 0; i < nxi; i++)
+    {
+      octave_idx_type j = tree.nearest (pxi, pdist[i]);
+
+      pidx[i] = (j < 0 ? numeric_limits<double>::NaN ()
+                 : static_cast<double> (j + 1));
+
+      pxi += n;
+
+      octave_quit ();
+    }
+
+  return ovl (idx, dist);
+}
+
+/*
+%!test
+%! x = [0 0; 1 0; 0 1; 1 1; 0.5 0.5];
+%! [idx, d] = __dsearchn__ (x, [0.1 0.1; 0.9 0.8; 0.5 0.4]);
+%! assert (idx, [1; 4; 5]);
+%! assert (d, [sqrt(0.02); sqrt(0.05); 0.1], eps);
+
+## Query points with a NaN coordinate have no nearest point
+%!test
+%! [idx, d] = __dsearchn__ ([1; 2], [NaN; 1.8]);
+%! assert (idx, [NaN; 2]);
+%! assert (d, [NaN; 0.2], eps);
+
+## Ties go to the point with the lowest index, as for an exhaustive search
+%!assert (__dsearchn__ ([1; -1; 1; -1], 0), 1)
+%!assert (__dsearchn__ ([2; 1; -1; 1; -1], 0), 2)
+
+## Compare with an exhaustive search
+%!test
+%! x = rand (500, 3);
+%! xi = rand (50, 3);
+%! [idx, d] = __dsearchn__ (x, xi);
+%! for i = 1:rows (xi)
+%! [d0, i0] = min (sqrt (sumsq (x - xi(i,:), 2)));
+%! assert (idx(i), i0);
+%! assert (d(i), d0, eps);
+%! endfor
+
+%!error <number of rows of X and XI must match> __dsearchn__ (ones (3, 2), 1)
+*/
+
+static const kdtree&
+get_kdtree (const octave_value& h, const char *who)
+{
+  if (octave_kdtree::static_type_id () < 0
+      || h.type_id () != octave_kdtree::static_type_id ())
+    error ("%s: invalid k-d tree handle", who);
+
+  return dynamic_cast<const octave_kdtree&> (h.get_rep ()).tree ();
+}
+
+static Matrix
+get_query_points (const kdtree& tree, const octave_value& arg,
+                  const char *who)
+{
+  Matrix xi = arg.xmatrix_value ("%s: XI must be a numeric matrix", who);
+
+  if (xi.columns () != tree.dims ())
+    error ("%s: XI must have the same number of columns as the points in the tree",
+           who);
+
+  return xi.transpose ();
+}
+
+DEFUN (__kdtree_build__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{h} =} __kdtree_build__ (@var{x})
+Build a k-d tree over the points @var{x} and return a handle to it.
+
+@var{x} is an @var{np}-by-@var{n} matrix with one @var{n}-dimensional point
+per row.  The tree can be queried repeatedly with @code{__kdtree_knn__} and
+@code{__kdtree_radius__}.  It is freed when the last copy of @var{h} is
+cleared.  Points with NaN coordinates are never returned by a query.
+@seealso{__kdtree_knn__, __kdtree_radius__, kdtree, dsearchn}
+@end deftypefn */)
+{
+  if (args.length () != 1)
+    print_usage ();
+
+  Matrix x = args(0).xmatrix_value ("__kdtree_build__: X must be a numeric matrix");
+
+  if (x.columns () < 1)
+    error ("__kdtree_build__: X must have at least one column");
+
+  if (octave_kdtree::static_type_id () < 0)
+    octave_kdtree::register_type ();
+
+  return ovl (octave_value (new octave_kdtree (x.transpose ())));
+}
+
+DEFUN (__kdtree_knn__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {[@var{idx}, @var{d}] =} __kdtree_knn__ (@var{h}, @var{xi})
+@deftypefnx {} {[@var{idx}, @var{d}] =} __kdtree_knn__ (@var{h}, @var{xi}, @var{k})
+Find the @var{k} nearest neighbors of the points @var{xi} in the k-d tree
+@var{h}.
+
+Row @var{i} of the @var{nxi}-by-@var{k} matrices @var{idx} and @var{d} holds
+the indices of and distances to the neighbors of @code{@var{xi}(@var{i},:)},
+ordered by increasing distance.  When two points are equally far away the one
+with the lower index comes first.  If the tree has fewer than @var{k} points,
+or a query point has a NaN coordinate, the missing entries are NaN.  The
+default for @var{k} is 1.
+@seealso{__kdtree_build__, __kdtree_radius__, kdtree}
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin < 2 || nargin > 3)
+    print_usage ();
+
+  const kdtree& tree = get_kdtree (args(0), "__kdtree_knn__");
+
+  Matrix xi = get_query_points (tree, args(1), "__kdtree_knn__");
+
+  octave_idx_type k = 1;
+  if (nargin == 3)
+    {
+      k = args(2).xidx_type_value ("__kdtree_knn__: K must be an integer");
+
+      if (k < 1)
+        error ("__kdtree_knn__: K must be positive");
+    }
+
+  octave_idx_type n = xi.rows ();
+  octave_idx_type nxi = xi.columns ();
+
+  Matrix idx (nxi, k, numeric_limits<double>::NaN ());
+  Matrix dist (nxi, k, numeric_limits<double>::NaN ());
+
+  std::vector<octave_idx_type> qidx;
+  std::vector<double> qdist;
 
   const double *pxi = xi.data ();
   for (octave_idx_type i = 0; i < nxi; i++)
     {
-      double d0;
-      const double *px = x.data ();
-      DIST(d0, px, pxi, n);
-      *pidx = 1.;
-      for (octave_idx_type j = 1; j < nx; j++)
+      tree.knn (pxi, k, qidx, qdist);
+
+      for (std::size_t j = 0; j < qidx.size (); j++)
         {
-          px += n;
-          double d;
-          DIST (d, px, pxi, n);
-          if (d < d0)
-            {
-              d0 = d;
-              *pidx = static_cast<double> (j + 1);
-            }
-          octave_quit ();
+          idx(i, j) = qidx[j] + 1;
+          dist(i, j) = qdist[j];
         }
 
-      *pdist++ = d0;
-      pidx++;
       pxi += n;
+
+      octave_quit ();
+    }
+
+  return ovl (idx, dist);
+}
+
+DEFUN (__kdtree_radius__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {[@var{idx}, @var{d}] =} __kdtree_radius__ (@var{h}, @var{xi}, @var{r})
+Find all points in the k-d tree @var{h} within distance @var{r} of the points
+@var{xi}.
+
+@var{idx} and @var{d} are @var{nxi}-by-1 cell arrays.  Element @var{i} holds
+a row vector of the indices of and distances to the points within distance
+@var{r} of @code{@var{xi}(@var{i},:)}, ordered by increasing distance.
+@seealso{__kdtree_build__, __kdtree_knn__, kdtree}
+@end deftypefn */)
+{
+  if (args.length () != 3)
+    print_usage ();
+
+  const kdtree& tree = get_kdtree (args(0), "__kdtree_radius__");
+
+  Matrix xi = get_query_points (tree, args(1), "__kdtree_radius__");
+
+  double r = args(2).xdouble_value ("__kdtree_radius__: R must be a real scalar");
+
+  if (! (r >= 0))
+    error ("__kdtree_radius__: R must be a non-negative scalar");
+
+  octave_idx_type n = xi.rows ();
+  octave_idx_type nxi = xi.columns ();
+
+  Cell idx (nxi, 1);
+  Cell dist (nxi, 1);
+
+  std::vector<octave_idx_type> qidx;
+  std::vector<double> qdist;
+
+  const double *pxi = xi.data ();
+  for (octave_idx_type i = 0; i < nxi; i++)
+    {
+      tree.radius (pxi, r, qidx, qdist);
+
+      octave_idx_type nq = qidx.size ();
+
+      RowVector ridx (nq);
+      RowVector rdist (nq);
+
+      for (octave_idx_type j = 0; j < nq; j++)
+        {
+          ridx(j) = qidx[j] + 1;
+          rdist(j) = qdist[j];
+        }
+
+      idx(i) = ridx;
+      dist(i) = rdist;
+
+      pxi += n;
+
+      octave_quit ();
     }
 
   return ovl (idx, dist);
 }
 
 /*
-## No test needed for internal helper function.
-%!assert (1)
+%!test
+%! x = [0 0; 1 0; 0 1; 1 1; 0.5 0.5];
+%! h = __kdtree_build__ (x);
+%! [idx, d] = __kdtree_knn__ (h, [0.1 0.1; 2 2]);
+%! assert (idx, [1; 4]);
+%! assert (d, [sqrt(0.02); sqrt(2)], eps);
+%! [idx, d] = __kdtree_knn__ (h, [0 0], 3);
+%! assert (idx, [1, 5, 2]);
+%! assert (d, [0, sqrt(0.5), 1], eps);
+%! [idx, d] = __kdtree_knn__ (h, [0 0], 7);
+%! assert (idx, [1, 5, 2, 3, 4, NaN, NaN]);
+%! [idx, d] = __kdtree_radius__ (h, [0 0; 10 10], 1);
+%! assert (idx, {[1, 5, 2, 3]; zeros(1, 0)});
+%! assert (d{1}, [0, sqrt(0.5), 1, 1], eps);
+
+## Compare with an exhaustive search
+%!test
+%! x = randn (1000, 2);
+%! xi = randn (20, 2);
+%! h = __kdtree_build__ (x);
+%! [idx, d] = __kdtree_knn__ (h, xi, 5);
+%! [ridx, rd] = __kdtree_radius__ (h, xi, 0.5);
+%! for i = 1:rows (xi)
+%!   dd = sqrt (sumsq (x - xi(i,:), 2));
+%!   [ds, is] = sort (dd);
+%!   assert (idx(i,:), is(1:5).');
+%!   assert (d(i,:), ds(1:5).', eps);
+%!   assert (ridx{i}, is(ds <= 0.5).');
+%! endfor
+
+%!error <invalid k-d tree handle> __kdtree_knn__ (-1, 1)
+%!error <K must be positive> __kdtree_knn__ (__kdtree_build__ (1), 1, 0)
+%!error <same number of columns> __kdtree_knn__ (__kdtree_build__ ([1 2]), 1)
+%!error <R must be a non-negative scalar> __kdtree_radius__ (__kdtree_build__ (1), 1, -1)
 */
 
 OCTAVE_END_NAMESPACE(octave)
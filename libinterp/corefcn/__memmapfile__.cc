@@ -0,0 +1,708 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "data-conv.h"
+#include "lo-mappers.h"
+#include "oct-mmap.h"
+
+#include "defun.h"
+#include "error.h"
+#include "oct-map.h"
+#include "ov.h"
+#include "ovl.h"
+#include "utils.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Internal functions of the memmapfile class.
+//
+// The Format of a memmapfile object is either the name of a numeric
+// type or an N-by-3 cell array of records with the type, dimensions and
+// name of each field.  Data of a simple Format is a column vector.  For
+// read-only files it refers to the mapped data without copying it.
+// Each such view uses its own private mapping of the file, so changing
+// a view that is no longer shared never changes the data of other views.
+// Data of a record Format is a struct array with copies of the fields.
+
+class mapped_file_entry
+{
+public:
+
+  mapped_file_entry (const std::shared_ptr<sys::mapped_file>& file)
+    : m_file (file), m_offset (0), m_type (oct_data_conv::dt_unknown),
+      m_count (0), m_data ()
+  { }
+
+  std::shared_ptr<sys::mapped_file> m_file;
+
+  // The last Data of a read-only file.  Holding a reference to it
+  // ensures that every array returned for it is shared, so changing any
+  // of them makes a copy instead of changing the mapped data.
+  std::size_t m_offset;
+  oct_data_conv::data_type m_type;
+  octave_idx_type m_count;
+  octave_value m_data;
+};
+
+static std::map<int, mapped_file_entry> mapped_files;
+
+static int next_mapped_file_id = 1;
+
+static mapped_file_entry&
+get_mapped_file (const octave_value& id_arg)
+{
+  int id = id_arg.xint_value ("memmapfile: ID must be an integer");
+
+  auto p = mapped_files.find (id);
+
+  if (p == mapped_files.end ())
+    error ("memmapfile: invalid memmapfile ID");
+
+  return p->second;
+}
+
+struct mapped_field
+{
+  std::string m_name;
+  oct_data_conv::data_type m_type;
+  dim_vector m_dims;
+
+  // Position in the record.
+  std::size_t m_offset;
+};
+
+static oct_data_conv::data_type
+get_mapped_type (const octave_value& arg)
+{
+  std::string name
+    = arg.xstring_value ("memmapfile: type of Format must be a string");
+
+  for (int i = oct_data_conv::dt_int8; i <= oct_data_conv::dt_double; i++)
+    {
+      oct_data_conv::data_type dt = static_cast<oct_data_conv::data_type> (i);
+
+      if (name == oct_data_conv::data_type_as_string (dt))
+        return dt;
+    }
+
+  error ("memmapfile: invalid type '%s' in Format", name.c_str ());
+}
+
+// Parse FMT.  Returns an empty list for a simple Format and sets TYPE.
+
+static std::vector<mapped_field>
+get_mapped_format (const octave_value& fmt, oct_data_conv::data_type& type,
+                   std::size_t& record_size)
+{
+  std::vector<mapped_field> fields;
+
+  if (fmt.is_string ())
+    {
+      type = get_mapped_type (fmt);
+      record_size = oct_data_conv::data_type_size (type);
+
+      return fields;
+    }
+
+  if (! fmt.iscell () || fmt.columns () != 3 || fmt.rows () < 1
+      || fmt.ndims () != 2)
+    error ("memmapfile: Format must be a type name or an N-by-3 cell array");
+
+  Cell c = fmt.cell_value ();
+
+  type = oct_data_conv::dt_unknown;
+  record_size = 0;
+
+  for (octave_idx_type i = 0; i < c.rows (); i++)
+    {
+      mapped_field fld;
+
+      fld.m_type = get_mapped_type (c(i, 0));
+
+      Array<octave_idx_type> dims
+        = c(i, 1).xoctave_idx_type_vector_value ("memmapfile: dimensions in Format must be a vector of integers");
+
+      if (dims.numel () < 2)
+        error ("memmapfile: dimensions in Format must have at least 2 elements");
+
+      fld.m_dims = dim_vector::alloc (dims.numel ());
+
+      for (octave_idx_type j = 0; j < dims.numel (); j++)
+        {
+          if (dims(j) < 0)
+            error ("memmapfile: dimensions in Format must not be negative");
+
+          fld.m_dims(j) = dims(j);
+        }
+
+      fld.m_name = c(i, 2).xstring_value ("memmapfile: field name in Format must be a string");
+
+      if (! valid_identifier (fld.m_name))
+        error ("memmapfile: invalid field name '%s' in Format",
+               fld.m_name.c_str ());
+
+      for (const auto& f : fields)
+        if (f.m_name == fld.m_name)
+          error ("memmapfile: duplicate field name '%s' in Format",
+                 fld.m_name.c_str ());
+
+      fld.m_offset = record_size;
+
+      record_size += (fld.m_dims.safe_numel ()
+                      * oct_data_conv::data_type_size (fld.m_type));
+
+      fields.push_back (fld);
+    }
+
+  return fields;
+}
+
+// Number of records of size RECORD_SIZE that are read for REPEAT.
+
+static octave_idx_type
+get_mapped_count (const sys::mapped_file& file, std::size_t offset,
+                  std::size_t record_size, const octave_value& repeat)
+{
+  if (offset > file.size ())
+    error ("memmapfile: Offset is beyond the end of the file");
+
+  std::size_t avail = (record_size == 0 ? 0
+                       : (file.size () - offset) / record_size);
+
+  double r = repeat.xdouble_value ("memmapfile: Repeat must be a number");
+
+  if (math::isinf (r) && r > 0)
+    return avail;
+
+  if (r < 1 || math::x_nint (r) != r)
+    error ("memmapfile: Repeat must be a positive integer or Inf");
+
+  if (r > avail)
+    error ("memmapfile: Format and Repeat exceed the size of the file");
+
+  return static_cast<octave_idx_type> (r);
+}
+
+static std::size_t
+get_mapped_offset (const octave_value& arg)
+{
+  double offset = arg.xdouble_value ("memmapfile: Offset must be a number");
+
+  if (offset < 0 || math::x_nint (offset) != offset || math::isinf (offset))
+    error ("memmapfile: Offset must be a non-negative integer");
+
+  return static_cast<std::size_t> (offset);
+}
+
+template <typename T> Array<T> mapped_array_value (const octave_value& val);
+
+template <>
+Array<double>
+mapped_array_value (const octave_value& val)
+{
+  return val.array_value ();
+}
+
+template <>
+Array<float>
+mapped_array_value (const octave_value& val)
+{
+  return val.float_array_value ();
+}
+
+#define MAPPED_INT_ARRAY_VALUE(T, FCN)                  \
+  template <>                                           \
+  Array<T>                                              \
+  mapped_array_value (const octave_value& val)          \
+  {                                                     \
+    return val.FCN ();                                  \
+  }
+
+MAPPED_INT_ARRAY_VALUE (octave_int8, int8_array_value)
+MAPPED_INT_ARRAY_VALUE (octave_int16, int16_array_value)
+MAPPED_INT_ARRAY_VALUE (octave_int32, int32_array_value)
+MAPPED_INT_ARRAY_VALUE (octave_int64, int64_array_value)
+MAPPED_INT_ARRAY_VALUE (octave_uint8, uint8_array_value)
+MAPPED_INT_ARRAY_VALUE (octave_uint16, uint16_array_value)
+MAPPED_INT_ARRAY_VALUE (octave_uint32, uint32_array_value)
+MAPPED_INT_ARRAY_VALUE (octave_uint64, uint64_array_value)
+
+#undef MAPPED_INT_ARRAY_VALUE
+
+template <typename T>
+static octave_value
+mapped_view (const std::shared_ptr<sys::mapped_file>& file,
+             std::size_t offset, const dim_vector& dv)
+{
+  return octave_value (sys::mapped_array<T> (file, offset, dv));
+}
+
+template <typename T>
+static octave_value
+mapped_copy (const std::shared_ptr<sys::mapped_file>& file,
+             std::size_t offset, const dim_vector& dv)
+{
+  Array<T> retval (dv);
+
+  std::copy_n (file->data () + offset, retval.numel () * sizeof (T),
+               reinterpret_cast<char *> (retval.fortran_vec ()));
+
+  return octave_value (retval);
+}
+
+// Index the data of FILE with IDX.  The result never refers to the
+// mapped data, even if IDX selects a contiguous range of it.
+
+template <typename T>
+static octave_value
+mapped_index (const std::shared_ptr<sys::mapped_file>& file,
+              std::size_t offset, const dim_vector& dv,
+              const octave_value_list& idx)
+{
+  Array<T> retval
+    = mapped_array_value<T> (mapped_view<T> (file, offset, dv).index_op (idx));
+
+  const char *p = reinterpret_cast<const char *> (retval.data ());
+
+  if (p >= file->data () && p < file->data () + file->size ())
+    {
+      Array<T> tmp (retval.dims ());
+
+      std::copy_n (retval.data (), retval.numel (), tmp.fortran_vec ());
+
+      retval = tmp;
+    }
+
+  return octave_value (retval);
+}
+
+// Store the N elements of VAL at OFFSET in FILE unless VAL already
+// refers to them.
+
+template <typename T>
+static bool
+mapped_store (const std::shared_ptr<sys::mapped_file>& file,
+              std::size_t offset, const dim_vector& dv,
+              const octave_value& val)
+{
+  Array<T> a = mapped_array_value<T> (val);
+
+  if (a.numel () != dv.safe_numel ())
+    return false;
+
+  const char *src = reinterpret_cast<const char *> (a.data ());
+  char *dest = file->data () + offset;
+
+  if (src != dest)
+    std::copy_n (src, a.numel () * sizeof (T), dest);
+
+  return true;
+}
+
+#define MAPPED_TYPE_DISPATCH(DT, FCN, ARGS)                             \
+  do                                                                    \
+    {                                                                   \
+      switch (DT)                                                       \
+        {                                                               \
+        case oct_data_conv::dt_int8:                                    \
+          return FCN<octave_int8> ARGS;                                 \
+        case oct_data_conv::dt_uint8:                                   \
+          return FCN<octave_uint8> ARGS;                                \
+        case oct_data_conv::dt_int16:                                   \
+          return FCN<octave_int16> ARGS;                                \
+        case oct_data_conv::dt_uint16:                                  \
+          return FCN<octave_uint16> ARGS;                               \
+        case oct_data_conv::dt_int32:                                   \
+          return FCN<octave_int32> ARGS;                                \
+        case oct_data_conv::dt_uint32:                                  \
+          return FCN<octave_uint32> ARGS;                               \
+        case oct_data_conv::dt_int64:                                   \
+          return FCN<octave_int64> ARGS;                                \
+        case oct_data_conv::dt_uint64:                                  \
+          return FCN<octave_uint64> ARGS;                               \
+        case oct_data_conv::dt_single:                                  \
+          return FCN<float> ARGS;                                       \
+        case oct_data_conv::dt_double:                                  \
+          return FCN<double> ARGS;                                      \
+        default:                                                        \
+          panic_impossible ();                                          \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+static octave_value
+mapped_view (oct_data_conv::data_type dt,
+             const std::shared_ptr<sys::mapped_file>& file,
+             std::size_t offset, const dim_vector& dv)
+{
+  MAPPED_TYPE_DISPATCH (dt, mapped_view, (file, offset, dv));
+}
+
+static octave_value
+mapped_copy (oct_data_conv::data_type dt,
+             const std::shared_ptr<sys::mapped_file>& file,
+             std::size_t offset, const dim_vector& dv)
+{
+  MAPPED_TYPE_DISPATCH (dt, mapped_copy, (file, offset, dv));
+}
+
+static bool
+mapped_store (oct_data_conv::data_type dt,
+              const std::shared_ptr<sys::mapped_file>& file,
+              std::size_t offset, const dim_vector& dv,
+              const octave_value& val)
+{
+  MAPPED_TYPE_DISPATCH (dt, mapped_store, (file, offset, dv, val));
+}
+
+static octave_value
+mapped_index (oct_data_conv::data_type dt,
+              const std::shared_ptr<sys::mapped_file>& file,
+              std::size_t offset, const dim_vector& dv,
+              const octave_value_list& idx)
+{
+  MAPPED_TYPE_DISPATCH (dt, mapped_index, (file, offset, dv, idx));
+}
+
+#undef MAPPED_TYPE_DISPATCH
+
+// Return the Data of the read-only file of ENTRY for a simple Format.
+
+static octave_value
+cached_view (mapped_file_entry& entry, oct_data_conv::data_type type,
+             std::size_t offset, octave_idx_type n)
+{
+  if (entry.m_data.is_undefined () || entry.m_offset != offset
+      || entry.m_type != type || entry.m_count != n)
+    {
+      // A view that is replaced here may become the only reference to
+      // its data, which is then changed in place.  Map the file again
+      // so that this can not change the data of any other view.
+      std::string name = entry.m_file->name ();
+      std::string msg;
+
+      std::shared_ptr<sys::mapped_file> file
+        = sys::mapped_file::open (name, false, msg);
+
+      if (! file)
+        error ("memmapfile: unable to map file '%s': %s", name.c_str (),
+               msg.c_str ());
+
+      if (file->size () < (offset
+                           + n * oct_data_conv::data_type_size (type)))
+        error ("memmapfile: file '%s' has changed size", name.c_str ());
+
+      entry.m_data = mapped_view (type, file, offset, dim_vector (n, 1));
+      entry.m_offset = offset;
+      entry.m_type = type;
+      entry.m_count = n;
+    }
+
+  return entry.m_data;
+}
+
+// Store VAL as the Data of FILE.
+
+static void
+mapped_write (const std::shared_ptr<sys::mapped_file>& file,
+              std::size_t offset, const octave_value& fmt,
+              const octave_value& repeat, const octave_value& val)
+{
+  if (! file->writable ())
+    error ("memmapfile: Data can not be changed unless Writable is true");
+
+  oct_data_conv::data_type type;
+  std::size_t record_size;
+
+  std::vector<mapped_field> fields
+    = get_mapped_format (fmt, type, record_size);
+
+  octave_idx_type n = get_mapped_count (*file, offset, record_size, repeat);
+
+  if (fields.empty ())
+    {
+      if (! val.isnumeric () && ! val.islogical ())
+        error ("memmapfile: Data must be a numeric array");
+
+      if (val.iscomplex ())
+        error ("memmapfile: Data must be real");
+
+      if (! mapped_store (type, file, offset, dim_vector (n, 1), val))
+        error ("memmapfile: assignment must not change the number of elements of Data");
+
+      return;
+    }
+
+  if (! val.isstruct ())
+    error ("memmapfile: Data must be a struct array for this Format");
+
+  octave_map m = val.map_value ();
+
+  if (m.numel () != n)
+    error ("memmapfile: assignment must not change the number of elements of Data");
+
+  for (const auto& fld : fields)
+    {
+      if (! m.isfield (fld.m_name))
+        error ("memmapfile: Data must have the field '%s'",
+               fld.m_name.c_str ());
+
+      const Cell c = m.contents (fld.m_name);
+
+      for (octave_idx_type i = 0; i < n; i++)
+        {
+          const octave_value& elt = c(i);
+
+          if (! elt.isnumeric () && ! elt.islogical ())
+            error ("memmapfile: field '%s' of Data must be numeric",
+                   fld.m_name.c_str ());
+
+          if (elt.iscomplex ())
+            error ("memmapfile: field '%s' of Data must be real",
+                   fld.m_name.c_str ());
+
+          if (! mapped_store (fld.m_type, file,
+                              offset + i * record_size + fld.m_offset,
+                              fld.m_dims, elt))
+            error ("memmapfile: field '%s' of Data must have %"
+                   OCTAVE_IDX_TYPE_FORMAT " elements", fld.m_name.c_str (),
+                   fld.m_dims.safe_numel ());
+        }
+    }
+}
+
+DEFUN (__memmapfile_open__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{id} =} __memmapfile_open__ (@var{filename}, @var{writable})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 2)
+    print_usage ();
+
+  std::string name = args(0).xstring_value ("memmapfile: FILENAME must be a string");
+
+  bool writable = args(1).xbool_value ("memmapfile: WRITABLE must be a logical value");
+
+  std::string msg;
+
+  std::shared_ptr<sys::mapped_file> file
+    = sys::mapped_file::open (name, writable, msg);
+
+  if (! file)
+    error ("memmapfile: unable to map file '%s': %s", name.c_str (),
+           msg.c_str ());
+
+  int id = next_mapped_file_id++;
+
+  mapped_files.emplace (id, mapped_file_entry (file));
+
+  return ovl (id);
+}
+
+DEFUN (__memmapfile_close__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {} __memmapfile_close__ (@var{id})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 1)
+    print_usage ();
+
+  mapped_file_entry& entry = get_mapped_file (args(0));
+
+  std::string msg;
+
+  bool ok = entry.m_file->flush (msg);
+
+  // Arrays that refer to the data keep the file mapped.
+  mapped_files.erase (args(0).int_value ());
+
+  if (! ok)
+    error ("memmapfile: unable to write file: %s", msg.c_str ());
+
+  return ovl ();
+}
+
+DEFUN (__memmapfile_read__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{data} =} __memmapfile_read__ (@var{id}, @var{offset}, @var{format}, @var{repeat})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 4)
+    print_usage ();
+
+  mapped_file_entry& entry = get_mapped_file (args(0));
+
+  const std::shared_ptr<sys::mapped_file>& file = entry.m_file;
+
+  std::size_t offset = get_mapped_offset (args(1));
+
+  oct_data_conv::data_type type;
+  std::size_t record_size;
+
+  std::vector<mapped_field> fields
+    = get_mapped_format (args(2), type, record_size);
+
+  octave_idx_type n = get_mapped_count (*file, offset, record_size, args(3));
+
+  if (fields.empty ())
+    {
+      // Writable files are copied so that the array does not change
+      // when the file is changed through Data.
+      if (file->writable ())
+        return ovl (mapped_copy (type, file, offset, dim_vector (n, 1)));
+
+      return ovl (cached_view (entry, type, offset, n));
+    }
+
+  string_vector keys (fields.size ());
+
+  for (std::size_t j = 0; j < fields.size (); j++)
+    keys(j) = fields[j].m_name;
+
+  octave_map retval (dim_vector (n, 1), keys);
+
+  for (const auto& fld : fields)
+    {
+      Cell c (dim_vector (n, 1));
+
+      for (octave_idx_type i = 0; i < n; i++)
+        c(i) = mapped_copy (fld.m_type, file,
+                            offset + i * record_size + fld.m_offset,
+                            fld.m_dims);
+
+      retval.setfield (fld.m_name, c);
+    }
+
+  return ovl (retval);
+}
+
+DEFUN (__memmapfile_write__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {} __memmapfile_write__ (@var{id}, @var{offset}, @var{format}, @var{repeat}, @var{data})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 5)
+    print_usage ();
+
+  mapped_file_entry& entry = get_mapped_file (args(0));
+
+  mapped_write (entry.m_file, get_mapped_offset (args(1)), args(2), args(3),
+                args(4));
+
+  return ovl ();
+}
+
+DEFUN (__memmapfile_index__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{val} =} __memmapfile_index__ (@var{id}, @var{offset}, @var{format}, @var{repeat}, @var{idx})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 5)
+    print_usage ();
+
+  mapped_file_entry& entry = get_mapped_file (args(0));
+
+  const std::shared_ptr<sys::mapped_file>& file = entry.m_file;
+
+  std::size_t offset = get_mapped_offset (args(1));
+
+  oct_data_conv::data_type type;
+  std::size_t record_size;
+
+  if (! get_mapped_format (args(2), type, record_size).empty ())
+    error ("memmapfile: indexing requires a simple Format");
+
+  octave_idx_type n = get_mapped_count (*file, offset, record_size, args(3));
+
+  octave_value_list idx (args(4).xcell_value ("memmapfile: IDX must be a cell array"));
+
+  if (! file->writable ())
+    return ovl (cached_view (entry, type, offset, n).index_op (idx));
+
+  return ovl (mapped_index (type, file, offset, dim_vector (n, 1), idx));
+}
+
+DEFUN (__memmapfile_assign__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {} __memmapfile_assign__ (@var{id}, @var{offset}, @var{format}, @var{repeat}, @var{idx}, @var{rhs})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 6)
+    print_usage ();
+
+  mapped_file_entry& entry = get_mapped_file (args(0));
+
+  const std::shared_ptr<sys::mapped_file>& file = entry.m_file;
+
+  if (! file->writable ())
+    error ("memmapfile: Data can not be changed unless Writable is true");
+
+  std::size_t offset = get_mapped_offset (args(1));
+
+  oct_data_conv::data_type type;
+  std::size_t record_size;
+
+  if (! get_mapped_format (args(2), type, record_size).empty ())
+    error ("memmapfile: indexing requires a simple Format");
+
+  octave_idx_type n = get_mapped_count (*file, offset, record_size, args(3));
+
+  octave_value_list idx (args(4).xcell_value ("memmapfile: IDX must be a cell array"));
+
+  // The view is the only reference to the mapped data, so the
+  // assignment changes the file in place unless it changes the type or
+  // size of the array.  Such results are converted and copied back.
+  octave_value val = mapped_view (type, file, offset, dim_vector (n, 1));
+
+  std::list<octave_value_list> idx_list (1, idx);
+
+  val.assign (octave_value::op_asn_eq, "(", idx_list, args(5));
+
+  if (val.ndims () != 2 || val.columns () != 1)
+    error ("memmapfile: assignment must not change the size of Data");
+
+  mapped_write (file, offset, args(2), args(3), val);
+
+  return ovl ();
+}
+
+OCTAVE_END_NAMESPACE(octave)
@@ -0,0 +1,795 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "dNDArray.h"
+#include "fNDArray.h"
+#include "lo-ieee.h"
+#include "oct-string.h"
+#include "oct-thread-pool.h"
+
+#include "defun.h"
+#include "error.h"
+#include "ovl.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Moving window statistics for movfun.m.
+//
+// Each column is processed in a single pass.  The window for output I
+// holds the NB elements before and the NA elements after element I.  For
+// the windows at the ends the column is extended with NB elements in
+// front and NA elements at the back, depending on the endpoint mode:
+//
+//   shrink    no elements, i.e. the windows at the ends are shorter
+//   fill      a constant value (NaN for "fill")
+//   same      copies of the first and last element
+//   periodic  the elements at the other end of the column
+//   discard   no elements, and only the windows that fit are computed
+//
+// The statistics are updated by an accumulator as the window slides.  An
+// accumulator has push (v) to add the newest element of the window,
+// pop (v) to remove the oldest one, and value () for the statistic of the
+// elements in the window.  NaN values are handled as the corresponding
+// Octave functions do with the default "includenan".
+
+enum class mov_endpoints
+{
+  shrink,
+  discard,
+  fill,
+  same,
+  periodic
+};
+
+enum class mov_stat
+{
+  sum,
+  mean,
+  prod,
+  min,
+  max,
+  median,
+  var,
+  std
+};
+
+// A column extended at both ends according to the endpoint mode.
+
+template <typename T>
+class mov_column
+{
+public:
+
+  mov_column (const T *x, octave_idx_type n, octave_idx_type n_pre,
+              mov_endpoints mode, double fill)
+    : m_x (x), m_n (n), m_n_pre (n_pre), m_mode (mode), m_fill (fill)
+  { }
+
+  bool present (octave_idx_type j) const
+  {
+    return (m_mode != mov_endpoints::shrink
+            || (j >= m_n_pre && j < m_n_pre + m_n));
+  }
+
+  double operator () (octave_idx_type j) const
+  {
+    octave_idx_type k = j - m_n_pre;
+
+    if (k >= 0 && k < m_n)
+      return m_x[k];
+
+    switch (m_mode)
+      {
+      case mov_endpoints::fill:
+        return m_fill;
+
+      case mov_endpoints::same:
+        return m_x[k < 0 ? 0 : m_n - 1];
+
+      case mov_endpoints::periodic:
+        return m_x[k < 0 ? k + m_n : k - m_n];
+
+      default:
+        return 0;
+      }
+  }
+
+private:
+
+  const T *m_x;
+  octave_idx_type m_n;
+  octave_idx_type m_n_pre;
+  mov_endpoints m_mode;
+  double m_fill;
+};
+
+// Sum and mean.  The finite values are summed with compensation (Neumaier)
+// and the non-finite ones are counted, so that they can leave the window
+// again.
+
+class mov_sum
+{
+public:
+
+  // The running sum can lose accuracy over time.
+  static const bool drifts = true;
+
+  mov_sum (bool mean) : m_mean (mean) { }
+
+  void clear ()
+  {
+    m_n = m_nan = m_pinf = m_ninf = 0;
+    m_sum = m_comp = 0;
+  }
+
+  void push (double v)
+  {
+    m_n++;
+    if (std::isfinite (v))
+      add (v);
+    else
+      count (v, 1);
+  }
+
+  void pop (double v)
+  {
+    m_n--;
+    if (std::isfinite (v))
+      add (-v);
+    else
+      count (v, -1);
+  }
+
+  // True if the sum of the finite values overflowed.
+  bool stale () const
+  {
+    return ! std::isfinite (m_sum + m_comp);
+  }
+
+  double value () const
+  {
+    double s;
+
+    if (m_nan || (m_pinf && m_ninf))
+      s = numeric_limits<double>::NaN ();
+    else if (m_pinf)
+      s = numeric_limits<double>::Inf ();
+    else if (m_ninf)
+      s = -numeric_limits<double>::Inf ();
+    else
+      s = m_sum + m_comp;
+
+    return m_mean ? s / m_n : s;
+  }
+
+private:
+
+  void add (double v)
+  {
+    double t = m_sum + v;
+
+    if (std::abs (m_sum) >= std::abs (v))
+      m_comp += (m_sum - t) + v;
+    else
+      m_comp += (v - t) + m_sum;
+
+    m_sum = t;
+  }
+
+  void count (double v, int k)
+  {
+    if (std::isnan (v))
+      m_nan += k;
+    else if (v > 0)
+      m_pinf += k;
+    else
+      m_ninf += k;
+  }
+
+  bool m_mean;
+
+  octave_idx_type m_n = 0;
+  octave_idx_type m_nan = 0;
+  octave_idx_type m_pinf = 0;
+  octave_idx_type m_ninf = 0;
+
+  double m_sum = 0;
+  double m_comp = 0;
+};
+
+// Minimum and maximum with a monotonic queue.  NaN values are ignored,
+// as max and min do, unless all the values in the window are NaN.
+
+template <bool MAX>
+class mov_minmax
+{
+public:
+
+  static const bool drifts = false;
+
+  mov_minmax () = default;
+
+  void clear ()
+  {
+    m_queue.clear ();
+    m_n_pushed = m_n_popped = 0;
+  }
+
+  void push (double v)
+  {
+    octave_idx_type k = m_n_pushed++;
+
+    if (std::isnan (v))
+      return;
+
+    // Keep the oldest of equal values, like max and min do.
+    while (! m_queue.empty ()
+           && (MAX ? m_queue.back ().m_val < v : m_queue.back ().m_val > v))
+      m_queue.pop_back ();
+
+    m_queue.push_back ({k, v});
+  }
+
+  void pop (double)
+  {
+    octave_idx_type k = m_n_popped++;
+
+    if (! m_queue.empty () && m_queue.front ().m_idx == k)
+      m_queue.pop_front ();
+  }
+
+  bool stale () const { return false; }
+
+  double value () const
+  {
+    return (m_queue.empty () ? numeric_limits<double>::NaN ()
+                             : m_queue.front ().m_val);
+  }
+
+private:
+
+  struct elt
+  {
+    octave_idx_type m_idx;
+    double m_val;
+  };
+
+  std::deque<elt> m_queue;
+
+  octave_idx_type m_n_pushed = 0;
+  octave_idx_type m_n_popped = 0;
+};
+
+// Variance and standard deviation, with Welford's updates for adding
+// and removing values.  OPT is the normalization as for var.  The updates
+// leave a small residual when the values in the window are all equal,
+// so the minimum and maximum are tracked to return exactly zero then.
+
+class mov_var
+{
+public:
+
+  static const bool drifts = true;
+
+  mov_var (int opt, bool sd) : m_opt (opt), m_sd (sd) { }
+
+  void clear ()
+  {
+    m_n = m_n_finite = 0;
+    m_mean = m_m2 = 0;
+    m_min.clear ();
+    m_max.clear ();
+  }
+
+  void push (double v)
+  {
+    m_n++;
+    m_min.push (v);
+    m_max.push (v);
+
+    if (! std::isfinite (v))
+      return;
+
+    m_n_finite++;
+    double d = v - m_mean;
+    m_mean += d / m_n_finite;
+    m_m2 += d * (v - m_mean);
+  }
+
+  void pop (double v)
+  {
+    m_n--;
+    m_min.pop (v);
+    m_max.pop (v);
+
+    if (! std::isfinite (v))
+      return;
+
+    m_n_finite--;
+    if (m_n_finite == 0)
+      {
+        m_mean = m_m2 = 0;
+        return;
+      }
+
+    double d = v - m_mean;
+    m_mean -= d / m_n_finite;
+    m_m2 -= d * (v - m_mean);
+  }
+
+  bool stale () const
+  {
+    return ! std::isfinite (m_m2);
+  }
+
+  double value () const
+  {
+    if (m_n_finite != m_n)
+      return numeric_limits<double>::NaN ();
+
+    if (m_min.value () == m_max.value ())
+      return 0;
+
+    double v = std::max (m_m2, 0.0) / (m_opt ? m_n : m_n - 1);
+
+    return m_sd ? std::sqrt (v) : v;
+  }
+
+private:
+
+  int m_opt;
+  bool m_sd;
+
+  octave_idx_type m_n = 0;
+  octave_idx_type m_n_finite = 0;
+
+  double m_mean = 0;
+  double m_m2 = 0;
+
+  mov_minmax<false> m_min;
+  mov_minmax<true> m_max;
+};
+
+// Median with the lower and upper halves of the window in two ordered
+// sets.  LO has the same number of elements as HI, or one more.
+
+class mov_median
+{
+public:
+
+  static const bool drifts = false;
+
+  mov_median () = default;
+
+  void clear ()
+  {
+    m_lo.clear ();
+    m_hi.clear ();
+    m_nan = 0;
+  }
+
+  void push (double v)
+  {
+    if (std::isnan (v))
+      m_nan++;
+    else
+      {
+        if (m_lo.empty () || v <= *m_lo.rbegin ())
+          m_lo.insert (v);
+        else
+          m_hi.insert (v);
+
+        balance ();
+      }
+  }
+
+  void pop (double v)
+  {
+    if (std::isnan (v))
+      m_nan--;
+    else
+      {
+        if (v <= *m_lo.rbegin ())
+          m_lo.erase (m_lo.find (v));
+        else
+          m_hi.erase (m_hi.find (v));
+
+        balance ();
+      }
+  }
+
+  bool stale () const { return false; }
+
+  double value () const
+  {
+    if (m_nan || m_lo.empty ())
+      return numeric_limits<double>::NaN ();
+
+    if (m_lo.size () > m_hi.size ())
+      return *m_lo.rbegin ();
+
+    return (*m_lo.rbegin () + *m_hi.begin ()) / 2;
+  }
+
+private:
+
+  void balance ()
+  {
+    if (m_lo.size () > m_hi.size () + 1)
+      {
+        auto it = std::prev (m_lo.end ());
+        m_hi.insert (*it);
+        m_lo.erase (it);
+      }
+    else if (m_hi.size () > m_lo.size ())
+      {
+        auto it = m_hi.begin ();
+        m_lo.insert (*it);
+        m_hi.erase (it);
+      }
+  }
+
+  std::multiset<double> m_lo;
+  std::multiset<double> m_hi;
+
+  octave_idx_type m_nan = 0;
+};
+
+// Slide a window of W elements over COL and store the N_OUT values of
+// the statistic in Y.  Accumulators that lose accuracy are rebuilt from
+// the elements in the window every W steps, which keeps the cost O(N).
+
+template <typename ACC, typename T>
+static void
+mov_window (ACC& acc, const mov_column<T>& col, octave_idx_type n_out,
+            octave_idx_type w, T *y)
+{
+  acc.clear ();
+
+  for (octave_idx_type j = 0; j < w - 1; j++)
+    if (col.present (j))
+      acc.push (col (j));
+
+  for (octave_idx_type i = 0; i < n_out; i++)
+    {
+      octave_idx_type j = i + w - 1;
+
+      if (col.present (j))
+        acc.push (col (j));
+
+      y[i] = acc.value ();
+
+      if (col.present (i))
+        acc.pop (col (i));
+
+      if (ACC::drifts && ((i + 1) % w == 0 || acc.stale ()))
+        {
+          acc.clear ();
+          for (octave_idx_type k = i + 1; k < i + w; k++)
+            if (col.present (k))
+              acc.push (col (k));
+        }
+    }
+}
+
+// Products, without divisions.  The extended column is split into blocks
+// of W elements.  A window is the product of a suffix of one block and a
+// prefix of the next one, and the suffix products of each block are
+// computed once.
+
+template <typename T>
+static void
+mov_prod (const mov_column<T>& col, octave_idx_type n_out,
+          octave_idx_type w, T *y)
+{
+  std::vector<double> suffix (w);
+
+  for (octave_idx_type s = 0; s < n_out; s += w)
+    {
+      // s + w does not exceed the length of the extended column.
+      double p = 1;
+      for (octave_idx_type j = s + w - 1; j >= s; j--)
+        {
+          if (col.present (j))
+            p *= col (j);
+          suffix[j-s] = p;
+        }
+
+      double prefix = 1;
+      octave_idx_type e = std::min (s + w, n_out);
+      for (octave_idx_type i = s; i < e; i++)
+        {
+          if (i == s)
+            y[i] = suffix[0];
+          else
+            {
+              octave_idx_type j = i + w - 1;
+              if (col.present (j))
+                prefix *= col (j);
+              y[i] = suffix[i-s] * prefix;
+            }
+        }
+    }
+}
+
+template <typename NDA>
+static NDA
+movfun_columns (mov_stat stat, const NDA& x, octave_idx_type nb,
+                octave_idx_type na, mov_endpoints mode, double fill,
+                int opt)
+{
+  typedef typename NDA::element_type T;
+
+  octave_idx_type n = x.rows ();
+  octave_idx_type ncols = x.columns ();
+
+  octave_idx_type w = nb + na + 1;
+
+  octave_idx_type n_out = n;
+  octave_idx_type n_pre = nb;
+  if (mode == mov_endpoints::discard)
+    {
+      n_out = std::max (n - nb - na, static_cast<octave_idx_type> (0));
+      n_pre = 0;
+    }
+
+  NDA y (dim_vector (n_out, ncols));
+
+  const T *px = x.data ();
+  T *py = y.fortran_vec ();
+
+  auto process = [=] (std::size_t begin, std::size_t end)
+  {
+    for (std::size_t c = begin; c < end; c++)
+      {
+        mov_column<T> col (px + c*n, n, n_pre, mode, fill);
+        T *yc = py + c*n_out;
+
+        switch (stat)
+          {
+          case mov_stat::sum:
+          case mov_stat::mean:
+            {
+              mov_sum acc (stat == mov_stat::mean);
+              mov_window (acc, col, n_out, w, yc);
+            }
+            break;
+
+          case mov_stat::var:
+          case mov_stat::std:
+            {
+              mov_var acc (opt, stat == mov_stat::std);
+              mov_window (acc, col, n_out, w, yc);
+            }
+            break;
+
+          case mov_stat::min:
+            {
+              mov_minmax<false> acc;
+              mov_window (acc, col, n_out, w, yc);
+            }
+            break;
+
+          case mov_stat::max:
+            {
+              mov_minmax<true> acc;
+              mov_window (acc, col, n_out, w, yc);
+            }
+            break;
+
+          case mov_stat::median:
+            {
+              mov_median acc;
+              mov_window (acc, col, n_out, w, yc);
+            }
+            break;
+
+          case mov_stat::prod:
+            mov_prod (col, n_out, w, yc);
+            break;
+          }
+      }
+  };
+
+  // The columns are independent.
+  if (ncols > 1 && thread_pool::use_threads (n * ncols))
+    thread_pool::parallel_for (ncols, 1, process);
+  else
+    process (0, ncols);
+
+  return y;
+}
+
+DEFUN (__movfun__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{y} =} __movfun__ (@var{stat}, @var{x}, @var{nb}, @var{na}, @var{endpoints}, @var{opt})
+Undocumented internal function.  Called from @file{movfun.m}.
+
+Compute the statistic @var{stat} (@qcode{"sum"}, @qcode{"mean"},
+@qcode{"prod"}, @qcode{"min"}, @qcode{"max"}, @qcode{"median"},
+@qcode{"var"}, or @qcode{"std"}) over moving windows along the columns of
+the real matrix @var{x}.  The windows include @var{nb} elements before and
+@var{na} elements after the center.  @var{endpoints} is one of the
+endpoint modes of @code{movfun} or a numeric value.  @var{opt} is the
+normalization for @qcode{"var"} and @qcode{"std"}.
+@end deftypefn */)
+{
+  if (args.length () != 6)
+    print_usage ();
+
+  std::string stat_name
+    = args(0).xstring_value ("__movfun__: STAT must be a string");
+
+  mov_stat stat;
+  if (stat_name == "sum")
+    stat = mov_stat::sum;
+  else if (stat_name == "mean")
+    stat = mov_stat::mean;
+  else if (stat_name == "prod")
+    stat = mov_stat::prod;
+  else if (stat_name == "min")
+    stat = mov_stat::min;
+  else if (stat_name == "max")
+    stat = mov_stat::max;
+  else if (stat_name == "median")
+    stat = mov_stat::median;
+  else if (stat_name == "var")
+    stat = mov_stat::var;
+  else if (stat_name == "std")
+    stat = mov_stat::std;
+  else
+    error ("__movfun__: unknown statistic '%s'", stat_name.c_str ());
+
+  octave_value x = args(1);
+
+  if (! x.isfloat () || x.iscomplex () || x.issparse () || x.ndims () != 2)
+    error ("__movfun__: X must be a real full floating point matrix");
+
+  octave_idx_type nb = args(2).xidx_type_value ("__movfun__: NB must be an integer");
+  octave_idx_type na = args(3).xidx_type_value ("__movfun__: NA must be an integer");
+
+  if (nb < 0 || na < 0 || nb > x.rows () || na > x.rows ())
+    error ("__movfun__: NB and NA must be between 0 and the number of rows of X");
+
+  mov_endpoints mode;
+  double fill = 0;
+
+  if (args(4).is_string ())
+    {
+      std::string bc = args(4).string_value ();
+
+      if (string::strcmpi (bc, "shrink"))
+        mode = mov_endpoints::shrink;
+      else if (string::strcmpi (bc, "discard"))
+        mode = mov_endpoints::discard;
+      else if (string::strcmpi (bc, "fill"))
+        {
+          mode = mov_endpoints::fill;
+          fill = numeric_limits<double>::NaN ();
+        }
+      else if (string::strcmpi (bc, "same"))
+        mode = mov_endpoints::same;
+      else if (string::strcmpi (bc, "periodic"))
+        mode = mov_endpoints::periodic;
+      else
+        error (R"(__movfun__: invalid ENDPOINTS "%s")", bc.c_str ());
+    }
+  else
+    {
+      mode = mov_endpoints::fill;
+      fill = args(4).xdouble_value ("__movfun__: ENDPOINTS must be a string or a numeric value");
+    }
+
+  int opt = args(5).xint_value ("__movfun__: OPT must be 0 or 1");
+
+  if (x.is_single_type ())
+    return ovl (movfun_columns (stat, x.float_array_value (), nb, na, mode,
+                                fill, opt));
+  else
+    return ovl (movfun_columns (stat, x.array_value (), nb, na, mode,
+                                fill, opt));
+}
+
+/*
+%!test
+%! x = [4 -1 NaN 3 8 Inf 2 -5 0 7 1 -Inf 6 6 2].';
+%! x(:,2) = (1:15).' .^ 2 / 7;
+%! for bc = {"shrink", "discard", "fill", "same", "periodic", 0, -2}
+%!   for w = {[1 1], [2 0], [0 3], [3 2], [0 0]}
+%!     nb = w{1}(1);  na = w{1}(2);
+%!     for stat = {"sum", "mean", "prod", "min", "max", "median", "var", "std"}
+%!       f = str2func (stat{1});
+%!       y = __movfun__ (stat{1}, x, nb, na, bc{1}, 0);
+%!       N = rows (x);
+%!       if (strcmp (bc{1}, "discard"))
+%!         ctr = (nb+1):(N-na);
+%!       else
+%!         ctr = 1:N;
+%!       endif
+%!       assert (rows (y), numel (ctr));
+%!       for c = 1:columns (x)
+%!         for k = 1:numel (ctr)
+%!           idx = ctr(k) + (-nb:na);
+%!           in = idx >= 1 & idx <= N;
+%!           xc = x(:,c);
+%!           if (ischar (bc{1}))
+%!             switch (bc{1})
+%!               case {"shrink", "discard"}
+%!                 v = xc(idx(in));
+%!               case "fill"
+%!                 v = NaN (numel (idx), 1);
+%!                 v(in) = xc(idx(in));
+%!               case "same"
+%!                 v = xc(min (max (idx, 1), N));
+%!               case "periodic"
+%!                 v = xc(mod (idx - 1, N) + 1);
+%!             endswitch
+%!           else
+%!             v = bc{1} * ones (numel (idx), 1);
+%!             v(in) = xc(idx(in));
+%!           endif
+%!           expected = f (v(:));
+%!           tol = 0;
+%!           if (isfinite (expected))
+%!             tol = 1e-12 * max (1, abs (expected));
+%!           endif
+%!           assert (y(k,c), expected, tol);
+%!         endfor
+%!       endfor
+%!     endfor
+%!   endfor
+%! endfor
+
+%!test
+%! x = single (rand (100, 3));
+%! y = __movfun__ ("median", x, 5, 5, "shrink", 0);
+%! assert (class (y), "single");
+%! assert (y(50,2), median (x(45:55,2)));
+
+%!test
+%! x = randn (1000, 1);
+%! y0 = __movfun__ ("var", x, 10, 10, "shrink", 0);
+%! y1 = __movfun__ ("var", x, 10, 10, "shrink", 1);
+%! assert (y0(500), var (x(490:510)), 1e-12);
+%! assert (y1(500), var (x(490:510), 1), 1e-12);
+%! assert (__movfun__ ("std", x, 10, 10, "shrink", 1), sqrt (y1), 1e-12);
+
+%!error <unknown statistic> __movfun__ ("mad", 1, 0, 0, "shrink", 0)
+%!error <real full floating point> __movfun__ ("sum", int8 (1), 0, 0, "shrink", 0)
+%!error <invalid ENDPOINTS> __movfun__ ("sum", 1, 0, 0, "foo", 0)
+*/
+
+OCTAVE_END_NAMESPACE(octave)
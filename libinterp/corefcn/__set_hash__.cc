@@ -0,0 +1,442 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "boolNDArray.h"
+#include "chNDArray.h"
+#include "dNDArray.h"
+#include "fNDArray.h"
+#include "int8NDArray.h"
+#include "int16NDArray.h"
+#include "int32NDArray.h"
+#include "int64NDArray.h"
+#include "uint8NDArray.h"
+#include "uint16NDArray.h"
+#include "uint32NDArray.h"
+#include "uint64NDArray.h"
+
+#include "defun.h"
+#include "error.h"
+#include "ovl.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Hash table implementations of unique and ismember for unique.m,
+// ismember.m and the other set functions.  Elements are equal if they
+// compare equal with ==, so NaN values are never equal to anything and
+// -0 is equal to 0.
+
+template <typename T>
+struct set_key
+{
+  typedef T type;
+
+  static type key (const T& x) { return x; }
+
+  static bool isnan (const T&) { return false; }
+};
+
+template <>
+struct set_key<double>
+{
+  typedef double type;
+
+  static type key (double x) { return x == 0 ? 0 : x; }
+
+  static bool isnan (double x) { return std::isnan (x); }
+};
+
+template <>
+struct set_key<float>
+{
+  typedef float type;
+
+  static type key (float x) { return x == 0 ? 0 : x; }
+
+  static bool isnan (float x) { return std::isnan (x); }
+};
+
+template <typename T>
+struct set_key<octave_int<T>>
+{
+  typedef T type;
+
+  static type key (const octave_int<T>& x) { return x.value (); }
+
+  static bool isnan (const octave_int<T>&) { return false; }
+};
+
+// Return the unique elements of X in Y, and the indices I and J such
+// that Y = X(I) and X = Y(J).  Y, I, and J are column vectors.  If
+// SORTED is false, Y is in the order of first occurrence in X.
+// Otherwise Y is sorted, with NaN values last, and I contains the last
+// occurrence of each element if LAST is true.  As with the sort based
+// algorithm, Y holds the last occurrence of each element when sorted.
+
+template <typename ARRAY>
+static ARRAY
+unique_hash (const ARRAY& x, bool sorted, bool last, bool need_j,
+             NDArray& i, NDArray& j)
+{
+  typedef typename ARRAY::element_type T;
+  typedef set_key<T> K;
+  typedef typename K::type key_type;
+
+  octave_idx_type n = x.numel ();
+
+  const T *px = x.data ();
+
+  // The first and last occurrence in X of each group of equal elements,
+  // and the group of each element.
+  std::vector<octave_idx_type> first;
+  std::vector<octave_idx_type> lastv;
+  std::vector<octave_idx_type> group;
+
+  if (need_j)
+    group.resize (n);
+
+  std::unordered_map<key_type, octave_idx_type> groups;
+
+  for (octave_idx_type k = 0; k < n; k++)
+    {
+      octave_idx_type g = first.size ();
+
+      if (K::isnan (px[k]))
+        {
+          first.push_back (k);
+          lastv.push_back (k);
+        }
+      else
+        {
+          auto it_new = groups.emplace (K::key (px[k]), g);
+
+          if (it_new.second)
+            {
+              first.push_back (k);
+              lastv.push_back (k);
+            }
+          else
+            {
+              g = it_new.first->second;
+              lastv[g] = k;
+            }
+        }
+
+      if (need_j)
+        group[k] = g;
+    }
+
+  groups.clear ();
+
+  octave_idx_type ng = first.size ();
+
+  // The groups in the order of the output.
+  std::vector<octave_idx_type> order (ng);
+  std::iota (order.begin (), order.end (), 0);
+
+  if (sorted)
+    std::stable_sort (order.begin (), order.end (),
+                      [=, &first] (octave_idx_type a, octave_idx_type b)
+                      {
+                        const T& xa = px[first[a]];
+                        const T& xb = px[first[b]];
+
+                        if (K::isnan (xb))
+                          return ! K::isnan (xa);
+                        else if (K::isnan (xa))
+                          return false;
+                        else
+                          return K::key (xa) < K::key (xb);
+                      });
+
+  ARRAY y (dim_vector (ng, 1));
+  i.resize (dim_vector (ng, 1));
+
+  for (octave_idx_type r = 0; r < ng; r++)
+    {
+      octave_idx_type g = order[r];
+
+      y.xelem (r) = px[sorted ? lastv[g] : first[g]];
+      i.xelem (r) = (sorted && last ? lastv[g] : first[g]) + 1;
+    }
+
+  if (need_j)
+    {
+      std::vector<octave_idx_type> rank (ng);
+      for (octave_idx_type r = 0; r < ng; r++)
+        rank[order[r]] = r;
+
+      j.resize (dim_vector (n, 1));
+      for (octave_idx_type k = 0; k < n; k++)
+        j.xelem (k) = rank[group[k]] + 1;
+    }
+  else
+    j = NDArray (dim_vector (0, 0));
+
+  return y;
+}
+
+// Return TF with the shape of A, true where the element of A is also an
+// element of S, and S_IDX with the index of the last such element of S.
+
+template <typename ARRAY>
+static void
+ismember_hash (const ARRAY& a, const ARRAY& s, boolNDArray& tf,
+               NDArray& s_idx)
+{
+  typedef typename ARRAY::element_type T;
+  typedef set_key<T> K;
+  typedef typename K::type key_type;
+
+  octave_idx_type na = a.numel ();
+  octave_idx_type ns = s.numel ();
+
+  const T *pa = a.data ();
+  const T *ps = s.data ();
+
+  std::unordered_map<key_type, octave_idx_type> index;
+
+  for (octave_idx_type k = 0; k < ns; k++)
+    if (! K::isnan (ps[k]))
+      index[K::key (ps[k])] = k + 1;
+
+  tf = boolNDArray (a.dims ());
+  s_idx = NDArray (a.dims ());
+
+  for (octave_idx_type k = 0; k < na; k++)
+    {
+      octave_idx_type loc = 0;
+
+      if (! K::isnan (pa[k]))
+        {
+          auto it = index.find (K::key (pa[k]));
+
+          if (it != index.end ())
+            loc = it->second;
+        }
+
+      tf.xelem (k) = (loc != 0);
+      s_idx.xelem (k) = loc;
+    }
+}
+
+DEFUN (__unique__, args, nargout,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {[@var{y}, @var{i}, @var{j}] =} __unique__ (@var{x}, @var{sorted}, @var{last})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 3)
+    print_usage ();
+
+  octave_value x = args(0);
+
+  bool sorted = args(1).xbool_value ("__unique__: SORTED must be a logical value");
+  bool last = args(2).xbool_value ("__unique__: LAST must be a logical value");
+
+  if (x.iscomplex () || x.issparse ())
+    error ("__unique__: X must be a real full array or a cell array of strings");
+
+  bool need_j = (nargout > 2);
+
+  NDArray i, j;
+  octave_value y;
+
+  if (x.iscellstr ())
+    y = unique_hash (x.cellstr_value (), sorted, last, need_j, i, j);
+  else if (x.is_string ())
+    y = octave_value (unique_hash (x.char_array_value (), sorted, last,
+                                   need_j, i, j),
+                      x.is_dq_string () ? '"' : '\'');
+  else
+    {
+      switch (x.builtin_type ())
+        {
+        case btyp_double:
+          y = unique_hash (x.array_value (), sorted, last, need_j, i, j);
+          break;
+
+        case btyp_float:
+          y = unique_hash (x.float_array_value (), sorted, last, need_j,
+                           i, j);
+          break;
+
+        case btyp_bool:
+          y = unique_hash (x.bool_array_value (), sorted, last, need_j,
+                           i, j);
+          break;
+
+#define MAKE_INT_BRANCH(X)                                              \
+          case btyp_ ## X:                                              \
+            y = unique_hash (x.X ## _array_value (), sorted, last,      \
+                             need_j, i, j);                             \
+            break;
+
+          MAKE_INT_BRANCH (int8);
+          MAKE_INT_BRANCH (int16);
+          MAKE_INT_BRANCH (int32);
+          MAKE_INT_BRANCH (int64);
+          MAKE_INT_BRANCH (uint8);
+          MAKE_INT_BRANCH (uint16);
+          MAKE_INT_BRANCH (uint32);
+          MAKE_INT_BRANCH (uint64);
+
+#undef MAKE_INT_BRANCH
+
+        default:
+          error ("__unique__: X must be a real full array or a cell array of strings");
+        }
+    }
+
+  return ovl (y, i, j);
+}
+
+DEFUN (__ismember__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {[@var{tf}, @var{s_idx}] =} __ismember__ (@var{a}, @var{s})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 2)
+    print_usage ();
+
+  octave_value a = args(0);
+  octave_value s = args(1);
+
+  if (a.class_name () != s.class_name ())
+    error ("__ismember__: A and S must have the same class");
+
+  if (a.iscomplex () || s.iscomplex () || a.issparse () || s.issparse ())
+    error ("__ismember__: A and S must be real full arrays or cell arrays of strings");
+
+  boolNDArray tf;
+  NDArray s_idx;
+
+  if (a.iscellstr () && s.iscellstr ())
+    ismember_hash (a.cellstr_value (), s.cellstr_value (), tf, s_idx);
+  else if (a.is_string ())
+    ismember_hash (a.char_array_value (), s.char_array_value (), tf, s_idx);
+  else
+    {
+      switch (a.builtin_type ())
+        {
+        case btyp_double:
+          ismember_hash (a.array_value (), s.array_value (), tf, s_idx);
+          break;
+
+        case btyp_float:
+          ismember_hash (a.float_array_value (), s.float_array_value (),
+                         tf, s_idx);
+          break;
+
+        case btyp_bool:
+          ismember_hash (a.bool_array_value (), s.bool_array_value (),
+                         tf, s_idx);
+          break;
+
+#define MAKE_INT_BRANCH(X)                                              \
+          case btyp_ ## X:                                              \
+            ismember_hash (a.X ## _array_value (), s.X ## _array_value (), \
+                           tf, s_idx);                                  \
+            break;
+
+          MAKE_INT_BRANCH (int8);
+          MAKE_INT_BRANCH (int16);
+          MAKE_INT_BRANCH (int32);
+          MAKE_INT_BRANCH (int64);
+          MAKE_INT_BRANCH (uint8);
+          MAKE_INT_BRANCH (uint16);
+          MAKE_INT_BRANCH (uint32);
+          MAKE_INT_BRANCH (uint64);
+
+#undef MAKE_INT_BRANCH
+
+        default:
+          error ("__ismember__: A and S must be real full arrays or cell arrays of strings");
+        }
+    }
+
+  return ovl (tf, s_idx);
+}
+
+/*
+%!test
+%! x = [3 1 NaN 2 -0 3 NaN 0 1];
+%! [y, i, j] = __unique__ (x, true, false);
+%! assert (y, [0; 1; 2; 3; NaN; NaN]);
+%! assert (i, [5; 2; 4; 1; 3; 7]);
+%! assert (j, [4; 2; 5; 3; 1; 4; 6; 1; 2]);
+%! [y, i, j] = __unique__ (x, true, true);
+%! assert (i, [8; 9; 4; 6; 3; 7]);
+%! [y, i, j] = __unique__ (x, false, false);
+%! assert (y, [3; 1; NaN; 2; 0; NaN]);
+%! assert (i, [1; 2; 3; 4; 5; 7]);
+%! assert (y(j), x(:));
+
+%!test
+%! x = {"b"; "a"; "b"; ""; "a"};
+%! [y, i, j] = __unique__ (x, true, false);
+%! assert (y, {""; "a"; "b"});
+%! assert (i, [4; 2; 1]);
+%! assert (j, [3; 2; 3; 1; 2]);
+%! [y, i, j] = __unique__ (x, false, false);
+%! assert (y, {"b"; "a"; ""});
+%! assert (y(j), x);
+
+%!test
+%! for cls = {"int8", "uint16", "int64", "single", "char"}
+%!   x = cast ([5 1 5 0 1 1], cls{1});
+%!   [y, i, j] = __unique__ (x, true, false);
+%!   assert (class (y), cls{1});
+%!   assert (y, cast ([0; 1; 5], cls{1}));
+%!   assert (y(j), x(:));
+%! endfor
+%! [y, i, j] = __unique__ (logical ([1 0 1 1]), false, false);
+%! assert (y, [true; false]);
+%! assert (j, [1; 2; 1; 1]);
+
+%!test
+%! [tf, loc] = __ismember__ ([1 NaN 3; 0 7 -0], [0 3 1 3 NaN]);
+%! assert (tf, logical ([1 0 1; 1 0 1]));
+%! assert (loc, [3 0 4; 1 0 1]);
+%! [tf, loc] = __ismember__ ({"x", "b", "a"}, {"a", "b", "a"});
+%! assert (tf, [false true true]);
+%! assert (loc, [0 2 3]);
+
+%!error <same class> __ismember__ (1, int8 (1))
+%!error <real full array> __unique__ (1i, true, false)
+*/
+
+OCTAVE_END_NAMESPACE(octave)
@@ -27,6 +27,8 @@
 #  include "config.h"
 #endif
 
+#include <atomic>
+#include <set>
 #include <string>
 #include <vector>
 #include <list>
@@ -35,6 +37,7 @@
 #include "lo-mappers.h"
 #include "oct-locbuf.h"
 #include "oct-string.h"
+#include "oct-thread-pool.h"
 
 #include "Cell.h"
 #include "oct-map.h"
@@ -62,6 +65,7 @@
 #include "ov-uint64.h"
 #include "ov-uint8.h"
 
+#include "ov-builtin.h"
 #include "ov-fcn-handle.h"
 
 OCTAVE_BEGIN_NAMESPACE(octave)
@@ -119,6 +123,183 @@ get_output_list (interpreter& interp, octave_idx_type count,
   return tmp;
 }
 
+// Built-in functions that may be called from several threads at once
+// by cellfun and arrayfun with the "Parallel" option.  They must not
+// use the interpreter, except to throw errors and warnings, and must not
+// have side effects other than filling caches of their arguments (for
+// example the matrix type that inv and det store).  Each call gets
+// unique copies of its arguments for that reason.  The fft functions are
+// not listed because the FFTW plan cache may only be used from the main
+// thread.
+
+static const std::set<std::string> thread_safe_builtins
+  = { "abs", "all", "any", "ceil", "columns", "cumprod", "cumsum", "det",
+      "diag", "eig", "exp", "fix", "floor", "imag", "inv", "isempty",
+      "isfinite", "isinf", "isnan", "isreal", "length", "log", "max",
+      "min", "ndims", "norm", "numel", "prod", "real", "round", "rows",
+      "schur", "size", "sort", "sqrt", "sum", "sumsq", "svd" };
+
+// Return the built-in function called by FCN if it is thread-safe,
+// otherwise nullptr.
+
+static octave_builtin *
+thread_safe_builtin (symbol_table& symtab, const octave_value& fcn)
+{
+  std::string name;
+
+  if (fcn.is_function_handle ())
+    {
+      octave_fcn_handle *fh = fcn.fcn_handle_value ();
+
+      if (! fh->is_simple ())
+        return nullptr;
+
+      name = fh->fcn_name ();
+    }
+  else if (fcn.is_function ())
+    name = fcn.function_value ()->name ();
+  else
+    return nullptr;
+
+  if (thread_safe_builtins.find (name) == thread_safe_builtins.end ())
+    return nullptr;
+
+  // The name may refer to a user function that shadows the built-in.
+  octave_value f = symtab.find_function (name);
+
+  if (! f.is_defined ())
+    return nullptr;
+
+  return dynamic_cast<octave_builtin *> (f.function_value ());
+}
+
+// Outputs of a thread-safe built-in function for the leading elements
+// of a cellfun or arrayfun call, computed by the thread pool.  Each
+// element has its own slot for its outputs.
+//
+// The function is called directly, without a stack frame.  An element
+// for which the function throws an error or a warning, or that has an
+// object argument (which could dispatch to a method), is not stored.
+// The remaining elements, starting with the first of these, must be
+// evaluated serially with get_output_list, so that errors, warnings, and
+// the ErrorHandler function are handled exactly as without "Parallel".
+
+class parallel_outputs
+{
+public:
+
+  parallel_outputs () : m_results (), m_count (0) { }
+
+  OCTAVE_DISABLE_COPY_MOVE (parallel_outputs)
+
+  ~parallel_outputs () = default;
+
+  void compute (interpreter& interp, octave_builtin& fcn,
+                const std::vector<octave_value_list>& args, int nargout);
+
+  bool has (octave_idx_type i) const { return i < m_count; }
+
+  octave_value_list take (octave_idx_type i)
+  {
+    return std::move (m_results[i]);
+  }
+
+private:
+
+  std::vector<octave_value_list> m_results;
+
+  // Number of leading elements whose outputs are stored.
+  octave_idx_type m_count;
+};
+
+void
+parallel_outputs::compute (interpreter& interp, octave_builtin& fcn,
+                           const std::vector<octave_value_list>& args,
+                           int nargout)
+{
+  octave_idx_type n = args.size ();
+
+  m_results.resize (n);
+
+  std::atomic<octave_idx_type> first_failed (n);
+  std::atomic<bool> interrupted (false);
+
+  octave_builtin::fcn f = fcn.function ();
+  octave_builtin::meth m = fcn.method ();
+
+  auto fail = [&] (octave_idx_type i)
+    {
+      octave_idx_type prev = first_failed;
+
+      while (i < prev && ! first_failed.compare_exchange_weak (prev, i))
+        ;
+    };
+
+  thread_pool::parallel_for (n, 1, [&] (std::size_t begin, std::size_t end)
+    {
+      for (octave_idx_type i = begin; i < static_cast<octave_idx_type> (end);
+           i++)
+        {
+          // Outputs after the first failure are not needed.
+          if (i > first_failed)
+            break;
+
+          octave_value_list a = args[i];
+
+          try
+            {
+              bool has_object = false;
+
+              for (octave_idx_type j = 0; j < a.length (); j++)
+                if (a(j).isobject () || a(j).is_classdef_object ()
+                    || a(j).is_magic_colon ())
+                  has_object = true;
+
+              if (has_object)
+                {
+                  fail (i);
+                  break;
+                }
+
+              // Values shared with other elements must not have their
+              // caches filled by several threads at once.
+              for (octave_idx_type j = 0; j < a.length (); j++)
+                a(j).make_unique ();
+
+              octave_value_list tmp = (f ? f (a, nargout)
+                                       : m (interp, a, nargout));
+
+              // As in tree_evaluator::execute_builtin_function.
+              tmp.make_storable_values ();
+
+              if (tmp.length () == 1 && tmp.xelem (0).is_undefined ())
+                tmp.clear ();
+
+              m_results[i] = tmp;
+            }
+          catch (const interrupt_exception&)
+            {
+              interrupted = true;
+              fail (i);
+              break;
+            }
+          catch (...)
+            {
+              fail (i);
+              break;
+            }
+        }
+    });
+
+  if (interrupted)
+    throw interrupt_exception ();
+
+  m_count = first_failed;
+
+  // Release the slots that will be filled serially.
+  m_results.resize (m_count);
+}
+
 // Templated function because the user can be stubborn enough to request
 // a cell array as an output even in these cases where the output fits
 // in an ordinary array
@@ -226,7 +407,7 @@ static void
 get_mapper_fun_options (symbol_table& symtab,
                         const octave_value_list& args,
                         int& nargin, bool& uniform_output,
-                        octave_value& error_handler)
+                        octave_value& error_handler, bool& parallel)
 {
   while (nargin > 3 && args(nargin-2).is_string ())
     {
@@ -237,6 +418,8 @@ get_mapper_fun_options (symbol_table& symtab,
 
       if (string::strncmpi (arg, "uniformoutput", compare_len))
         uniform_output = args(nargin-1).bool_value ();
+      else if (string::strncmpi (arg, "parallel", compare_len))
+        parallel = args(nargin-1).bool_value ();
       else if (string::strncmpi (arg, "errorhandler", compare_len))
         {
           if (args(nargin-1).is_function_handle ()
@@ -277,6 +460,7 @@ DEFMETHOD (cellfun, interp, args, nargout,
 @deftypefnx {} {[@var{A1}, @var{A2}, @dots{}] =} cellfun (@dots{})
 @deftypefnx {} {@var{A} =} cellfun (@dots{}, "ErrorHandler", @var{errfcn})
 @deftypefnx {} {@var{A} =} cellfun (@dots{}, "UniformOutput", @var{val})
+@deftypefnx {} {@var{A} =} cellfun (@dots{}, "Parallel", @var{tf})
 
 Evaluate the function named "@var{fcn}" on the elements of the cell array
 @var{C}.
@@ -387,6 +571,20 @@ cellfun ("factorial", @{-1,2@}, "ErrorHandler", @@foo)
 @end group
 @end example
 
+If the parameter @qcode{"Parallel"} is true and @var{fcn} is one of the
+built-in functions @code{abs}, @code{all}, @code{any}, @code{ceil},
+@code{columns}, @code{cumprod}, @code{cumsum}, @code{det}, @code{diag},
+@code{eig}, @code{exp}, @code{fix}, @code{floor}, @code{imag}, @code{inv},
+@code{isempty}, @code{isfinite}, @code{isinf}, @code{isnan}, @code{isreal},
+@code{length}, @code{log}, @code{max}, @code{min}, @code{ndims}, @code{norm},
+@code{numel}, @code{prod}, @code{real}, @code{round}, @code{rows},
+@code{schur}, @code{size}, @code{sort}, @code{sqrt}, @code{sum}, @code{sumsq},
+or @code{svd}, the function is evaluated for several elements at once in
+separate threads (see @code{maxNumCompThreads}).  The results, errors, and
+warnings are the same as without @qcode{"Parallel"}: the elements from the
+first one that fails or warns onward are evaluated serially.  For other
+functions, the option has no effect.
+
 Use @code{cellfun} intelligently.  The @code{cellfun} function is a useful tool
 for avoiding loops.  It is often used with anonymous function handles; however,
 calling an anonymous function involves an overhead quite comparable to the
@@ -448,8 +646,10 @@ v = cellfun (@@det, C);         # 40% faster
 
   bool uniform_output = true;
   octave_value error_handler;
+  bool parallel = false;
 
-  get_mapper_fun_options (symtab, args, nargin, uniform_output, error_handler);
+  get_mapper_fun_options (symtab, args, nargin, uniform_output, error_handler,
+                          parallel);
 
   // The following is an optimization because the symbol table can give a
   // more specific function class, so this can result in fewer polymorphic
@@ -536,6 +736,29 @@ nevermind:
         }
     }
 
+  // Compute the outputs of a thread-safe built-in function in parallel.
+
+  parallel_outputs par;
+
+  octave_builtin *par_fcn
+    = (parallel && k > 1 ? thread_safe_builtin (symtab, fcn) : nullptr);
+
+  if (par_fcn)
+    {
+      std::vector<octave_value_list> arglists (k, inputlist);
+
+      for (octave_idx_type count = 0; count < k; count++)
+        {
+          for (int j = 0; j < nargin; j++)
+            {
+              if (mask[j])
+                arglists[count](j) = cinputs[j](count);
+            }
+        }
+
+      par.compute (interp, *par_fcn, arglists, nargout);
+    }
+
   // Apply functions.
 
   if (uniform_output)
@@ -556,8 +779,9 @@ nevermind:
             }
 
           const octave_value_list tmp
-            = get_output_list (interp, count, nargout, inputlist, fcn,
-                               error_handler);
+            = (par.has (count) ? par.take (count)
+               : get_output_list (interp, count, nargout, inputlist, fcn,
+                                  error_handler));
 
           int tmp_numel = tmp.length ();
           if (count == 0)
@@ -642,8 +866,9 @@ nevermind:
             }
 
           const octave_value_list tmp
-            = get_output_list (interp, count, nargout, inputlist, fcn,
-                               error_handler);
+            = (par.has (count) ? par.take (count)
+               : get_output_list (interp, count, nargout, inputlist, fcn,
+                                  error_handler));
 
           if (nargout > 0 && tmp.length () < nargout)
             error ("cellfun: function returned fewer than nargout values");
@@ -1044,6 +1269,55 @@ nevermind:
 %!         [1, 2, NaN]);
 %! assert (! isempty (__errmsg));
 %! clear -global __errmsg;
+
+## "Parallel" option
+%!test
+%! C = num2cell (reshape (1:2000, 4, 5, 100), [1, 2]);
+%! [U1, S1, V1] = cellfun (@svd, C, "UniformOutput", false);
+%! [U2, S2, V2] = cellfun (@svd, C, "UniformOutput", false, "Parallel", true);
+%! assert (S2, S1);
+%! assert (U2, U1);
+%! assert (V2, V1);
+%! assert (cellfun ("norm", C, "Parallel", true), cellfun ("norm", C));
+%! assert (cellfun (@numel, {1, [1, 2], "abc"}, "Parallel", true), [1, 2, 3]);
+%! assert (cellfun (@(x) 2*x, {1, 2}, "Parallel", true), [2, 4]);
+
+%!test
+%! C = {[3, 4], ones (2, 2, 2), [6, 8], ones (1, 1, 2)};
+%! r = cellfun (@norm, C, "Parallel", true, "ErrorHandler", @(s, x) -s.index);
+%! assert (r, [5, -2, 10, -4]);
+%! msg1 = msg2 = "";
+%! try
+%!   cellfun (@norm, C);
+%! catch err
+%!   msg1 = err.message;
+%! end_try_catch
+%! try
+%!   cellfun (@norm, C, "Parallel", true);
+%! catch err
+%!   msg2 = err.message;
+%! end_try_catch
+%! assert (msg2, msg1);
+
+## Shared arguments whose caches are filled by the function
+%!test
+%! old_threads = __thread_pool__ ("threads", 4);
+%! old_threshold = __thread_pool__ ("threshold", 1);
+%! unwind_protect
+%!   A = [4, 1; 2, 3];
+%!   r = cellfun (@inv, repmat ({A}, 1, 1e4), "UniformOutput", false,
+%!                "Parallel", true);
+%!   assert (all (cellfun (@(x) isequal (x, inv (A)), r)));
+%!   D = diag ([2, 3, 4]);
+%!   assert (cellfun (@det, repmat ({D}, 1, 1e4), "Parallel", true),
+%!           24 * ones (1, 1e4));
+%! unwind_protect_cleanup
+%!   __thread_pool__ ("threads", old_threads);
+%!   __thread_pool__ ("threshold", old_threshold);
+%! end_unwind_protect
+
+%!warning <singular>
+%! cellfun (@inv, {2, 0, 4}, "Parallel", true);
 */
 
 // Arrayfun was originally a .m file written by Bill Denney and Jaroslav
@@ -1057,6 +1331,7 @@ DEFMETHOD (arrayfun, interp, args, nargout,
 @deftypefnx {} {[@var{B1}, @var{B2}, @dots{}] =} arrayfun (@var{fcn}, @var{A}, @dots{})
 @deftypefnx {} {@var{B} =} arrayfun (@dots{}, "UniformOutput", @var{val})
 @deftypefnx {} {@var{B} =} arrayfun (@dots{}, "ErrorHandler", @var{errfcn})
+@deftypefnx {} {@var{B} =} arrayfun (@dots{}, "Parallel", @var{tf})
 
 Execute a function on each element of an array.
 
@@ -1167,6 +1442,9 @@ arrayfun (@@str2num, [1234],
 @end group
 @end example
 
+The parameter @qcode{"Parallel"} evaluates some built-in functions for several
+elements at once in separate threads, as described for @code{cellfun}.
+
 @seealso{spfun, cellfun, structfun}
 @end deftypefn */)
 {
@@ -1233,9 +1511,10 @@ arrayfun (@@str2num, [1234],
 
       bool uniform_output = true;
       octave_value error_handler;
+      bool parallel = false;
 
       get_mapper_fun_options (symtab, args, nargin, uniform_output,
-                              error_handler);
+                              error_handler, parallel);
 
       octave_value_list inputlist (nargin, octave_value ());
 
@@ -1274,6 +1553,35 @@ arrayfun (@@str2num, [1234],
             }
         }
 
+      // Compute the outputs of a thread-safe built-in function in
+      // parallel.
+
+      parallel_outputs par;
+
+      octave_builtin *par_fcn
+        = (parallel && k > 1 ? thread_safe_builtin (symtab, fcn) : nullptr);
+
+      if (par_fcn)
+        {
+          std::vector<octave_value_list> arglists (k, inputlist);
+
+          std::list<octave_value_list> idx_list (1);
+          idx_list.front ().resize (1);
+
+          for (octave_idx_type count = 0; count < k; count++)
+            {
+              idx_list.front ()(0) = count + 1.0;
+
+              for (int j = 0; j < nargin; j++)
+                {
+                  if (mask[j])
+                    arglists[count](j) = inputs[j].index_op (idx_list);
+                }
+            }
+
+          par.compute (interp, *par_fcn, arglists, nargout);
+        }
+
       // Apply functions.
 
       if (uniform_output)
@@ -1295,8 +1603,9 @@ arrayfun (@@str2num, [1234],
                 }
 
               const octave_value_list tmp
-                = get_output_list (interp, count, nargout, inputlist, fcn,
-                                   error_handler);
+                = (par.has (count) ? par.take (count)
+                   : get_output_list (interp, count, nargout, inputlist, fcn,
+                                      error_handler));
 
               if (nargout > 0 && tmp.length () < nargout)
                 error_with_id ("Octave:invalid-fun-call",
@@ -1387,8 +1696,9 @@ arrayfun (@@str2num, [1234],
                 }
 
               const octave_value_list tmp
-                = get_output_list (interp, count, nargout, inputlist, fcn,
-                                   error_handler);
+                = (par.has (count) ? par.take (count)
+                   : get_output_list (interp, count, nargout, inputlist, fcn,
+                                      error_handler));
 
               if (nargout > 0 && tmp.length () < nargout)
                 error_with_id ("Octave:invalid-fun-call",
@@ -1668,6 +1978,15 @@ arrayfun (@@str2num, [1234],
 %! assert ([(isempty (A(1).message)), (isempty (A(2).message))],
 %!         [false, false]);
 %! assert ([A(1).index, A(2).index], [1, 2]);
+
+## "Parallel" option
+%!test
+%! A = magic (20);
+%! assert (arrayfun (@sqrt, A, "Parallel", true), sqrt (A));
+%! assert (arrayfun (@max, A, A', "Parallel", true), max (A, A'));
+%! assert (arrayfun ("sqrt", [1, 4, -9], "UniformOutput", false,
+%!                   "Parallel", true),
+%!         {1, 2, 3i});
 */
 
 static void
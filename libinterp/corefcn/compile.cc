@@ -32,7 +32,9 @@
 #include "defun.h"
 #include "variables.h"
 #include "interpreter.h"
+#include "oct-map.h"
 
+#include "pt-bytecode-cache.h"
 #include "pt-bytecode-vm.h"
 #include "pt-bytecode-walk.h"
 
@@ -408,6 +410,53 @@ The @qcode{"clear"} option removes the bytecode from the function instead.
   return octave_value {true};
 }
 
+DEFUN (__vm_bytecode_cache__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {[@var{dir}, @var{stats}] =} __vm_bytecode_cache__ ()
+@deftypefnx {} {@var{old_dir} =} __vm_bytecode_cache__ (@var{dir})
+Query or set the directory of the on-disk cache of compiled functions.
+
+When the directory is not empty, the bytecode of functions defined in files
+is written to it when they are compiled, and loaded from it instead of
+compiling them again in later sessions.  An entry is only used if neither
+the function file nor the version of Octave and its bytecode format have
+changed since it was written, and if all the operands of its instructions
+are valid.  The directory is created when needed.  An empty string
+disables the cache.
+
+The initial directory is the value of the environment variable
+@env{OCTAVE_VM_CACHE_DIR}.
+
+The second output is a struct with the number of @qcode{"hits"},
+@qcode{"misses"}, and @qcode{"writes"} of the cache in this session.
+
+@seealso{__compile, __enable_vm_eval__}
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin > 1)
+    print_usage ();
+
+  std::string old_dir = bytecode_cache::directory ();
+
+  if (nargin == 1)
+    {
+      std::string dir
+        = args(0).xstring_value ("__vm_bytecode_cache__: DIR must be a string");
+
+      bytecode_cache::directory (dir);
+    }
+
+  octave_scalar_map stats;
+
+  stats.setfield ("hits", static_cast<double> (bytecode_cache::hits ()));
+  stats.setfield ("misses", static_cast<double> (bytecode_cache::misses ()));
+  stats.setfield ("writes", static_cast<double> (bytecode_cache::writes ()));
+
+  return ovl (old_dir, stats);
+}
+
 // If TRUE, use VM evaluator rather than tree walker.
 // FIXME: Use OCTAVE_ENABLE_VM_EVALUATOR define to set it to true when
 // the VM has been tested properly.
@@ -450,4 +499,26 @@ function's m-file.
                                 "__enable_vm_eval__");
 }
 
+// If TRUE, fuse frequent instruction sequences when compiling.
+bool V__vm_fuse_instructions__ = true;
+
+DEFUN (__vm_fuse_instructions__, args, nargout,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{val} =} __vm_fuse_instructions__ ()
+@deftypefnx {} {@var{old_val} =} __vm_fuse_instructions__ (@var{new_val})
+@deftypefnx {} {@var{old_val} =} __vm_fuse_instructions__ (@var{new_val}, "local")
+Query or set whether the bytecode compiler replaces frequent instruction
+sequences, such as @code{s = s + x(i)} and the conditions of loops, with
+fused instructions.
+
+The setting only affects functions compiled after it is changed.  It is
+intended for testing and benchmarking the fused instructions.
+
+@seealso{__compile, __enable_vm_eval__}
+@end deftypefn */)
+{
+  return set_internal_variable (V__vm_fuse_instructions__, args, nargout,
+                                "__vm_fuse_instructions__");
+}
+
 OCTAVE_END_NAMESPACE(octave)
@@ -35,11 +35,13 @@
 #include <algorithm>
 #include <limits>
 #include <string>
+#include <vector>
 
 #include "lo-ieee.h"
 #include "mx-base.h"
 #include "oct-base64.h"
 #include "oct-binmap.h"
+#include "oct-thread-pool.h"
 #include "oct-time.h"
 #include "quit.h"
 
@@ -7328,17 +7330,52 @@ ordered lists.
 
 %!error sort ()
 %!error sort (1, 2, 3, 4)
+
+## Sorts split across threads give the same result as serial sorts
+%!test
+%! old_n = __thread_pool__ ("threads", 4);
+%! old_m = __thread_pool__ ("threshold", 1000);
+%! unwind_protect
+%!   x = randi (100, 1, 50001);
+%!   x(1:97:end) = NaN;
+%!   c = cellstr (num2str (randi (1000, 3001, 1)));
+%!   [s4, i4] = sort (x);
+%!   [d4, j4] = sort (x, "descend");
+%!   [c4, k4] = sort (c);
+%!   u4 = unique (x);
+%!   __thread_pool__ ("threads", 1);
+%!   [s1, i1] = sort (x);
+%!   [d1, j1] = sort (x, "descend");
+%!   [c1, k1] = sort (c);
+%!   u1 = unique (x);
+%!   assert (s4, s1);
+%!   assert (i4, i1);
+%!   assert (d4, d1);
+%!   assert (j4, j1);
+%!   assert (c4, c1);
+%!   assert (k4, k1);
+%!   assert (u4, u1);
+%!   __thread_pool__ ("threads", 4);
+%!   assert (issorted (s4));
+%!   assert (! issorted (x));
+%! unwind_protect_cleanup
+%!   __thread_pool__ ("threads", old_n);
+%!   __thread_pool__ ("threshold", old_m);
+%! end_unwind_protect
 */
 
 // Sort the rows of the matrix @var{a} according to the order
 // specified by @var{mode}, which can either be 'ascend' or 'descend'
-// and return the index vector corresponding to the sort order.
+// and return the index vector corresponding to the sort order.  Instead
+// of @var{mode}, a logical vector @var{desc} may select the columns that
+// are sorted in descending order.
 //
 // FIXME: This function does not yet support sparse matrices.
 
 DEFUN (__sort_rows_idx__, args, ,
        doc: /* -*- texinfo -*-
-@deftypefn {} {@var{idx} =} __sort_rows_idx__ (@var{A}, @var{mode})
+@deftypefn  {} {@var{idx} =} __sort_rows_idx__ (@var{A}, @var{mode})
+@deftypefnx {} {@var{idx} =} __sort_rows_idx__ (@var{A}, @var{desc})
 Called internally from @file{sortrows.m}.
 @end deftypefn */)
 {
@@ -7347,21 +7384,6 @@ Called internally from @file{sortrows.m}.
   if (nargin < 1 || nargin > 2)
     print_usage ();
 
-  if (nargin == 2 && ! args(1).is_string ())
-    error ("__sort_rows_idx__: second argument must be a string");
-
-  sortmode smode = ASCENDING;
-  if (nargin > 1)
-    {
-      std::string mode = args(1).string_value ();
-      if (mode == "ascend")
-        smode = ASCENDING;
-      else if (mode == "descend")
-        smode = DESCENDING;
-      else
-        error (R"(__sort_rows_idx__: MODE must be either "ascend" or "descend")");
-    }
-
   octave_value arg = args(0);
 
   if (arg.issparse ())
@@ -7370,12 +7392,82 @@ Called internally from @file{sortrows.m}.
   if (arg.ndims () != 2)
     error ("__sort_rows_idx__: needs a 2-D object");
 
-  Array<octave_idx_type> idx = arg.sort_rows_idx (smode);
+  Array<octave_idx_type> idx;
+
+  if (nargin == 2 && ! args(1).is_string ())
+    {
+      if (! (args(1).islogical () || args(1).isnumeric ()))
+        error ("__sort_rows_idx__: second argument must be a string or a "
+               "logical vector");
+
+      boolNDArray desc = args(1).bool_array_value ();
+
+      if (desc.numel () != arg.columns ())
+        error ("__sort_rows_idx__: DESC must have one element per column");
+
+      idx = arg.sort_rows_idx (desc);
+    }
+  else
+    {
+      sortmode smode = ASCENDING;
+      if (nargin > 1)
+        {
+          std::string mode = args(1).string_value ();
+          if (mode == "ascend")
+            smode = ASCENDING;
+          else if (mode == "descend")
+            smode = DESCENDING;
+          else
+            error (R"(__sort_rows_idx__: MODE must be either "ascend" or "descend")");
+        }
+
+      idx = arg.sort_rows_idx (smode);
+    }
 
   // This cannot be ovl(), relies on special overloaded octave_value call.
   return octave_value (idx, true, true);
 }
 
+/*
+%!test
+%! A = [1, 2, 3; 1, 2, 2; 1, 1, 3; 2, 1, 1; NaN, 1, 1; 1, NaN, 2];
+%! assert (__sort_rows_idx__ (A, [false, false, false]),
+%!         __sort_rows_idx__ (A, "ascend"));
+%! assert (__sort_rows_idx__ (A, [true, true, true]),
+%!         __sort_rows_idx__ (A, "descend"));
+%! assert (__sort_rows_idx__ (A, [false, true, false]), [6; 2; 1; 3; 4; 5]);
+
+%!test
+%! ## Compare with per-column stable sorts on a large matrix, with the
+%! ## sorts split across threads.
+%! old_n = __thread_pool__ ("threads", 4);
+%! old_m = __thread_pool__ ("threshold", 1000);
+%! unwind_protect
+%!   A = randi (5, 20000, 3);
+%!   A(randi (numel (A), 100, 1)) = NaN;
+%!   desc = [true, false, true];
+%!   i = (1:rows (A))';
+%!   for j = 3:-1:1
+%!     if (desc(j))
+%!       [~, k] = sort (A(i,j), "descend");
+%!     else
+%!       [~, k] = sort (A(i,j), "ascend");
+%!     endif
+%!     i = i(k);
+%!   endfor
+%!   assert (__sort_rows_idx__ (A, desc), i);
+%!   assert (__sort_rows_idx__ (single (A), desc), i);
+%! unwind_protect_cleanup
+%!   __thread_pool__ ("threads", old_n);
+%!   __thread_pool__ ("threshold", old_m);
+%! end_unwind_protect
+
+%!error <DESC must have one element per column>
+%! __sort_rows_idx__ ([1, 2, 3], [true, false])
+%!error <MODE must be either>
+%! __sort_rows_idx__ ([1, 2, 3], "foo")
+*/
+
 static sortmode
 get_sort_mode_option (const octave_value& arg)
 {
@@ -7849,6 +7941,461 @@ Undocumented internal function.
   return do_accumarray_minmax_fcn (args, false);
 }
 
+// Group-wise reductions for accumarray.  Each reduction is described by
+// an accumulator type with the value for an empty group (init), the
+// update for the value at position K of VALS (add), and the combination
+// of two partial results, where B is from later positions than A (merge).
+
+template <typename T>
+class accum_moments
+{
+public:
+
+  struct acc_type
+  {
+    T m_sum;
+    octave_idx_type m_n;
+  };
+
+  accum_moments (const T *vals, octave_idx_type stride)
+    : m_vals (vals), m_stride (stride)
+  { }
+
+  acc_type init () const { return { T (), 0 }; }
+
+  void add (acc_type& a, octave_idx_type k) const
+  {
+    a.m_sum += m_vals[k * m_stride];
+    a.m_n++;
+  }
+
+  void merge (acc_type& a, const acc_type& b) const
+  {
+    a.m_sum += b.m_sum;
+    a.m_n += b.m_n;
+  }
+
+private:
+
+  const T *m_vals;
+  octave_idx_type m_stride;
+};
+
+class accum_count
+{
+public:
+
+  typedef octave_idx_type acc_type;
+
+  acc_type init () const { return 0; }
+
+  void add (acc_type& a, octave_idx_type) const { a++; }
+
+  void merge (acc_type& a, const acc_type& b) const { a += b; }
+};
+
+// Sum of squared deviations from the group means MEAN.
+
+template <typename T>
+class accum_sqdev
+{
+public:
+
+  typedef T acc_type;
+
+  accum_sqdev (const T *vals, octave_idx_type stride,
+               const octave_idx_type *idx, const T *mean)
+    : m_vals (vals), m_stride (stride), m_idx (idx), m_mean (mean)
+  { }
+
+  acc_type init () const { return T (); }
+
+  void add (acc_type& a, octave_idx_type k) const
+  {
+    T d = m_vals[k * m_stride] - m_mean[m_idx[k]];
+    a += d * d;
+  }
+
+  void merge (acc_type& a, const acc_type& b) const { a += b; }
+
+private:
+
+  const T *m_vals;
+  octave_idx_type m_stride;
+  const octave_idx_type *m_idx;
+  const T *m_mean;
+};
+
+template <typename T>
+class accum_prod
+{
+public:
+
+  typedef T acc_type;
+
+  accum_prod (const T *vals, octave_idx_type stride)
+    : m_vals (vals), m_stride (stride)
+  { }
+
+  acc_type init () const { return T (1); }
+
+  void add (acc_type& a, octave_idx_type k) const
+  {
+    a *= m_vals[k * m_stride];
+  }
+
+  void merge (acc_type& a, const acc_type& b) const { a *= b; }
+
+private:
+
+  const T *m_vals;
+  octave_idx_type m_stride;
+};
+
+// any and all, on the values converted to logical.  The accumulator is
+// a char because std::vector<bool> elements cannot be referenced.
+
+template <bool ANY>
+class accum_anyall
+{
+public:
+
+  typedef char acc_type;
+
+  accum_anyall (const bool *vals, octave_idx_type stride)
+    : m_vals (vals), m_stride (stride)
+  { }
+
+  acc_type init () const { return ! ANY; }
+
+  void add (acc_type& a, octave_idx_type k) const
+  {
+    if (ANY)
+      a = a || m_vals[k * m_stride];
+    else
+      a = a && m_vals[k * m_stride];
+  }
+
+  void merge (acc_type& a, const acc_type& b) const
+  {
+    a = (ANY ? a || b : a && b);
+  }
+
+private:
+
+  const bool *m_vals;
+  octave_idx_type m_stride;
+};
+
+// Position of the first or last value of each group, -1 if empty.
+
+template <bool FIRST>
+class accum_position
+{
+public:
+
+  typedef octave_idx_type acc_type;
+
+  accum_position (octave_idx_type stride) : m_stride (stride) { }
+
+  acc_type init () const { return -1; }
+
+  void add (acc_type& a, octave_idx_type k) const
+  {
+    if (! FIRST || a < 0)
+      a = k * m_stride;
+  }
+
+  void merge (acc_type& a, const acc_type& b) const
+  {
+    if (b >= 0 && (! FIRST || a < 0))
+      a = b;
+  }
+
+private:
+
+  octave_idx_type m_stride;
+};
+
+// Apply OP to the LEN values with (zero-based) group indices IDX for N
+// groups.  Large inputs with few groups relative to their length are
+// split into one chunk per thread, each with its own accumulators, which
+// are then merged in order.
+
+template <typename OP>
+static std::vector<typename OP::acc_type>
+accum_scatter (const OP& op, const octave_idx_type *idx,
+               octave_idx_type len, octave_idx_type n)
+{
+  typedef typename OP::acc_type acc_type;
+
+  std::vector<acc_type> acc (n, op.init ());
+
+  octave_idx_type nt = thread_pool::size ();
+
+  if (nt < 2 || ! thread_pool::use_threads (len) || n * nt > len)
+    {
+      for (octave_idx_type k = 0; k < len; k++)
+        op.add (acc[idx[k]], k);
+
+      return acc;
+    }
+
+  octave_idx_type chunk = (len + nt - 1) / nt;
+
+  // The first chunk uses ACC directly.
+  std::vector<std::vector<acc_type>> part (nt - 1);
+
+  thread_pool::parallel_for
+    (nt, 1, [&] (std::size_t begin, std::size_t end)
+     {
+       for (std::size_t c = begin; c < end; c++)
+         {
+           if (c > 0)
+             part[c-1].assign (n, op.init ());
+
+           std::vector<acc_type>& a = (c > 0 ? part[c-1] : acc);
+
+           octave_idx_type k0 = c * chunk;
+           octave_idx_type k1 = std::min (k0 + chunk, len);
+
+           for (octave_idx_type k = k0; k < k1; k++)
+             op.add (a[idx[k]], k);
+         }
+     });
+
+  thread_pool::parallel_for
+    (n, 1024, [&] (std::size_t begin, std::size_t end)
+     {
+       for (const auto& p : part)
+         for (std::size_t g = begin; g < end; g++)
+           op.merge (acc[g], p[g]);
+     });
+
+  return acc;
+}
+
+template <typename NDT>
+static octave_value
+do_accumarray_moments (const std::string& op, const NDT& vals,
+                       const Array<octave_idx_type>& idx, octave_idx_type n,
+                       octave_idx_type stride)
+{
+  typedef typename NDT::element_type T;
+
+  octave_idx_type len = idx.numel ();
+  const T *pv = vals.data ();
+  const octave_idx_type *pi = idx.data ();
+
+  auto mom = accum_scatter (accum_moments<T> (pv, stride), pi, len, n);
+
+  NDT mean (dim_vector (n, 1));
+  for (octave_idx_type g = 0; g < n; g++)
+    mean.xelem (g) = mom[g].m_sum / T (mom[g].m_n);
+
+  if (op == "mean")
+    return mean;
+
+  // Two passes for var and std, as var does.
+  auto ss = accum_scatter (accum_sqdev<T> (pv, stride, pi, mean.data ()),
+                           pi, len, n);
+
+  bool sd = (op == "std");
+
+  NDT retval (dim_vector (n, 1));
+  for (octave_idx_type g = 0; g < n; g++)
+    {
+      octave_idx_type m = mom[g].m_n;
+      // A single value gives 0, or NaN if it is not finite.
+      T v = (m > 1 ? ss[g] / T (m - 1) : ss[g]);
+      retval.xelem (g) = (sd ? std::sqrt (v) : v);
+    }
+
+  return retval;
+}
+
+template <typename NDT>
+static NDT
+do_accumarray_prod (const NDT& vals, const Array<octave_idx_type>& idx,
+                    octave_idx_type n, octave_idx_type stride)
+{
+  typedef typename NDT::element_type T;
+
+  auto acc = accum_scatter (accum_prod<T> (vals.data (), stride),
+                            idx.data (), idx.numel (), n);
+
+  NDT retval (dim_vector (n, 1));
+  for (octave_idx_type g = 0; g < n; g++)
+    retval.xelem (g) = acc[g];
+
+  return retval;
+}
+
+template <typename OP>
+static boolNDArray
+do_accumarray_anyall (const boolNDArray& vals,
+                      const Array<octave_idx_type>& idx, octave_idx_type n,
+                      octave_idx_type stride)
+{
+  auto acc = accum_scatter (OP (vals.data (), stride), idx.data (),
+                            idx.numel (), n);
+
+  boolNDArray retval (dim_vector (n, 1));
+  for (octave_idx_type g = 0; g < n; g++)
+    retval.xelem (g) = acc[g];
+
+  return retval;
+}
+
+template <typename OP>
+static octave_value
+do_accumarray_position (const octave_value& vals,
+                        const Array<octave_idx_type>& idx, octave_idx_type n,
+                        octave_idx_type stride)
+{
+  // All groups are empty.  accumarray.m fills them.
+  if (vals.numel () == 0)
+    return vals.resize (dim_vector (n, 1));
+
+  auto acc = accum_scatter (OP (stride), idx.data (), idx.numel (), n);
+
+  // Empty groups take the first value.  accumarray.m replaces them with
+  // the fill value.
+  Array<octave_idx_type> pos (dim_vector (n, 1));
+  for (octave_idx_type g = 0; g < n; g++)
+    pos.xelem (g) = std::max (acc[g], static_cast<octave_idx_type> (0));
+
+  octave_value tmp = vals;
+  octave_value retval = tmp.index_op (ovl (octave_value (idx_vector (pos))));
+
+  return retval.reshape (dim_vector (n, 1));
+}
+
+DEFUN (__accumarray_reduce__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {} __accumarray_reduce__ (@var{idx}, @var{vals}, @var{op}, @var{n})
+Undocumented internal function.
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin < 3 || nargin > 4)
+    print_usage ();
+
+  if (! args(0).isnumeric ())
+    error ("__accumarray_reduce__: first argument must be numeric");
+
+  std::string op = args(2).xstring_value ("__accumarray_reduce__: OP must be a string");
+
+  octave_value vals = args(1);
+
+  octave_value retval;
+
+  try
+    {
+      idx_vector iv = args(0).index_vector ();
+      octave_idx_type n = -1;
+      if (nargin == 4)
+        n = args(3).idx_type_value (true);
+
+      if (n < 0)
+        n = iv.extent (0);
+      else if (iv.extent (n) > n)
+        error ("accumarray: index out of range");
+
+      Array<octave_idx_type> idx = iv.as_array ();
+
+      octave_idx_type stride = 1;
+      if (vals.numel () == 1)
+        stride = 0;
+      else if (vals.numel () != idx.numel ())
+        error ("accumarray: dimensions mismatch");
+
+      if (op == "count")
+        {
+          auto acc = accum_scatter (accum_count (), idx.data (),
+                                    idx.numel (), n);
+
+          NDArray count (dim_vector (n, 1));
+          for (octave_idx_type g = 0; g < n; g++)
+            count.xelem (g) = acc[g];
+
+          retval = count;
+        }
+      else if (op == "mean" || op == "var" || op == "std")
+        {
+          if (vals.is_single_type ())
+            retval = do_accumarray_moments (op, vals.float_array_value (),
+                                            idx, n, stride);
+          else if (vals.isnumeric () || vals.islogical ())
+            retval = do_accumarray_moments (op, vals.array_value (),
+                                            idx, n, stride);
+          else
+            err_wrong_type_arg ("accumarray", vals);
+        }
+      else if (op == "prod")
+        {
+          if (vals.is_single_type ())
+            retval = do_accumarray_prod (vals.float_array_value (), idx, n,
+                                         stride);
+          else if (vals.isnumeric () || vals.islogical ())
+            retval = do_accumarray_prod (vals.array_value (), idx, n,
+                                         stride);
+          else
+            err_wrong_type_arg ("accumarray", vals);
+        }
+      else if (op == "any")
+        retval = do_accumarray_anyall<accum_anyall<true>>
+                   (vals.bool_array_value (), idx, n, stride);
+      else if (op == "all")
+        retval = do_accumarray_anyall<accum_anyall<false>>
+                   (vals.bool_array_value (), idx, n, stride);
+      else if (op == "first")
+        retval = do_accumarray_position<accum_position<true>>
+                   (vals, idx, n, stride);
+      else if (op == "last")
+        retval = do_accumarray_position<accum_position<false>>
+                   (vals, idx, n, stride);
+      else
+        error ("__accumarray_reduce__: unknown operation '%s'", op.c_str ());
+    }
+  catch (const index_exception& ie)
+    {
+      error ("__accumarray_reduce__: invalid index %s", ie.what ());
+    }
+
+  return retval;
+}
+
+/*
+%!test
+%! idx = [1; 3; 1; 3; 3; 5];
+%! vals = [2; 4; 6; 1; 7; 3];
+%! assert (__accumarray_reduce__ (idx, vals, "count"), [2; 0; 3; 0; 1]);
+%! assert (__accumarray_reduce__ (idx, vals, "mean", 5), [4; NaN; 4; NaN; 3]);
+%! assert (__accumarray_reduce__ (idx, vals, "prod"), [12; 1; 28; 1; 3]);
+%! assert (__accumarray_reduce__ (idx, vals, "var")([1 3 5]), [8; 9; 0]);
+%! assert (__accumarray_reduce__ (idx, vals, "std")([1 3 5]), [sqrt(8); 3; 0]);
+%! assert (__accumarray_reduce__ (idx, vals, "first")([1 3 5]), [2; 4; 3]);
+%! assert (__accumarray_reduce__ (idx, vals, "last")([1 3 5]), [6; 7; 3]);
+%! assert (__accumarray_reduce__ (idx, vals - 4, "any"),
+%!         logical ([1; 0; 1; 0; 1]));
+%! assert (__accumarray_reduce__ (idx, vals - 4, "all")([1 3 5]),
+%!         logical ([1; 0; 1]));
+
+%!test
+%! assert (__accumarray_reduce__ ([2 2 1], single (3), "prod"),
+%!         single ([3; 9]));
+%! assert (__accumarray_reduce__ ([2 2 1], {"a", "b", "c"}, "last"),
+%!         {"c"; "b"});
+%! assert (__accumarray_reduce__ ([1 1], [1 NaN], "var"), NaN);
+%! assert (__accumarray_reduce__ (zeros (0, 1), [], "first", 3), zeros (3, 1));
+%! assert (__accumarray_reduce__ (zeros (0, 1), {}, "last", 2), cell (2, 1));
+
+%!error <unknown operation> __accumarray_reduce__ (1, 1, "foo")
+%!error <dimensions mismatch> __accumarray_reduce__ ([1 2], [1 2 3], "prod")
+*/
+
 template <typename NDT>
 static NDT
 do_accumdim_sum (const idx_vector& idx, const NDT& vals,
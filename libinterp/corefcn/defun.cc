@@ -29,6 +29,9 @@
 
 #include <string>
 
+#include "oct-thread-pool.h"
+#include "quit.h"
+
 #include "defun.h"
 #include "dynamic-ld.h"
 #include "error.h"
@@ -53,6 +56,12 @@ OCTAVE_BEGIN_NAMESPACE(octave)
 void
 print_usage ()
 {
+  // The usage message is printed by an m-file, which can not be
+  // executed in the threads of a parallel loop.
+  if (thread_pool::in_parallel_loop ())
+    throw execution_exception ("error", "Octave:invalid-fun-call",
+                               "invalid call in a parallel loop");
+
   tree_evaluator& tw = __get_evaluator__ ();
 
   const octave_function *cur = tw.current_function ();
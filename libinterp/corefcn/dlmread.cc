@@ -30,15 +30,23 @@
 #  include "config.h"
 #endif
 
+#include <cerrno>
 #include <clocale>
 #include <cmath>
 #include <cctype>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <limits>
+#include <string_view>
+#include <tuple>
+#include <vector>
 
 #include "file-ops.h"
 #include "lo-ieee.h"
 #include "lo-sysdep.h"
+#include "oct-mmap.h"
+#include "oct-thread-pool.h"
 
 #include "defun.h"
 #include "interpreter.h"
@@ -169,6 +177,535 @@ parse_range_spec (const octave_value& range_spec,
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
+// Infer the separator from LINE, the first line of data that is not
+// blank.
+
+static void
+infer_separator (std::string_view line, std::string& sep,
+                 bool& auto_sep_is_wspace)
+{
+  // Skip leading whitespace.
+  std::size_t pos1 = line.find_first_not_of (" \t");
+
+  // For Matlab compatibility, blank delimiter should
+  // correspond to whitespace (space and tab).
+  std::size_t n = line.find_first_of (",:; \t", pos1);
+  if (n == std::string::npos)
+    {
+      sep = " \t";
+      auto_sep_is_wspace = true;
+    }
+  else
+    {
+      char ch = line[n];
+
+      switch (ch)
+        {
+        case ' ':
+        case '\t':
+          sep = " \t";
+          auto_sep_is_wspace = true;
+          break;
+
+        default:
+          sep = ch;
+          break;
+        }
+    }
+}
+
+// Call FCN (STR) for each field STR of LINE and return the number of
+// fields.
+
+template <typename FCN>
+static octave_idx_type
+for_each_field (std::string_view line, std::string_view sep,
+                bool auto_sep_is_wspace, FCN&& fcn)
+{
+  octave_idx_type nfields = 0;
+
+  std::size_t pos1, pos2;
+  if (auto_sep_is_wspace)
+    pos1 = line.find_first_not_of (" \t");  // Skip leading whitespace.
+  else
+    pos1 = 0;
+
+  do
+    {
+      pos2 = line.find_first_of (sep, pos1);
+      std::string_view str = line.substr (pos1, pos2 - pos1);
+
+      if (auto_sep_is_wspace && pos2 != std::string::npos)
+        {
+          // Treat consecutive separators as one.
+          pos2 = line.find_first_not_of (sep, pos2);
+          if (pos2 != std::string::npos)
+            pos2 -= 1;
+          else
+            pos2 = line.length () - 1;
+        }
+
+      // Separator followed by EOL doesn't generate extra column
+      if (pos2 == std::string::npos && str.empty ())
+        break;
+
+      fcn (str);
+      nfields++;
+
+      pos1 = pos2 + 1;
+    }
+  while (pos2 != std::string::npos);
+
+  return nfields;
+}
+
+static inline bool
+is_blank (char ch)
+{
+  return ch == ' ' || ch == '\t';
+}
+
+static inline bool
+is_digit (char ch)
+{
+  return ch >= '0' && ch <= '9';
+}
+
+// Read a field that is a plain real number such as "-1.5e3", possibly
+// surrounded by blanks, without the overhead of a stream.  Returns
+// false for anything else, including values that overflow or
+// underflow, which are left to read_value.  strtod gives the same
+// value as reading from a stream because the "C" locale is set while
+// reading.
+
+static bool
+read_simple_real (std::string_view str, double& val)
+{
+  std::size_t n = str.size ();
+  std::size_t k = 0;
+
+  while (k < n && is_blank (str[k]))
+    k++;
+
+  std::size_t start = k;
+
+  if (k < n && (str[k] == '+' || str[k] == '-'))
+    k++;
+
+  std::size_t ndigits = 0;
+  while (k < n && is_digit (str[k]))
+    {
+      k++;
+      ndigits++;
+    }
+
+  if (k < n && str[k] == '.')
+    {
+      k++;
+      while (k < n && is_digit (str[k]))
+        {
+          k++;
+          ndigits++;
+        }
+    }
+
+  if (ndigits == 0)
+    return false;
+
+  if (k < n && (str[k] == 'e' || str[k] == 'E'))
+    {
+      k++;
+      if (k < n && (str[k] == '+' || str[k] == '-'))
+        k++;
+
+      std::size_t nexp = 0;
+      while (k < n && is_digit (str[k]))
+        {
+          k++;
+          nexp++;
+        }
+
+      if (nexp == 0)
+        return false;
+    }
+
+  std::size_t len = k - start;
+
+  while (k < n && is_blank (str[k]))
+    k++;
+
+  if (k != n)
+    return false;
+
+  // strtod needs a null-terminated string.
+  char buf[64];
+  if (len >= sizeof (buf))
+    return false;
+
+  std::memcpy (buf, str.data () + start, len);
+  buf[len] = '\0';
+
+  char *end;
+  errno = 0;
+  val = std::strtod (buf, &end);
+
+  return errno != ERANGE && end == buf + len;
+}
+
+enum field_kind
+{
+  field_empty,
+  field_real,
+  field_complex
+};
+
+// Read the value of field STR into VAL.  Fields that can not be read
+// are empty and are replaced by the empty value.
+
+static field_kind
+read_field (std::istringstream& tmp_stream, std::string_view str,
+            Complex& val)
+{
+  double x;
+
+  if (read_simple_real (str, x))
+    {
+      val = x;
+      return field_real;
+    }
+
+  tmp_stream.str (std::string (str));
+  tmp_stream.clear ();
+
+  x = read_value<double> (tmp_stream);
+
+  // read_value<double>() parsing failed
+  if (! tmp_stream)
+    return field_empty;
+
+  if (tmp_stream.eof ())
+    {
+      val = x;
+      return field_real;
+    }
+
+  int next_char = tmp_stream.peek ();
+  if (next_char == 'i' || next_char == 'j'
+      || next_char == 'I' || next_char == 'J')
+    {
+      // Process pure imaginary numbers.
+      tmp_stream.get ();
+      next_char = tmp_stream.peek ();
+      if (next_char == std::istringstream::traits_type::eof ())
+        {
+          val = Complex (0, x);
+          return field_complex;
+        }
+
+      // Parsing failed, <number>i|j<extra text>
+      return field_empty;
+    }
+  else if (std::isalpha (next_char) && ! std::isfinite (x))
+    {
+      // Parsing failed, <Inf|NA|NaN><extra text>
+      return field_empty;
+    }
+
+  double y = read_value<double> (tmp_stream);
+
+  if (y != 0.0)
+    {
+      val = Complex (x, y);
+      return field_complex;
+    }
+
+  val = x;
+  return field_real;
+}
+
+// The values read from a range of lines of a file.
+
+struct dlm_chunk
+{
+  // Number of fields of each line.
+  std::vector<octave_idx_type> m_nfields;
+
+  // Real parts of the fields of all lines, row by row.
+  std::vector<double> m_values;
+
+  // Line within the chunk, column, and value of complex fields.
+  std::vector<std::tuple<octave_idx_type, octave_idx_type, Complex>>
+    m_complex;
+};
+
+// Return the end of the line that starts at P and the start of the
+// next line in NEXT.
+
+static const char *
+line_end (const char *p, const char *end, const char *& next)
+{
+  const char *eol
+    = static_cast<const char *> (std::memchr (p, '\n', end - p));
+
+  if (eol)
+    {
+      next = eol + 1;
+      return eol;
+    }
+
+  next = end;
+  return end;
+}
+
+static std::string_view
+make_line (const char *p, const char *eol)
+{
+  std::string_view line (p, eol - p);
+
+  // getline does not remove carriage returns from mapped files.
+#if defined (OCTAVE_USE_WINDOWS_API)
+  if (! line.empty () && line.back () == '\r')
+    line.remove_suffix (1);
+#endif
+
+  return line;
+}
+
+static void
+read_chunk (const char *p, const char *end, const std::string& sep,
+            bool auto_sep_is_wspace, bool skip_blank, double empty_value,
+            dlm_chunk& chunk)
+{
+  std::istringstream tmp_stream;
+
+  octave_idx_type i = 0;
+
+  while (p < end)
+    {
+      const char *next;
+      std::string_view line = make_line (p, line_end (p, end, next));
+      p = next;
+
+      // Skip blank lines for compatibility.
+      if (skip_blank && line.find_first_not_of (" \t") == std::string::npos)
+        continue;
+
+      octave_idx_type j = 0;
+
+      octave_idx_type nfields
+        = for_each_field (line, sep, auto_sep_is_wspace,
+                          [&] (std::string_view str)
+      {
+        Complex val;
+
+        switch (read_field (tmp_stream, str, val))
+          {
+          case field_empty:
+            chunk.m_values.push_back (empty_value);
+            break;
+
+          case field_real:
+            chunk.m_values.push_back (val.real ());
+            break;
+
+          case field_complex:
+            chunk.m_values.push_back (val.real ());
+            chunk.m_complex.emplace_back (i, j, val);
+            break;
+          }
+
+        j++;
+      });
+
+      chunk.m_nfields.push_back (nfields);
+
+      i++;
+    }
+}
+
+// Copy columns C0 to C0+NCOLS-1 of the lines of CHUNKS to the
+// column-major array DATA with NROWS rows.
+
+template <typename T>
+static void
+copy_chunks (T *data, octave_idx_type nrows, octave_idx_type c0,
+             octave_idx_type ncols, const std::vector<dlm_chunk>& chunks,
+             const std::vector<octave_idx_type>& first_row,
+             double empty_value)
+{
+  thread_pool::parallel_for
+    (chunks.size (), 1, [&] (std::size_t begin, std::size_t end)
+  {
+    for (std::size_t k = begin; k < end; k++)
+      {
+        const dlm_chunk& chunk = chunks[k];
+
+        std::size_t pos = 0;
+        octave_idx_type nlines = chunk.m_nfields.size ();
+
+        for (octave_idx_type i = 0; i < nlines; i++)
+          {
+            T *row = data + first_row[k] + i;
+            octave_idx_type nfields = chunk.m_nfields[i];
+
+            for (octave_idx_type j = 0; j < ncols; j++)
+              row[j * nrows] = (c0 + j < nfields
+                                ? T (chunk.m_values[pos + c0 + j])
+                                : T (empty_value));
+
+            pos += nfields;
+          }
+      }
+  });
+}
+
+// Read the data of file FNAME in parallel.  The file is mapped into
+// memory, split into chunks of whole lines, and the chunks are read
+// by the threads of the thread pool.  Only used if all lines after
+// the first R0 are read.  Returns false if the file can not be read
+// this way or is too small to benefit, and the caller then reads it
+// serially.  The result is the same as that of the serial code.
+
+static bool
+dlmread_parallel (const std::string& fname, std::string sep,
+                  octave_idx_type r0, octave_idx_type c0,
+                  octave_idx_type c1, double empty_value,
+                  octave_value& retval)
+{
+  if (! sys::mapped_file::is_supported ())
+    return false;
+
+  std::string msg;
+  std::shared_ptr<sys::mapped_file> file
+    = sys::mapped_file::open (fname, false, msg);
+
+  if (! file || ! thread_pool::use_threads (file->size ()))
+    return false;
+
+  const char *p = file->data ();
+  const char *end = p + file->size ();
+
+  // Strip Byte Order Mark (BOM)
+  if (r0 == 0 && end - p >= 3 && std::memcmp (p, "\xEF\xBB\xBF", 3) == 0)
+    p += 3;
+
+  retval = Matrix (0, 0);
+
+  // Skip the r0 leading lines
+  for (octave_idx_type k = 0; k < r0; k++)
+    {
+      if (p == end)
+        return true;  // Not enough lines in file to satisfy RANGE
+
+      line_end (p, end, p);
+    }
+
+  bool sep_is_wspace = (sep.find_first_of (" \t") != std::string::npos);
+  bool auto_sep_is_wspace = false;
+
+  // Infer separator from file if delimiter is blank.
+  if (sep.empty ())
+    {
+      const char *q = p;
+
+      while (sep.empty ())
+        {
+          if (q == end)
+            return true;
+
+          const char *next;
+          std::string_view line = make_line (q, line_end (q, end, next));
+          q = next;
+
+          if (line.find_first_not_of (" \t") != std::string::npos)
+            infer_separator (line, sep, auto_sep_is_wspace);
+        }
+    }
+
+  bool skip_blank = (! sep_is_wspace || auto_sep_is_wspace);
+
+  // Split the data into chunks of whole lines.
+  std::size_t nchunks = 4 * thread_pool::size ();
+  std::vector<const char *> bounds (nchunks + 1);
+
+  bounds[0] = p;
+  bounds[nchunks] = end;
+  for (std::size_t k = 1; k < nchunks; k++)
+    {
+      const char *q = std::max (p + (end - p) / nchunks * k, bounds[k-1]);
+      line_end (q, end, bounds[k]);
+    }
+
+  std::vector<dlm_chunk> chunks (nchunks);
+
+  thread_pool::parallel_for
+    (nchunks, 1, [&] (std::size_t begin, std::size_t end_chunk)
+  {
+    for (std::size_t k = begin; k < end_chunk; k++)
+      read_chunk (bounds[k], bounds[k+1], sep, auto_sep_is_wspace,
+                  skip_blank, empty_value, chunks[k]);
+  });
+
+  std::vector<octave_idx_type> first_row (nchunks + 1, 0);
+  octave_idx_type c = 1;
+  bool iscmplx = false;
+
+  for (std::size_t k = 0; k < nchunks; k++)
+    {
+      const dlm_chunk& chunk = chunks[k];
+
+      first_row[k+1] = first_row[k] + chunk.m_nfields.size ();
+
+      for (octave_idx_type nfields : chunk.m_nfields)
+        c = std::max (c, nfields);
+
+      iscmplx = iscmplx || ! chunk.m_complex.empty ();
+    }
+
+  octave_idx_type nrows = first_row[nchunks];
+
+  // Clip selection indices to actual size of data
+  if (c1 >= c)
+    c1 = c - 1;
+
+  if (nrows == 0 || c0 > c1)
+    {
+      if (iscmplx)
+        retval = ComplexMatrix (0, 0);
+
+      return true;
+    }
+
+  octave_idx_type ncols = c1 - c0 + 1;
+
+  if (iscmplx)
+    {
+      ComplexMatrix cdata (nrows, ncols);
+
+      Complex *data = cdata.fortran_vec ();
+
+      copy_chunks (data, nrows, c0, ncols, chunks, first_row, empty_value);
+
+      for (std::size_t k = 0; k < nchunks; k++)
+        for (const auto& [i, j, val] : chunks[k].m_complex)
+          if (j >= c0 && j <= c1)
+            data[first_row[k] + i + (j - c0) * nrows] = val;
+
+      retval = cdata;
+    }
+  else
+    {
+      Matrix rdata (nrows, ncols);
+
+      copy_chunks (rdata.fortran_vec (), nrows, c0, ncols, chunks, first_row,
+                   empty_value);
+
+      retval = rdata;
+    }
+
+  return true;
+}
+
 DEFMETHOD (dlmread, interp, args, ,
            doc: /* -*- texinfo -*-
 @deftypefn  {} {@var{data} =} dlmread (@var{file})
@@ -201,6 +738,9 @@ latter case, the file is read until end of file is reached.
 The @qcode{"emptyvalue"} option may be used to specify the value used to
 fill empty fields.  The default is zero.  Note that any non-numeric values,
 such as text, are also replaced by the @qcode{"emptyvalue"}.
+
+Large files that are given by name are read in parallel with the threads of
+the thread pool, unless the range ends before the last row.
 @seealso{csvread, textscan, dlmwrite}
 @end deftypefn */)
 {
@@ -221,13 +761,14 @@ such as text, are also replaced by the @qcode{"emptyvalue"}.
 
   std::istream *input = nullptr;
   std::ifstream input_file;
+  std::string tname;
 
   if (args(0).is_string ())
     {
       // Filename.
       std::string fname (args(0).string_value ());
 
-      std::string tname = sys::file_ops::tilde_expand (fname);
+      tname = sys::file_ops::tilde_expand (fname);
 
       tname = find_data_file_in_load_path ("dlmread", tname);
 
@@ -343,6 +884,15 @@ such as text, are also replaced by the @qcode{"emptyvalue"}.
   unwind_action act
   ([old_locale] () { std::setlocale (LC_ALL, old_locale.c_str ()); });
 
+  // Read large files in parallel if all of their lines are needed.
+  if (! tname.empty () && r1 == idx_max)
+    {
+      octave_value retval;
+
+      if (dlmread_parallel (tname, sep, r0, c0, c1, empty_value, retval))
+        return ovl (retval);
+    }
+
   std::string line;
 
   // Skip the r0 leading lines
@@ -367,36 +917,7 @@ such as text, are also replaced by the @qcode{"emptyvalue"}.
 
       // Infer separator from file if delimiter is blank.
       if (sep.empty ())
-        {
-          // Skip leading whitespace.
-          std::size_t pos1 = line.find_first_not_of (" \t");
-
-          // For Matlab compatibility, blank delimiter should
-          // correspond to whitespace (space and tab).
-          std::size_t n = line.find_first_of (",:; \t", pos1);
-          if (n == std::string::npos)
-            {
-              sep = " \t";
-              auto_sep_is_wspace = true;
-            }
-          else
-            {
-              char ch = line.at (n);
-
-              switch (line.at (n))
-                {
-                case ' ':
-                case '\t':
-                  sep = " \t";
-                  auto_sep_is_wspace = true;
-                  break;
-
-                default:
-                  sep = ch;
-                  break;
-                }
-            }
-        }
+        infer_separator (line, sep, auto_sep_is_wspace);
 
       // Estimate the number of columns from first line of data.
       if (cmax == 0)
@@ -438,115 +959,52 @@ such as text, are also replaced by the @qcode{"emptyvalue"}.
       r = (r > i + 1 ? r : i + 1);
       j = 0;
 
-      std::size_t pos1, pos2;
-      if (auto_sep_is_wspace)
-        pos1 = line.find_first_not_of (" \t");  // Skip leading whitespace.
-      else
-        pos1 = 0;
-
-      do
-        {
-          octave_quit ();
-
-          pos2 = line.find_first_of (sep, pos1);
-          std::string str = line.substr (pos1, pos2 - pos1);
-
-          if (auto_sep_is_wspace && pos2 != std::string::npos)
-            {
-              // Treat consecutive separators as one.
-              pos2 = line.find_first_not_of (sep, pos2);
-              if (pos2 != std::string::npos)
-                pos2 -= 1;
-              else
-                pos2 = line.length () - 1;
-            }
-
-          // Separator followed by EOL doesn't generate extra column
-          if (pos2 == std::string::npos && str.empty ())
+      for_each_field (line, sep, auto_sep_is_wspace,
+                      [&] (std::string_view str)
+      {
+        octave_quit ();
+
+        c = (c > j + 1 ? c : j + 1);
+        if (r > rmax || c > cmax)
+          {
+            // Use resize_and_fill for the case of unequal length rows.
+            // Keep rmax a power of 2.
+            rmax = std::max (2*(r-1), rmax);
+            cmax = std::max (c, cmax);
+            if (iscmplx)
+              cdata.resize (rmax, cmax, empty_value);
+            else
+              rdata.resize (rmax, cmax, empty_value);
+          }
+
+        Complex val;
+
+        switch (read_field (tmp_stream, str, val))
+          {
+          case field_empty:
+            // Leave data initialized to empty_value
             break;
 
-          c = (c > j + 1 ? c : j + 1);
-          if (r > rmax || c > cmax)
-            {
-              // Use resize_and_fill for the case of unequal length rows.
-              // Keep rmax a power of 2.
-              rmax = std::max (2*(r-1), rmax);
-              cmax = std::max (c, cmax);
-              if (iscmplx)
-                cdata.resize (rmax, cmax, empty_value);
-              else
-                rdata.resize (rmax, cmax, empty_value);
-            }
+          case field_real:
+            if (iscmplx)
+              cdata(i, j) = val.real ();
+            else
+              rdata(i, j) = val.real ();
+            break;
 
-          tmp_stream.str (str);
-          tmp_stream.clear ();
+          case field_complex:
+            if (! iscmplx)
+              {
+                iscmplx = true;
+                cdata = ComplexMatrix (rdata);
+              }
 
-          double x = read_value<double> (tmp_stream);
-          if (tmp_stream)
-            {
-              if (tmp_stream.eof ())
-                {
-                  if (iscmplx)
-                    cdata(i, j++) = x;
-                  else
-                    rdata(i, j++) = x;
-                }
-              else
-                {
-                  int next_char = tmp_stream.peek ();
-                  if (next_char == 'i' || next_char == 'j'
-                      || next_char == 'I' || next_char == 'J')
-                    {
-                      // Process pure imaginary numbers.
-                      tmp_stream.get ();
-                      next_char = tmp_stream.peek ();
-                      if (next_char == std::istringstream::traits_type::eof ())
-                        {
-                          if (! iscmplx)
-                            {
-                              iscmplx = true;
-                              cdata = ComplexMatrix (rdata);
-                            }
-
-                          cdata(i, j++) = Complex (0, x);
-                        }
-                      else
-                        {
-                          // Parsing failed, <number>i|j<extra text>
-                          j++;  // Leave data initialized to empty_value
-                        }
-                    }
-                  else if (std::isalpha (next_char) && ! std::isfinite (x))
-                    {
-                      // Parsing failed, <Inf|NA|NaN><extra text>
-                      j++;  // Leave data initialized to empty_value
-                    }
-                  else
-                    {
-                      double y = read_value<double> (tmp_stream);
-
-                      if (! iscmplx && y != 0.0)
-                        {
-                          iscmplx = true;
-                          cdata = ComplexMatrix (rdata);
-                        }
-
-                      if (iscmplx)
-                        cdata(i, j++) = Complex (x, y);
-                      else
-                        rdata(i, j++) = x;
-                    }
-                }
-            }
-          else
-            {
-              // read_value<double>() parsing failed
-              j++;  // Leave data initialized to empty_value
-            }
+            cdata(i, j) = val;
+            break;
+          }
 
-          pos1 = pos2 + 1;
-        }
-      while (pos2 != std::string::npos);
+        j++;
+      });
 
       if (i == r1)
         break;  // Stop early if the desired range has been read.
@@ -763,6 +1221,43 @@ such as text, are also replaced by the @qcode{"emptyvalue"}.
 %!   unlink (file);
 %! end_unwind_protect
 
+## Large files are read in parallel with the same result
+%!test
+%! file = tempname ();
+%! old_threads = __thread_pool__ ("threads", 4);
+%! old_threshold = __thread_pool__ ("threshold", 1);
+%! unwind_protect
+%!   fid = fopen (file, "wt");
+%!   fwrite (fid, char ([0xEF, 0xBB, 0xBF]));  # UTF-8 BOM
+%!   for k = 1:50
+%!     fprintf (fid, "%d,%.17g,-%de-3\n", k, k / 7, k);
+%!     if (mod (k, 10) == 0)
+%!       fprintf (fid, "\n%d,text,,NaN,2+%di\n", k, k);
+%!     endif
+%!   endfor
+%!   fclose (fid);
+%!
+%!   a = dlmread (file);
+%!   b = dlmread (file, ",", 3, 1);
+%!   c = dlmread (file, "", [0, 1, Inf, 2]);
+%!   d = dlmread (file, "emptyvalue", -1);
+%!   __thread_pool__ ("threads", 1);
+%!   assert (a, dlmread (file));
+%!   assert (b, dlmread (file, ",", 3, 1));
+%!   assert (c, dlmread (file, "", [0, 1, Inf, 2]));
+%!   assert (d, dlmread (file, "emptyvalue", -1));
+%!   assert (size (a), [55, 5]);
+%!   assert (iscomplex (a));
+%!   assert (! iscomplex (c));
+%!   assert (a(1:2,1:3), [1, 1/7, -1e-3; 2, 2/7, -2e-3]);
+%!   assert (a(11,:), [10, 0, 0, NaN, 2+10i]);
+%!   assert (d(11,:), [10, -1, -1, NaN, 2+10i]);
+%! unwind_protect_cleanup
+%!   __thread_pool__ ("threads", old_threads);
+%!   __thread_pool__ ("threshold", old_threshold);
+%!   unlink (file);
+%! end_unwind_protect
+
 */
 
 OCTAVE_END_NAMESPACE(octave)
@@ -37,6 +37,7 @@
 #include <sstream>
 #include <string>
 
+#include "oct-thread-pool.h"
 #include "quit.h"
 
 #include "bp-table.h"
@@ -584,6 +585,13 @@ void error_system::vwarning (const char *id, const char *fmt, va_list args)
 {
   int warn_opt = warning_enabled (id);
 
+  // Warnings can not be displayed from the threads of a parallel loop.
+  // Code that calls interpreter functions in parallel (for example,
+  // cellfun with "Parallel") repeats the work serially to issue them.
+  if (warn_opt != 0 && thread_pool::in_parallel_loop ())
+    throw execution_exception ("warning", id ? id : "",
+                               "warning issued in a parallel loop");
+
   if (warn_opt == 2)
     {
       // Handle this warning as an error.
@@ -1475,6 +1475,8 @@ This specifies the number of bytes to use for the internal buffer.
 A modest speed improvement may be obtained by setting this to a large value
 when reading a large file, especially if the input contains long strings.
 The default is 4096, or a value dependent on @var{n} if that is specified.
+When @var{n} is not specified, the default is the size of the rest of the
+file, between 4096 bytes and 1MiB.
 
 @item @qcode{"CollectOutput"}
 A value of 1 or true instructs @code{textscan} to concatenate consecutive
@@ -2039,6 +2041,26 @@ as the name of the function when reporting errors.
 %!               "delimiter", ",");
 %! assert (cell2mat (C), [3+0i, 2-4i, NaN+0i; 0-i,  1+0i, 23.4+2.2i; 1 1 1+1i]);
 
+## Complex values and empty fields across refills of the buffer
+%!test
+%! f = tempname ();
+%! unwind_protect
+%!   fid = fopen (f, "w");
+%!   fprintf (fid, "%d.5-2.25i,NN,-i\n", 1:3000);
+%!   fclose (fid);
+%!   for bufsize = {{"BufSize", 1000}, {}}
+%!     fid = fopen (f);
+%!     C = textscan (fid, "%f %f %f", "Delimiter", ",",
+%!                   "TreatAsEmpty", "NN", bufsize{1}{:});
+%!     fclose (fid);
+%!     assert (C{1}, (1:3000)' + 0.5 - 2.25i);
+%!     assert (isnan (C{2}), true (3000, 1));
+%!     assert (C{3}, repmat (-1i, 3000, 1));
+%!   endfor
+%! unwind_protect_cleanup
+%!   unlink (f);
+%! end_unwind_protect
+
 %!test
 %! ## TreatAsEmpty
 %! C = textscan ("1,2,3,NN,5,6\n", "%d%d%d%f", "delimiter", ",",
@@ -2425,6 +2447,89 @@ as the name of the function when reporting errors.
 %!error <no valid format conversion specifiers> textscan ("1.0", "foo")
 */
 
+DEFUN (__textscan_stats__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{stats} =} __textscan_stats__ ()
+@deftypefnx {} {@var{stats} =} __textscan_stats__ ("reset")
+Return the counters of the input buffers of @code{textscan}.
+
+The result is a struct with the fields @code{bytes_read}, the number of bytes
+read from files, @code{refills}, the number of reads that refill the buffer,
+@code{bytes_moved}, the number of bytes moved to the start of the buffer by
+refills, and @code{max_buffer_size}, the largest buffer size used.  The
+counters accumulate over all calls.  With the argument @qcode{"reset"}, they
+are set to zero after they are returned.
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin > 1)
+    print_usage ();
+
+  bool reset = false;
+
+  if (nargin == 1)
+    {
+      std::string opt
+        = args(0).xstring_value ("__textscan_stats__: argument must be a string");
+
+      if (opt != "reset")
+        error (R"(__textscan_stats__: argument must be "reset")");
+
+      reset = true;
+    }
+
+  textscan_buffer_stats& stats = textscan_stats ();
+
+  octave_scalar_map retval;
+
+  retval.assign ("bytes_read", static_cast<double> (stats.bytes_read));
+  retval.assign ("refills", static_cast<double> (stats.refills));
+  retval.assign ("bytes_moved", static_cast<double> (stats.bytes_moved));
+  retval.assign ("max_buffer_size",
+                 static_cast<double> (stats.max_buffer_size));
+
+  if (reset)
+    stats = textscan_buffer_stats ();
+
+  return ovl (retval);
+}
+
+/*
+%!test
+%! f = tempname ();
+%! unwind_protect
+%!   fid = fopen (f, "w");
+%!   fprintf (fid, "%d,%d\n", [1:20000; 2:20001]);
+%!   fclose (fid);
+%!   nbytes = stat (f).size;
+%!
+%!   fid = fopen (f);
+%!   __textscan_stats__ ("reset");
+%!   c = textscan (fid, "%d %d", "Delimiter", ",");
+%!   stats = __textscan_stats__ ("reset");
+%!   fclose (fid);
+%!   assert (c{1}, int32 (1:20000)');
+%!   assert (c{2}, int32 (2:20001)');
+%!   assert (stats.bytes_read, nbytes);
+%!   ## The buffer holds the whole file when reading to its end.
+%!   assert (stats.max_buffer_size, nbytes);
+%!   assert (stats.refills < nbytes / 4096);
+%!
+%!   fid = fopen (f);
+%!   c = textscan (fid, "%d %d", "Delimiter", ",", "BufSize", 4096);
+%!   stats = __textscan_stats__ ();
+%!   fclose (fid);
+%!   assert (c{2}, int32 (2:20001)');
+%!   assert (stats.max_buffer_size, 4096);
+%!   assert (stats.refills >= nbytes / 4096);
+%! unwind_protect_cleanup
+%!   unlink (f);
+%! end_unwind_protect
+
+%!error <argument must be "reset"> __textscan_stats__ ("clear")
+*/
+
 static octave_value
 do_fread (stream& os, const octave_value& size_arg,
           const octave_value& prec_arg, const octave_value& skip_arg,
@@ -0,0 +1,489 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "dNDArray.h"
+#include "fNDArray.h"
+#include "CNDArray.h"
+#include "fCNDArray.h"
+#include "file-ops.h"
+#include "int8NDArray.h"
+#include "int16NDArray.h"
+#include "int32NDArray.h"
+#include "int64NDArray.h"
+#include "oct-locbuf.h"
+#include "uint8NDArray.h"
+#include "uint16NDArray.h"
+#include "uint32NDArray.h"
+#include "uint64NDArray.h"
+
+#include "defun.h"
+#include "error.h"
+#include "errwarn.h"
+#include "oct-hdf5.h"
+#include "ovl.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+#if defined (HAVE_HDF5)
+
+// Close an HDF5 object when it goes out of scope.
+
+class hdf5_handle
+{
+public:
+
+  hdf5_handle (hid_t id, herr_t (*close_fcn) (hid_t))
+    : m_id (id), m_close_fcn (close_fcn)
+  { }
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (hdf5_handle)
+
+  ~hdf5_handle ()
+  {
+    if (m_id >= 0)
+      m_close_fcn (m_id);
+  }
+
+  hid_t id () const { return m_id; }
+
+private:
+
+  hid_t m_id;
+
+  herr_t (*m_close_fcn) (hid_t);
+};
+
+// Return true if the object PATH exists in LOC_ID and set IS_GROUP.
+
+static bool
+hdf5_object_exists (hid_t loc_id, const std::string& path, bool& is_group)
+{
+  H5E_auto_t err_fcn;
+  void *err_fcn_data;
+
+  // Do not print HDF5 errors for objects that do not exist.
+
+#if defined (HAVE_HDF5_18)
+  H5Eget_auto (octave_H5E_DEFAULT, &err_fcn, &err_fcn_data);
+  H5Eset_auto (octave_H5E_DEFAULT, nullptr, nullptr);
+#else
+  H5Eget_auto (&err_fcn, &err_fcn_data);
+  H5Eset_auto (nullptr, nullptr);
+#endif
+
+  H5G_stat_t info;
+  bool retval = H5Gget_objinfo (loc_id, path.c_str (), 1, &info) >= 0;
+
+  if (retval)
+    is_group = (info.type == H5G_GROUP);
+
+#if defined (HAVE_HDF5_18)
+  H5Eset_auto (octave_H5E_DEFAULT, err_fcn, err_fcn_data);
+#else
+  H5Eset_auto (err_fcn, err_fcn_data);
+#endif
+
+  return retval;
+}
+
+template <typename NDA>
+static octave_value
+read_dataset (hid_t data_id, hid_t mem_type_id, hid_t mem_space_id,
+              hid_t file_space_id, const dim_vector& dv)
+{
+  NDA retval (dv);
+
+  if (dv.safe_numel () > 0
+      && H5Dread (data_id, mem_type_id, mem_space_id, file_space_id,
+                  octave_H5P_DEFAULT, retval.fortran_vec ()) < 0)
+    error ("h5read: error reading dataset");
+
+  return octave_value (retval);
+}
+
+// Create the type of complex values with parts of type T in memory.
+// Octave saves complex values as compound types with the members
+// "real" and "imag", and HDF5 converts them by member name.
+
+template <typename T>
+static hid_t
+make_complex_mem_type (hid_t part_type_id)
+{
+  hid_t type_id = H5Tcreate (H5T_COMPOUND, 2 * sizeof (T));
+
+  H5Tinsert (type_id, "real", 0, part_type_id);
+  H5Tinsert (type_id, "imag", sizeof (T), part_type_id);
+
+  return type_id;
+}
+
+static bool
+is_complex_type (hid_t type_id)
+{
+  if (H5Tget_class (type_id) != H5T_COMPOUND
+      || H5Tget_nmembers (type_id) != 2)
+    return false;
+
+  return (H5Tget_member_index (type_id, "real") >= 0
+          && H5Tget_member_index (type_id, "imag") >= 0
+          && H5Tget_member_class (type_id, 0) == H5T_FLOAT
+          && H5Tget_member_class (type_id, 1) == H5T_FLOAT);
+}
+
+#endif
+
+DEFUN (h5read, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{data} =} h5read (@var{filename}, @var{dataset})
+@deftypefnx {} {@var{data} =} h5read (@var{filename}, @var{dataset}, @var{start}, @var{count})
+@deftypefnx {} {@var{data} =} h5read (@var{filename}, @var{dataset}, @var{start}, @var{count}, @var{stride})
+Read numeric data from the dataset @var{dataset} of the @sc{hdf5} file
+@var{filename}.
+
+@var{dataset} is the full path of the dataset in the file, such as
+@qcode{"/grid/temperature"}.  Variables saved by Octave with
+@code{save -hdf5} can be given by their name, such as @qcode{"/x"}.
+
+With @var{start} and @var{count}, only part of the dataset is read.  Both
+have one element for each dimension of the data.  @var{start} gives the
+index of the first element to read in each dimension, starting from 1, and
+@var{count} the number of elements to read.  A count of @code{Inf} reads to
+the end of the dimension.  The optional @var{stride} gives the distance
+between the elements that are read in each dimension and defaults to 1.
+Only the selected elements are read from the file, so parts of large
+datasets can be loaded without loading the whole dataset.  This is most
+efficient for datasets stored in chunks, see the @option{-chunk} option of
+@code{save}.
+
+As in other programs that read @sc{hdf5} files in column-major order, the
+dimensions of @var{data} are those of the dataset in reverse order.  Arrays
+saved by Octave therefore keep their dimensions.
+
+Floating point data is returned as double or single, integer data as the
+integer class of the same size, and compound data with the members
+@qcode{"real"} and @qcode{"imag"}, as saved by Octave, as complex values.
+Logical arrays saved by Octave are returned as integers.  Other types of data
+are not supported.
+@seealso{load, save}
+@end deftypefn */)
+{
+#if defined (HAVE_HDF5)
+
+  int nargin = args.length ();
+
+  if (nargin != 2 && nargin != 4 && nargin != 5)
+    print_usage ();
+
+  std::string fname
+    = args(0).xstring_value ("h5read: FILENAME must be a string");
+  std::string path
+    = args(1).xstring_value ("h5read: DATASET must be a string");
+
+  fname = sys::file_ops::tilde_expand (fname);
+
+  std::string name = path;
+
+  hdf5_handle file (H5Fopen (fname.c_str (), H5F_ACC_RDONLY,
+                             octave_H5P_DEFAULT), H5Fclose);
+
+  if (file.id () < 0)
+    error ("h5read: unable to open file '%s'", fname.c_str ());
+
+  bool is_group = false;
+
+  if (! hdf5_object_exists (file.id (), path, is_group))
+    error ("h5read: dataset '%s' not found", path.c_str ());
+
+  // Variables saved by Octave are groups with the dataset "value".
+  if (is_group)
+    {
+      path += "/value";
+
+      if (! hdf5_object_exists (file.id (), path, is_group) || is_group)
+        error ("h5read: '%s' is not a dataset", name.c_str ());
+    }
+
+#if defined (HAVE_HDF5_18)
+  hdf5_handle data (H5Dopen (file.id (), path.c_str (), octave_H5P_DEFAULT),
+                    H5Dclose);
+#else
+  hdf5_handle data (H5Dopen (file.id (), path.c_str ()), H5Dclose);
+#endif
+
+  if (data.id () < 0)
+    error ("h5read: unable to open dataset '%s'", path.c_str ());
+
+  hdf5_handle file_space (H5Dget_space (data.id ()), H5Sclose);
+
+  int rank = H5Sget_simple_extent_ndims (file_space.id ());
+
+  if (rank < 0)
+    error ("h5read: unable to read the dimensions of '%s'", path.c_str ());
+
+  OCTAVE_LOCAL_BUFFER (hsize_t, hdims, std::max (rank, 1));
+  OCTAVE_LOCAL_BUFFER (hsize_t, hstart, std::max (rank, 1));
+  OCTAVE_LOCAL_BUFFER (hsize_t, hcount, std::max (rank, 1));
+  OCTAVE_LOCAL_BUFFER (hsize_t, hstride, std::max (rank, 1));
+
+  H5Sget_simple_extent_dims (file_space.id (), hdims, nullptr);
+
+  for (int i = 0; i < rank; i++)
+    {
+      hstart[i] = 0;
+      hcount[i] = hdims[i];
+      hstride[i] = 1;
+    }
+
+  if (nargin > 2)
+    {
+      NDArray start
+        = args(2).xarray_value ("h5read: START must be a numeric vector");
+      NDArray count
+        = args(3).xarray_value ("h5read: COUNT must be a numeric vector");
+      NDArray stride
+        = (nargin > 4
+           ? args(4).xarray_value ("h5read: STRIDE must be a numeric vector")
+           : NDArray (dim_vector (1, rank), 1.0));
+
+      if (start.numel () != rank || count.numel () != rank
+          || stride.numel () != rank)
+        error ("h5read: START, COUNT, and STRIDE must have %d elements", rank);
+
+      // Octave uses column-major, while HDF5 uses row-major ordering
+      for (int i = 0; i < rank; i++)
+        {
+          int j = rank - i - 1;
+
+          double s = start(i);
+          double c = count(i);
+          double st = stride(i);
+
+          if (s < 1 || s != std::round (s) || s > hdims[j])
+            error ("h5read: START must contain valid indices");
+
+          if (st < 1 || st != std::round (st) || std::isinf (st))
+            error ("h5read: STRIDE must contain positive integers");
+
+          hstart[j] = static_cast<hsize_t> (s - 1);
+          hstride[j] = static_cast<hsize_t> (st);
+
+          hsize_t available
+            = (hdims[j] - hstart[j] + hstride[j] - 1) / hstride[j];
+
+          if (std::isinf (c) && c > 0)
+            hcount[j] = available;
+          else if (c < 0 || c != std::round (c) || c > available)
+            error ("h5read: COUNT exceeds the dimensions of '%s'",
+                   path.c_str ());
+          else
+            hcount[j] = static_cast<hsize_t> (c);
+        }
+    }
+
+  dim_vector dv;
+
+  if (rank == 0)
+    dv = dim_vector (1, 1);
+  else if (rank == 1)
+    dv = dim_vector (hcount[0], 1);
+  else
+    {
+      dv.resize (rank);
+      for (int i = 0; i < rank; i++)
+        dv(i) = hcount[rank-i-1];
+    }
+
+  hid_t mem_space_id = octave_H5S_ALL;
+  hid_t file_space_id = octave_H5S_ALL;
+
+  hdf5_handle mem_space (rank > 0 ? H5Screate_simple (rank, hcount, nullptr)
+                         : -1, H5Sclose);
+
+  if (nargin > 2 && rank > 0)
+    {
+      if (mem_space.id () < 0
+          || H5Sselect_hyperslab (file_space.id (), H5S_SELECT_SET, hstart,
+                                  hstride, hcount, nullptr) < 0)
+        error ("h5read: unable to select data of '%s'", path.c_str ());
+
+      mem_space_id = mem_space.id ();
+      file_space_id = file_space.id ();
+    }
+
+  hdf5_handle type (H5Dget_type (data.id ()), H5Tclose);
+
+  std::size_t size = H5Tget_size (type.id ());
+
+  octave_value retval;
+
+  switch (H5Tget_class (type.id ()))
+    {
+    case H5T_FLOAT:
+      if (size <= 4)
+        retval = read_dataset<FloatNDArray> (data.id (), H5T_NATIVE_FLOAT,
+                                             mem_space_id, file_space_id,
+                                             dv);
+      else
+        retval = read_dataset<NDArray> (data.id (), H5T_NATIVE_DOUBLE,
+                                        mem_space_id, file_space_id, dv);
+      break;
+
+    case H5T_INTEGER:
+      {
+        bool is_signed = (H5Tget_sign (type.id ()) != H5T_SGN_NONE);
+
+#define READ_INT_DATASET(S, U, H5S, H5U)                                \
+        retval = (is_signed                                             \
+                  ? read_dataset<S> (data.id (), H5S, mem_space_id,     \
+                                     file_space_id, dv)                 \
+                  : read_dataset<U> (data.id (), H5U, mem_space_id,     \
+                                     file_space_id, dv))
+
+        switch (size)
+          {
+          case 1:
+            READ_INT_DATASET (int8NDArray, uint8NDArray,
+                              H5T_NATIVE_INT8, H5T_NATIVE_UINT8);
+            break;
+
+          case 2:
+            READ_INT_DATASET (int16NDArray, uint16NDArray,
+                              H5T_NATIVE_INT16, H5T_NATIVE_UINT16);
+            break;
+
+          case 4:
+            READ_INT_DATASET (int32NDArray, uint32NDArray,
+                              H5T_NATIVE_INT32, H5T_NATIVE_UINT32);
+            break;
+
+          case 8:
+            READ_INT_DATASET (int64NDArray, uint64NDArray,
+                              H5T_NATIVE_INT64, H5T_NATIVE_UINT64);
+            break;
+
+          default:
+            error ("h5read: unsupported integer size in '%s'", path.c_str ());
+          }
+
+#undef READ_INT_DATASET
+      }
+      break;
+
+    case H5T_COMPOUND:
+      if (! is_complex_type (type.id ()))
+        error ("h5read: unsupported data type in '%s'", path.c_str ());
+
+      {
+        hdf5_handle part_type (H5Tget_member_type (type.id (), 0), H5Tclose);
+
+        if (H5Tget_size (part_type.id ()) <= 4)
+          {
+            hdf5_handle mem_type
+              (make_complex_mem_type<float> (H5T_NATIVE_FLOAT), H5Tclose);
+
+            retval = read_dataset<FloatComplexNDArray> (data.id (),
+                                                        mem_type.id (),
+                                                        mem_space_id,
+                                                        file_space_id, dv);
+          }
+        else
+          {
+            hdf5_handle mem_type
+              (make_complex_mem_type<double> (H5T_NATIVE_DOUBLE), H5Tclose);
+
+            retval = read_dataset<ComplexNDArray> (data.id (),
+                                                   mem_type.id (),
+                                                   mem_space_id,
+                                                   file_space_id, dv);
+          }
+      }
+      break;
+
+    default:
+      error ("h5read: unsupported data type in '%s'", path.c_str ());
+    }
+
+  return ovl (retval);
+
+#else
+
+  octave_unused_parameter (args);
+
+  err_disabled_feature ("h5read", "HDF5");
+
+#endif
+}
+
+/*
+%!testif HAVE_HDF5
+%! f = [tempname(), ".h5"];
+%! unwind_protect
+%!   x = reshape (1:60, 5, 12);
+%!   y = single (reshape (1:24, 2, 3, 4)) + 2i;
+%!   z = int16 (-5:5);
+%!   save ("-hdf5", "-deflate", "-shuffle", "-chunk=2x3", f, "x", "y", "z");
+%!   assert (h5read (f, "/x"), x);
+%!   assert (h5read (f, "/x/value"), x);
+%!   assert (h5read (f, "/x", [2, 3], [3, 4]), x(2:4, 3:6));
+%!   assert (h5read (f, "/x", [1, 2], [Inf, 4], [2, 3]), x(1:2:end, 2:3:end));
+%!   assert (h5read (f, "/x", [5, 12], [1, 1]), 60);
+%!   assert (h5read (f, "/y"), y);
+%!   assert (h5read (f, "/y", [1, 2, 3], [2, 1, 2]), y(:, 2, 3:4));
+%!   assert (h5read (f, "/z", [1, 4], [1, Inf]), z(4:end));
+%!   s = load (f);
+%!   assert (s.x, x);
+%!   assert (s.y, y);
+%!   assert (s.z, z);
+%! unwind_protect_cleanup
+%!   unlink (f);
+%! end_unwind_protect
+
+%!testif HAVE_HDF5
+%! f = [tempname(), ".h5"];
+%! unwind_protect
+%!   x = magic (4);
+%!   save ("-hdf5", f, "x");
+%!   fail ('h5read (f, "/x", [1, 1], [5, 1])', "COUNT exceeds");
+%!   fail ('h5read (f, "/x", [0, 1], [1, 1])', "START must contain valid");
+%!   fail ('h5read (f, "/x", 1, 1)', "must have 2 elements");
+%!   fail ('h5read (f, "/nosuchvar")', "not found");
+%! unwind_protect_cleanup
+%!   unlink (f);
+%! end_unwind_protect
+
+%!error h5read ()
+%!error h5read ("file.h5")
+%!error h5read ("file.h5", "/x", 1)
+*/
+
+OCTAVE_END_NAMESPACE(octave)
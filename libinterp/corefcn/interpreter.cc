@@ -45,6 +45,7 @@
 #include "lo-error.h"
 #include "lo-sysdep.h"
 #include "oct-env.h"
+#include "oct-thread-budget.h"
 #include "quit.h"
 #include "str-vec.h"
 #include "signal-wrappers.h"
@@ -491,6 +492,9 @@ interpreter::interpreter (application *app_context)
 
   initialize_xerbla_error_handler ();
 
+  // Limit the BLAS threads if requested by OCTAVE_NUM_THREADS.
+  thread_budget::init ();
+
   initialize_error_handlers ();
 
   if (m_app_context)
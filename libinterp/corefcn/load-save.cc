@@ -27,6 +27,7 @@
 #  include "config.h"
 #endif
 
+#include <cctype>
 #include <cstring>
 
 #include <fstream>
@@ -525,6 +526,52 @@ load_save_system::load_vars (std::istream& stream,
   return retval;
 }
 
+#if defined (HAVE_HDF5)
+
+// Set the HDF5 storage option OPT, which is -deflate[=N], -shuffle, or
+// -chunk=N1xN2x...
+
+static void
+parse_hdf5_save_option (const std::string& opt, hdf5_save_options& options)
+{
+  if (opt == "-shuffle")
+    options.shuffle = true;
+  else if (opt == "-deflate")
+    options.deflate = 6;
+  else if (opt.compare (0, 9, "-deflate=") == 0)
+    {
+      if (opt.length () != 10 || ! std::isdigit (opt[9]))
+        error ("save: -deflate level must be an integer from 0 to 9");
+
+      options.deflate = opt[9] - '0';
+    }
+  else
+    {
+      std::istringstream is (opt.substr (7));
+
+      options.chunk.clear ();
+
+      while (true)
+        {
+          octave_idx_type n;
+
+          if (! (is >> n) || n < 1)
+            error ("save: -chunk dimensions must be positive integers separated by 'x'");
+
+          options.chunk.push_back (n);
+
+          int ch = is.get ();
+
+          if (ch == std::istream::traits_type::eof ())
+            break;
+          else if (ch != 'x' && ch != ',')
+            error ("save: -chunk dimensions must be positive integers separated by 'x'");
+        }
+    }
+}
+
+#endif
+
 string_vector
 load_save_system::parse_save_options (const string_vector& argv,
                                       load_save_format& fmt, bool& append,
@@ -616,6 +663,15 @@ load_save_system::parse_save_options (const string_vector& argv,
           use_zlib = true;
         }
 #endif
+      else if (argv[i] == "-deflate" || argv[i].compare (0, 9, "-deflate=") == 0
+               || argv[i] == "-shuffle" || argv[i].compare (0, 7, "-chunk=") == 0)
+        {
+#if defined (HAVE_HDF5)
+          parse_hdf5_save_option (argv[i], hdf5_current_save_options ());
+#else
+          err_disabled_feature ("save", "HDF5");
+#endif
+        }
       else if (argv[i] == "-struct")
         {
           retval.append (argv[i]);
@@ -1407,6 +1463,14 @@ load_save_system::save (const octave_value_list& args, int nargout)
   bool append = false;
   bool use_zlib = false;
 
+#if defined (HAVE_HDF5)
+  // HDF5 storage options only apply to one save command.
+  hdf5_save_options& hdf5_options = hdf5_current_save_options ();
+  hdf5_options = hdf5_save_options ();
+
+  unwind_action reset_hdf5_options
+  ([&hdf5_options] () { hdf5_options = hdf5_save_options (); });
+#endif
 
   // get default options
   parse_save_options (save_default_options (), format, append,
@@ -1417,6 +1481,11 @@ load_save_system::save (const octave_value_list& args, int nargout)
 
   argv = parse_save_options (argv, format, append, save_as_floats, use_zlib);
 
+#if defined (HAVE_HDF5)
+  if (hdf5_options.use_chunks () && format.type () != HDF5)
+    warning (R"(save: "-deflate", "-shuffle", and "-chunk" options only have an effect with "-hdf5")");
+#endif
+
   int argc = argv.numel ();
   int i = 0;
 
@@ -1754,6 +1823,25 @@ Save the data in @sc{hdf5} format but using only single precision.  Use this
 format @strong{only} if you know that all the values to be saved can be
 represented in single precision.
 
+The following options change how numeric and logical arrays are stored in
+@sc{hdf5} files.  Arrays stored in chunks can be compressed, and parts of them
+can be read with @code{h5read} without reading the whole array.
+
+@table @code
+@item -deflate[=@var{n}]
+Compress arrays with the deflate (gzip) filter at level @var{n} from 0 to 9.
+The default level is 6.
+
+@item -shuffle
+Shuffle the bytes of the array elements before they are compressed, which
+usually improves the compression of numeric data.
+
+@item -chunk=@var{n1}x@var{n2}x@dots{}
+Store arrays in chunks with the given dimensions.  Missing dimensions are 1
+and dimensions are limited to the size of each array.  If only compression is
+requested, chunks of about 1MiB made of whole columns are used.
+@end table
+
 @item -text
 Save the data in Octave's text data format.  (default)
 
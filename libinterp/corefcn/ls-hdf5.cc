@@ -29,6 +29,7 @@
 
 #if defined (HAVE_HDF5)
 
+#include <algorithm>
 #include <cctype>
 
 #include <iomanip>
@@ -1298,6 +1299,90 @@ save_hdf5_empty (octave_hdf5_id loc_id, const char *name, const dim_vector& d)
 #endif
 }
 
+hdf5_save_options&
+hdf5_current_save_options ()
+{
+  static hdf5_save_options options;
+
+  return options;
+}
+
+// Size of the chunks chosen when no chunk size is given.
+static const std::size_t default_chunk_bytes = 1048576;
+
+octave_hdf5_id
+hdf5_create_dataset (octave_hdf5_id loc_id, const char *name,
+                     octave_hdf5_id type_id, octave_hdf5_id space_id,
+                     const dim_vector& dv)
+{
+#if defined (HAVE_HDF5)
+
+  const hdf5_save_options& options = hdf5_current_save_options ();
+
+  hid_t dcpl_id = octave_H5P_DEFAULT;
+
+  if (options.use_chunks ())
+    {
+      int rank = dv.ndims ();
+
+      OCTAVE_LOCAL_BUFFER (hsize_t, chunk, rank);
+
+      std::size_t elt_size = H5Tget_size (type_id);
+      std::size_t chunk_bytes = elt_size;
+
+      for (int i = 0; i < rank; i++)
+        {
+          hsize_t n;
+
+          if (options.chunk.empty ())
+            n = default_chunk_bytes / chunk_bytes;
+          else if (i < static_cast<int> (options.chunk.size ()))
+            n = options.chunk[i];
+          else
+            n = 1;
+
+          n = std::max (std::min (n, static_cast<hsize_t> (dv(i))),
+                        static_cast<hsize_t> (1));
+
+          chunk_bytes *= n;
+
+          // Octave uses column-major, while HDF5 uses row-major ordering
+          chunk[rank-i-1] = n;
+        }
+
+      dcpl_id = H5Pcreate (H5P_DATASET_CREATE);
+
+      if (dcpl_id < 0)
+        return dcpl_id;
+
+      if (H5Pset_chunk (dcpl_id, rank, chunk) < 0
+          || (options.shuffle && H5Pset_shuffle (dcpl_id) < 0)
+          || (options.deflate > 0
+              && H5Pset_deflate (dcpl_id, options.deflate) < 0))
+        {
+          H5Pclose (dcpl_id);
+          return -1;
+        }
+    }
+
+#if defined (HAVE_HDF5_18)
+  hid_t data_id = H5Dcreate (loc_id, name, type_id, space_id,
+                             octave_H5P_DEFAULT, dcpl_id,
+                             octave_H5P_DEFAULT);
+#else
+  hid_t data_id = H5Dcreate (loc_id, name, type_id, space_id, dcpl_id);
+#endif
+
+  if (dcpl_id != octave_H5P_DEFAULT)
+    H5Pclose (dcpl_id);
+
+  return data_id;
+
+#else
+  err_disabled_feature ("hdf5_create_dataset", "HDF5");
+#endif
+}
+
 // Load an empty matrix, if needed.  Returns
 //    > 0  loaded empty matrix, dimensions returned
 //    = 0  Not an empty matrix; did nothing
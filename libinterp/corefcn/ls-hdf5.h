@@ -29,6 +29,7 @@
 #include "octave-config.h"
 
 #include <iosfwd>
+#include <vector>
 
 #include "oct-hdf5-types.h"
 #include "ov.h"
@@ -148,6 +149,47 @@ add_hdf5_data (octave_hdf5_id loc_id, const octave_value& tc,
 extern OCTINTERP_API int
 save_hdf5_empty (octave_hdf5_id loc_id, const char *name, const dim_vector& d);
 
+// Storage options for the datasets of arrays written by save.  With
+// the default options, datasets are stored contiguously.
+
+struct hdf5_save_options
+{
+public:
+
+  hdf5_save_options ()
+    : deflate (0), shuffle (false), chunk () { }
+
+  OCTAVE_DEFAULT_COPY_MOVE_DELETE (hdf5_save_options)
+
+  // TRUE if datasets must be stored in chunks.
+  bool use_chunks () const
+  { return deflate > 0 || shuffle || ! chunk.empty (); }
+
+  // Level of deflate (gzip) compression from 0 (none) to 9.
+  int deflate;
+
+  // Whether to shuffle the bytes of the elements before compressing.
+  bool shuffle;
+
+  // Chunk dimensions, in the same order as the dimensions of Octave
+  // arrays.  Missing dimensions are 1.  If empty, chunks of about 1MiB
+  // made of whole columns are used when chunks are needed.
+  std::vector<octave_idx_type> chunk;
+};
+
+// The options used while a save command writes an HDF5 file.
+
+extern OCTINTERP_API hdf5_save_options&
+hdf5_current_save_options ();
+
+// Create the dataset NAME in LOC_ID for an array with dimensions DV,
+// using the current save options.
+
+extern OCTINTERP_API octave_hdf5_id
+hdf5_create_dataset (octave_hdf5_id loc_id, const char *name,
+                     octave_hdf5_id type_id, octave_hdf5_id space_id,
+                     const dim_vector& dv);
+
 extern OCTINTERP_API int
 load_hdf5_empty (octave_hdf5_id loc_id, const char *name, dim_vector& d);
 
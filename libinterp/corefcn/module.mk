@@ -126,8 +126,11 @@ COREFCN_SRC = \
   %reldir%/__isprimelarge__.cc \
   %reldir%/__lin_interpn__.cc \
   %reldir%/__magick_read__.cc \
+  %reldir%/__memmapfile__.cc \
+  %reldir%/__movfun__.cc \
   %reldir%/__pchip_deriv__.cc \
   %reldir%/__qp__.cc \
+  %reldir%/__set_hash__.cc \
   %reldir%/amd.cc \
   %reldir%/auto-shlib.cc \
   %reldir%/balance.cc \
@@ -188,6 +191,7 @@ COREFCN_SRC = \
   %reldir%/graphics.cc \
   %reldir%/gsvd.cc \
   %reldir%/gtk-manager.cc \
+  %reldir%/h5read.cc \
   %reldir%/hash.cc \
   %reldir%/help.cc \
   %reldir%/hess.cc \
@@ -27,10 +27,17 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
+
+#include "lo-mappers.h"
+#include "mx-simd.h"
 #include "nproc-wrapper.h"
+#include "oct-thread-budget.h"
+#include "oct-thread-pool.h"
 
 #include "defun.h"
 #include "error.h"
+#include "ovl.h"
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
@@ -112,4 +119,367 @@ same as @code{current}, but overridable through the
 %!error nproc ("no_valid_option")
 */
 
+DEFUN (maxNumCompThreads, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{n} =} maxNumCompThreads ()
+@deftypefnx {} {@var{n_old} =} maxNumCompThreads (@var{n})
+@deftypefnx {} {@var{n_old} =} maxNumCompThreads ("automatic")
+Query or set the maximum number of threads used for computations.
+
+The limit applies to the operations that Octave splits across threads
+(element-wise operations, reductions, sorting, and sparse matrix products on
+large arrays), to @code{fft} and related functions, and to the BLAS library
+if it is OpenBLAS, Intel MKL, or FlexiBLAS.  Setting it also sets the number
+of threads of the thread pool and of @code{fftw}.  Double precision
+transforms use at most 3 threads.
+
+The initial value is taken from the environment variable
+@w{@env{OCTAVE_NUM_THREADS}} if it is set, and is otherwise the value of
+@code{nproc ()}.  The argument @qcode{"automatic"} restores the initial
+value, and restores the number of BLAS threads that was in effect when Octave
+started, for example from @w{@env{OPENBLAS_NUM_THREADS}}.  When called with
+an argument, the previous value is returned.
+
+Limiting the number of threads is useful when several Octave processes run
+on the same machine, for example to keep each process within its share of
+the processors.
+@seealso{nproc, fftw}
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin > 1)
+    print_usage ();
+
+  octave_value retval = thread_budget::size ();
+
+  if (nargin == 1)
+    {
+      octave_value arg = args(0);
+
+      if (arg.is_string () && arg.string_value () == "automatic")
+        thread_budget::size (0);
+      else if (arg.isnumeric () && arg.is_scalar_type () && ! arg.iscomplex ())
+        {
+          double n = arg.double_value ();
+
+          if (! math::isfinite (n) || n < 1 || n != math::fix (n))
+            error ("maxNumCompThreads: invalid input argument");
+
+          thread_budget::size (std::min (n, 65536.0));
+        }
+      else
+        error ("maxNumCompThreads: invalid input argument");
+    }
+
+  return retval;
+}
+
+/*
+%!assert (maxNumCompThreads () >= 1)
+
+%!test
+%! old_n = maxNumCompThreads ();
+%! old_blas = __blas_threads__ ();
+%! unwind_protect
+%!   maxNumCompThreads (4);
+%!   assert (maxNumCompThreads (), 4);
+%!   assert (__thread_pool__ ("threads"), 4);
+%!   maxNumCompThreads (1);
+%!   A = rand (400, 400);
+%!   s1 = sum (A(:) .* A(:));
+%!   maxNumCompThreads (3);
+%!   s3 = sum (A(:) .* A(:));
+%!   assert (s3, s1, 1e-10 * s1);
+%!   assert (maxNumCompThreads (old_n), 3);
+%! unwind_protect_cleanup
+%!   maxNumCompThreads (old_n);
+%!   __blas_threads__ (old_blas);
+%! end_unwind_protect
+
+%!test
+%! old_n = maxNumCompThreads ();
+%! old_blas = __blas_threads__ ();
+%! unwind_protect
+%!   __blas_threads__ (0);
+%!   blas_default = __blas_threads__ ();
+%!   maxNumCompThreads (2);
+%!   if (blas_default > 0)
+%!     assert (__blas_threads__ (), 2);
+%!   endif
+%!   maxNumCompThreads ("automatic");
+%!   if (isempty (getenv ("OCTAVE_NUM_THREADS")))
+%!     assert (maxNumCompThreads (), nproc ());
+%!     assert (__blas_threads__ (), blas_default);
+%!   endif
+%! unwind_protect_cleanup
+%!   maxNumCompThreads (old_n);
+%!   __blas_threads__ (old_blas);
+%! end_unwind_protect
+
+%!error <invalid input argument> maxNumCompThreads ([1, 2])
+%!error <invalid input argument> maxNumCompThreads (0)
+%!error <invalid input argument> maxNumCompThreads (2.5)
+%!error <invalid input argument> maxNumCompThreads ("foobar")
+*/
+
+DEFUN (__thread_pool__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{n} =} __thread_pool__ ("threads")
+@deftypefnx {} {@var{old_n} =} __thread_pool__ ("threads", @var{n})
+@deftypefnx {} {@var{m} =} __thread_pool__ ("threshold")
+@deftypefnx {} {@var{old_m} =} __thread_pool__ ("threshold", @var{m})
+Query or set the parameters of the thread pool used for element-wise
+operations, reductions, and sparse matrix products on large arrays.
+
+@table @code
+@item threads
+Number of threads, including the main thread.  The default is
+@code{maxNumCompThreads ()}.  Setting it to 0 restores the default.  With 1
+thread, all operations run serially.
+
+@item threshold
+Minimum number of elements of an operation to split it across threads.  For
+sparse matrix products, the number of multiplications is used instead.
+@end table
+
+When called with a new value, the previous value is returned.
+@seealso{nproc, maxNumCompThreads}
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin < 1 || nargin > 2)
+    print_usage ();
+
+  std::string param
+    = args(0).xstring_value ("__thread_pool__: PARAM must be a string");
+
+  octave_value retval;
+
+  if (param == "threads")
+    {
+      retval = thread_pool::size ();
+
+      if (nargin == 2)
+        {
+          int n = args(1).xint_value ("__thread_pool__: N must be an integer");
+
+          if (n < 0)
+            error ("__thread_pool__: N must be non-negative");
+
+          thread_pool::size (n);
+        }
+    }
+  else if (param == "threshold")
+    {
+      retval = static_cast<double> (thread_pool::threshold ());
+
+      if (nargin == 2)
+        {
+          octave_idx_type m
+            = args(1).xidx_type_value ("__thread_pool__: M must be an integer");
+
+          if (m < 0)
+            error ("__thread_pool__: M must be non-negative");
+
+          thread_pool::threshold (m);
+        }
+    }
+  else
+    error (R"(__thread_pool__: PARAM must be "threads" or "threshold")");
+
+  return retval;
+}
+
+/*
+%!assert (__thread_pool__ ("threads") >= 1)
+
+%!test
+%! old_n = __thread_pool__ ("threads", 4);
+%! old_m = __thread_pool__ ("threshold", 1);
+%! unwind_protect
+%!   A = rand (300, 250);
+%!   B = rand (300, 250);
+%!   C = single (rand (300, 250));
+%!   r4 = {A .* B + A, -A, A > B, A .* 2, 3 - B, sqrt (A), C .* C, ...
+%!         sum (A), sum (A, 2), prod (A), cumsum (A), cumsum (A, 2), ...
+%!         max (A), cummax (A), diff (A), diff (A, 2, 2), ...
+%!         any (A > 0.999), int8 (100 * A) + int8 (50)};
+%!   [m4, i4] = max (A, [], 2);
+%!   [cm4, ci4] = cummin (A, [], 2);
+%!   __thread_pool__ ("threads", 1);
+%!   r1 = {A .* B + A, -A, A > B, A .* 2, 3 - B, sqrt (A), C .* C, ...
+%!         sum (A), sum (A, 2), prod (A), cumsum (A), cumsum (A, 2), ...
+%!         max (A), cummax (A), diff (A), diff (A, 2, 2), ...
+%!         any (A > 0.999), int8 (100 * A) + int8 (50)};
+%!   [m1, i1] = max (A, [], 2);
+%!   [cm1, ci1] = cummin (A, [], 2);
+%!   assert (r4, r1);
+%!   assert (m4, m1);
+%!   assert (i4, i1);
+%!   assert (cm4, cm1);
+%!   assert (ci4, ci1);
+%! unwind_protect_cleanup
+%!   __thread_pool__ ("threads", old_n);
+%!   __thread_pool__ ("threshold", old_m);
+%! end_unwind_protect
+
+%!test
+%! old_n = __thread_pool__ ("threads", 4);
+%! old_m = __thread_pool__ ("threshold", 1);
+%! unwind_protect
+%!   A = sprand (400, 300, 0.05);
+%!   B = sprand (300, 200, 0.05) + 1i * sprand (300, 200, 0.05);
+%!   x = rand (300, 1);
+%!   X = rand (300, 3) + 1i;
+%!   y = rand (2, 400);
+%!   r4 = {A * A', A * B, B' * B, y * A, y * A', X.' * B.', X' * B'};
+%!   v4 = {A * x, A * X, A' * y', B.' * A' * y'};
+%!   __thread_pool__ ("threads", 1);
+%!   r1 = {A * A', A * B, B' * B, y * A, y * A', X.' * B.', X' * B'};
+%!   v1 = {A * x, A * X, A' * y', B.' * A' * y'};
+%!   assert (r4, r1);
+%!   ## Products with few columns sum partial results from each thread.
+%!   for k = 1:numel (v1)
+%!     assert (v4{k}, v1{k}, -1e-12);
+%!   endfor
+%! unwind_protect_cleanup
+%!   __thread_pool__ ("threads", old_n);
+%!   __thread_pool__ ("threshold", old_m);
+%! end_unwind_protect
+
+%!error __thread_pool__ ()
+%!error <PARAM must be> __thread_pool__ ("foo")
+%!error <N must be non-negative> __thread_pool__ ("threads", -1)
+*/
+
+DEFUN (__blas_threads__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{n} =} __blas_threads__ ()
+@deftypefnx {} {@var{old_n} =} __blas_threads__ (@var{n})
+Query or set the number of threads of the BLAS library only.
+
+The number is 0 if the BLAS library is not OpenBLAS, Intel MKL, or FlexiBLAS.
+Setting it to 0 restores the number that was in effect when Octave started.
+When called with a new value, the previous value is returned.
+@seealso{maxNumCompThreads}
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin > 1)
+    print_usage ();
+
+  octave_value retval = thread_budget::blas_threads ();
+
+  if (nargin == 1)
+    {
+      int n = args(0).xint_value ("__blas_threads__: N must be an integer");
+
+      if (n < 0)
+        error ("__blas_threads__: N must be non-negative");
+
+      thread_budget::blas_threads (n);
+    }
+
+  return retval;
+}
+
+/*
+%!assert (__blas_threads__ () >= 0)
+
+%!test
+%! old_n = __blas_threads__ (1);
+%! unwind_protect
+%!   if (old_n > 0)
+%!     assert (__blas_threads__ (), 1);
+%!   endif
+%! unwind_protect_cleanup
+%!   __blas_threads__ (old_n);
+%! end_unwind_protect
+
+%!error <N must be non-negative> __blas_threads__ (-1)
+*/
+
+
+DEFUN (__mx_simd__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {[@var{level}, @var{max_level}] =} __mx_simd__ ()
+@deftypefnx {} {@var{old_level} =} __mx_simd__ (@var{level})
+Query or set the instruction set used by the vectorized kernels for
+comparisons, @code{min}, @code{max}, @code{isnan}-type tests and
+@code{isfinite}-type tests on real arrays.
+
+The level is one of @qcode{"scalar"}, @qcode{"sse2"}, @qcode{"avx2"}, or
+@qcode{"avx512"}.  @var{max_level} is the best level supported by the
+processor, and is the default.  Requesting a level that is not supported
+selects @var{max_level} instead.  All levels give identical results; this
+function is intended for testing and benchmarking.
+@seealso{__thread_pool__}
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin > 1)
+    print_usage ();
+
+  std::string old_level = mx_simd::level_name (mx_simd::level ());
+
+  if (nargin == 1)
+    {
+      std::string name
+        = args(0).xstring_value ("__mx_simd__: LEVEL must be a string");
+
+      mx_simd::isa l;
+
+      if (! mx_simd::level_from_name (name, l))
+        error ("__mx_simd__: unknown LEVEL '%s'", name.c_str ());
+
+      mx_simd::set_level (l);
+
+      return ovl (old_level);
+    }
+
+  return ovl (old_level, mx_simd::level_name (mx_simd::max_level ()));
+}
+
+/*
+%!test
+%! [level, max_level] = __mx_simd__ ();
+%! assert (any (strcmp (level, {"scalar", "sse2", "avx2", "avx512"})));
+%! assert (any (strcmp (max_level, {"scalar", "sse2", "avx2", "avx512"})));
+
+%!test
+%! old_level = __mx_simd__ ();
+%! unwind_protect
+%!   special = [NaN, Inf, -Inf, 0, -0, 1, -1, 2];
+%!   for cls = {"double", "single"}
+%!     for n = [0:37, 1000]
+%!       x = cast (special(randi (8, 1, n)), cls{1});
+%!       y = cast (special(randi (8, 1, n)), cls{1});
+%!       s = cast (special(randi (8)), cls{1});
+%!       r = {};
+%!       for level = {"scalar", "sse2", "avx2", "avx512"}
+%!         __mx_simd__ (level{1});
+%!         r{end+1} = {x < y, x <= y, x > y, x >= y, x == y, x != y, ...
+%!                     x < s, s <= y, x > s, s >= y, x == s, s != y, ...
+%!                     any (isnan (x)), all (isfinite (x)), ...
+%!                     1 ./ min (x, y), 1 ./ max (x, y), ...
+%!                     1 ./ min (x, s), 1 ./ min (s, y), ...
+%!                     1 ./ max (x, s), 1 ./ max (s, y)};
+%!       endfor
+%!       assert (r{2}, r{1});
+%!       assert (r{3}, r{1});
+%!       assert (r{4}, r{1});
+%!     endfor
+%!   endfor
+%! unwind_protect_cleanup
+%!   __mx_simd__ (old_level);
+%! end_unwind_protect
+
+%!error __mx_simd__ (1, 2)
+%!error <unknown LEVEL> __mx_simd__ ("foo")
+*/
+
 OCTAVE_END_NAMESPACE(octave)
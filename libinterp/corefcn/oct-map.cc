@@ -27,6 +27,9 @@
 #  include "config.h"
 #endif
 
+#include <functional>
+#include <string>
+
 #include "Array-util.h"
 #include "error.h"
 #include "oct-locbuf.h"
@@ -35,6 +38,95 @@
 #include "oct-map.h"
 #include "utils.h"
 
+// Number of fields at which lookups switch from the tree to the hash
+// index.
+static const std::size_t fields_hash_threshold = 8;
+
+octave_fields::fields_rep::const_iterator
+octave_fields::fields_rep::find (const std::string& key) const
+{
+  if (m_index.empty ())
+    return m_map.find (key);
+
+  std::size_t h = std::hash<std::string> {} (key);
+  std::size_t mask = m_index.size () - 1;
+
+  for (std::size_t i = h & mask; m_index[i].used; i = (i + 1) & mask)
+    {
+      const index_slot& slot = m_index[i];
+
+      if (slot.hash == h && slot.it->first == key)
+        return slot.it;
+    }
+
+  return m_map.end ();
+}
+
+void
+octave_fields::fields_rep::assign (const std::string& key,
+                                   octave_idx_type idx)
+{
+  auto p = m_map.find (key);
+
+  if (p != m_map.end ())
+    {
+      p->second = idx;
+      return;
+    }
+
+  p = m_map.emplace (key, idx).first;
+
+  // Keep the load factor of the index at or below one half.
+  if (m_index.empty () ? m_map.size () >= fields_hash_threshold
+                       : 2 * m_map.size () > m_index.size ())
+    rebuild_index ();
+  else if (! m_index.empty ())
+    index_insert (p);
+}
+
+void
+octave_fields::fields_rep::erase (const std::string& key)
+{
+  m_map.erase (key);
+
+  rebuild_index ();
+}
+
+void
+octave_fields::fields_rep::index_insert (iterator it)
+{
+  std::size_t h = std::hash<std::string> {} (it->first);
+  std::size_t mask = m_index.size () - 1;
+
+  std::size_t i = h & mask;
+  while (m_index[i].used)
+    i = (i + 1) & mask;
+
+  index_slot& slot = m_index[i];
+
+  slot.hash = h;
+  slot.it = it;
+  slot.used = true;
+}
+
+void
+octave_fields::fields_rep::rebuild_index ()
+{
+  m_index.clear ();
+
+  if (m_map.size () < fields_hash_threshold)
+    return;
+
+  std::size_t capacity = 2 * fields_hash_threshold;
+  while (capacity < 2 * m_map.size ())
+    capacity *= 2;
+
+  m_index.resize (capacity);
+
+  for (auto it = m_map.begin (); it != m_map.end (); it++)
+    index_insert (it);
+}
+
 octave_fields::fields_rep *
 octave_fields::nil_rep ()
 {
@@ -47,7 +139,7 @@ octave_fields::octave_fields (const string_vector& fields)
 {
   octave_idx_type n = fields.numel ();
   for (octave_idx_type i = 0; i < n; i++)
-    (*m_rep)[fields(i)] = i;
+    m_rep->assign (fields(i), i);
 }
 
 octave_fields::octave_fields (const char *const *fields)
@@ -55,7 +147,7 @@ octave_fields::octave_fields (const char *const *fields)
 {
   octave_idx_type n = 0;
   while (*fields)
-    (*m_rep)[std::string (*fields++)] = n++;
+    m_rep->assign (std::string (*fields++), n++);
 }
 
 bool
@@ -81,7 +173,8 @@ octave_fields::getfield (const std::string& field)
     {
       make_unique ();
       octave_idx_type n = m_rep->size ();
-      return (*m_rep)[field] = n;
+      m_rep->assign (field, n);
+      return n;
     }
 }
 
@@ -106,6 +199,25 @@ octave_fields::rmfield (const std::string& field)
     }
 }
 
+/*
+## Structs with enough fields to use the hash index
+%!test
+%! names = arrayfun (@(i) sprintf ("f%02d", i), 30:-1:1, "uniformoutput", false);
+%! s = cell2struct (num2cell (1:30), names, 2);
+%! assert (fieldnames (s), names(:));
+%! assert (s.f30, 1);
+%! assert (s.f01, 30);
+%! assert (isfield (s, "f15"));
+%! assert (! isfield (s, "f31"));
+%! s = rmfield (s, "f15");
+%! assert (numfields (s), 29);
+%! assert (! isfield (s, "f15"));
+%! assert (s.f14, 17);
+%! s.f15 = 42;
+%! assert (s.f15, 42);
+%! assert (fieldnames (orderfields (s)), sort (names(:)));
+*/
+
 void
 octave_fields::orderfields (Array<octave_idx_type>& perm)
 {
@@ -196,6 +308,25 @@ octave_scalar_map::setfield (const std::string& k, const octave_value& val)
     m_vals.push_back (val);
 }
 
+octave_value
+octave_scalar_map::getfield (const std::string& k,
+                             octave_field_cache& cache) const
+{
+  octave_idx_type idx = cache.lookup (m_keys, k);
+  return (idx >= 0) ? m_vals[idx] : octave_value ();
+}
+
+void
+octave_scalar_map::setfield (const std::string& k, const octave_value& val,
+                             octave_field_cache& cache)
+{
+  octave_idx_type idx = cache.lookup (m_keys, k);
+  if (idx >= 0)
+    m_vals[idx] = val;
+  else
+    setfield (k, val);
+}
+
 void
 octave_scalar_map::rmfield (const std::string& k)
 {
@@ -30,6 +30,7 @@
 
 #include <algorithm>
 #include <map>
+#include <vector>
 
 #include "oct-refcount.h"
 
@@ -42,20 +43,67 @@ class string_vector;
 class OCTINTERP_API
 octave_fields
 {
-  class fields_rep : public std::map<std::string, octave_idx_type>
+  // The field map.  Iteration is ordered by field name.  Once a map
+  // has more than a few fields, lookups go through an open addressing
+  // hash table of iterators into the map instead of walking the tree.
+  class fields_rep
   {
   public:
 
-    fields_rep () : std::map<std::string, octave_idx_type> (), m_count (1) { }
+    typedef std::map<std::string, octave_idx_type> map_type;
+
+    typedef map_type::iterator iterator;
+    typedef map_type::const_iterator const_iterator;
+
+    fields_rep () : m_count (1), m_map (), m_index () { }
 
     fields_rep (const fields_rep& other)
-      : std::map<std::string, octave_idx_type> (other), m_count (1) { }
+      : m_count (1), m_map (other.m_map), m_index ()
+    {
+      rebuild_index ();
+    }
 
     fields_rep& operator = (const fields_rep&) = delete;
 
     ~fields_rep () = default;
 
+    octave_idx_type size () const { return m_map.size (); }
+
+    iterator begin () { return m_map.begin (); }
+    iterator end () { return m_map.end (); }
+
+    const_iterator begin () const { return m_map.begin (); }
+    const_iterator end () const { return m_map.end (); }
+
+    const_iterator cbegin () const { return m_map.cbegin (); }
+    const_iterator cend () const { return m_map.cend (); }
+
+    const_iterator find (const std::string& key) const;
+
+    // Set the index of KEY, adding it if it does not exist.
+    void assign (const std::string& key, octave_idx_type idx);
+
+    void erase (const std::string& key);
+
     octave::refcount<octave_idx_type> m_count;
+
+  private:
+
+    struct index_slot
+    {
+      std::size_t hash = 0;
+      iterator it;
+      bool used = false;
+    };
+
+    void index_insert (iterator it);
+
+    void rebuild_index ();
+
+    map_type m_map;
+
+    // Empty until the map has grown large enough for hashing to pay off.
+    std::vector<index_slot> m_index;
   };
 
   fields_rep *m_rep;
@@ -105,7 +153,7 @@ public:
 
   // constant iteration support. non-const iteration intentionally unsupported.
 
-  typedef std::map<std::string, octave_idx_type>::const_iterator const_iterator;
+  typedef fields_rep::const_iterator const_iterator;
   typedef const_iterator iterator;
 
   const_iterator begin () const { return m_rep->begin (); }
@@ -160,6 +208,36 @@ public:
   }
 };
 
+// Cache of the index of one field name in a set of fields, used to skip
+// the lookup when the same field of structs sharing the same fields is
+// accessed repeatedly.  A cache must always be used with the same field
+// name.  Because the cache holds a reference to the fields, any change to
+// them makes a copy and the cache is refreshed on the next lookup.
+class OCTINTERP_API
+octave_field_cache
+{
+public:
+
+  OCTAVE_DEFAULT_CONSTRUCT_COPY_MOVE_DELETE (octave_field_cache)
+
+  octave_idx_type lookup (const octave_fields& keys, const std::string& name)
+  {
+    if (! m_keys.is_same (keys))
+      {
+        m_keys = keys;
+        m_index = keys.getfield (name);
+      }
+
+    return m_index;
+  }
+
+private:
+
+  octave_fields m_keys;
+
+  octave_idx_type m_index = -1;
+};
+
 class OCTINTERP_API
 octave_scalar_map
 {
@@ -230,6 +308,12 @@ public:
   void assign (const std::string& k, const octave_value& val)
   { setfield (k, val); }
 
+  // same as above, but look up the field through CACHE.
+  octave_value getfield (const std::string& key,
+                         octave_field_cache& cache) const;
+  void setfield (const std::string& key, const octave_value& val,
+                 octave_field_cache& cache);
+
   // remove a given field.  do nothing if not exist.
   void rmfield (const std::string& key);
   void del (const std::string& k) { rmfield (k); }
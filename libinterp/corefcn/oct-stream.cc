@@ -44,6 +44,7 @@
 #include "Array.h"
 #include "Cell.h"
 #include "byte-swap.h"
+#include "file-stat.h"
 #include "lo-ieee.h"
 #include "lo-mappers.h"
 #include "lo-utils.h"
@@ -1201,6 +1202,40 @@ init_inf_nan ()
   return retval;
 }
 
+// Number of characters from the current position of IS to its end, or
+// -1 if the stream can not seek.  The position and state of IS are
+// unchanged.
+
+static std::streamoff
+remaining_size (std::istream& is)
+{
+  std::ios_base::iostate state = is.rdstate ();
+
+  std::streampos pos = is.tellg ();
+
+  if (pos < 0)
+    {
+      is.clear (state);
+      return -1;
+    }
+
+  is.seekg (0, std::ios::end);
+  std::streampos end = is.tellg ();
+  is.clear ();
+  is.seekg (pos);
+  is.clear (state);
+
+  return end < pos ? -1 : static_cast<std::streamoff> (end - pos);
+}
+
+textscan_buffer_stats&
+textscan_stats ()
+{
+  static textscan_buffer_stats stats;
+
+  return stats;
+}
+
 // Delimited stream, optimized to read strings of characters separated
 // by single-character delimiters.
 //
@@ -1208,11 +1243,14 @@ init_inf_nan ()
 // seek/tell, but the opportunity has been taken to optimise for the
 // textscan workload.
 //
-// The function reads chunks into a 4kiB buffer, and marks where the
-// last delimiter occurs.  Reads up to this delimiter can be fast.
-// After that last delimiter, the remaining text is moved to the front
-// of the buffer and the buffer is refilled.  This also allows cheap
-// seek and tell operations within a "fast read" block.
+// The function reads chunks into a buffer (4kiB by default), and marks
+// where the last delimiter occurs.  Reads up to this delimiter can be
+// fast.  After that last delimiter, the remaining text is moved to the
+// front of the buffer and the buffer is refilled.  This also allows
+// cheap seek and tell operations within a "fast read" block.
+//
+// The buffer is never reallocated, because callers keep positions in
+// it across refills (see textscan::scan_complex).
 
 class
 delimited_stream
@@ -1481,10 +1519,13 @@ delimited_stream::refresh_buf (bool initialize)
 
   octave_quit ();                       // allow ctrl-C
 
+  textscan_buffer_stats& stats = textscan_stats ();
+
   if (old_remaining + m_overlap > 0)
     {
       m_buf_in_file += (m_idx - old_overlap - m_buf);
       std::memmove (m_buf, m_idx - m_overlap, m_overlap + old_remaining);
+      stats.bytes_moved += m_overlap + old_remaining;
     }
   else
     m_buf_in_file = m_i_stream.tellg ();  // record for destructor
@@ -1499,6 +1540,11 @@ delimited_stream::refresh_buf (bool initialize)
       m_i_stream.read (m_buf + m_overlap + old_remaining,
                        m_bufsize - m_overlap - old_remaining);
       gcount = m_i_stream.gcount ();
+
+      stats.refills++;
+      stats.bytes_read += gcount;
+      stats.max_buffer_size = std::max (stats.max_buffer_size,
+                                        static_cast<std::size_t> (m_bufsize));
     }
   else
     gcount = 0;
@@ -2602,6 +2648,9 @@ textscan::do_scan (std::istream& isp, textscan_format_list& fmt_list,
                                  m_delim_len, 3});  // 3 for NaN and Inf
 
   // Next, choose a buffer size to avoid reading too much, or too often.
+  // When reading to the end of the file, use the size of the rest of the
+  // file, up to 1MiB, so that large files are read in large blocks.  The
+  // size is fixed for the whole scan.
   octave_idx_type buf_size = 4096;
   if (m_buffer_size)
     buf_size = m_buffer_size;
@@ -2611,6 +2660,12 @@ textscan::do_scan (std::istream& isp, textscan_format_list& fmt_list,
       buf_size = std::min (buf_size, std::max (ntimes, 80 * ntimes));
       buf_size = std::max (buf_size, ntimes);
     }
+  else
+    {
+      std::streamoff remaining = remaining_size (isp);
+      if (remaining > buf_size)
+        buf_size = std::min (remaining, static_cast<std::streamoff> (1048576));
+    }
   // Finally, create the stream.
   delimited_stream is (isp,
                        (m_delims.empty () ? m_whitespace + "\r\n"
@@ -6601,6 +6656,114 @@ stream::finalize_read (std::list<void *>& input_buf_list,
   return retval;
 }
 
+// Compute the dimensions of the result of fread after COUNT elements
+// were read for the size specification NR and NC.
+
+static void
+fread_result_dims (bool read_to_eof, std::ptrdiff_t count,
+                   octave_idx_type& nr, octave_idx_type& nc)
+{
+  if (read_to_eof)
+    {
+      if (nc < 0)
+        {
+          nc = count / nr;
+
+          if (count % nr != 0)
+            nc++;
+        }
+      else
+        nr = count;
+    }
+  else if (count == 0)
+    {
+      nr = 0;
+      nc = 0;
+    }
+  else if (count != nr * nc)
+    {
+      if (count % nr != 0)
+        nc = count / nr + 1;
+      else
+        nc = count / nr;
+
+      if (count < nr)
+        nr = count;
+    }
+}
+
+// Read elements that do not need to be converted to another type
+// directly into the result array.  The general case in stream::read
+// reads into temporary buffers and copies the data element by element.
+// CAPACITY is the initial number of elements of the result.  It grows
+// as needed, so that a large count does not allocate more memory than
+// the data that is actually read.
+
+template <typename T>
+static octave_value
+read_same_type (std::istream& is, octave_idx_type nr, octave_idx_type nc,
+                octave_idx_type capacity, bool swap,
+                oct_data_conv::data_type type, mach_info::float_format ffmt,
+                octave_idx_type& count)
+{
+  octave_idx_type elts_to_read = nr * nc;
+
+  bool read_to_eof = elts_to_read < 0;
+
+  if (! read_to_eof && capacity > elts_to_read)
+    capacity = elts_to_read;
+
+  Array<T> buf (dim_vector (capacity, 1));
+
+  std::ptrdiff_t n = 0;
+
+  while (is && capacity > 0)
+    {
+      char *data = reinterpret_cast<char *> (buf.fortran_vec ());
+
+      is.read (data + n * sizeof (T), (capacity - n) * sizeof (T));
+
+      n += is.gcount () / sizeof (T);
+
+      if (! is || n < capacity || n == elts_to_read)
+        break;
+
+      // Don't grow the buffer if it was just large enough.
+      if (is.peek () == std::istream::traits_type::eof ())
+        break;
+
+      if (capacity > std::numeric_limits<octave_idx_type>::max () / 2)
+        error ("fread: number of elements read exceeds max index size");
+
+      capacity *= 2;
+
+      if (! read_to_eof && capacity > elts_to_read)
+        capacity = elts_to_read;
+
+      buf.resize (dim_vector (capacity, 1));
+    }
+
+  count = n;
+
+  fread_result_dims (read_to_eof, n, nr, nc);
+
+  // Pad the last column with zeros or drop unused elements.
+  if (nr * nc != capacity)
+    buf.resize (dim_vector (nr * nc, 1));
+
+  if (swap)
+    {
+      if (type == oct_data_conv::dt_double)
+        do_double_format_conversion (buf.fortran_vec (), n, ffmt);
+      else if (type == oct_data_conv::dt_single)
+        do_float_format_conversion (buf.fortran_vec (), n, ffmt);
+      else
+        swap_bytes<sizeof (T)> (buf.fortran_vec (), n);
+    }
+
+  return octave_value (buf.reshape (dim_vector (nr, nc)));
+}
+
 octave_value
 stream::read (const Array<double>& size, octave_idx_type block_size,
               oct_data_conv::data_type input_type,
@@ -6697,6 +6860,77 @@ stream::read (const Array<double>& size, octave_idx_type block_size,
     {
       std::istream& is = *isp;
 
+      if (skip == 0 && input_type == output_type
+          && input_type != oct_data_conv::dt_logical)
+        {
+          if (ffmt == mach_info::flt_fmt_unknown)
+            ffmt = float_format ();
+
+          bool swap = (mach_info::words_big_endian ()
+                       ? ffmt == mach_info::flt_fmt_ieee_little_endian
+                       : ffmt == mach_info::flt_fmt_ieee_big_endian);
+
+          // Use the size of the rest of a regular file as the initial
+          // size of the buffer.  Otherwise start with 1M elements.
+          octave_idx_type capacity = 1024 * 1024;
+
+          if (elts_to_read != 0)
+            {
+              sys::file_fstat fs (file_number ());
+
+              off_t pos = (is ? static_cast<off_t> (is.tellg ()) : -1);
+
+              if (fs && fs.is_reg () && pos >= 0 && fs.size () > pos)
+                capacity = ((fs.size () - pos + input_elt_size - 1)
+                            / input_elt_size);
+            }
+
+          switch (input_type)
+            {
+            case oct_data_conv::dt_int8:
+              return read_same_type<octave_int8> (is, nr, nc, capacity, swap,
+                                                  input_type, ffmt, count);
+            case oct_data_conv::dt_uint8:
+              return read_same_type<octave_uint8> (is, nr, nc, capacity, swap,
+                                                   input_type, ffmt, count);
+            case oct_data_conv::dt_int16:
+              return read_same_type<octave_int16> (is, nr, nc, capacity, swap,
+                                                   input_type, ffmt, count);
+            case oct_data_conv::dt_uint16:
+              return read_same_type<octave_uint16> (is, nr, nc, capacity,
+                                                    swap, input_type, ffmt,
+                                                    count);
+            case oct_data_conv::dt_int32:
+              return read_same_type<octave_int32> (is, nr, nc, capacity, swap,
+                                                   input_type, ffmt, count);
+            case oct_data_conv::dt_uint32:
+              return read_same_type<octave_uint32> (is, nr, nc, capacity,
+                                                    swap, input_type, ffmt,
+                                                    count);
+            case oct_data_conv::dt_int64:
+              return read_same_type<octave_int64> (is, nr, nc, capacity, swap,
+                                                   input_type, ffmt, count);
+            case oct_data_conv::dt_uint64:
+              return read_same_type<octave_uint64> (is, nr, nc, capacity,
+                                                    swap, input_type, ffmt,
+                                                    count);
+            case oct_data_conv::dt_single:
+              return read_same_type<float> (is, nr, nc, capacity, swap,
+                                            input_type, ffmt, count);
+            case oct_data_conv::dt_double:
+              return read_same_type<double> (is, nr, nc, capacity, swap,
+                                             input_type, ffmt, count);
+            case oct_data_conv::dt_char:
+            case oct_data_conv::dt_schar:
+            case oct_data_conv::dt_uchar:
+              return read_same_type<char> (is, nr, nc, capacity, swap,
+                                           input_type, ffmt, count);
+            default:
+              // Use the general case below.
+              break;
+            }
+        }
+
       // Initialize eof_pos variable just once per function call
       off_t eof_pos = 0;
       off_t cur_pos = 0;
@@ -6754,33 +6988,7 @@ stream::read (const Array<double>& size, octave_idx_type block_size,
             }
         }
 
-      if (read_to_eof)
-        {
-          if (nc < 0)
-            {
-              nc = tmp_count / nr;
-
-              if (tmp_count % nr != 0)
-                nc++;
-            }
-          else
-            nr = tmp_count;
-        }
-      else if (tmp_count == 0)
-        {
-          nr = 0;
-          nc = 0;
-        }
-      else if (tmp_count != nr * nc)
-        {
-          if (tmp_count % nr != 0)
-            nc = tmp_count / nr + 1;
-          else
-            nc = tmp_count / nr;
-
-          if (tmp_count < nr)
-            nr = tmp_count;
-        }
+      fread_result_dims (read_to_eof, tmp_count, nr, nc);
 
       if (tmp_count > std::numeric_limits<octave_idx_type>::max ())
         error ("fread: number of elements read exceeds max index size");
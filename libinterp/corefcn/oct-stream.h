@@ -28,6 +28,8 @@
 
 #include "octave-config.h"
 
+#include <cstddef>
+#include <cstdint>
 #include <ios>
 #include <iosfwd>
 #include <list>
@@ -61,6 +63,26 @@ class scanf_format_list;
 class printf_format_elt;
 class printf_format_list;
 
+// Counters of the input buffers of textscan, used to tune the reading
+// of large files.  They accumulate over all calls until they are reset.
+
+struct textscan_buffer_stats
+{
+  // Number of bytes read from files.
+  uint64_t bytes_read = 0;
+
+  // Number of reads that refill the buffer.
+  uint64_t refills = 0;
+
+  // Number of bytes moved to the start of the buffer by refills.
+  uint64_t bytes_moved = 0;
+
+  // Largest buffer size used.
+  std::size_t max_buffer_size = 0;
+};
+
+extern OCTINTERP_API textscan_buffer_stats& textscan_stats ();
+
 // Provide an interface for Octave streams.
 
 class
@@ -27,9 +27,13 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
 #include <cmath>
+#include <tuple>
+#include <vector>
 
 #include "lo-ieee.h"
+#include "lo-mappers.h"
 
 #include "defun.h"
 #include "error.h"
@@ -49,13 +53,194 @@ inline double min (double a, double b, double c)
 
 #define REF(x,k,i) x(static_cast<octave_idx_type> (elem((k), (i))) - 1)
 
-// for large data set the algorithm is very slow
-// one should presort (how?) either the elements of the points of evaluation
-// to cut down the time needed to decide which triangle contains the
-// given point
+// Uniform grid over the bounding boxes of the triangles.  Each cell lists,
+// in increasing order, the triangles whose bounding box overlaps it, so a
+// query only has to test the few triangles listed in the cell containing
+// the point.  The grid has roughly one cell per triangle.
 
-// e.g., build up a neighbouring triangle structure and use a simplex-like
-// method to traverse it
+class tri_grid
+{
+public:
+
+  tri_grid (const ColumnVector& minx, const ColumnVector& maxx,
+            const ColumnVector& miny, const ColumnVector& maxy)
+    : m_nx (0), m_ny (0), m_xmin (0), m_ymin (0), m_xmax (0), m_ymax (0),
+      m_dx (1), m_dy (1), m_start (), m_tri ()
+  {
+    octave_idx_type nelem = minx.numel ();
+
+    bool empty = true;
+
+    for (octave_idx_type k = 0; k < nelem; k++)
+      {
+        // Skip triangles with NaN vertices.  They can't contain any point.
+        if (! (minx(k) <= maxx(k) && miny(k) <= maxy(k)))
+          continue;
+
+        if (empty)
+          {
+            m_xmin = minx(k);
+            m_xmax = maxx(k);
+            m_ymin = miny(k);
+            m_ymax = maxy(k);
+            empty = false;
+          }
+        else
+          {
+            m_xmin = std::min (m_xmin, minx(k));
+            m_xmax = std::max (m_xmax, maxx(k));
+            m_ymin = std::min (m_ymin, miny(k));
+            m_ymax = std::max (m_ymax, maxy(k));
+          }
+      }
+
+    if (empty)
+      return;
+
+    octave_idx_type ncells = std::ceil (std::sqrt (static_cast<double> (nelem)));
+
+    m_nx = (m_xmax > m_xmin ? ncells : 1);
+    m_ny = (m_ymax > m_ymin ? ncells : 1);
+    m_dx = (m_xmax - m_xmin) / m_nx;
+    m_dy = (m_ymax - m_ymin) / m_ny;
+
+    if (! (m_dx > 0) || ! std::isfinite (m_dx))
+      {
+        m_nx = 1;
+        m_dx = 1;
+      }
+    if (! (m_dy > 0) || ! std::isfinite (m_dy))
+      {
+        m_ny = 1;
+        m_dy = 1;
+      }
+
+    // Count triangles per cell, then fill the cell lists.
+
+    m_start.assign (m_nx * m_ny + 1, 0);
+
+    for (octave_idx_type k = 0; k < nelem; k++)
+      {
+        if (! (minx(k) <= maxx(k) && miny(k) <= maxy(k)))
+          continue;
+
+        octave_idx_type ix0 = xcell (minx(k));
+        octave_idx_type ix1 = xcell (maxx(k));
+        octave_idx_type iy0 = ycell (miny(k));
+        octave_idx_type iy1 = ycell (maxy(k));
+
+        for (octave_idx_type iy = iy0; iy <= iy1; iy++)
+          for (octave_idx_type ix = ix0; ix <= ix1; ix++)
+            m_start[iy * m_nx + ix + 1]++;
+      }
+
+    for (octave_idx_type c = 0; c < m_nx * m_ny; c++)
+      m_start[c+1] += m_start[c];
+
+    m_tri.resize (m_start.back ());
+
+    std::vector<octave_idx_type> pos (m_start.begin (), m_start.end () - 1);
+
+    for (octave_idx_type k = 0; k < nelem; k++)
+      {
+        if (! (minx(k) <= maxx(k) && miny(k) <= maxy(k)))
+          continue;
+
+        octave_idx_type ix0 = xcell (minx(k));
+        octave_idx_type ix1 = xcell (maxx(k));
+        octave_idx_type iy0 = ycell (miny(k));
+        octave_idx_type iy1 = ycell (maxy(k));
+
+        for (octave_idx_type iy = iy0; iy <= iy1; iy++)
+          for (octave_idx_type ix = ix0; ix <= ix1; ix++)
+            m_tri[pos[iy * m_nx + ix]++] = k;
+      }
+  }
+
+  OCTAVE_DISABLE_COPY_MOVE (tri_grid)
+
+  ~tri_grid () = default;
+
+  // Range [BEGIN, END) of m_tri holding the candidate triangles for the
+  // point (XT, YT).  The range is empty if the point is outside of all
+  // bounding boxes.
+
+  void candidates (double xt, double yt, const octave_idx_type *& begin,
+                   const octave_idx_type *& end) const
+  {
+    begin = end = m_tri.data ();
+
+    if (m_nx == 0 || ! (xt >= m_xmin && xt <= m_xmax
+                        && yt >= m_ymin && yt <= m_ymax))
+      return;
+
+    octave_idx_type c = ycell (yt) * m_nx + xcell (xt);
+
+    begin = m_tri.data () + m_start[c];
+    end = m_tri.data () + m_start[c+1];
+  }
+
+private:
+
+  octave_idx_type xcell (double v) const
+  {
+    octave_idx_type i = std::floor ((v - m_xmin) / m_dx);
+    return std::max<octave_idx_type> (0, std::min (i, m_nx - 1));
+  }
+
+  octave_idx_type ycell (double v) const
+  {
+    octave_idx_type i = std::floor ((v - m_ymin) / m_dy);
+    return std::max<octave_idx_type> (0, std::min (i, m_ny - 1));
+  }
+
+  octave_idx_type m_nx, m_ny;
+  double m_xmin, m_ymin, m_xmax, m_ymax;
+  double m_dx, m_dy;
+
+  // Cell C holds m_tri[m_start[C]] ... m_tri[m_start[C+1]-1].
+  std::vector<octave_idx_type> m_start;
+  std::vector<octave_idx_type> m_tri;
+};
+
+// For each triangle K and each vertex I, the triangle sharing the edge
+// opposite vertex I, or -1 if that edge is on the boundary.
+
+static std::vector<octave_idx_type>
+triangle_neighbors (const Matrix& elem)
+{
+  const octave_idx_type nelem = elem.rows ();
+
+  std::vector<octave_idx_type> nbr (3 * nelem, -1);
+
+  // (smaller vertex, larger vertex, 3*triangle + opposite vertex)
+  std::vector<std::tuple<double, double, octave_idx_type>> edges;
+  edges.reserve (3 * nelem);
+
+  for (octave_idx_type k = 0; k < nelem; k++)
+    for (int i = 0; i < 3; i++)
+      {
+        double v1 = elem(k, (i + 1) % 3);
+        double v2 = elem(k, (i + 2) % 3);
+        edges.emplace_back (std::min (v1, v2), std::max (v1, v2), 3*k + i);
+      }
+
+  std::sort (edges.begin (), edges.end ());
+
+  for (std::size_t e = 1; e < edges.size (); e++)
+    {
+      if (std::get<0> (edges[e]) == std::get<0> (edges[e-1])
+          && std::get<1> (edges[e]) == std::get<1> (edges[e-1]))
+        {
+          octave_idx_type a = std::get<2> (edges[e-1]);
+          octave_idx_type b = std::get<2> (edges[e]);
+          nbr[a] = b / 3;
+          nbr[b] = a / 3;
+        }
+    }
+
+  return nbr;
+}
 
 DEFUN (tsearch, args, ,
        doc: /* -*- texinfo -*-
@@ -96,11 +281,44 @@ convex hull, @var{idx} is NaN.
   const octave_idx_type np = xi.numel ();
   ColumnVector values (np);
 
+  // Index of the bounding boxes.
+  tri_grid grid (minx, maxx, miny, maxy);
+
+  // Adjacency for walking from the last triangle found.  Built on first
+  // use only.
+  std::vector<octave_idx_type> nbr;
+
   double x0 = 0.0, y0 = 0.0;
   double a11 = 0.0, a12 = 0.0, a21 = 0.0, a22 = 0.0, det = 0.0;
   double xt = 0.0, yt = 0.0;
   double dx1 = 0.0, dx2 = 0.0, c1 = 0.0, c2 = 0.0;
 
+  // Compute the barycentric coordinates of (xt,yt) with respect to
+  // triangle K and return true if the point is inside of it.
+
+  auto inside = [&] (octave_idx_type k) -> bool
+  {
+    x0  = REF (x, k, 0);
+    y0  = REF (y, k, 0);
+    a11 = REF (x, k, 1) - x0;
+    a12 = REF (y, k, 1) - y0;
+    a21 = REF (x, k, 2) - x0;
+    a22 = REF (y, k, 2) - y0;
+    det = a11 * a22 - a21 * a12;
+
+    // solve the system
+    dx1 = xt - x0;
+    dx2 = yt - y0;
+    c1 = (a22 * dx1 - a21 * dx2) / det;
+    c2 = (-a12 * dx1 + a11 * dx2) / det;
+
+    return (c1 >= -eps && c2 >= -eps && (c1 + c2) <= 1 + eps);
+  };
+
+  // Maximum number of steps to take when walking from the last triangle
+  // before falling back to the grid.
+  const int max_walk = 8;
+
   octave_idx_type k = nelem;   // k is more than just an index variable.
 
   for (octave_idx_type kp = 0; kp < np; kp++)   // for each point
@@ -123,38 +341,80 @@ convex hull, @var{idx} is NaN.
               values (kp) = k+1;
               continue;
             }
+
+          // Walk towards the point across the edge opposite the vertex
+          // with the most negative barycentric coordinate.
+
+          if (nbr.empty ())
+            nbr = triangle_neighbors (elem);
+
+          bool found = false;
+
+          for (int step = 0; step < max_walk; step++)
+            {
+              double c0 = 1 - c1 - c2;
+
+              if (math::isnan (c0))
+                break;
+
+              int v = (c0 < c1 ? (c0 < c2 ? 0 : 2) : (c1 < c2 ? 1 : 2));
+
+              k = nbr[3*k + v];
+
+              if (k < 0)
+                break;
+
+              if (inside (k))
+                {
+                  found = true;
+                  break;
+                }
+            }
+
+          if (found)
+            {
+              values (kp) = k+1;
+              continue;
+            }
+
+          k = nelem;
         }
 
-      // The point is not in the same triangle, so go through all triangles.
-      for (k = 0; k < nelem; k++)
+      // Test the triangles whose bounding boxes overlap the grid cell
+      // containing the point.  These are visited in increasing order so
+      // the result is the same as for an exhaustive search.
+
+      const octave_idx_type *pk = nullptr;
+      const octave_idx_type *pk_end = nullptr;
+
+      grid.candidates (xt, yt, pk, pk_end);
+
+      bool found = false;
+
+      for (; pk != pk_end; pk++)
         {
+          k = *pk;
+
           if (xt >= minx(k) && xt <= maxx(k) && yt >= miny(k) && yt <= maxy(k))
             {
               // Point is inside the triangle's bounding rectangle:
               // See if it's inside the triangle itself.
-              x0  = REF (x, k, 0);
-              y0  = REF (y, k, 0);
-              a11 = REF (x, k, 1) - x0;
-              a12 = REF (y, k, 1) - y0;
-              a21 = REF (x, k, 2) - x0;
-              a22 = REF (y, k, 2) - y0;
-              det = a11 * a22 - a21 * a12;
-
-              // solve the system
-              dx1 = xt - x0;
-              dx2 = yt - y0;
-              c1 = (a22 * dx1 - a21 * dx2) / det;
-              c2 = (-a12 * dx1 + a11 * dx2) / det;
-              if (c1 >= -eps && c2 >= -eps && (c1 + c2) <= 1 + eps)
+              if (inside (k))
                 {
                   values (kp) = k+1;
+                  found = true;
                   break;
                 }
             } //end see if it's inside the triangle itself
-        } //end for each triangle
+        } //end for each candidate triangle
 
-      if (k == nelem)
-        values (kp) = lo_ieee_nan_value ();
+      if (! found)
+        {
+          values (kp) = lo_ieee_nan_value ();
+          k = nelem;
+        }
+
+      octave_quit ();
 
     } //end for each point
 
@@ -172,6 +432,44 @@ convex hull, @var{idx} is NaN.
 %!assert (tsearch (x,y,tri,-1/3, -1/3), 1)
 %!assert (tsearch (x,y,tri, 1, 1), NaN)
 
+## Compare with an exhaustive search on a larger mesh
+%!testif HAVE_QHULL
+%! x = rand (200, 1);
+%! y = rand (200, 1);
+%! tri = delaunay (x, y);
+%! xi = [rand(100, 1); 2];
+%! yi = [rand(100, 1); 2];
+%! idx = tsearch (x, y, tri, xi, yi);
+%! for i = 1:numel (xi)
+%!   inside = false (rows (tri), 1);
+%!   for k = 1:rows (tri)
+%!     v = tri(k,:);
+%!     b = [x(v).'; y(v).'; 1 1 1] \ [xi(i); yi(i); 1];
+%!     inside(k) = all (b >= -1e-12);
+%!   endfor
+%!   if (any (inside))
+%!     assert (idx(i), find (inside, 1));
+%!   else
+%!     assert (idx(i), NaN);
+%!   endif
+%! endfor
+
+## Points sampled along a path use the walking search
+%!testif HAVE_QHULL
+%! [x, y] = meshgrid (0:0.1:1);
+%! x = x(:);  y = y(:);
+%! tri = delaunay (x, y);
+%! t = linspace (0.05, 0.95, 500).';
+%! xi = t;
+%! yi = 0.5 + 0.4 * sin (2*pi*t);
+%! idx = tsearch (x, y, tri, xi, yi);
+%! assert (! any (isnan (idx)));
+%! for i = 1:numel (xi)
+%!   v = tri(idx(i),:);
+%!   b = [x(v).'; y(v).'; 1 1 1] \ [xi(i); yi(i); 1];
+%!   assert (all (b >= -1e-10));
+%! endfor
+
 %!error tsearch ()
 */
 
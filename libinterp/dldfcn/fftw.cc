@@ -28,17 +28,20 @@
 #endif
 
 #include <algorithm>
+#include <limits>
 #include <string>
 
 #if defined (HAVE_FFTW3_H)
 #  include <fftw3.h>
 #endif
 
+#include "lo-mappers.h"
 #include "oct-fftw.h"
 
 #include "defun-dld.h"
 #include "error.h"
 #include "errwarn.h"
+#include "oct-map.h"
 #include "ov.h"
 
 OCTAVE_BEGIN_NAMESPACE(octave)
@@ -51,6 +54,8 @@ DEFUN_DLD (fftw, args, ,
 @deftypefnx {} {} fftw ("dwisdom", @var{wisdom})
 @deftypefnx {} {@var{nthreads} =} fftw ("threads")
 @deftypefnx {} {} fftw ("threads", @var{nthreads})
+@deftypefnx {} {@var{stats} =} fftw ("cache")
+@deftypefnx {} {} fftw ("cache", @var{nplans})
 
 Manage @sc{fftw} wisdom data.
 
@@ -135,10 +140,35 @@ fftw ("threads", @var{NTHREADS})
 @end example
 
 Note that Octave must be compiled with multi-threaded @sc{fftw} support for
-this feature.  By default, the number of (logical) processors available to the
-current process or @var{3} is used (whichever is smaller).
+this feature.  By default, the value of @code{maxNumCompThreads ()} or
+@var{3} is used (whichever is smaller).  Setting @code{maxNumCompThreads}
+also sets the number of threads of @sc{fftw}.
 
-@seealso{fft, ifft, fft2, ifft2, fftn, ifftn}
+Plans are cached so that repeated transforms of the same size and layout do
+not need to be planned again.  Separate caches are kept for double and single
+precision transforms.  Each holds up to 16 plans by default and discards the
+least recently used plan when it is full.  The size of the caches can be set
+with
+
+@example
+fftw ("cache", @var{nplans})
+@end example
+
+@noindent
+and
+
+@example
+@var{stats} = fftw ("cache")
+@end example
+
+@noindent
+returns a structure with fields @qcode{"double"} and @qcode{"single"}.  Each
+of these is a structure with the fields @qcode{"capacity"}, @qcode{"plans"},
+@qcode{"hits"}, and @qcode{"misses"} which can be used to check whether a
+workload is replanning unnecessarily.  Changing the planner method or the
+number of threads clears the caches.
+
+@seealso{fft, ifft, fft2, ifft2, fftn, ifftn, maxNumCompThreads}
 @end deftypefn */)
 {
 #if defined (HAVE_FFTW)
@@ -326,6 +356,53 @@ current process or @var{3} is used (whichever is smaller).
         retval = 1;
 #endif
     }
+  else if (arg0 == "cache")
+    {
+      if (nargin == 2)  // cache size setter
+        {
+          if (! args(1).is_real_scalar ())
+            error ("fftw: setting cache size needs one integer argument");
+
+          double nplans = args(1).double_value ();
+          if (math::isnan (nplans) || nplans < 1)
+            error ("fftw: cache size must be >=1");
+
+          std::size_t n = (math::isinf (nplans)
+                           ? std::numeric_limits<std::size_t>::max ()
+                           : static_cast<std::size_t> (nplans));
+
+          fftw_planner::cache_size (n);
+          float_fftw_planner::cache_size (n);
+        }
+      else  // cache statistics getter
+        {
+          octave_scalar_map dstats;
+          dstats.setfield ("capacity",
+                           static_cast<double> (fftw_planner::cache_size ()));
+          dstats.setfield ("plans",
+                           static_cast<double> (fftw_planner::cached_plans ()));
+          dstats.setfield ("hits",
+                           static_cast<double> (fftw_planner::cache_hits ()));
+          dstats.setfield ("misses",
+                           static_cast<double> (fftw_planner::cache_misses ()));
+
+          octave_scalar_map sstats;
+          sstats.setfield ("capacity",
+                           static_cast<double> (float_fftw_planner::cache_size ()));
+          sstats.setfield ("plans",
+                           static_cast<double> (float_fftw_planner::cached_plans ()));
+          sstats.setfield ("hits",
+                           static_cast<double> (float_fftw_planner::cache_hits ()));
+          sstats.setfield ("misses",
+                           static_cast<double> (float_fftw_planner::cache_misses ()));
+
+          octave_scalar_map stats;
+          stats.setfield ("double", dstats);
+          stats.setfield ("single", sstats);
+
+          retval = stats;
+        }
+    }
   else
     error ("fftw: unrecognized argument");
 
@@ -389,6 +466,30 @@ current process or @var{3} is used (whichever is smaller).
 %!   fftw ("threads", n);
 %! end_unwind_protect
 
+%!testif HAVE_FFTW
+%! stats = fftw ("cache");
+%! n = stats.double.capacity;
+%! unwind_protect
+%!   fftw ("cache", 2);
+%!   x = rand (1, 17);
+%!   y = rand (1, 19);
+%!   xf = fft (x);
+%!   yf = fft (y);
+%!   before = fftw ("cache").double;
+%!   assert (before.capacity, 2);
+%!   assert (before.plans <= 2);
+%!   for i = 1:3
+%!     assert (fft (x), xf);
+%!     assert (fft (y), yf);
+%!   endfor
+%!   after = fftw ("cache").double;
+%!   assert (after.hits - before.hits, 6);
+%!   assert (after.misses, before.misses);
+%!   assert (fftw ("cache").single.capacity, 2);
+%! unwind_protect_cleanup
+%!   fftw ("cache", n);
+%! end_unwind_protect
+
 %!error <Invalid call to fftw|was unavailable or disabled> fftw ()
 %!error <Invalid call to fftw|was unavailable or disabled> fftw ("planner", "estimate", "measure")
 %!error fftw (3)
@@ -399,6 +500,8 @@ current process or @var{3} is used (whichever is smaller).
 %!error fftw ("swisdom", "invalid")
 %!error fftw ("threads", "invalid")
 %!error fftw ("threads", -3)
+%!error fftw ("cache", "invalid")
+%!error fftw ("cache", 0)
  */
 
 OCTAVE_END_NAMESPACE(octave)
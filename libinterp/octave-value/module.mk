@@ -26,6 +26,7 @@ OCTAVE_VALUE_INC = \
   %reldir%/cdef-package.h \
   %reldir%/cdef-property.h \
   %reldir%/cdef-utils.h \
+  %reldir%/ov-alloc.h \
   %reldir%/ov-base-diag.h \
   %reldir%/ov-base-mat.h \
   %reldir%/ov-base-scalar.h \
@@ -99,6 +100,7 @@ OCTAVE_VALUE_SRC = \
   %reldir%/cdef-package.cc \
   %reldir%/cdef-property.cc \
   %reldir%/cdef-utils.cc \
+  %reldir%/ov-alloc.cc \
   %reldir%/ov-base.cc \
   %reldir%/ov-bool-mat.cc \
   %reldir%/ov-bool.cc \
@@ -0,0 +1,329 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "defun.h"
+#include "oct-map.h"
+#include "ov-alloc.h"
+#include "ovl.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Number of blocks allocated at once when a free list is empty.
+static const std::size_t slab_blocks = 512;
+
+void
+value_freelist_pool::lock () const
+{
+  while (m_lock.exchange (true, std::memory_order_acquire))
+    std::this_thread::yield ();
+}
+
+void
+value_freelist_pool::give (value_freelist_block *head,
+                           value_freelist_block *tail, std::size_t n)
+{
+  lock ();
+
+  tail->next = m_head;
+  m_head = head;
+  m_count += n;
+
+  unlock ();
+}
+
+value_freelist_block *
+value_freelist_pool::take (std::size_t& n)
+{
+  lock ();
+
+  value_freelist_block *retval = m_head;
+  n = m_count;
+
+  m_head = nullptr;
+  m_count = 0;
+
+  unlock ();
+
+  return retval;
+}
+
+std::size_t
+value_freelist_pool::count () const
+{
+  lock ();
+
+  std::size_t retval = m_count;
+
+  unlock ();
+
+  return retval;
+}
+
+// Set once the free lists of the thread have been retired.  Trivially
+// destructible, so that it can be read until the thread has exited.
+static thread_local bool s_thread_exiting = false;
+
+// The free lists used by a thread.  They are retired by the destructor
+// when the thread exits.
+
+class thread_freelists
+{
+public:
+
+  thread_freelists () = default;
+
+  OCTAVE_DISABLE_COPY_MOVE (thread_freelists)
+
+  ~thread_freelists ()
+  {
+    s_thread_exiting = true;
+
+    for (value_freelist *fl : m_lists)
+      fl->retire ();
+  }
+
+  void add (value_freelist *fl) { m_lists.push_back (fl); }
+
+private:
+
+  std::vector<value_freelist *> m_lists;
+};
+
+void
+value_freelist::retire ()
+{
+  m_state = retired;
+
+  if (! m_head)
+    return;
+
+  block *tail = m_head;
+
+  while (tail->next)
+    tail = tail->next;
+
+  m_pool.give (m_head, tail, m_available);
+
+  m_head = nullptr;
+  m_available = 0;
+}
+
+bool
+value_freelist::enlist ()
+{
+  if (m_state == unlisted)
+    {
+      // A list first used after the lists of the thread were retired.
+      if (s_thread_exiting)
+        m_state = retired;
+      else
+        {
+          static thread_local thread_freelists lists;
+
+          lists.add (this);
+          m_state = listed;
+        }
+    }
+
+  return m_state == listed;
+}
+
+void
+value_freelist::refill ()
+{
+  std::size_t n;
+
+  m_head = m_pool.take (n);
+
+  if (m_head)
+    {
+      m_available += n;
+      return;
+    }
+
+  char *slab = static_cast<char *> (::operator new (slab_blocks * m_size));
+
+  for (std::size_t i = slab_blocks; i-- > 0; )
+    {
+      block *b = reinterpret_cast<block *> (slab + i * m_size);
+      b->next = m_head;
+      m_head = b;
+    }
+
+  m_available += slab_blocks;
+  m_slabs++;
+}
+
+// Move the blocks above half of the maximum to the shared list, so that
+// a thread that frees many objects allocated by others does not keep
+// them.
+
+void
+value_freelist::trim ()
+{
+  std::size_t n = m_available - max_available / 2;
+
+  block *head = m_head;
+  block *tail = m_head;
+
+  for (std::size_t i = 1; i < n; i++)
+    tail = tail->next;
+
+  m_head = tail->next;
+  m_available -= n;
+
+  m_pool.give (head, tail, n);
+}
+
+value_freelist::counters
+value_freelist::get_counters () const
+{
+  counters retval;
+
+  retval.allocated = m_allocated;
+  retval.freed = m_freed;
+  retval.slabs = m_slabs;
+  retval.available = m_available;
+  retval.block_size = m_size;
+  retval.shared = m_pool.count ();
+
+  return retval;
+}
+
+static std::mutex&
+freelist_registry_mutex ()
+{
+  static std::mutex mtx;
+  return mtx;
+}
+
+static std::map<std::string, value_freelist_counters_fcn>&
+freelist_registry ()
+{
+  static std::map<std::string, value_freelist_counters_fcn> registry;
+  return registry;
+}
+
+value_freelist_registrar::value_freelist_registrar
+  (const char *name, value_freelist_counters_fcn fcn)
+{
+  std::lock_guard<std::mutex> lock (freelist_registry_mutex ());
+
+  freelist_registry ()[name] = fcn;
+}
+
+DEFUN (__value_pool_stats__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{stats} =} __value_pool_stats__ ()
+Return allocation counters for the free lists used for scalar values.
+
+@var{stats} is a structure with one field for each value type that uses a
+free list.  Each field is a structure with the fields
+
+@table @asis
+@item @qcode{"allocated"}
+Number of objects allocated.
+
+@item @qcode{"freed"}
+Number of objects freed.
+
+@item @qcode{"slabs"}
+Number of times the free list was empty and a new slab of blocks had to be
+allocated.
+
+@item @qcode{"available"}
+Number of blocks currently on the free list.
+
+@item @qcode{"block_size"}
+Size of each block in bytes.
+
+@item @qcode{"shared"}
+Number of blocks on the list shared by all threads.  Threads move blocks
+there when they exit or when their own list grows too long.
+@end table
+
+The counters are those of the calling thread, except for
+@qcode{"shared"}.
+@end deftypefn */)
+{
+  if (args.length () != 0)
+    print_usage ();
+
+  octave_scalar_map retval;
+
+  std::lock_guard<std::mutex> lock (freelist_registry_mutex ());
+
+  for (const auto& name_fcn : freelist_registry ())
+    {
+      value_freelist::counters c = name_fcn.second ();
+
+      octave_scalar_map m;
+
+      m.setfield ("allocated", static_cast<double> (c.allocated));
+      m.setfield ("freed", static_cast<double> (c.freed));
+      m.setfield ("slabs", static_cast<double> (c.slabs));
+      m.setfield ("available", static_cast<double> (c.available));
+      m.setfield ("block_size", static_cast<double> (c.block_size));
+      m.setfield ("shared", static_cast<double> (c.shared));
+
+      retval.setfield (name_fcn.first, m);
+    }
+
+  return ovl (retval);
+}
+
+/*
+%!test
+%! s0 = __value_pool_stats__ ();
+%! assert (isfield (s0, {"octave_scalar", "octave_float_scalar", "octave_bool", "octave_complex", "octave_float_complex", "octave_int32_scalar"}));
+%! x = 0;
+%! for i = 1:100
+%!   x = x + 1;
+%! endfor
+%! s1 = __value_pool_stats__ ();
+%! assert (s1.octave_scalar.allocated > s0.octave_scalar.allocated);
+%! assert (s1.octave_scalar.freed > s0.octave_scalar.freed);
+
+## The free list of a thread is bounded
+%!test
+%! c = num2cell (1:1e4);
+%! clear c;
+%! s = __value_pool_stats__ ();
+%! assert (s.octave_scalar.available <= 4096);
+
+%!error __value_pool_stats__ (1)
+*/
+
+OCTAVE_END_NAMESPACE(octave)
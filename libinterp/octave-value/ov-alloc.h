@@ -0,0 +1,281 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_ov_alloc_h)
+#define octave_ov_alloc_h 1
+
+#include "octave-config.h"
+
+#include <atomic>
+#include <cstddef>
+
+#include <new>
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Free list allocator for the small value representations that are
+// created and destroyed for nearly every scalar operation.
+//
+// Each type using DECLARE_OV_ALLOCATOR gets one free list per thread, so
+// allocating and freeing usually never takes a lock.  Blocks are carved
+// out of larger slabs that are never returned to the system.  An object
+// freed by a different thread than the one that allocated it simply joins
+// the free list of the freeing thread.
+//
+// A thread keeps at most max_available blocks on its free list.  Further
+// blocks, and the whole list of a thread that exits, are moved to a
+// shared list for the type, from which any thread refills its list
+// before it allocates a new slab.  The memory used for a type is thus
+// bounded by the largest number of its objects that existed at once.
+//
+// The free lists are trivially destructible thread_local objects, so they
+// remain usable until the thread has exited.  Objects may still be freed
+// after the thread_local destructors of the thread have run.  That
+// happens for the main thread, whose thread_local objects are destroyed
+// before static objects such as the octave_value constants of builtin
+// functions.  When the thread exits its lists are retired instead, see
+// value_freelist::retire.
+
+struct value_freelist_block
+{
+  value_freelist_block *next;
+};
+
+// Blocks shared by the free lists of all threads for one type.  It is
+// trivially destructible and constant-initialized, so that threads may
+// use it at any time, even while the program exits.
+
+class
+OCTINTERP_API
+value_freelist_pool
+{
+public:
+
+  constexpr value_freelist_pool ()
+    : m_lock (false), m_head (nullptr), m_count (0)
+  { }
+
+  OCTAVE_DISABLE_COPY_MOVE (value_freelist_pool)
+
+  ~value_freelist_pool () = default;
+
+  // Add the N blocks starting at HEAD and ending at TAIL.
+  void give (value_freelist_block *head, value_freelist_block *tail,
+             std::size_t n);
+
+  // Take all blocks.  Sets N to their number.
+  value_freelist_block * take (std::size_t& n);
+
+  std::size_t count () const;
+
+private:
+
+  void lock () const;
+
+  void unlock () const { m_lock.store (false, std::memory_order_release); }
+
+  mutable std::atomic<bool> m_lock;
+
+  value_freelist_block *m_head;
+
+  std::size_t m_count;
+};
+
+class
+OCTINTERP_API
+value_freelist
+{
+public:
+
+  struct counters
+  {
+    // Objects allocated and freed through this free list.
+    std::size_t allocated = 0;
+    std::size_t freed = 0;
+
+    // Allocations that had to grab a new slab.
+    std::size_t slabs = 0;
+
+    // Blocks currently available on the free list.
+    std::size_t available = 0;
+
+    // Block size in bytes.
+    std::size_t block_size = 0;
+
+    // Blocks on the list shared by all threads.
+    std::size_t shared = 0;
+  };
+
+  // Maximum number of blocks on the free list of one thread.
+  static const std::size_t max_available = 4096;
+
+  constexpr value_freelist (std::size_t size, value_freelist_pool& pool)
+    : m_size (size < sizeof (block) ? sizeof (block) : size),
+      m_pool (pool), m_head (nullptr), m_allocated (0), m_freed (0),
+      m_slabs (0), m_available (0), m_state (unlisted)
+  { }
+
+  OCTAVE_DISABLE_COPY_MOVE (value_freelist)
+
+  ~value_freelist () = default;
+
+  void * alloc (std::size_t size)
+  {
+    // Derived classes that don't declare their own allocator end up
+    // here with a different size.
+    if (size > m_size)
+      return ::operator new (size);
+
+    if (! m_head)
+      {
+        if (! enlist ())
+          return ::operator new (m_size);
+
+        refill ();
+      }
+
+    block *b = m_head;
+    m_head = b->next;
+
+    m_available--;
+    m_allocated++;
+
+    return b;
+  }
+
+  void free (void *p, std::size_t size)
+  {
+    if (! p)
+      return;
+
+    if (size > m_size)
+      {
+        ::operator delete (p);
+        return;
+      }
+
+    block *b = static_cast<block *> (p);
+
+    if (m_state != listed && ! enlist ())
+      {
+        m_pool.give (b, b, 1);
+        return;
+      }
+
+    b->next = m_head;
+    m_head = b;
+
+    m_available++;
+    m_freed++;
+
+    if (m_available > max_available)
+      trim ();
+  }
+
+  counters get_counters () const;
+
+  // Move the remaining blocks to the shared list when the thread exits.
+  // Afterwards, freed blocks go straight to the shared list and new
+  // objects are allocated with operator new.
+  void retire ();
+
+private:
+
+  typedef value_freelist_block block;
+
+  enum state { unlisted, listed, retired };
+
+  // Make sure that the list is retired when the thread exits.  Returns
+  // false if it is already retired.
+  bool enlist ();
+
+  void refill ();
+
+  void trim ();
+
+  std::size_t m_size;
+
+  value_freelist_pool& m_pool;
+
+  block *m_head;
+
+  std::size_t m_allocated;
+  std::size_t m_freed;
+  std::size_t m_slabs;
+  std::size_t m_available;
+
+  state m_state;
+};
+
+typedef value_freelist::counters (*value_freelist_counters_fcn) ();
+
+// Make the counters of the free list for type NAME visible to
+// __value_pool_stats__.
+
+class
+OCTINTERP_API
+value_freelist_registrar
+{
+public:
+
+  value_freelist_registrar (const char *name,
+                            value_freelist_counters_fcn fcn);
+
+  OCTAVE_DISABLE_COPY_MOVE (value_freelist_registrar)
+
+  ~value_freelist_registrar () = default;
+};
+
+OCTAVE_END_NAMESPACE(octave)
+
+// Use a per-thread free list for objects of this class.  Must be paired
+// with DEFINE_OV_ALLOCATOR in the source file for the class.
+
+#define DECLARE_OV_ALLOCATOR                                    \
+  public:                                                       \
+    static void * operator new (std::size_t size);              \
+    static void operator delete (void *p, std::size_t size);    \
+    static octave::value_freelist::counters allocator_counters ();
+
+#define DEFINE_OV_ALLOCATOR(t)                                          \
+  static octave::value_freelist_pool t ## _freelist_pool;               \
+  static thread_local octave::value_freelist                            \
+  t ## _freelist (sizeof (t), t ## _freelist_pool);                     \
+  void * t::operator new (std::size_t size)                             \
+  {                                                                     \
+    return t ## _freelist.alloc (size);                                 \
+  }                                                                     \
+  void t::operator delete (void *p, std::size_t size)                   \
+  {                                                                     \
+    t ## _freelist.free (p, size);                                      \
+  }                                                                     \
+  octave::value_freelist::counters t::allocator_counters ()             \
+  {                                                                     \
+    return t ## _freelist.get_counters ();                              \
+  }                                                                     \
+  static octave::value_freelist_registrar                               \
+  t ## _freelist_registrar (#t, t::allocator_counters)
+
+#endif
@@ -133,6 +133,9 @@ public:
   Array<octave_idx_type> sort_rows_idx (sortmode mode = ASCENDING) const
   { return to_dense ().sort_rows_idx (mode); }
 
+  Array<octave_idx_type> sort_rows_idx (const Array<bool>& desc) const
+  { return to_dense ().sort_rows_idx (desc); }
+
   sortmode is_sorted_rows (sortmode mode = UNSORTED) const
   { return to_dense ().is_sorted_rows (mode); }
 
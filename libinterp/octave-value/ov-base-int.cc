@@ -451,14 +451,8 @@ octave_base_int_matrix<T>::save_hdf5_internal (octave_hdf5_id loc_id,
   space_hid = H5Screate_simple (rank, hdims, nullptr);
 
   if (space_hid < 0) return false;
-#if defined (HAVE_HDF5_18)
-  data_hid = H5Dcreate (loc_id, name, save_type_hid, space_hid,
-                        octave_H5P_DEFAULT, octave_H5P_DEFAULT,
-                        octave_H5P_DEFAULT);
-#else
-  data_hid = H5Dcreate (loc_id, name, save_type_hid, space_hid,
-                        octave_H5P_DEFAULT);
-#endif
+  data_hid = hdf5_create_dataset (loc_id, name, save_type_hid, space_hid,
+                                  dv);
   if (data_hid < 0)
     {
       H5Sclose (space_hid);
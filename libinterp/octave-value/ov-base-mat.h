@@ -159,6 +159,9 @@ public:
   Array<octave_idx_type> sort_rows_idx (sortmode mode = ASCENDING) const
   { return m_matrix.sort_rows_idx (mode); }
 
+  Array<octave_idx_type> sort_rows_idx (const Array<bool>& desc) const
+  { return m_matrix.sort_rows_idx (desc); }
+
   sortmode is_sorted_rows (sortmode mode = UNSORTED) const
   { return m_matrix.is_sorted_rows (mode); }
 
@@ -128,6 +128,12 @@ public:
                                    static_cast<octave_idx_type> (0));
   }
 
+  Array<octave_idx_type> sort_rows_idx (const Array<bool>&) const
+  {
+    return Array<octave_idx_type> (dim_vector (1, 1),
+                                   static_cast<octave_idx_type> (0));
+  }
+
   sortmode is_sorted_rows (sortmode mode = UNSORTED) const
   { return mode == UNSORTED ? ASCENDING : mode; }
 
@@ -1099,6 +1099,12 @@ octave_base_value::sort_rows_idx (sortmode) const
   err_wrong_type_arg ("octave_base_value::sort_rows_idx ()", type_name ());
 }
 
+Array<octave_idx_type>
+octave_base_value::sort_rows_idx (const Array<bool>&) const
+{
+  err_wrong_type_arg ("octave_base_value::sort_rows_idx ()", type_name ());
+}
+
 sortmode
 octave_base_value::is_sorted_rows (sortmode) const
 {
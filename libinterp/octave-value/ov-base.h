@@ -790,6 +790,9 @@ public:
   virtual Array<octave_idx_type>
   sort_rows_idx (sortmode mode = ASCENDING) const;
 
+  virtual Array<octave_idx_type>
+  sort_rows_idx (const Array<bool>& desc) const;
+
   virtual sortmode is_sorted_rows (sortmode mode = UNSORTED) const;
 
   virtual void lock ();
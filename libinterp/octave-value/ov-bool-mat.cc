@@ -447,14 +447,8 @@ octave_bool_matrix::save_hdf5 (octave_hdf5_id loc_id, const char *name,
 
   space_hid = H5Screate_simple (rank, hdims, nullptr);
   if (space_hid < 0) return false;
-#if defined (HAVE_HDF5_18)
-  data_hid = H5Dcreate (loc_id, name, H5T_NATIVE_HBOOL, space_hid,
-                        octave_H5P_DEFAULT, octave_H5P_DEFAULT,
-                        octave_H5P_DEFAULT);
-#else
-  data_hid = H5Dcreate (loc_id, name, H5T_NATIVE_HBOOL, space_hid,
-                        octave_H5P_DEFAULT);
-#endif
+  data_hid = hdf5_create_dataset (loc_id, name, H5T_NATIVE_HBOOL, space_hid,
+                                  dv);
   if (data_hid < 0)
     {
       H5Sclose (space_hid);
@@ -38,6 +38,7 @@
 #include "str-vec.h"
 
 #include "oct-stream.h"
+#include "ov-alloc.h"
 #include "ov-base.h"
 #include "ov-base-scalar.h"
 #include "ov-bool-mat.h"
@@ -258,6 +259,8 @@ public:
 
 private:
 
+  DECLARE_OV_ALLOCATOR
+
   DECLARE_OV_TYPEID_FUNCTIONS_AND_DATA
 };
 
@@ -543,6 +543,21 @@ octave_cell::sort_rows_idx (sortmode mode) const
   return retval;
 }
 
+Array<octave_idx_type>
+octave_cell::sort_rows_idx (const Array<bool>& desc) const
+{
+  Array<octave_idx_type> retval;
+
+  if (! iscellstr ())
+    error ("sortrows: only cell arrays of character strings may be sorted");
+
+  Array<std::string> tmp = cellstr_value ();
+
+  retval = tmp.sort_rows_idx (desc);
+
+  return retval;
+}
+
 sortmode
 octave_cell::is_sorted_rows (sortmode mode) const
 {
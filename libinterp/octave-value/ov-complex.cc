@@ -65,6 +65,8 @@ template class octave_base_scalar<Complex>;
 DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA (octave_complex,
                                      "complex scalar", "double");
 
+DEFINE_OV_ALLOCATOR (octave_complex);
+
 OCTAVE_BEGIN_NAMESPACE(octave)
 
 // Complain if a complex value is used as a subscript.
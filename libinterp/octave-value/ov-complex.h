@@ -39,6 +39,7 @@
 
 #include "errwarn.h"
 #include "error.h"
+#include "ov-alloc.h"
 #include "ov-base.h"
 #include "ov-cx-mat.h"
 #include "ov-base-scalar.h"
@@ -206,6 +207,8 @@ public:
 
 private:
 
+  DECLARE_OV_ALLOCATOR
+
   DECLARE_OV_TYPEID_FUNCTIONS_AND_DATA
 };
 
@@ -64,6 +64,8 @@ template class octave_base_scalar<float>;
 DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA (octave_float_scalar, "float scalar",
                                      "single");
 
+DEFINE_OV_ALLOCATOR (octave_float_scalar);
+
 octave_value
 octave_float_scalar::do_index_op (const octave_value_list& idx, bool resize_ok)
 {
@@ -40,6 +40,7 @@
 #include "str-vec.h"
 
 #include "errwarn.h"
+#include "ov-alloc.h"
 #include "ov-base.h"
 #include "ov-re-mat.h"
 #include "ov-flt-re-mat.h"
@@ -275,6 +276,8 @@ public:
 
 private:
 
+  DECLARE_OV_ALLOCATOR
+
   DECLARE_OV_TYPEID_FUNCTIONS_AND_DATA
 };
 
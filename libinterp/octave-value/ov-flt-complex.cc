@@ -63,6 +63,8 @@ template class octave_base_scalar<FloatComplex>;
 DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA (octave_float_complex,
                                      "float complex scalar", "single");
 
+DEFINE_OV_ALLOCATOR (octave_float_complex);
+
 octave_base_value *
 octave_float_complex::try_narrowing_conversion ()
 {
@@ -39,6 +39,7 @@
 
 #include "errwarn.h"
 #include "error.h"
+#include "ov-alloc.h"
 #include "ov-base.h"
 #include "ov-flt-cx-mat.h"
 #include "ov-base-scalar.h"
@@ -197,6 +198,8 @@ public:
 
 private:
 
+  DECLARE_OV_ALLOCATOR
+
   DECLARE_OV_TYPEID_FUNCTIONS_AND_DATA
 };
 
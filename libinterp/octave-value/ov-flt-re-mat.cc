@@ -617,14 +617,8 @@ octave_float_matrix::save_hdf5 (octave_hdf5_id loc_id, const char *name, bool)
           = save_type_to_hdf5 (octave::get_save_type (max_val, min_val));
     }
 #endif
-#if defined (HAVE_HDF5_18)
-  data_hid = H5Dcreate (loc_id, name, save_type_hid, space_hid,
-                        octave_H5P_DEFAULT, octave_H5P_DEFAULT,
-                        octave_H5P_DEFAULT);
-#else
-  data_hid = H5Dcreate (loc_id, name, save_type_hid, space_hid,
-                        octave_H5P_DEFAULT);
-#endif
+  data_hid = hdf5_create_dataset (loc_id, name, save_type_hid, space_hid,
+                                  dv);
   if (data_hid < 0)
     {
       H5Sclose (space_hid);
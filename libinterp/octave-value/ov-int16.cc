@@ -77,3 +77,5 @@ template class octave_base_int_scalar<octave_int16>;
 
 DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA (octave_int16_scalar,
                                      "int16 scalar", "int16");
+
+DEFINE_OV_ALLOCATOR (octave_int16_scalar);
@@ -77,3 +77,5 @@ template class octave_base_int_scalar<octave_int32>;
 
 DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA (octave_int32_scalar,
                                      "int32 scalar", "int32");
+
+DEFINE_OV_ALLOCATOR (octave_int32_scalar);
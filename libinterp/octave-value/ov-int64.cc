@@ -77,3 +77,5 @@ template class octave_base_int_scalar<octave_int64>;
 
 DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA (octave_int64_scalar,
                                      "int64 scalar", "int64");
+
+DEFINE_OV_ALLOCATOR (octave_int64_scalar);
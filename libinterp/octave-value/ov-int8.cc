@@ -77,3 +77,5 @@ template class octave_base_int_scalar<octave_int8>;
 
 DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA (octave_int8_scalar,
                                      "int8 scalar", "int8");
+
+DEFINE_OV_ALLOCATOR (octave_int8_scalar);
@@ -41,6 +41,7 @@
 #include "error.h"
 #include "mxarray.h"
 #include "oct-stream.h"
+#include "ov-alloc.h"
 #include "ov-base.h"
 #include "ov-base-int.h"
 #include "ov-typeinfo.h"
@@ -696,5 +697,7 @@ private:
 
   static octave_hdf5_id s_hdf5_save_type;
 
+  DECLARE_OV_ALLOCATOR
+
   DECLARE_OV_TYPEID_FUNCTIONS_AND_DATA
 };
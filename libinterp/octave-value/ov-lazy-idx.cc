@@ -154,6 +154,12 @@ octave_lazy_index::sort_rows_idx (sortmode mode) const
   return m_index.as_array ().sort_rows_idx (mode);
 }
 
+Array<octave_idx_type>
+octave_lazy_index::sort_rows_idx (const Array<bool>& desc) const
+{
+  return m_index.as_array ().sort_rows_idx (desc);
+}
+
 sortmode
 octave_lazy_index::is_sorted_rows (sortmode mode) const
 {
@@ -126,6 +126,8 @@ public:
 
   Array<octave_idx_type> sort_rows_idx (sortmode mode = ASCENDING) const;
 
+  Array<octave_idx_type> sort_rows_idx (const Array<bool>& desc) const;
+
   sortmode is_sorted_rows (sortmode mode = UNSORTED) const;
 
   bool is_matrix_type () const { return true; }
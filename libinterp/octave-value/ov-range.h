@@ -308,6 +308,11 @@ public:
     return Array<octave_idx_type> (dim_vector (1, 0));
   }
 
+  Array<octave_idx_type> sort_rows_idx (const Array<bool>&) const
+  {
+    return Array<octave_idx_type> (dim_vector (1, 0));
+  }
+
   sortmode is_sorted_rows (sortmode mode = UNSORTED) const
   {
     return (mode == UNSORTED) ? ASCENDING : mode;
@@ -414,6 +414,15 @@ octave_matrix::sort_rows_idx (sortmode mode) const
     return octave_base_matrix<NDArray>::sort_rows_idx (mode);
 }
 
+Array<octave_idx_type>
+octave_matrix::sort_rows_idx (const Array<bool>& desc) const
+{
+  if (m_idx_cache)
+    return octave_lazy_index (*m_idx_cache).sort_rows_idx (desc);
+  else
+    return octave_base_matrix<NDArray>::sort_rows_idx (desc);
+}
+
 sortmode
 octave_matrix::is_sorted_rows (sortmode mode) const
 {
@@ -743,14 +752,8 @@ octave_matrix::save_hdf5 (octave_hdf5_id loc_id, const char *name,
     }
 #endif
 
-#if defined (HAVE_HDF5_18)
-  data_hid = H5Dcreate (loc_id, name, save_type_hid, space_hid,
-                        octave_H5P_DEFAULT, octave_H5P_DEFAULT,
-                        octave_H5P_DEFAULT);
-#else
-  data_hid = H5Dcreate (loc_id, name, save_type_hid, space_hid,
-                        octave_H5P_DEFAULT);
-#endif
+  data_hid = hdf5_create_dataset (loc_id, name, save_type_hid, space_hid,
+                                  dv);
   if (data_hid < 0)
     {
       H5Sclose (space_hid);
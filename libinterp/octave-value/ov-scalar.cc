@@ -68,6 +68,8 @@ template class octave_base_scalar<double>;
 
 DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA (octave_scalar, "scalar", "double");
 
+DEFINE_OV_ALLOCATOR (octave_scalar);
+
 static octave_base_value *
 default_numeric_demotion_function (const octave_base_value& a)
 {
@@ -40,6 +40,7 @@
 #include "str-vec.h"
 
 #include "errwarn.h"
+#include "ov-alloc.h"
 #include "ov-base.h"
 #include "ov-re-mat.h"
 #include "ov-base-scalar.h"
@@ -288,6 +289,8 @@ public:
 
 private:
 
+  DECLARE_OV_ALLOCATOR
+
   DECLARE_OV_TYPEID_FUNCTIONS_AND_DATA
 };
 
@@ -264,6 +264,16 @@ public:
   bool isfield (const std::string& field_name) const
   { return m_map.isfield (field_name); }
 
+  // Direct field access for the bytecode interpreter, which keeps a
+  // field index cache for each instruction that refers to a field.
+  octave_value getfield (const std::string& key,
+                         octave_field_cache& cache) const
+  { return m_map.getfield (key, cache); }
+
+  void setfield (const std::string& key, const octave_value& val,
+                 octave_field_cache& cache)
+  { m_map.setfield (key, val, cache); }
+
   void print (std::ostream& os, bool pr_as_read_syntax = false);
 
   void print_raw (std::ostream& os, bool pr_as_read_syntax = false) const;
@@ -78,3 +78,5 @@ template class octave_base_int_scalar<octave_uint16>;
 
 DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA (octave_uint16_scalar,
                                      "uint16 scalar", "uint16");
+
+DEFINE_OV_ALLOCATOR (octave_uint16_scalar);
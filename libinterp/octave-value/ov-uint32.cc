@@ -77,3 +77,5 @@ template class octave_base_int_scalar<octave_uint32>;
 
 DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA (octave_uint32_scalar,
                                      "uint32 scalar", "uint32");
+
+DEFINE_OV_ALLOCATOR (octave_uint32_scalar);
@@ -1425,6 +1425,9 @@ public:
   Array<octave_idx_type> sort_rows_idx (sortmode mode = ASCENDING) const
   { return m_rep->sort_rows_idx (mode); }
 
+  Array<octave_idx_type> sort_rows_idx (const Array<bool>& desc) const
+  { return m_rep->sort_rows_idx (desc); }
+
   sortmode is_sorted_rows (sortmode mode = UNSORTED) const
   { return m_rep->is_sorted_rows (mode); }
 
@@ -88,6 +88,9 @@ DEFBINOP (ldiv, sparse_complex_matrix, matrix)
     }
 }
 
+DEFBINOP_FN (trans_mul, sparse_complex_matrix, matrix, trans_mul);
+DEFBINOP_FN (herm_mul, sparse_complex_matrix, matrix, herm_mul);
+
 DEFBINOP_FN (lt, sparse_complex_matrix, matrix, mx_el_lt)
 DEFBINOP_FN (le, sparse_complex_matrix, matrix, mx_el_le)
 DEFBINOP_FN (eq, sparse_complex_matrix, matrix, mx_el_eq)
@@ -142,6 +145,10 @@ install_scm_m_ops (octave::type_info& ti)
   INSTALL_BINOP_TI (ti, op_pow, octave_sparse_complex_matrix, octave_matrix, pow);
   INSTALL_BINOP_TI (ti, op_ldiv, octave_sparse_complex_matrix, octave_matrix,
                     ldiv);
+  INSTALL_BINOP_TI (ti, op_trans_mul, octave_sparse_complex_matrix,
+                    octave_matrix, trans_mul);
+  INSTALL_BINOP_TI (ti, op_herm_mul, octave_sparse_complex_matrix,
+                    octave_matrix, herm_mul);
   INSTALL_BINOP_TI (ti, op_lt, octave_sparse_complex_matrix, octave_matrix, lt);
   INSTALL_BINOP_TI (ti, op_le, octave_sparse_complex_matrix, octave_matrix, le);
   INSTALL_BINOP_TI (ti, op_eq, octave_sparse_complex_matrix, octave_matrix, eq);
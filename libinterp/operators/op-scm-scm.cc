@@ -116,6 +116,11 @@ DEFBINOP (ldiv, sparse_complex_matrix, sparse_complex_matrix)
     }
 }
 
+DEFBINOP_FN (trans_mul, sparse_complex_matrix, sparse_complex_matrix,
+             trans_mul);
+DEFBINOP_FN (herm_mul, sparse_complex_matrix, sparse_complex_matrix,
+             herm_mul);
+
 DEFBINOP_FN (lt, sparse_complex_matrix, sparse_complex_matrix, mx_el_lt)
 DEFBINOP_FN (le, sparse_complex_matrix, sparse_complex_matrix, mx_el_le)
 DEFBINOP_FN (eq, sparse_complex_matrix, sparse_complex_matrix, mx_el_eq)
@@ -166,6 +171,10 @@ install_scm_scm_ops (octave::type_info& ti)
                     octave_sparse_complex_matrix, pow);
   INSTALL_BINOP_TI (ti, op_ldiv, octave_sparse_complex_matrix,
                     octave_sparse_complex_matrix, ldiv);
+  INSTALL_BINOP_TI (ti, op_trans_mul, octave_sparse_complex_matrix,
+                    octave_sparse_complex_matrix, trans_mul);
+  INSTALL_BINOP_TI (ti, op_herm_mul, octave_sparse_complex_matrix,
+                    octave_sparse_complex_matrix, herm_mul);
   INSTALL_BINOP_TI (ti, op_lt, octave_sparse_complex_matrix,
                     octave_sparse_complex_matrix, lt);
   INSTALL_BINOP_TI (ti, op_le, octave_sparse_complex_matrix,
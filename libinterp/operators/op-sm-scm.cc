@@ -91,6 +91,8 @@ DEFBINOP (ldiv, sparse_matrix, sparse_complex_matrix)
     }
 }
 
+DEFBINOP_FN (trans_mul, sparse_matrix, sparse_complex_matrix, trans_mul);
+
 DEFBINOP_FN (lt, sparse_matrix, sparse_complex_matrix, mx_el_lt)
 DEFBINOP_FN (le, sparse_matrix, sparse_complex_matrix, mx_el_le)
 DEFBINOP_FN (eq, sparse_matrix, sparse_complex_matrix, mx_el_eq)
@@ -143,6 +145,10 @@ install_sm_scm_ops (octave::type_info& ti)
   INSTALL_BINOP_TI (ti, op_ldiv, octave_sparse_matrix,
                     octave_sparse_complex_matrix,
                     ldiv);
+  INSTALL_BINOP_TI (ti, op_trans_mul, octave_sparse_matrix,
+                    octave_sparse_complex_matrix, trans_mul);
+  INSTALL_BINOP_TI (ti, op_herm_mul, octave_sparse_matrix,
+                    octave_sparse_complex_matrix, trans_mul);
   INSTALL_BINOP_TI (ti, op_lt, octave_sparse_matrix, octave_sparse_complex_matrix,
                     lt);
   INSTALL_BINOP_TI (ti, op_le, octave_sparse_matrix, octave_sparse_complex_matrix,
@@ -16,6 +16,7 @@ PARSE_TREE_INC = \
   %reldir%/pt-binop.h \
   %reldir%/pt-bp.h \
   %reldir%/pt-bytecode.h \
+  %reldir%/pt-bytecode-cache.h \
   %reldir%/pt-bytecode-walk.h \
   %reldir%/pt-bytecode-vm.h \
   %reldir%/pt-bytecode-vm-internal.h \
@@ -37,6 +38,7 @@ PARSE_TREE_INC = \
   %reldir%/pt-loop.h \
   %reldir%/pt-mat.h \
   %reldir%/pt-misc.h \
+  %reldir%/pt-parfor.h \
   %reldir%/pt-pr-code.h \
   %reldir%/pt-select.h \
   %reldir%/pt-spmd.h \
@@ -68,6 +70,7 @@ PARSE_TREE_SRC = \
   %reldir%/pt-assign.cc \
   %reldir%/pt-binop.cc \
   %reldir%/pt-bp.cc \
+  %reldir%/pt-bytecode-cache.cc \
   %reldir%/pt-bytecode-walk.cc \
   %reldir%/pt-bytecode-vm.cc \
   %reldir%/pt-cbinop.cc \
@@ -86,6 +89,7 @@ PARSE_TREE_SRC = \
   %reldir%/pt-loop.cc \
   %reldir%/pt-mat.cc \
   %reldir%/pt-misc.cc \
+  %reldir%/pt-parfor.cc \
   %reldir%/pt-pr-code.cc \
   %reldir%/pt-select.cc \
   %reldir%/pt-spmd.cc \
@@ -0,0 +1,1553 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "file-ops.h"
+#include "file-stat.h"
+#include "lo-hash.h"
+#include "lo-sysdep.h"
+#include "mach-info.h"
+#include "oct-env.h"
+#include "oct-syscalls.h"
+
+#include "interpreter-private.h"
+#include "interpreter.h"
+#include "ls-oct-binary.h"
+#include "ov-magic-int.h"
+#include "ov-null-mat.h"
+#include "ov-usr-fcn.h"
+#include "pt-all.h"
+#include "pt-bytecode-cache.h"
+#include "pt-bytecode.h"
+#include "pt-walk.h"
+#include "version.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Increment when the layout of the cache files changes.  Changes of the
+// bytecode itself are detected by bytecode_build_id.
+static const int bytecode_cache_format = 3;
+
+// The operands of each instruction, in the order of INSTR.  They are
+// used to check loaded bytecode, and their names and order are part of
+// the cache key.  One character per operand:
+//
+//   b  byte
+//   i  int
+//   s  slot, an unsigned short after WIDE, else a byte
+//   w  slot, unsigned short
+//   k  index into the constants, an unsigned short after WIDE, else a byte
+//   K  index into the constants, int
+//   j  jump target, unsigned short
+//   B  index into the binary operator caches, unsigned short
+//   F  index into the field caches, unsigned short
+//   *  a variable layout, checked by bytecode_checker::special_operands
+//
+// WIDE only widens the first operand of the next instruction.
+
+struct instr_layout
+{
+  INSTR m_op;
+  const char *m_name;
+  const char *m_operands;
+};
+
+#define INSTR_LAYOUT(op, operands) { INSTR::op, #op, operands }
+
+static constexpr instr_layout instr_layouts[] =
+{
+  INSTR_LAYOUT (POP, ""),
+  INSTR_LAYOUT (DUP, ""),
+  INSTR_LAYOUT (LOAD_CST, "k"),
+  INSTR_LAYOUT (MUL, "B"),
+  INSTR_LAYOUT (DIV, "B"),
+  INSTR_LAYOUT (ADD, "B"),
+  INSTR_LAYOUT (SUB, "B"),
+  INSTR_LAYOUT (RET, ""),
+  INSTR_LAYOUT (ASSIGN, "s"),
+  INSTR_LAYOUT (JMP_IF, "j"),
+  INSTR_LAYOUT (JMP, "j"),
+  INSTR_LAYOUT (JMP_IFN, "j"),
+  INSTR_LAYOUT (PUSH_SLOT_NARGOUT0, "s"),
+  INSTR_LAYOUT (LE, "B"),
+  INSTR_LAYOUT (LE_EQ, "B"),
+  INSTR_LAYOUT (GR, "B"),
+  INSTR_LAYOUT (GR_EQ, "B"),
+  INSTR_LAYOUT (EQ, "B"),
+  INSTR_LAYOUT (NEQ, "B"),
+  INSTR_LAYOUT (INDEX_ID_NARGOUT0, "sb"),
+  INSTR_LAYOUT (PUSH_SLOT_INDEXED, "s"),
+  INSTR_LAYOUT (POW, "B"),
+  INSTR_LAYOUT (LDIV, "B"),
+  INSTR_LAYOUT (EL_MUL, "B"),
+  INSTR_LAYOUT (EL_DIV, "B"),
+  INSTR_LAYOUT (EL_POW, "B"),
+  INSTR_LAYOUT (EL_AND, "B"),
+  INSTR_LAYOUT (EL_OR, "B"),
+  INSTR_LAYOUT (EL_LDIV, "B"),
+  INSTR_LAYOUT (NOT, ""),
+  INSTR_LAYOUT (UADD, ""),
+  INSTR_LAYOUT (USUB, ""),
+  INSTR_LAYOUT (TRANS, ""),
+  INSTR_LAYOUT (HERM, ""),
+  INSTR_LAYOUT (INCR_ID_PREFIX, "s"),
+  INSTR_LAYOUT (DECR_ID_PREFIX, "s"),
+  INSTR_LAYOUT (INCR_ID_POSTFIX, "s"),
+  INSTR_LAYOUT (DECR_ID_POSTFIX, "s"),
+  INSTR_LAYOUT (FOR_SETUP, ""),
+  INSTR_LAYOUT (FOR_COND, "sj"),
+  INSTR_LAYOUT (POP_N_INTS, "b"),
+  INSTR_LAYOUT (PUSH_SLOT_NARGOUT1, "s"),
+  INSTR_LAYOUT (INDEX_ID_NARGOUT1, "sb"),
+  INSTR_LAYOUT (PUSH_FCN_HANDLE, "s"),
+  INSTR_LAYOUT (COLON3, ""),
+  INSTR_LAYOUT (COLON2, ""),
+  INSTR_LAYOUT (COLON3_CMD, ""),
+  INSTR_LAYOUT (COLON2_CMD, ""),
+  INSTR_LAYOUT (PUSH_TRUE, ""),
+  INSTR_LAYOUT (PUSH_FALSE, ""),
+  INSTR_LAYOUT (UNARY_TRUE, ""),
+  INSTR_LAYOUT (INDEX_IDN, "sbb"),
+  INSTR_LAYOUT (ASSIGNN, "*"),
+  INSTR_LAYOUT (PUSH_SLOT_NARGOUTN, "sb"),
+  INSTR_LAYOUT (SUBASSIGN_ID, "sb"),
+  INSTR_LAYOUT (END_ID, "sbb"),
+  INSTR_LAYOUT (MATRIX, "bb"),
+  INSTR_LAYOUT (TRANS_MUL, ""),
+  INSTR_LAYOUT (MUL_TRANS, ""),
+  INSTR_LAYOUT (HERM_MUL, ""),
+  INSTR_LAYOUT (MUL_HERM, ""),
+  INSTR_LAYOUT (TRANS_LDIV, ""),
+  INSTR_LAYOUT (HERM_LDIV, ""),
+  INSTR_LAYOUT (WORDCMD, "sbb"),
+  INSTR_LAYOUT (HANDLE_SIGNALS, ""),
+  INSTR_LAYOUT (PUSH_CELL, ""),
+  INSTR_LAYOUT (PUSH_OV_U64, ""),
+  INSTR_LAYOUT (EXPAND_CS_LIST, ""),
+  INSTR_LAYOUT (INDEX_CELL_ID_NARGOUT0, "sb"),
+  INSTR_LAYOUT (INDEX_CELL_ID_NARGOUT1, "sb"),
+  INSTR_LAYOUT (INDEX_CELL_ID_NARGOUTN, "sbb"),
+  INSTR_LAYOUT (INCR_PREFIX, ""),
+  INSTR_LAYOUT (ROT, ""),
+  INSTR_LAYOUT (GLOBAL_INIT, "*"),
+  INSTR_LAYOUT (ASSIGN_COMPOUND, "sb"),
+  INSTR_LAYOUT (JMP_IFDEF, "j"),
+  INSTR_LAYOUT (JMP_IFNCASEMATCH, "j"),
+  INSTR_LAYOUT (BRAINDEAD_PRECONDITION, ""),
+  INSTR_LAYOUT (BRAINDEAD_WARNING, "sb"),
+  INSTR_LAYOUT (FORCE_ASSIGN, "s"),
+  INSTR_LAYOUT (PUSH_NIL, ""),
+  INSTR_LAYOUT (THROW_IFERROBJ, ""),
+  INSTR_LAYOUT (INDEX_STRUCT_NARGOUTN, "bwwF"),
+  INSTR_LAYOUT (SUBASSIGN_STRUCT, "swF"),
+  INSTR_LAYOUT (SUBASSIGN_CELL_ID, "sb"),
+  INSTR_LAYOUT (INDEX_OBJ, "*"),
+  INSTR_LAYOUT (SUBASSIGN_OBJ, "bb"),
+  INSTR_LAYOUT (MATRIX_UNEVEN, "*"),
+  INSTR_LAYOUT (LOAD_FAR_CST, "K"),
+  INSTR_LAYOUT (END_OBJ, "sbb"),
+  INSTR_LAYOUT (SET_IGNORE_OUTPUTS, "*"),
+  INSTR_LAYOUT (CLEAR_IGNORE_OUTPUTS, "*"),
+  INSTR_LAYOUT (SUBASSIGN_CHAINED, "*"),
+  INSTR_LAYOUT (SET_SLOT_TO_STACK_DEPTH, "s"),
+  INSTR_LAYOUT (DUPN, "bb"),
+  INSTR_LAYOUT (DEBUG, "*"),
+  INSTR_LAYOUT (INDEX_STRUCT_CALL, "*"),
+  INSTR_LAYOUT (END_X_N, "*"),
+  INSTR_LAYOUT (EVAL, "bi"),
+  INSTR_LAYOUT (BIND_ANS, "s"),
+  INSTR_LAYOUT (PUSH_ANON_FCN_HANDLE, "i"),
+  INSTR_LAYOUT (FOR_COMPLEX_SETUP, "j"),
+  INSTR_LAYOUT (FOR_COMPLEX_COND, "jww"),
+  INSTR_LAYOUT (PUSH_SLOT_NARGOUT1_SPECIAL, "s"),
+  INSTR_LAYOUT (DISP, "sw"),
+  INSTR_LAYOUT (PUSH_SLOT_DISP, "sw"),
+  INSTR_LAYOUT (LOAD_CST_ALT2, "k"),
+  INSTR_LAYOUT (LOAD_CST_ALT3, "k"),
+  INSTR_LAYOUT (LOAD_CST_ALT4, "k"),
+  INSTR_LAYOUT (LOAD_2_CST, "*"),
+  INSTR_LAYOUT (MUL_DBL, "B"),
+  INSTR_LAYOUT (ADD_DBL, "B"),
+  INSTR_LAYOUT (SUB_DBL, "B"),
+  INSTR_LAYOUT (DIV_DBL, "B"),
+  INSTR_LAYOUT (POW_DBL, "B"),
+  INSTR_LAYOUT (LE_DBL, "B"),
+  INSTR_LAYOUT (LE_EQ_DBL, "B"),
+  INSTR_LAYOUT (GR_DBL, "B"),
+  INSTR_LAYOUT (GR_EQ_DBL, "B"),
+  INSTR_LAYOUT (EQ_DBL, "B"),
+  INSTR_LAYOUT (NEQ_DBL, "B"),
+  INSTR_LAYOUT (INDEX_ID1_MAT_1D, "sb"),
+  INSTR_LAYOUT (INDEX_ID1_MAT_2D, "sb"),
+  INSTR_LAYOUT (PUSH_PI, "s"),
+  INSTR_LAYOUT (INDEX_ID1_MATHY_UFUN, "bsb"),
+  INSTR_LAYOUT (SUBASSIGN_ID_MAT_1D, "sb"),
+  INSTR_LAYOUT (INCR_ID_PREFIX_DBL, "s"),
+  INSTR_LAYOUT (DECR_ID_PREFIX_DBL, "s"),
+  INSTR_LAYOUT (INCR_ID_POSTFIX_DBL, "s"),
+  INSTR_LAYOUT (DECR_ID_POSTFIX_DBL, "s"),
+  INSTR_LAYOUT (PUSH_DBL_0, ""),
+  INSTR_LAYOUT (PUSH_DBL_1, ""),
+  INSTR_LAYOUT (PUSH_DBL_2, ""),
+  INSTR_LAYOUT (JMP_IF_BOOL, "j"),
+  INSTR_LAYOUT (JMP_IFN_BOOL, "j"),
+  INSTR_LAYOUT (USUB_DBL, ""),
+  INSTR_LAYOUT (NOT_DBL, ""),
+  INSTR_LAYOUT (NOT_BOOL, ""),
+  INSTR_LAYOUT (PUSH_FOLDED_CST, "sj"),
+  INSTR_LAYOUT (SET_FOLDED_CST, "s"),
+  INSTR_LAYOUT (SLOT_BINOP_ASSIGN, "s"),
+  INSTR_LAYOUT (IDX_BINOP_ASSIGN, "s"),
+  INSTR_LAYOUT (SLOT_CMP_JMP_IFN, "s"),
+  INSTR_LAYOUT (IDX_CMP_JMP_IFN, "s"),
+  INSTR_LAYOUT (WIDE, "*"),
+};
+
+#undef INSTR_LAYOUT
+
+static constexpr std::size_t n_instr_layouts
+  = sizeof (instr_layouts) / sizeof (instr_layouts[0]);
+
+static constexpr bool
+instr_layouts_in_order ()
+{
+  for (std::size_t i = 0; i < n_instr_layouts; i++)
+    if (static_cast<std::size_t> (instr_layouts[i].m_op) != i)
+      return false;
+
+  return true;
+}
+
+static_assert (n_instr_layouts == static_cast<std::size_t> (INSTR::WIDE) + 1
+               && instr_layouts_in_order (),
+               "instr_layouts must list every INSTR in order");
+
+// Identify the bytecode that the compiler emits and the VM executes.
+// It only depends on the sources, so builds stay reproducible.
+
+static std::string
+bytecode_build_id ()
+{
+  static std::string id;
+
+  if (id.empty ())
+    {
+      std::ostringstream buf;
+
+      buf << OCTAVE_VERSION << ' ' << OCTAVE_API_VERSION << ' '
+          << bytecode_format_version << ' '
+          << sizeof (unwind_entry) << ' ' << sizeof (loc_entry) << "\n";
+
+      for (const auto& layout : instr_layouts)
+        buf << layout.m_name << ' ' << layout.m_operands << "\n";
+
+      id = crypto::sha1_hash (buf.str ());
+    }
+
+  return id;
+}
+
+std::size_t bytecode_cache::s_hits = 0;
+std::size_t bytecode_cache::s_misses = 0;
+std::size_t bytecode_cache::s_writes = 0;
+
+static bool s_directory_initialized = false;
+static std::string s_directory;
+
+std::string
+bytecode_cache::directory ()
+{
+  if (! s_directory_initialized)
+    {
+      s_directory = sys::env::getenv ("OCTAVE_VM_CACHE_DIR");
+      s_directory_initialized = true;
+    }
+
+  return s_directory;
+}
+
+void
+bytecode_cache::directory (const std::string& dir)
+{
+  s_directory = dir;
+  s_directory_initialized = true;
+}
+
+bool
+bytecode_cache::is_cacheable (octave_user_function& ufn)
+{
+  return (! directory ().empty () && ! ufn.fcn_file_name ().empty ()
+          && ! ufn.is_subfunction ());
+}
+
+// Enumerate the nodes of the parse tree of a function in a fixed order,
+// so that the nodes referenced by the bytecode can be stored by their
+// index.  The parse trees of the same file contents are enumerated in
+// the same order.
+
+class tree_node_list : public tree_walker
+{
+public:
+
+  tree_node_list (octave_user_function& fcn)
+  {
+    tree_parameter_list *params = fcn.parameter_list ();
+    if (params)
+      params->accept (*this);
+
+    tree_parameter_list *rets = fcn.return_list ();
+    if (rets)
+      rets->accept (*this);
+
+    tree_statement_list *body = fcn.body ();
+    if (body)
+      body->accept (*this);
+  }
+
+  OCTAVE_DISABLE_COPY_MOVE (tree_node_list)
+
+  ~tree_node_list () = default;
+
+  // Index of node T, or -1 if it is not part of the tree.
+  int index (tree *t)
+  {
+    if (m_index.empty ())
+      {
+        for (std::size_t i = 0; i < m_nodes.size (); i++)
+          m_index.emplace (m_nodes[i], i);
+      }
+
+    auto it = m_index.find (t);
+
+    return it == m_index.end () ? -1 : it->second;
+  }
+
+  tree * node (int idx) const
+  {
+    return (idx >= 0 && static_cast<std::size_t> (idx) < m_nodes.size ()
+            ? m_nodes[idx] : nullptr);
+  }
+
+#define NOTE_NODE(TYPE)                         \
+  void visit_ ## TYPE (tree_ ## TYPE& t)        \
+  {                                             \
+    note (t);                                   \
+    tree_walker::visit_ ## TYPE (t);            \
+  }
+
+  NOTE_NODE (anon_fcn_handle)
+  NOTE_NODE (argument_list)
+  NOTE_NODE (arguments_block)
+  NOTE_NODE (args_block_attribute_list)
+  NOTE_NODE (args_block_validation_list)
+  NOTE_NODE (arg_validation)
+  NOTE_NODE (arg_size_spec)
+  NOTE_NODE (arg_validation_fcns)
+  NOTE_NODE (binary_expression)
+  NOTE_NODE (boolean_expression)
+  NOTE_NODE (compound_binary_expression)
+  NOTE_NODE (break_command)
+  NOTE_NODE (colon_expression)
+  NOTE_NODE (continue_command)
+  NOTE_NODE (decl_command)
+  NOTE_NODE (decl_elt)
+  NOTE_NODE (decl_init_list)
+  NOTE_NODE (simple_for_command)
+  NOTE_NODE (complex_for_command)
+  NOTE_NODE (spmd_command)
+  NOTE_NODE (function_def)
+  NOTE_NODE (identifier)
+  NOTE_NODE (if_clause)
+  NOTE_NODE (if_command)
+  NOTE_NODE (if_command_list)
+  NOTE_NODE (switch_case)
+  NOTE_NODE (switch_case_list)
+  NOTE_NODE (switch_command)
+  NOTE_NODE (index_expression)
+  NOTE_NODE (matrix)
+  NOTE_NODE (cell)
+  NOTE_NODE (multi_assignment)
+  NOTE_NODE (no_op_command)
+  NOTE_NODE (constant)
+  NOTE_NODE (fcn_handle)
+  NOTE_NODE (parameter_list)
+  NOTE_NODE (postfix_expression)
+  NOTE_NODE (prefix_expression)
+  NOTE_NODE (return_command)
+  NOTE_NODE (simple_assignment)
+  NOTE_NODE (statement)
+  NOTE_NODE (statement_list)
+  NOTE_NODE (try_catch_command)
+  NOTE_NODE (unwind_protect_command)
+  NOTE_NODE (while_command)
+  NOTE_NODE (do_until_command)
+  NOTE_NODE (superclass_ref)
+  NOTE_NODE (metaclass_query)
+
+#undef NOTE_NODE
+
+private:
+
+  template <typename T>
+  void note (T& t)
+  {
+    if constexpr (std::is_base_of<tree, T>::value)
+      m_nodes.push_back (&t);
+  }
+
+  std::vector<tree *> m_nodes;
+
+  std::map<tree *, int> m_index;
+};
+
+// Tags of the constants in the data table.  Values that can not be
+// restored with the binary load format are stored specially.
+
+enum class cst_tag : unsigned char
+{
+  UNDEFINED,
+  MAGIC_COLON,
+  NULL_MATRIX,
+  NULL_STR,
+  NULL_SQ_STR,
+  MAGIC_INT,
+  MAGIC_UINT,
+  BINARY
+};
+
+class bytecode_cache_writer
+{
+public:
+
+  bytecode_cache_writer (std::ostream& os) : m_os (os) { }
+
+  OCTAVE_DISABLE_COPY_MOVE (bytecode_cache_writer)
+
+  ~bytecode_cache_writer () = default;
+
+  template <typename T>
+  void pod (const T& val)
+  {
+    static_assert (std::is_trivially_copyable<T>::value);
+
+    m_os.write (reinterpret_cast<const char *> (&val), sizeof (T));
+  }
+
+  template <typename T>
+  void pod_vector (const std::vector<T>& v)
+  {
+    static_assert (std::is_trivially_copyable<T>::value);
+
+    pod<uint64_t> (v.size ());
+    m_os.write (reinterpret_cast<const char *> (v.data ()),
+                v.size () * sizeof (T));
+  }
+
+  void string (const std::string& s)
+  {
+    pod<uint64_t> (s.size ());
+    m_os.write (s.data (), s.size ());
+  }
+
+  void int_map (const std::map<int, int>& m)
+  {
+    pod<uint64_t> (m.size ());
+    for (const auto& kv : m)
+      {
+        pod<int32_t> (kv.first);
+        pod<int32_t> (kv.second);
+      }
+  }
+
+  bool value (const octave_value& val)
+  {
+    if (val.is_undefined ())
+      pod (cst_tag::UNDEFINED);
+    else if (val.is_magic_colon ())
+      pod (cst_tag::MAGIC_COLON);
+    else if (val.type_id () == octave_null_matrix::static_type_id ())
+      pod (cst_tag::NULL_MATRIX);
+    else if (val.type_id () == octave_null_str::static_type_id ())
+      pod (cst_tag::NULL_STR);
+    else if (val.type_id () == octave_null_sq_str::static_type_id ())
+      pod (cst_tag::NULL_SQ_STR);
+    else if (val.type_id () == octave_magic_int::static_type_id ())
+      {
+        const octave_magic_int& rep
+          = static_cast<const octave_magic_int&> (val.get_rep ());
+
+        pod (cst_tag::MAGIC_INT);
+        pod<int64_t> (rep.scalar_ref ().value ());
+      }
+    else if (val.type_id () == octave_magic_uint::static_type_id ())
+      {
+        const octave_magic_uint& rep
+          = static_cast<const octave_magic_uint&> (val.get_rep ());
+
+        pod (cst_tag::MAGIC_UINT);
+        pod<uint64_t> (rep.scalar_ref ().value ());
+      }
+    else
+      {
+        pod (cst_tag::BINARY);
+        if (! save_binary_data (m_os, val, "", "", false, false))
+          return false;
+      }
+
+    return static_cast<bool> (m_os);
+  }
+
+  bool function (const std::string& name, const bytecode& bc,
+                 tree_node_list& nodes)
+  {
+    const unwind_data& ud = bc.m_unwind_data;
+
+    string (name);
+
+    pod_vector (bc.m_code);
+
+    pod<uint64_t> (bc.m_data.size ());
+    for (const auto& val : bc.m_data)
+      if (! value (val))
+        return false;
+
+    pod<uint64_t> (bc.m_ids.size ());
+    for (const auto& id : bc.m_ids)
+      string (id);
+
+    pod_vector (ud.m_unwind_entries);
+    pod_vector (ud.m_loc_entry);
+    int_map (ud.m_slot_to_persistent_slot);
+
+    pod<uint64_t> (ud.m_ip_to_tree.size ());
+    for (const auto& kv : ud.m_ip_to_tree)
+      {
+        int idx = -1;
+
+        if (kv.second)
+          {
+            idx = nodes.index (kv.second);
+
+            // The bytecode refers to a node that we can not find again.
+            if (idx < 0)
+              return false;
+          }
+
+        pod<int32_t> (kv.first);
+        pod<int32_t> (idx);
+      }
+
+    pod<uint64_t> (ud.m_argname_entries.size ());
+    for (const auto& e : ud.m_argname_entries)
+      {
+        pod<int32_t> (e.m_ip_start);
+        pod<int32_t> (e.m_ip_end);
+        if (! value (octave_value (e.m_arg_names)))
+          return false;
+        string (e.m_obj_name);
+      }
+
+    int_map (ud.m_external_frame_offset_to_internal);
+
+    // The inline caches are filled at run time.  Only their number is
+    // needed.
+    pod<uint64_t> (ud.m_field_caches.size ());
+    pod<uint64_t> (ud.m_binary_op_caches.size ());
+
+    string (ud.m_name);
+    string (ud.m_file);
+    pod<uint32_t> (ud.m_code_size);
+    pod<uint32_t> (ud.m_ids_size);
+
+    return static_cast<bool> (m_os);
+  }
+
+private:
+
+  std::ostream& m_os;
+};
+
+// Reads what bytecode_cache_writer wrote.  Any inconsistency marks the
+// reader as failed and the entry is ignored.
+
+class bytecode_cache_reader
+{
+public:
+
+  bytecode_cache_reader (std::istream& is, const std::string& file,
+                         std::size_t file_size)
+    : m_is (is), m_file (file), m_max_count (file_size), m_ok (true)
+  { }
+
+  OCTAVE_DISABLE_COPY_MOVE (bytecode_cache_reader)
+
+  ~bytecode_cache_reader () = default;
+
+  bool ok () const { return m_ok && m_is; }
+
+  template <typename T>
+  T pod ()
+  {
+    static_assert (std::is_trivially_copyable<T>::value);
+
+    T val {};
+
+    if (ok ())
+      m_is.read (reinterpret_cast<char *> (&val), sizeof (T));
+
+    return val;
+  }
+
+  // Read a count and check that it is not larger than the file.
+  std::size_t count ()
+  {
+    uint64_t n = pod<uint64_t> ();
+
+    if (n > m_max_count)
+      m_ok = false;
+
+    return ok () ? n : 0;
+  }
+
+  template <typename T>
+  void pod_vector (std::vector<T>& v)
+  {
+    static_assert (std::is_trivially_copyable<T>::value);
+
+    std::size_t n = count ();
+
+    v.resize (n);
+    if (n)
+      m_is.read (reinterpret_cast<char *> (v.data ()), n * sizeof (T));
+  }
+
+  std::string string ()
+  {
+    std::size_t n = count ();
+
+    std::string s (n, '\0');
+    if (n)
+      m_is.read (&s[0], n);
+
+    return s;
+  }
+
+  void int_map (std::map<int, int>& m)
+  {
+    std::size_t n = count ();
+
+    for (std::size_t i = 0; i < n && ok (); i++)
+      {
+        int k = pod<int32_t> ();
+        m[k] = pod<int32_t> ();
+      }
+  }
+
+  octave_value value ()
+  {
+    cst_tag tag = pod<cst_tag> ();
+
+    if (! ok ())
+      return octave_value ();
+
+    switch (tag)
+      {
+      case cst_tag::UNDEFINED:
+        return octave_value ();
+
+      case cst_tag::MAGIC_COLON:
+        return octave_value (octave_value::magic_colon_t);
+
+      case cst_tag::NULL_MATRIX:
+        return octave_null_matrix::instance;
+
+      case cst_tag::NULL_STR:
+        return octave_null_str::instance;
+
+      case cst_tag::NULL_SQ_STR:
+        return octave_null_sq_str::instance;
+
+      case cst_tag::MAGIC_INT:
+        {
+          octave_int64 val (pod<int64_t> ());
+          return octave_value (new octave_magic_int (val));
+        }
+
+      case cst_tag::MAGIC_UINT:
+        {
+          octave_uint64 val (pod<uint64_t> ());
+          return octave_value (new octave_magic_uint (val));
+        }
+
+      case cst_tag::BINARY:
+        {
+          octave_value val;
+          bool global;
+          std::string doc;
+
+          read_binary_data (m_is, false, mach_info::native_float_format (),
+                            m_file, global, val, doc);
+
+          if (val.is_undefined ())
+            m_ok = false;
+
+          return val;
+        }
+
+      default:
+        m_ok = false;
+        return octave_value ();
+      }
+  }
+
+  bool function (std::string& name, bytecode& bc, tree_node_list& nodes)
+  {
+    unwind_data& ud = bc.m_unwind_data;
+
+    name = string ();
+
+    pod_vector (bc.m_code);
+
+    std::size_t n = count ();
+    bc.m_data.resize (n);
+    for (std::size_t i = 0; i < n && ok (); i++)
+      bc.m_data[i] = value ();
+
+    n = count ();
+    bc.m_ids.resize (n);
+    for (std::size_t i = 0; i < n && ok (); i++)
+      bc.m_ids[i] = string ();
+
+    pod_vector (ud.m_unwind_entries);
+    pod_vector (ud.m_loc_entry);
+    int_map (ud.m_slot_to_persistent_slot);
+
+    n = count ();
+    for (std::size_t i = 0; i < n && ok (); i++)
+      {
+        int ip = pod<int32_t> ();
+        int idx = pod<int32_t> ();
+
+        tree *t = nullptr;
+
+        if (idx >= 0)
+          {
+            t = nodes.node (idx);
+
+            if (! t)
+              m_ok = false;
+          }
+
+        ud.m_ip_to_tree[ip] = t;
+      }
+
+    n = count ();
+    ud.m_argname_entries.resize (n);
+    for (std::size_t i = 0; i < n && ok (); i++)
+      {
+        arg_name_entry& e = ud.m_argname_entries[i];
+
+        e.m_ip_start = pod<int32_t> ();
+        e.m_ip_end = pod<int32_t> ();
+
+        octave_value names = value ();
+        if (! ok () || ! names.iscell ())
+          {
+            m_ok = false;
+            break;
+          }
+
+        e.m_arg_names = names.cell_value ();
+        e.m_obj_name = string ();
+      }
+
+    int_map (ud.m_external_frame_offset_to_internal);
+
+    ud.m_field_caches.resize (count ());
+    ud.m_binary_op_caches.resize (count ());
+
+    ud.m_name = string ();
+    ud.m_file = string ();
+    ud.m_code_size = pod<uint32_t> ();
+    ud.m_ids_size = pod<uint32_t> ();
+
+    return ok ();
+  }
+
+private:
+
+  std::istream& m_is;
+
+  std::string m_file;
+
+  std::size_t m_max_count;
+
+  bool m_ok;
+};
+
+// The header of a cache file.  An entry is valid if the header matches
+// exactly.  Returns an empty string if the function file can not be
+// read.
+
+static std::string
+cache_key (const std::string& file)
+{
+  sys::file_stat fs (file);
+
+  if (! fs)
+    return "";
+
+  std::ifstream is = sys::ifstream (file, std::ios::in | std::ios::binary);
+
+  if (! is)
+    return "";
+
+  std::ostringstream contents;
+  contents << is.rdbuf ();
+
+  std::ostringstream key;
+
+  key << "Octave bytecode cache " << bytecode_cache_format << "\n"
+      << bytecode_build_id () << "\n"
+      << sizeof (void *) << ' ' << sizeof (int) << ' '
+      << static_cast<int> (mach_info::native_float_format ()) << ' '
+      << (mach_info::words_big_endian () ? "big" : "little") << "\n"
+      << file << "\n"
+      << fs.mtime ().unix_time () << '.' << fs.mtime ().usec () << ' '
+      << fs.size () << ' ' << crypto::sha1_hash (contents.str ()) << "\n";
+
+  return key.str ();
+}
+
+// Decode the instructions of a cache entry and check every operand:
+// slots must refer to the ids, constants to the data, cache indices to
+// the caches and jump targets to the start of an instruction.  The
+// operand sequences that the fused instructions read must be those that
+// bytecode_walker::maybe_fuse_instructions emits.  The VM relies on
+// this since it does not check the code it executes.
+
+class bytecode_checker
+{
+public:
+
+  bytecode_checker (const bytecode& bc)
+    : m_bc (bc), m_code (bc.m_code), m_n_code (m_code.size ()),
+      m_n_ids (bc.m_ids.size ()), m_n_data (bc.m_data.size ()),
+      m_is_instr (m_n_code, false), m_ip (0), m_ok (true)
+  { }
+
+  OCTAVE_DISABLE_COPY_MOVE (bytecode_checker)
+
+  ~bytecode_checker () = default;
+
+  bool check ();
+
+private:
+
+  unsigned byte ()
+  {
+    if (m_ip >= m_n_code)
+      {
+        m_ok = false;
+        return 0;
+      }
+
+    return m_code[m_ip++];
+  }
+
+  unsigned ushort ()
+  {
+    unsigned b0 = byte ();
+    unsigned b1 = byte ();
+
+    return b0 | (b1 << 8);
+  }
+
+  unsigned uint ()
+  {
+    unsigned lo = ushort ();
+    unsigned hi = ushort ();
+
+    return lo | (hi << 16);
+  }
+
+  void slot (unsigned idx)
+  {
+    if (idx >= m_n_ids)
+      m_ok = false;
+  }
+
+  void constant (unsigned idx)
+  {
+    if (idx >= m_n_data)
+      m_ok = false;
+  }
+
+  void target (unsigned ip)
+  {
+    m_targets.push_back (ip);
+  }
+
+  void operands (const char *layout, bool wide);
+
+  void special_operands (INSTR op, bool wide);
+
+  void fused_operands (INSTR op, std::size_t ip);
+
+  bool indexed_operand (std::size_t ip) const;
+
+  bool dbl_constant (std::size_t ip) const;
+
+  //--------
+
+  const bytecode& m_bc;
+  const std::vector<unsigned char>& m_code;
+
+  std::size_t m_n_code;
+  std::size_t m_n_ids;
+  std::size_t m_n_data;
+
+  // Whether an instruction starts at each offset.
+  std::vector<bool> m_is_instr;
+
+  std::vector<std::size_t> m_targets;
+
+  std::size_t m_ip;
+
+  bool m_ok;
+};
+
+bool
+bytecode_checker::check ()
+{
+  const unwind_data& ud = m_bc.m_unwind_data;
+
+  // The name of the function, its type and the name used by the profiler
+  // are the first constants.
+
+  if (m_n_code < 4 || ud.m_code_size != m_n_code || ud.m_ids_size != m_n_ids
+      || m_n_data < 3)
+    return false;
+
+  int n_returns = std::abs (static_cast<signed char> (m_code[0]));
+  int n_args = std::abs (static_cast<signed char> (m_code[1]));
+  std::size_t n_locals = m_code[2] | (m_code[3] << 8);
+
+  if (n_locals != m_n_ids || static_cast<std::size_t> (n_returns) > n_locals
+      || static_cast<std::size_t> (n_args) > n_locals)
+    return false;
+
+  m_ip = 4;
+
+  INSTR op = INSTR::RET;
+  bool wide = false;
+
+  while (m_ok && m_ip < m_n_code)
+    {
+      std::size_t ip = m_ip;
+
+      if (m_code[ip] >= n_instr_layouts)
+        return false;
+
+      op = static_cast<INSTR> (m_code[ip]);
+
+      const char *layout = instr_layouts[m_code[ip]].m_operands;
+
+      if (wide)
+        {
+          if (layout[0] != 's' && layout[0] != 'k'
+              && op != INSTR::INDEX_STRUCT_CALL)
+            return false;
+        }
+      else
+        m_is_instr[ip] = true;
+
+      m_ip++;
+
+      switch (op)
+        {
+        case INSTR::WIDE:
+          wide = true;
+          continue;
+
+        case INSTR::SLOT_BINOP_ASSIGN:
+        case INSTR::IDX_BINOP_ASSIGN:
+        case INSTR::SLOT_CMP_JMP_IFN:
+        case INSTR::IDX_CMP_JMP_IFN:
+          if (wide)
+            return false;
+          fused_operands (op, ip);
+          break;
+
+        default:
+          break;
+        }
+
+      if (layout[0] == '*')
+        special_operands (op, wide);
+      else
+        operands (layout, wide);
+
+      wide = false;
+    }
+
+  if (! m_ok || wide || op != INSTR::RET)
+    return false;
+
+  for (const auto& e : ud.m_unwind_entries)
+    if (e.m_ip_target >= 0)
+      m_targets.push_back (e.m_ip_target);
+    else
+      return false;
+
+  for (std::size_t ip : m_targets)
+    if (ip >= m_n_code || ! m_is_instr[ip])
+      return false;
+
+  return true;
+}
+
+void
+bytecode_checker::operands (const char *layout, bool wide)
+{
+  const unwind_data& ud = m_bc.m_unwind_data;
+
+  for (const char *c = layout; *c; c++)
+    {
+      bool wide_operand = (wide && c == layout);
+
+      switch (*c)
+        {
+        case 'b':
+          byte ();
+          break;
+
+        case 'i':
+          uint ();
+          break;
+
+        case 's':
+          slot (wide_operand ? ushort () : byte ());
+          break;
+
+        case 'w':
+          slot (ushort ());
+          break;
+
+        case 'k':
+          constant (wide_operand ? ushort () : byte ());
+          break;
+
+        case 'K':
+          constant (uint ());
+          break;
+
+        case 'j':
+          target (ushort ());
+          break;
+
+        case 'B':
+          if (ushort () >= ud.m_binary_op_caches.size ())
+            m_ok = false;
+          break;
+
+        case 'F':
+          if (ushort () >= ud.m_field_caches.size ())
+            m_ok = false;
+          break;
+
+        default:
+          m_ok = false;
+          break;
+        }
+    }
+}
+
+void
+bytecode_checker::special_operands (INSTR op, bool wide)
+{
+  switch (op)
+    {
+    case INSTR::ASSIGNN:
+      {
+        // The VM assigns at least one slot.
+        unsigned n = byte ();
+        if (n == 0)
+          m_ok = false;
+        for (unsigned i = 0; m_ok && i < n; i++)
+          slot (ushort ());
+      }
+      break;
+
+    case INSTR::GLOBAL_INIT:
+      {
+        byte ();
+        slot (ushort ());
+        ushort ();
+        if (byte ())
+          target (ushort ());
+      }
+      break;
+
+    case INSTR::INDEX_OBJ:
+      {
+        byte ();
+        bool has_slot = byte ();
+        unsigned idx = ushort ();
+        if (has_slot)
+          slot (idx);
+        byte ();
+        byte ();
+      }
+      break;
+
+    case INSTR::MATRIX_UNEVEN:
+      {
+        if (byte () == 0)
+          {
+            unsigned n_rows = uint ();
+            for (unsigned i = 0; m_ok && i < n_rows; i++)
+              uint ();
+          }
+        else
+          {
+            uint ();
+            uint ();
+          }
+      }
+      break;
+
+    case INSTR::SET_IGNORE_OUTPUTS:
+      {
+        unsigned n = byte ();
+        byte ();
+        for (unsigned i = 0; m_ok && i < n; i++)
+          byte ();
+      }
+      break;
+
+    case INSTR::CLEAR_IGNORE_OUTPUTS:
+      {
+        unsigned n = byte ();
+        for (unsigned i = 0; m_ok && i < n; i++)
+          slot (ushort ());
+      }
+      break;
+
+    case INSTR::SUBASSIGN_CHAINED:
+      {
+        byte ();
+        unsigned n = byte ();
+        for (unsigned i = 0; m_ok && i < 2 * n; i++)
+          byte ();
+      }
+      break;
+
+    case INSTR::INDEX_STRUCT_CALL:
+      {
+        unsigned idx = (wide ? ushort () : byte ());
+        if (byte ())
+          slot (idx);
+        byte ();
+        unsigned n = byte ();
+        for (unsigned i = 0; m_ok && i < 2 * n; i++)
+          byte ();
+      }
+      break;
+
+    case INSTR::END_X_N:
+      {
+        unsigned n = byte ();
+        for (unsigned i = 0; m_ok && i < n; i++)
+          {
+            byte ();
+            byte ();
+            byte ();
+            slot (ushort ());
+          }
+      }
+      break;
+
+    case INSTR::LOAD_2_CST:
+      constant (byte () + 1);
+      break;
+
+    default:
+      // DEBUG is not emitted by the compiler.
+      m_ok = false;
+      break;
+    }
+}
+
+// Whether the code at IP is "x(i)", i.e. PUSH_SLOT_INDEXED x,
+// PUSH_SLOT_NARGOUT1 i, INDEX_ID_NARGOUT1 x 1.  The first opcode may
+// already be replaced by a fused instruction.
+
+bool
+bytecode_checker::indexed_operand (std::size_t ip) const
+{
+  return (ip + 7 <= m_n_code
+          && static_cast<INSTR> (m_code[ip+2]) == INSTR::PUSH_SLOT_NARGOUT1
+          && static_cast<INSTR> (m_code[ip+4]) == INSTR::INDEX_ID_NARGOUT1
+          && m_code[ip+5] == m_code[ip+1] && m_code[ip+6] == 1);
+}
+
+bool
+bytecode_checker::dbl_constant (std::size_t ip) const
+{
+  if (ip + 1 >= m_n_code || m_code[ip+1] >= m_n_data)
+    return false;
+
+  const octave_value& val = m_bc.m_data[m_code[ip+1]];
+
+  return val.is_double_type () && val.is_real_scalar ();
+}
+
+// The fused instruction at IP reads its operands and the operator ahead
+// of the instructions that are checked next.  See vm::fused_binop_assign
+// and vm::fused_cmp_jmp_ifn.
+
+void
+bytecode_checker::fused_operands (INSTR op, std::size_t ip)
+{
+  bool is_cmp = (op == INSTR::SLOT_CMP_JMP_IFN
+                 || op == INSTR::IDX_CMP_JMP_IFN);
+
+  std::size_t p = ip + 2;
+
+  if (op == INSTR::IDX_BINOP_ASSIGN || op == INSTR::IDX_CMP_JMP_IFN)
+    {
+      if (! indexed_operand (ip))
+        {
+          m_ok = false;
+          return;
+        }
+
+      p = ip + 7;
+    }
+
+  if (p >= m_n_code)
+    {
+      m_ok = false;
+      return;
+    }
+
+  switch (static_cast<INSTR> (m_code[p]))
+    {
+    case INSTR::PUSH_SLOT_NARGOUT1:
+      p += 2;
+      break;
+
+    case INSTR::LOAD_CST:
+    case INSTR::LOAD_CST_ALT2:
+    case INSTR::LOAD_CST_ALT3:
+    case INSTR::LOAD_CST_ALT4:
+      if (! dbl_constant (p))
+        {
+          m_ok = false;
+          return;
+        }
+      p += 2;
+      break;
+
+    case INSTR::PUSH_DBL_0:
+    case INSTR::PUSH_DBL_1:
+    case INSTR::PUSH_DBL_2:
+      p += 1;
+      break;
+
+    case INSTR::PUSH_SLOT_INDEXED:
+      if (! indexed_operand (p))
+        {
+          m_ok = false;
+          return;
+        }
+      p += 7;
+      break;
+
+    default:
+      // The VM executes the original instructions.
+      return;
+    }
+
+  if (p >= m_n_code)
+    {
+      m_ok = false;
+      return;
+    }
+
+  bool is_fused_op = false;
+
+  switch (static_cast<INSTR> (m_code[p]))
+    {
+    case INSTR::ADD:
+    case INSTR::ADD_DBL:
+    case INSTR::SUB:
+    case INSTR::SUB_DBL:
+    case INSTR::MUL:
+    case INSTR::MUL_DBL:
+    case INSTR::EL_MUL:
+    case INSTR::DIV:
+    case INSTR::DIV_DBL:
+    case INSTR::EL_DIV:
+      is_fused_op = ! is_cmp;
+      break;
+
+    case INSTR::LE:
+    case INSTR::LE_DBL:
+    case INSTR::LE_EQ:
+    case INSTR::LE_EQ_DBL:
+    case INSTR::GR:
+    case INSTR::GR_DBL:
+    case INSTR::GR_EQ:
+    case INSTR::GR_EQ_DBL:
+    case INSTR::EQ:
+    case INSTR::EQ_DBL:
+    case INSTR::NEQ:
+    case INSTR::NEQ_DBL:
+      is_fused_op = is_cmp;
+      break;
+
+    default:
+      break;
+    }
+
+  if (! is_fused_op)
+    return;
+
+  // The operator is followed by ASSIGN or JMP_IFN, whose operand is
+  // checked as part of that instruction.
+
+  INSTR next = (is_cmp ? INSTR::JMP_IFN : INSTR::ASSIGN);
+
+  if (p + 3 >= m_n_code || static_cast<INSTR> (m_code[p+3]) != next)
+    m_ok = false;
+}
+
+static bool
+is_valid_bytecode (const bytecode& bc)
+{
+  bytecode_checker checker (bc);
+
+  return checker.check ();
+}
+
+static std::string
+cache_file_name (octave_user_function& ufn)
+{
+  std::string file = ufn.fcn_file_name ();
+  std::string name = ufn.name ();
+
+  // Several functions of a classdef file may be compiled separately.
+  std::string hash = crypto::sha1_hash (file + "\n" + name);
+
+  return sys::file_ops::concat (bytecode_cache::directory (),
+                                name + '-' + hash.substr (0, 16) + ".obc");
+}
+
+bool
+bytecode_cache::load (octave_user_function& ufn)
+{
+  std::string cache_file = cache_file_name (ufn);
+
+  sys::file_stat fs (cache_file);
+
+  std::ifstream is;
+
+  if (fs)
+    is = sys::ifstream (cache_file, std::ios::in | std::ios::binary);
+
+  if (! fs || ! is)
+    {
+      s_misses++;
+      return false;
+    }
+
+  bytecode_cache_reader reader (is, cache_file, fs.size ());
+
+  bool ok = false;
+
+  try
+    {
+      std::string key = cache_key (ufn.fcn_file_name ());
+
+      ok = ! key.empty () && reader.string () == key;
+
+      std::map<std::string, octave_value> subs = ufn.subfunctions ();
+
+      std::size_t n = reader.count ();
+
+      ok = ok && n == subs.size () + 1;
+
+      for (std::size_t i = 0; ok && i < n; i++)
+        {
+          octave_user_function *fcn = &ufn;
+
+          if (i > 0)
+            {
+              // Subfunctions are written in the order of the map.
+              auto it = subs.begin ();
+              std::advance (it, i - 1);
+              fcn = it->second.user_function_value ();
+
+              if (! fcn)
+                {
+                  ok = false;
+                  break;
+                }
+            }
+
+          tree_node_list nodes (*fcn);
+
+          std::string name;
+          bytecode bc;
+
+          ok = (reader.function (name, bc, nodes) && name == fcn->name ()
+                && is_valid_bytecode (bc));
+
+          if (ok)
+            fcn->set_bytecode (bc);
+        }
+    }
+  catch (const execution_exception&)
+    {
+      interpreter& interp = __get_interpreter__ ();
+
+      interp.recover_from_exception ();
+
+      ok = false;
+    }
+
+  if (ok)
+    s_hits++;
+  else
+    {
+      ufn.clear_bytecode ();
+      s_misses++;
+    }
+
+  return ok;
+}
+
+bool
+bytecode_cache::save (octave_user_function& ufn)
+{
+  std::string key = cache_key (ufn.fcn_file_name ());
+
+  if (key.empty ())
+    return false;
+
+  std::string dir = directory ();
+  std::string msg;
+
+  sys::file_stat ds (dir);
+
+  if (! ds && sys::recursive_mkdir (dir, 0777, msg) < 0)
+    return false;
+
+  // Write to a temporary file first, so that other sessions never read
+  // a partial entry.
+  std::string cache_file = cache_file_name (ufn);
+  std::string tmp_file
+    = cache_file + '.' + std::to_string (sys::getpid ()) + ".tmp";
+
+  bool ok = false;
+
+  {
+    std::ofstream os = sys::ofstream (tmp_file, std::ios::out
+                                      | std::ios::binary
+                                      | std::ios::trunc);
+
+    if (! os)
+      return false;
+
+    bytecode_cache_writer writer (os);
+
+    try
+      {
+        std::map<std::string, octave_value> subs = ufn.subfunctions ();
+
+        writer.string (key);
+        writer.pod<uint64_t> (subs.size () + 1);
+
+        tree_node_list nodes (ufn);
+        ok = writer.function (ufn.name (), ufn.get_bytecode (), nodes);
+
+        for (const auto& kv : subs)
+          {
+            if (! ok)
+              break;
+
+            octave_user_function *sub = kv.second.user_function_value ();
+
+            if (! sub)
+              {
+                ok = false;
+                break;
+              }
+
+            tree_node_list sub_nodes (*sub);
+            ok = writer.function (sub->name (), sub->get_bytecode (),
+                                  sub_nodes);
+          }
+      }
+    catch (const execution_exception&)
+      {
+        interpreter& interp = __get_interpreter__ ();
+
+        interp.recover_from_exception ();
+
+        ok = false;
+      }
+
+    os.close ();
+
+    ok = ok && os;
+  }
+
+  if (ok)
+    ok = sys::rename (tmp_file, cache_file, msg) == 0;
+
+  if (ok)
+    s_writes++;
+  else
+    sys::unlink (tmp_file, msg);
+
+  return ok;
+}
+
+OCTAVE_END_NAMESPACE(octave)
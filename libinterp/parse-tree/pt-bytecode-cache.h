@@ -0,0 +1,87 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_pt_bytecode_cache_h)
+#define octave_pt_bytecode_cache_h 1
+
+#include "octave-config.h"
+
+#include <cstddef>
+#include <string>
+
+class octave_user_function;
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// On-disk cache of the bytecode of functions defined in files.
+//
+// The bytecode of the main function of a file and of its subfunctions
+// is written to one file in the cache directory.  An entry is only used
+// if the modification time, size, and contents of the function file and
+// the version of Octave are the same as when it was written.
+//
+// The VM still needs the parse tree of a function (for breakpoints,
+// anonymous functions and expressions evaluated by the tree evaluator),
+// so the cache only saves the compilation to bytecode.  The tree nodes
+// referenced by the bytecode are stored by their position in a walk of
+// the parse tree.
+
+class bytecode_cache
+{
+public:
+
+  // Directory of the cache files.  The cache is disabled if it is
+  // empty.  The initial value is taken from the environment variable
+  // OCTAVE_VM_CACHE_DIR.
+  static std::string directory ();
+
+  static void directory (const std::string& dir);
+
+  // TRUE if the bytecode of UFN may be stored in the cache.
+  static bool is_cacheable (octave_user_function& ufn);
+
+  // Set the bytecode of UFN and its subfunctions from the cache.
+  // Returns false, and leaves UFN without bytecode, if there is no valid
+  // entry for UFN.
+  static bool load (octave_user_function& ufn);
+
+  // Write the bytecode of UFN and its subfunctions to the cache.
+  // Failures are silently ignored.
+  static bool save (octave_user_function& ufn);
+
+  static std::size_t hits () { return s_hits; }
+  static std::size_t misses () { return s_misses; }
+  static std::size_t writes () { return s_writes; }
+
+private:
+
+  static std::size_t s_hits;
+  static std::size_t s_misses;
+  static std::size_t s_writes;
+};
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
@@ -109,6 +109,8 @@ else /* TODO: Should be function call to keep code shorter. */\
       goto jmp_target;                                                                   \
     }                                                                                    \
                                                                                          \
+  ip++; /* Skip the high byte of the cache index */                                      \
+                                                                                         \
   try                                                                                    \
     {                                                                                    \
       lhs = op_fn (lhs.get_rep (), rhs.get_rep ());                                      \
@@ -142,6 +144,50 @@ else /* TODO: Should be function call to keep code shorter. */\
   CATCH_BAD_ALLOC                                                                        \
 }                                                                                        \
 
+// Binary operators with an inline cache.  The instruction has a two byte
+// operand, the index of its cache in the unwind data.  The low byte is
+// already in arg0.
+
+#define DO_CACHED_BINOP(op, lhs, rhs, lhs_type, rhs_type)                                 \
+{                                                                                          \
+  int cache_idx = arg0 | (POP_CODE () << 8);                                               \
+  binary_op_cache& cache = unwind_data->m_binary_op_caches[cache_idx];                     \
+                                                                                           \
+  try                                                                                      \
+    {                                                                                      \
+      type_info::binary_op_fcn f = cache.lookup (lhs_type, rhs_type);                      \
+                                                                                           \
+      if (OCTAVE_UNLIKELY (! f))                                                           \
+        {                                                                                  \
+          /* Only direct matches are cached.  Everything else (classes, */                 \
+          /* type conversions) takes the general path every time. */                       \
+          f = m_ti->lookup_binary_op (octave_value::op, lhs_type, rhs_type);               \
+          if (f)                                                                           \
+            cache.insert (lhs_type, rhs_type, f);                                          \
+        }                                                                                  \
+                                                                                           \
+      octave_value ans = (f ? f (lhs.get_rep (), rhs.get_rep ())                           \
+                          : binary_op (*m_ti, octave_value::op, lhs, rhs));                \
+      STACK_DESTROY (2);                                                                   \
+      PUSH_OV (std::move (ans));                                                           \
+    }                                                                                      \
+  CATCH_INTERRUPT_EXCEPTION                                                                \
+  CATCH_INDEX_EXCEPTION                                                                    \
+  CATCH_EXECUTION_EXCEPTION                                                                \
+  CATCH_BAD_ALLOC                                                                          \
+}                                                                                          \
+
+#define MAKE_BINOP_CACHED(op)                                                              \
+{                                                                                          \
+  octave_value &rhs = TOP_OV ();                                                           \
+  octave_value &lhs = SEC_OV ();                                                           \
+                                                                                           \
+  int rhs_type = rhs.type_id ();                                                           \
+  int lhs_type = lhs.type_id ();                                                           \
+                                                                                           \
+  DO_CACHED_BINOP (op, lhs, rhs, lhs_type, rhs_type)                                       \
+}                                                                                          \
+
 #define MAKE_BINOP_SELFMODIFYING(op, jmp_target, op_target) \
 {                                                                                          \
   octave_value &rhs = TOP_OV ();                                                           \
@@ -155,19 +201,7 @@ else /* TODO: Should be function call to keep code shorter. */\
       goto jmp_target;                                                                     \
     }                                                                                      \
                                                                                            \
-  try                                                                                      \
-    {                                                                                      \
-      octave_value ans =                                                                   \
-        binary_op (*m_ti,                                                                  \
-                    octave_value::op,                                                      \
-                    lhs, rhs);                                                             \
-      STACK_DESTROY (2);                                                                   \
-      PUSH_OV (std::move (ans));                                                           \
-    }                                                                                      \
-  CATCH_INTERRUPT_EXCEPTION                                                                \
-  CATCH_INDEX_EXCEPTION                                                                    \
-  CATCH_EXECUTION_EXCEPTION                                                                \
-  CATCH_BAD_ALLOC                                                                          \
+  DO_CACHED_BINOP (op, lhs, rhs, lhs_type, rhs_type)                                       \
 }                                                                                          \
 
 #define CATCH_INDEX_EXCEPTION \
@@ -44,7 +44,9 @@
 #include "ov-classdef.h"
 #include "ov-ref.h"
 #include "ov-range.h"
+#include "ov-re-mat.h"
 #include "ov-inline.h"
+#include "ov-struct.h"
 
 #include "ov-vm.h"
 
@@ -171,6 +173,13 @@ octave::opcodes_to_strings (std::vector<unsigned char> &v_code, std::vector<std:
                                       names[u].c_str() :            \
                                       "INVALID SLOT"});}
 
+#define PCST() \
+    {if (wide_opext_active)                                         \
+      PSHORT ()                                                     \
+    else                                                            \
+      PCHAR ()                                                      \
+    wide_opext_active = false;}
+
 #define CHECK_END() \
   do {if (p >= v_code.data () + v_code.size ()) { error ("Invalid bytecode\n");}} while((0))
 
@@ -196,27 +205,27 @@ octave::opcodes_to_strings (std::vector<unsigned char> &v_code, std::vector<std:
 
           PRINT_OP (POP)
           PRINT_OP (DUP)
-          PRINT_OP (MUL)
-          PRINT_OP (MUL_DBL)
-          PRINT_OP (ADD)
-          PRINT_OP (ADD_DBL)
-          PRINT_OP (SUB)
-          PRINT_OP (SUB_DBL)
-          PRINT_OP (DIV)
-          PRINT_OP (DIV_DBL)
+          CASE_START (MUL) PSHORT () CASE_END ()
+          CASE_START (MUL_DBL) PSHORT () CASE_END ()
+          CASE_START (ADD) PSHORT () CASE_END ()
+          CASE_START (ADD_DBL) PSHORT () CASE_END ()
+          CASE_START (SUB) PSHORT () CASE_END ()
+          CASE_START (SUB_DBL) PSHORT () CASE_END ()
+          CASE_START (DIV) PSHORT () CASE_END ()
+          CASE_START (DIV_DBL) PSHORT () CASE_END ()
           PRINT_OP (RET)
-          PRINT_OP (LE)
-          PRINT_OP (LE_DBL)
-          PRINT_OP (LE_EQ)
-          PRINT_OP (LE_EQ_DBL)
-          PRINT_OP (GR)
-          PRINT_OP (GR_DBL)
-          PRINT_OP (GR_EQ)
-          PRINT_OP (GR_EQ_DBL)
-          PRINT_OP (EQ)
-          PRINT_OP (EQ_DBL)
-          PRINT_OP (NEQ)
-          PRINT_OP (NEQ_DBL)
+          CASE_START (LE) PSHORT () CASE_END ()
+          CASE_START (LE_DBL) PSHORT () CASE_END ()
+          CASE_START (LE_EQ) PSHORT () CASE_END ()
+          CASE_START (LE_EQ_DBL) PSHORT () CASE_END ()
+          CASE_START (GR) PSHORT () CASE_END ()
+          CASE_START (GR_DBL) PSHORT () CASE_END ()
+          CASE_START (GR_EQ) PSHORT () CASE_END ()
+          CASE_START (GR_EQ_DBL) PSHORT () CASE_END ()
+          CASE_START (EQ) PSHORT () CASE_END ()
+          CASE_START (EQ_DBL) PSHORT () CASE_END ()
+          CASE_START (NEQ) PSHORT () CASE_END ()
+          CASE_START (NEQ_DBL) PSHORT () CASE_END ()
           PRINT_OP (TRANS_MUL)
           PRINT_OP (MUL_TRANS)
           PRINT_OP (HERM_MUL)
@@ -228,15 +237,15 @@ octave::opcodes_to_strings (std::vector<unsigned char> &v_code, std::vector<std:
           PRINT_OP (PUSH_CELL)
           PRINT_OP (PUSH_OV_U64)
           PRINT_OP (EXPAND_CS_LIST)
-          PRINT_OP (POW_DBL)
-          PRINT_OP (POW)
-          PRINT_OP (LDIV)
-          PRINT_OP (EL_MUL)
-          PRINT_OP (EL_DIV)
-          PRINT_OP (EL_POW)
-          PRINT_OP (EL_AND)
-          PRINT_OP (EL_OR)
-          PRINT_OP (EL_LDIV)
+          CASE_START (POW_DBL) PSHORT () CASE_END ()
+          CASE_START (POW) PSHORT () CASE_END ()
+          CASE_START (LDIV) PSHORT () CASE_END ()
+          CASE_START (EL_MUL) PSHORT () CASE_END ()
+          CASE_START (EL_DIV) PSHORT () CASE_END ()
+          CASE_START (EL_POW) PSHORT () CASE_END ()
+          CASE_START (EL_AND) PSHORT () CASE_END ()
+          CASE_START (EL_OR) PSHORT () CASE_END ()
+          CASE_START (EL_LDIV) PSHORT () CASE_END ()
           PRINT_OP (NOT_DBL)
           PRINT_OP (NOT_BOOL)
           PRINT_OP (NOT)
@@ -268,10 +277,10 @@ octave::opcodes_to_strings (std::vector<unsigned char> &v_code, std::vector<std:
           CASE_START (PUSH_FOLDED_CST) PSLOT () PSHORT () CASE_END ()
           CASE_START (SET_FOLDED_CST) PSLOT () CASE_END ()
 
-          CASE_START (LOAD_CST)       PCHAR () CASE_END ()
-          CASE_START (LOAD_CST_ALT2)  PCHAR () CASE_END ()
-          CASE_START (LOAD_CST_ALT3)  PCHAR () CASE_END ()
-          CASE_START (LOAD_CST_ALT4)  PCHAR () CASE_END ()
+          CASE_START (LOAD_CST)       PCST () CASE_END ()
+          CASE_START (LOAD_CST_ALT2)  PCST () CASE_END ()
+          CASE_START (LOAD_CST_ALT3)  PCST () CASE_END ()
+          CASE_START (LOAD_CST_ALT4)  PCST () CASE_END ()
           CASE_START (LOAD_2_CST)     PCHAR () CASE_END ()
           CASE_START (POP_N_INTS)     PCHAR () CASE_END ()
 
@@ -290,6 +299,10 @@ octave::opcodes_to_strings (std::vector<unsigned char> &v_code, std::vector<std:
           CASE_START (PUSH_PI)                    PSLOT() CASE_END ()
           CASE_START (PUSH_SLOT_NARGOUT1_SPECIAL) PSLOT() CASE_END ()
           CASE_START (PUSH_SLOT_INDEXED)          PSLOT() CASE_END ()
+          CASE_START (SLOT_BINOP_ASSIGN)          PSLOT() CASE_END ()
+          CASE_START (IDX_BINOP_ASSIGN)           PSLOT() CASE_END ()
+          CASE_START (SLOT_CMP_JMP_IFN)           PSLOT() CASE_END ()
+          CASE_START (IDX_CMP_JMP_IFN)            PSLOT() CASE_END ()
           CASE_START (PUSH_FCN_HANDLE)            PSLOT() CASE_END ()
           CASE_START (PUSH_SLOT_NARGOUT0)         PSLOT() CASE_END ()
           CASE_START (SET_SLOT_TO_STACK_DEPTH)    PSLOT() CASE_END ()
@@ -331,12 +344,12 @@ octave::opcodes_to_strings (std::vector<unsigned char> &v_code, std::vector<std:
 
           CASE_START (FOR_COMPLEX_COND) PSHORT () PWSLOT () PWSLOT () CASE_END ()
 
-          CASE_START (INDEX_STRUCT_NARGOUTN)  PCHAR () PWSLOT () PWSLOT () CASE_END ()
+          CASE_START (INDEX_STRUCT_NARGOUTN)  PCHAR () PWSLOT () PWSLOT () PSHORT () CASE_END ()
           CASE_START (END_ID)                 PSLOT () PCHAR () PCHAR () CASE_END ()
 
           CASE_START (PUSH_SLOT_NARGOUTN)     PSLOT () PCHAR () CASE_END ()
           CASE_START (BRAINDEAD_WARNING)      PSLOT () PCHAR () CASE_END ()
-          CASE_START (SUBASSIGN_STRUCT)       PSLOT () PWSLOT () CASE_END ()
+          CASE_START (SUBASSIGN_STRUCT)       PSLOT () PWSLOT () PSHORT () CASE_END ()
 
           CASE_START (SUBASSIGN_ID)         PSLOT () PCHAR () CASE_END ()
           CASE_START (SUBASSIGN_ID_MAT_1D)  PSLOT () PCHAR () CASE_END ()
@@ -669,6 +682,202 @@ std::shared_ptr<vm_profiler> vm::m_vm_profiler;
 bool vm::m_profiler_enabled;
 bool vm::m_trace_enabled;
 
+// Helpers for the fused instructions, see
+// bytecode_walker::maybe_fuse_instructions.  They only handle double
+// operands.  If they return false or nullptr nothing has been changed
+// and the VM executes the original instruction sequence instead.
+
+// Read the value pushed by the operand code at P, whose opcode is OP,
+// and advance P past that code.
+
+static inline bool
+fused_dbl_operand (INSTR op, unsigned char *&p, stack_element *bsp,
+                   const octave_value *data, double& val)
+{
+  switch (op)
+    {
+    case INSTR::PUSH_SLOT_NARGOUT1:
+      {
+        octave_base_value *ovb = bsp[p[1]].ovb;
+        if (ovb->type_id () != vm::m_scalar_typeid)
+          return false;
+        val = static_cast<octave_scalar *> (ovb)->octave_scalar::double_value ();
+        p += 2;
+        return true;
+      }
+
+    case INSTR::LOAD_CST:
+    case INSTR::LOAD_CST_ALT2:
+    case INSTR::LOAD_CST_ALT3:
+    case INSTR::LOAD_CST_ALT4:
+      // The compiler only fuses double constants
+      val = data[p[1]].scalar_value ();
+      p += 2;
+      return true;
+
+    case INSTR::PUSH_DBL_0:
+      val = 0;
+      p += 1;
+      return true;
+    case INSTR::PUSH_DBL_1:
+      val = 1;
+      p += 1;
+      return true;
+    case INSTR::PUSH_DBL_2:
+      val = 2;
+      p += 1;
+      return true;
+
+    case INSTR::PUSH_SLOT_INDEXED:
+      {
+        // x(i), i.e. PUSH_SLOT_INDEXED x, PUSH_SLOT_NARGOUT1 i, INDEX_ID x 1
+        octave_base_value *ovb_mat = bsp[p[1]].ovb;
+        octave_base_value *ovb_idx = bsp[p[3]].ovb;
+        if (ovb_mat->type_id () != vm::m_matrix_typeid
+            || ovb_idx->type_id () != vm::m_scalar_typeid)
+          return false;
+
+        const NDArray& mat
+          = static_cast<octave_matrix *> (ovb_mat)->matrix_ref ();
+        double idx_double
+          = static_cast<octave_scalar *> (ovb_idx)->octave_scalar::double_value ();
+
+        // Out of range and non-integer indices take the slow path, which
+        // throws the proper error.
+        if (! (idx_double >= 1 && idx_double <= mat.numel ()))
+          return false;
+        octave_idx_type idx = static_cast<octave_idx_type> (idx_double);
+        if (idx != idx_double)
+          return false;
+
+        val = mat.xelem (idx - 1);
+        p += 7;
+        return true;
+      }
+
+    default:
+      return false;
+    }
+}
+
+static inline bool
+fused_dbl_binop (INSTR op, double a, double b, double& r)
+{
+  switch (op)
+    {
+    case INSTR::ADD:
+    case INSTR::ADD_DBL:
+      r = a + b;
+      return true;
+    case INSTR::SUB:
+    case INSTR::SUB_DBL:
+      r = a - b;
+      return true;
+    case INSTR::MUL:
+    case INSTR::MUL_DBL:
+    case INSTR::EL_MUL:
+      r = a * b;
+      return true;
+    case INSTR::DIV:
+    case INSTR::DIV_DBL:
+    case INSTR::EL_DIV:
+      r = a / b;
+      return true;
+    default:
+      return false;
+    }
+}
+
+static inline bool
+fused_dbl_cmp (INSTR op, double a, double b, bool& r)
+{
+  switch (op)
+    {
+    case INSTR::LE:
+    case INSTR::LE_DBL:
+      r = a < b;
+      return true;
+    case INSTR::LE_EQ:
+    case INSTR::LE_EQ_DBL:
+      r = a <= b;
+      return true;
+    case INSTR::GR:
+    case INSTR::GR_DBL:
+      r = a > b;
+      return true;
+    case INSTR::GR_EQ:
+    case INSTR::GR_EQ_DBL:
+      r = a >= b;
+      return true;
+    case INSTR::EQ:
+    case INSTR::EQ_DBL:
+      r = a == b;
+      return true;
+    case INSTR::NEQ:
+    case INSTR::NEQ_DBL:
+      r = a != b;
+      return true;
+    default:
+      return false;
+    }
+}
+
+// "c = a OP b" starting at P, where the opcode of the first operand code
+// was FIRST before it was replaced.  Returns the address of the next
+// instruction.
+
+inline unsigned char *
+vm::fused_binop_assign (INSTR first, unsigned char *p, stack_element *bsp,
+                        const octave_value *data)
+{
+  double a, b, r;
+
+  if (! fused_dbl_operand (first, p, bsp, data, a))
+    return nullptr;
+  if (! fused_dbl_operand (static_cast<INSTR> (*p), p, bsp, data, b))
+    return nullptr;
+  if (! fused_dbl_binop (static_cast<INSTR> (*p), a, b, r))
+    return nullptr;
+
+  p += 3; // The operator and its cache index
+
+  // p is at ASSIGN
+  octave_value& lhs = bsp[p[1]].ov;
+  if (lhs.vm_need_dispatch_assign_lhs ())
+    return nullptr;
+
+  if (! lhs.maybe_update_double (r))
+    lhs = octave_value_factory::make (r);
+
+  return p + 2;
+}
+
+// "a CMP b" followed by JMP_IFN starting at P.  Returns the address of
+// the next instruction.
+
+inline unsigned char *
+vm::fused_cmp_jmp_ifn (INSTR first, unsigned char *p, unsigned char *code,
+                       stack_element *bsp, const octave_value *data)
+{
+  double a, b;
+  bool r;
+
+  if (! fused_dbl_operand (first, p, bsp, data, a))
+    return nullptr;
+  if (! fused_dbl_operand (static_cast<INSTR> (*p), p, bsp, data, b))
+    return nullptr;
+  if (! fused_dbl_cmp (static_cast<INSTR> (*p), a, b, r))
+    return nullptr;
+
+  p += 3; // The operator and its cache index
+
+  // p is at JMP_IFN
+  if (r)
+    return p + 3;
+
+  return code + (p[1] | (p[2] << 8));
+}
+
 // These two are used for pushing true and false ov:s to the
 // operand stack.
 static octave_value ov_true {true};
@@ -837,6 +1046,10 @@ vm::execute_code (const octave_value_list &root_args, int root_nargout)
       &&not_bool,                                          // NOT_BOOL,
       &&push_folded_cst,                                   // PUSH_FOLDED_CST,
       &&set_folded_cst,                                    // SET_FOLDED_CST,
+      &&slot_binop_assign,                                 // SLOT_BINOP_ASSIGN,
+      &&idx_binop_assign,                                  // IDX_BINOP_ASSIGN,
+      &&slot_cmp_jmp_ifn,                                  // SLOT_CMP_JMP_IFN,
+      &&idx_cmp_jmp_ifn,                                   // IDX_CMP_JMP_IFN,
       &&wide,                                              // WIDE
     };
 
@@ -1001,28 +1214,28 @@ load_cst:
   }
 mul_dbl:
   MAKE_BINOP_SPECIALIZED (m_fn_dbl_mul, mul, MUL, m_scalar_typeid)
-  DISPATCH_1BYTEOP();
+  DISPATCH ();
 mul:
   MAKE_BINOP_SELFMODIFYING (binary_op::op_mul, mul_dbl, MUL_DBL)
-  DISPATCH_1BYTEOP();
+  DISPATCH ();
 div_dbl:
   MAKE_BINOP_SPECIALIZED (m_fn_dbl_div, div, DIV, m_scalar_typeid)
-  DISPATCH_1BYTEOP();
+  DISPATCH ();
 div:
   MAKE_BINOP_SELFMODIFYING (binary_op::op_div, div_dbl, DIV_DBL)
-  DISPATCH_1BYTEOP();
+  DISPATCH ();
 add_dbl:
   MAKE_BINOP_SPECIALIZED (m_fn_dbl_add, add, ADD, m_scalar_typeid)
-  DISPATCH_1BYTEOP();
+  DISPATCH ();
 add:
   MAKE_BINOP_SELFMODIFYING (binary_op::op_add, add_dbl, ADD_DBL)
-  DISPATCH_1BYTEOP();
+  DISPATCH ();
 sub_dbl:
   MAKE_BINOP_SPECIALIZED (m_fn_dbl_sub, sub, SUB, m_scalar_typeid)
-  DISPATCH_1BYTEOP();
+  DISPATCH ();
 sub:
   MAKE_BINOP_SELFMODIFYING (binary_op::op_sub, sub_dbl, SUB_DBL)
-  DISPATCH_1BYTEOP();
+  DISPATCH ();
 ret:
   {
     // We need to tell the bytecode frame we are unwinding so that it can save
@@ -1769,40 +1982,40 @@ cmd_fcn_or_undef_error:
   DISPATCH ();
 le_dbl:
   MAKE_BINOP_SPECIALIZED (m_fn_dbl_le, le, LE, m_scalar_typeid)
-  DISPATCH_1BYTEOP ();
+  DISPATCH ();
 le:
   MAKE_BINOP_SELFMODIFYING (binary_op::op_lt, le_dbl, LE_DBL)
-  DISPATCH_1BYTEOP ();
+  DISPATCH ();
 le_eq_dbl:
   MAKE_BINOP_SPECIALIZED (m_fn_dbl_le_eq, le_eq, LE_EQ, m_scalar_typeid)
-  DISPATCH_1BYTEOP();
+  DISPATCH ();
 le_eq:
   MAKE_BINOP_SELFMODIFYING(binary_op::op_le, le_eq_dbl, LE_EQ_DBL)
-  DISPATCH_1BYTEOP();
+  DISPATCH ();
 gr_dbl:
   MAKE_BINOP_SPECIALIZED (m_fn_dbl_gr, gr, GR, m_scalar_typeid)
-  DISPATCH_1BYTEOP();
+  DISPATCH ();
 gr:
   MAKE_BINOP_SELFMODIFYING(binary_op::op_gt, gr_dbl, GR_DBL)
-  DISPATCH_1BYTEOP();
+  DISPATCH ();
 gr_eq_dbl:
   MAKE_BINOP_SPECIALIZED (m_fn_dbl_gr_eq, gr_eq, GR_EQ, m_scalar_typeid)
-  DISPATCH_1BYTEOP();
+  DISPATCH ();
 gr_eq:
   MAKE_BINOP_SELFMODIFYING(binary_op::op_ge, gr_eq_dbl, GR_EQ_DBL)
-  DISPATCH_1BYTEOP();
+  DISPATCH ();
 eq_dbl:
   MAKE_BINOP_SPECIALIZED(m_fn_dbl_eq, eq, EQ, m_scalar_typeid)
-  DISPATCH_1BYTEOP();
+  DISPATCH ();
 eq:
   MAKE_BINOP_SELFMODIFYING(binary_op::op_eq, eq_dbl, EQ_DBL)
-  DISPATCH_1BYTEOP();
+  DISPATCH ();
 neq_dbl:
   MAKE_BINOP_SPECIALIZED(m_fn_dbl_neq, neq, NEQ, m_scalar_typeid)
-  DISPATCH_1BYTEOP();
+  DISPATCH ();
 neq:
   MAKE_BINOP_SELFMODIFYING(binary_op::op_ne, neq_dbl, NEQ_DBL)
-  DISPATCH_1BYTEOP();
+  DISPATCH ();
 
 
 index_id1_mat_1d:
@@ -2181,6 +2394,50 @@ querry_fcn_cache:
   }
   DISPATCH ();
 
+slot_binop_assign:
+  {
+    unsigned char *next = fused_binop_assign (INSTR::PUSH_SLOT_NARGOUT1,
+                                              ip - 2, bsp, data);
+    if (OCTAVE_LIKELY (next))
+      {
+        ip = next;
+        DISPATCH ();
+      }
+  }
+  goto push_slot_nargout1;
+idx_binop_assign:
+  {
+    unsigned char *next = fused_binop_assign (INSTR::PUSH_SLOT_INDEXED,
+                                              ip - 2, bsp, data);
+    if (OCTAVE_LIKELY (next))
+      {
+        ip = next;
+        DISPATCH ();
+      }
+  }
+  goto push_slot_indexed;
+slot_cmp_jmp_ifn:
+  {
+    unsigned char *next = fused_cmp_jmp_ifn (INSTR::PUSH_SLOT_NARGOUT1,
+                                             ip - 2, code, bsp, data);
+    if (OCTAVE_LIKELY (next))
+      {
+        ip = next;
+        DISPATCH ();
+      }
+  }
+  goto push_slot_nargout1;
+idx_cmp_jmp_ifn:
+  {
+    unsigned char *next = fused_cmp_jmp_ifn (INSTR::PUSH_SLOT_INDEXED,
+                                             ip - 2, code, bsp, data);
+    if (OCTAVE_LIKELY (next))
+      {
+        ip = next;
+        DISPATCH ();
+      }
+  }
+  goto push_slot_indexed;
 push_slot_indexed:
   {
     // The next instruction is the slot number
@@ -2201,31 +2458,31 @@ push_slot_indexed:
 
 pow_dbl:
   MAKE_BINOP_SPECIALIZED (m_fn_dbl_pow, pow, POW, m_scalar_typeid)
-  DISPATCH_1BYTEOP();
+  DISPATCH ();
 pow:
   MAKE_BINOP_SELFMODIFYING(binary_op::op_pow, pow_dbl, POW_DBL)
-  DISPATCH_1BYTEOP();
+  DISPATCH ();
 ldiv:
-  MAKE_BINOP(binary_op::op_ldiv)
-  DISPATCH_1BYTEOP();
+  MAKE_BINOP_CACHED (binary_op::op_ldiv)
+  DISPATCH ();
 el_mul:
-  MAKE_BINOP(binary_op::op_el_mul)
-  DISPATCH_1BYTEOP();
+  MAKE_BINOP_CACHED (binary_op::op_el_mul)
+  DISPATCH ();
 el_div:
-  MAKE_BINOP(binary_op::op_el_div)
-  DISPATCH_1BYTEOP();
+  MAKE_BINOP_CACHED (binary_op::op_el_div)
+  DISPATCH ();
 el_pow:
-  MAKE_BINOP(binary_op::op_el_pow)
-  DISPATCH_1BYTEOP();
+  MAKE_BINOP_CACHED (binary_op::op_el_pow)
+  DISPATCH ();
 el_and:
-  MAKE_BINOP(binary_op::op_el_and)
-  DISPATCH_1BYTEOP();
+  MAKE_BINOP_CACHED (binary_op::op_el_and)
+  DISPATCH ();
 el_or:
-  MAKE_BINOP(binary_op::op_el_or)
-  DISPATCH_1BYTEOP();
+  MAKE_BINOP_CACHED (binary_op::op_el_or)
+  DISPATCH ();
 el_ldiv:
-  MAKE_BINOP(binary_op::op_el_ldiv)
-  DISPATCH_1BYTEOP();
+  MAKE_BINOP_CACHED (binary_op::op_el_ldiv)
+  DISPATCH ();
 
 not_dbl:
 MAKE_UNOP_SPECIALIZED (m_fn_dbl_not, op_not, NOT, m_scalar_typeid);
@@ -4958,47 +5215,72 @@ index_struct_n:
 
     int slot = POP_CODE_USHORT (); // Needed if we need a function lookup
     int slot_for_field = POP_CODE_USHORT ();
+    int cache_idx = POP_CODE_USHORT ();
 
     octave_value &ov = TOP_OV ();
 
-    std::string field_name = name_data [slot_for_field];
-
-    octave_value ov_field_name {field_name};
+    std::string &field_name = name_data [slot_for_field];
 
     octave_value_list retval;
 
-    // TODO: Should be a "simple_subsref for "{" and "."
-    octave_value_list ovl_idx;
-    ovl_idx.append (ov_field_name);
+    // Fast path for scalar structs.  The field index is cached for this
+    // instruction, so repeated accesses skip the field lookup.  Missing
+    // fields and function values take the general path below.
+    bool done = false;
 
-    std::list<octave_value_list> idx;
-    idx.push_back (ovl_idx);
+    if (ov.type_id () == octave_scalar_struct::static_type_id ())
+      {
+        octave_field_cache& cache = unwind_data->m_field_caches[cache_idx];
 
-    try
+        const octave_scalar_struct *ovb_struct
+          = static_cast<const octave_scalar_struct *> (ov.internal_rep ());
+
+        octave_value val = ovb_struct->getfield (field_name, cache);
+
+        if (val.is_defined () && ! val.is_function ())
+          {
+            retval = ovl (val);
+            done = true;
+          }
+      }
+
+    if (! done)
       {
-        m_tw->set_active_bytecode_ip (ip - code);
-        retval = ov.subsref(".", idx, nargout);
+        octave_value ov_field_name {field_name};
 
-        // TODO: Kludge for e.g. "m = containsers.Map;" which returns a function.
-        //       Should preferably be done by .subsref?
-        octave_value val = (retval.length () ? retval(0) : octave_value ());
-        if (val.is_function ())
+        // TODO: Should be a "simple_subsref for "{" and "."
+        octave_value_list ovl_idx;
+        ovl_idx.append (ov_field_name);
+
+        std::list<octave_value_list> idx;
+        idx.push_back (ovl_idx);
+
+        try
           {
-            octave_function *fcn = val.function_value (true);
+            m_tw->set_active_bytecode_ip (ip - code);
+            retval = ov.subsref(".", idx, nargout);
 
-            if (fcn)
+            // TODO: Kludge for e.g. "m = containsers.Map;" which returns a function.
+            //       Should preferably be done by .subsref?
+            octave_value val = (retval.length () ? retval(0) : octave_value ());
+            if (val.is_function ())
               {
-                retval = fcn->call (*m_tw, nargout, {});
+                octave_function *fcn = val.function_value (true);
+
+                if (fcn)
+                  {
+                    retval = fcn->call (*m_tw, nargout, {});
+                  }
               }
-          }
 
-        idx.clear ();
+            idx.clear ();
+          }
+        CATCH_INTERRUPT_EXCEPTION
+        CATCH_INDEX_EXCEPTION_WITH_NAME
+        CATCH_EXECUTION_EXCEPTION
+        CATCH_BAD_ALLOC
+        CATCH_EXIT_EXCEPTION
       }
-    CATCH_INTERRUPT_EXCEPTION
-    CATCH_INDEX_EXCEPTION_WITH_NAME
-    CATCH_EXECUTION_EXCEPTION
-    CATCH_BAD_ALLOC
-    CATCH_EXIT_EXCEPTION
 
     STACK_DESTROY (1);
     EXPAND_CSLIST_PUSH_N_OVL_ELEMENTS_TO_STACK (retval, nargout);
@@ -5009,6 +5291,7 @@ subasgn_struct:
   {
     int slot = arg0;
     int field_slot = POP_CODE_USHORT ();
+    int cache_idx = POP_CODE_USHORT ();
 
     // The top of the stack is the rhs value
     octave_value &rhs = TOP_OV ();
@@ -5022,30 +5305,45 @@ subasgn_struct:
     else
       ov.ref_rep ()->ref ().make_unique ();
 
-    // TODO: Uggly containers
-    std::list<octave_value_list> idx;
-    octave_value_list ovl;
+    std::string &field_name = name_data[field_slot];
 
-    std::string field_name = name_data[field_slot];
+    // Fast path for scalar structs, which are updated in place, using
+    // the field index cache of this instruction.
+    if (OCTAVE_LIKELY (!ov.is_ref ())
+        && ov.type_id () == octave_scalar_struct::static_type_id ())
+      {
+        octave_field_cache& cache = unwind_data->m_field_caches[cache_idx];
 
-    octave_value ov_field_name {field_name};
+        octave_scalar_struct *ovb_struct
+          = static_cast<octave_scalar_struct *> (ov.internal_rep ());
 
-    ovl.append (ov_field_name);
+        ovb_struct->setfield (field_name, rhs.storable_value (), cache);
+      }
+    else
+      {
+        // TODO: Uggly containers
+        std::list<octave_value_list> idx;
+        octave_value_list ovl;
 
-    idx.push_back (ovl);
+        octave_value ov_field_name {field_name};
 
-    // E.g. scalars do not update them self inplace
-    // but create a new octave_value, so we need to
-    // copy the return value to the slot.
-    try
-      {
-        ov = ov.subsasgn (".", idx, rhs);
+        ovl.append (ov_field_name);
+
+        idx.push_back (ovl);
+
+        // E.g. scalars do not update them self inplace
+        // but create a new octave_value, so we need to
+        // copy the return value to the slot.
+        try
+          {
+            ov = ov.subsasgn (".", idx, rhs);
+          }
+        CATCH_INTERRUPT_EXCEPTION
+        CATCH_INDEX_EXCEPTION_WITH_NAME
+        CATCH_EXECUTION_EXCEPTION
+        CATCH_BAD_ALLOC
+        CATCH_EXIT_EXCEPTION
       }
-    CATCH_INTERRUPT_EXCEPTION
-    CATCH_INDEX_EXCEPTION_WITH_NAME
-    CATCH_EXECUTION_EXCEPTION
-    CATCH_BAD_ALLOC
-    CATCH_EXIT_EXCEPTION
 
     STACK_DESTROY (1);
   }
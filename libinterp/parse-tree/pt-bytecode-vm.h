@@ -551,6 +551,15 @@ class vm
   unwind_entry* find_unwind_entry_for_current_state (bool only_find_unwind_protect);
   int find_unwind_entry_for_forloop (int current_stack_depth);
 
+  // Fused instructions
+  static unsigned char *
+  fused_binop_assign (INSTR first, unsigned char *p, stack_element *bsp,
+                      const octave_value *data);
+
+  static unsigned char *
+  fused_cmp_jmp_ifn (INSTR first, unsigned char *p, unsigned char *code,
+                     stack_element *bsp, const octave_value *data);
+
   static std::shared_ptr<vm_profiler> m_vm_profiler;
   static bool m_profiler_enabled;
   static bool m_trace_enabled;
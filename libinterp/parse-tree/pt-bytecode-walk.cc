@@ -28,6 +28,7 @@
 #endif
 
 #include "pt-all.h"
+#include "pt-bytecode-cache.h"
 #include "pt-bytecode-walk.h"
 #include "symrec.h"
 #include "pt-walk.h"
@@ -39,6 +40,13 @@ using namespace octave;
 
 void octave::compile_user_function (octave_user_function &ufn, bool do_print)
 {
+  // Function files compiled in an earlier session are loaded from the
+  // bytecode cache.  The subfunctions are loaded with the main function.
+  bool use_cache = ! do_print && bytecode_cache::is_cacheable (ufn);
+
+  if (use_cache && bytecode_cache::load (ufn))
+    return;
+
   try
     {
       if (ufn.is_classdef_constructor ())
@@ -72,6 +80,9 @@ void octave::compile_user_function (octave_user_function &ufn, bool do_print)
     ufn.clear_bytecode ();
     throw;
   }
+
+  if (use_cache)
+    bytecode_cache::save (ufn);
 }
 
 // Class to walk the tree and see if a index expression has
@@ -399,6 +410,17 @@ do {\
 #define UNWIND(i) m_code.m_unwind_data.m_unwind_entries[i]
 #define N_UNWIND() m_code.m_unwind_data.m_unwind_entries.size ()
 
+// Allocate a field index cache and push its index as a short operand
+#define PUSH_FIELD_CACHE() do {\
+  PUSH_CODE_SHORT (m_code.m_unwind_data.m_field_caches.size ());\
+  m_code.m_unwind_data.m_field_caches.emplace_back ();\
+} while ((0))
+
+#define PUSH_BINARY_OP_CACHE() do {\
+  PUSH_CODE_SHORT (m_code.m_unwind_data.m_binary_op_caches.size ());\
+  m_code.m_unwind_data.m_binary_op_caches.emplace_back ();\
+} while ((0))
+
 #define PUSH_GLOBAL(name) do {m_map_id_is_global[name] = 1;} while ((0))
 #define IS_GLOBAL(name) (m_map_id_is_global.find (name) !=\
                                                   m_map_id_is_global.end ())
@@ -1943,6 +1965,8 @@ visit_binary_expression (tree_binary_expression& expr)
       TODO ("not covered");
     }
 
+  PUSH_BINARY_OP_CACHE ();
+
   if (fold_slot != -1)
     {
       m_is_folding = false;
@@ -1994,6 +2018,142 @@ emit_load_2_cst (tree_expression *lhs, tree_expression *rhs)
   DEC_DEPTH();
 }
 
+// Returns the size of the code at OFFSET if it pushes a value that the
+// fused instructions can read without executing it, i.e. a variable, a
+// double constant or "x(i)" with x and i variables.  Otherwise -1.
+
+int
+bytecode_walker::
+fusable_operand_size (int offset)
+{
+  std::vector<unsigned char> &code = m_code.m_code;
+  int n = code.size ();
+
+  if (offset >= n)
+    return -1;
+
+  switch (static_cast<INSTR> (code[offset]))
+    {
+    case INSTR::PUSH_SLOT_NARGOUT1:
+      return 2;
+
+    case INSTR::LOAD_CST:
+    case INSTR::LOAD_CST_ALT2:
+    case INSTR::LOAD_CST_ALT3:
+    case INSTR::LOAD_CST_ALT4:
+      {
+        // The VM does not check the type of constants
+        if (offset + 2 > n)
+          return -1;
+        octave_value &ov = m_code.m_data[code[offset + 1]];
+        if (ov.type_id () != octave_scalar::static_type_id ())
+          return -1;
+        return 2;
+      }
+
+    case INSTR::PUSH_DBL_0:
+    case INSTR::PUSH_DBL_1:
+    case INSTR::PUSH_DBL_2:
+      return 1;
+
+    case INSTR::PUSH_SLOT_INDEXED:
+      // PUSH_SLOT_INDEXED x, PUSH_SLOT_NARGOUT1 i, INDEX_ID_NARGOUT1 x 1
+      if (offset + 7 <= n
+          && code[offset + 2] == static_cast<unsigned char> (INSTR::PUSH_SLOT_NARGOUT1)
+          && code[offset + 4] == static_cast<unsigned char> (INSTR::INDEX_ID_NARGOUT1)
+          && code[offset + 5] == code[offset + 1]
+          && code[offset + 6] == 1)
+        return 7;
+      return -1;
+
+    default:
+      return -1;
+    }
+}
+
+// Frequent instruction sequences are replaced by a fused instruction,
+// which does the work of the whole sequence in one dispatch when all
+// the operands are doubles.  The sequences are
+//
+//   a OP b, ASSIGN c          ->  SLOT_BINOP_ASSIGN or IDX_BINOP_ASSIGN
+//   a CMP b, JMP_IFN target   ->  SLOT_CMP_JMP_IFN or IDX_CMP_JMP_IFN
+//
+// where a is a variable or x(i) (which decides the fused opcode), b is
+// anything fusable_operand_size accepts, OP is +, -, *, /, .* or ./ and
+// CMP is a comparison.
+//
+// Only the opcode of the first instruction is replaced.  The rest of the
+// sequence is left as is, for the VM to read the operands from and to
+// fall back to if the operands are of other types.
+//
+// START is the offset of the first instruction.  The sequence has to end
+// at the end of the code emitted so far.
+
+void
+bytecode_walker::
+maybe_fuse_instructions (int start)
+{
+  if (! V__vm_fuse_instructions__)
+    return;
+
+  std::vector<unsigned char> &code = m_code.m_code;
+  int end = code.size ();
+
+  if (start >= end)
+    return;
+
+  INSTR first = static_cast<INSTR> (code[start]);
+  if (first != INSTR::PUSH_SLOT_NARGOUT1 && first != INSTR::PUSH_SLOT_INDEXED)
+    return;
+
+  int n1 = fusable_operand_size (start);
+  if (n1 < 0)
+    return;
+  int n2 = fusable_operand_size (start + n1);
+  if (n2 < 0)
+    return;
+
+  // The operator and its cache index
+  int op_offset = start + n1 + n2;
+  if (op_offset + 3 >= end)
+    return;
+
+  INSTR op = static_cast<INSTR> (code[op_offset]);
+  INSTR tail = static_cast<INSTR> (code[op_offset + 3]);
+
+  bool is_slot = first == INSTR::PUSH_SLOT_NARGOUT1;
+
+  switch (op)
+    {
+    case INSTR::ADD:
+    case INSTR::SUB:
+    case INSTR::MUL:
+    case INSTR::DIV:
+    case INSTR::EL_MUL:
+    case INSTR::EL_DIV:
+      if (tail != INSTR::ASSIGN || op_offset + 5 != end)
+        return;
+      code[start] = static_cast<unsigned char>
+        (is_slot ? INSTR::SLOT_BINOP_ASSIGN : INSTR::IDX_BINOP_ASSIGN);
+      break;
+
+    case INSTR::LE:
+    case INSTR::LE_EQ:
+    case INSTR::GR:
+    case INSTR::GR_EQ:
+    case INSTR::EQ:
+    case INSTR::NEQ:
+      if (tail != INSTR::JMP_IFN || op_offset + 6 != end)
+        return;
+      code[start] = static_cast<unsigned char>
+        (is_slot ? INSTR::SLOT_CMP_JMP_IFN : INSTR::IDX_CMP_JMP_IFN);
+      break;
+
+    default:
+      return;
+    }
+}
+
 void
 bytecode_walker::
 visit_constant (tree_constant& cst)
@@ -3199,6 +3359,7 @@ visit_simple_assignment (tree_simple_assignment& expr)
               PUSH_CODE (INSTR::SUBASSIGN_STRUCT);
               PUSH_SLOT (slot);
               PUSH_WSLOT (slot_field);
+              PUSH_FIELD_CACHE ();
 
               if (DEPTH () != 1)
                 {
@@ -3408,6 +3569,8 @@ visit_simple_assignment (tree_simple_assignment& expr)
 
       tree_expression *rhs = expr.right_hand_side ();
 
+      int rhs_offset = CODE_SIZE ();
+
       CHECK_NONNULL (rhs);
       rhs->accept (*this);
       // The value of rhs is on the operand stack now
@@ -3426,6 +3589,8 @@ visit_simple_assignment (tree_simple_assignment& expr)
           MAYBE_PUSH_WIDE_OPEXT (slot);
           PUSH_CODE (INSTR::ASSIGN);
           PUSH_SLOT (slot);
+
+          maybe_fuse_instructions (rhs_offset);
         }
 
       // If the assignment is not at root we want to keep the
@@ -3807,6 +3972,7 @@ visit_do_until_command (tree_do_until_command& cmd)
     SET_CODE_SHORT (offset, CODE_SIZE ());
 
   CHECK_NONNULL (expr);
+  int cond_offset = CODE_SIZE ();
   INC_DEPTH (); // Since we need the value
   PUSH_TREE_FOR_DBG (expr);
   expr->accept (*this);
@@ -3817,6 +3983,8 @@ visit_do_until_command (tree_do_until_command& cmd)
   PUSH_CODE (INSTR::JMP_IFN);
   PUSH_CODE_SHORT (code_start);
 
+  maybe_fuse_instructions (cond_offset);
+
   // The breaks jump to here
   for (int offset : POP_BREAKS ())
     SET_CODE_SHORT (offset, CODE_SIZE ());
@@ -3847,6 +4015,8 @@ visit_while_command (tree_while_command& cmd)
   int offset_need_jmp_after = CODE_SIZE ();
   PUSH_CODE_SHORT (-1); // Placeholder
 
+  maybe_fuse_instructions (cond_offset);
+
   LOC (loc_id).m_ip_end = CODE_SIZE ();
   LOC (loc_id).m_col = expr->column ();
   LOC (loc_id).m_line = expr->line ();
@@ -4079,6 +4249,8 @@ visit_if_command (tree_if_command& cmd)
           need_after_body = CODE_SIZE ();
           PUSH_CODE_SHORT (-1); // Placeholder, jump to after all
 
+          maybe_fuse_instructions (LOC (loc_id).m_ip_start);
+
           LOC (loc_id).m_ip_end = CODE_SIZE ();
           LOC (loc_id).m_col = cond->column ();
           LOC (loc_id).m_line = cond->line ();
@@ -4412,6 +4584,7 @@ simple_visit_index_expression (tree_index_expression& expr)
 
           PUSH_WSLOT (slot);   // id to index
           PUSH_WSLOT (SLOT (field_name)); // VM need name of the field
+          PUSH_FIELD_CACHE ();
         }
       else
         TODO ("Not implemeted typetag");
@@ -208,6 +208,9 @@ namespace octave
 
     void emit_load_2_cst (tree_expression *lhs, tree_expression *rhs);
 
+    int fusable_operand_size (int offset);
+    void maybe_fuse_instructions (int start);
+
     void maybe_emit_bind_ans_and_disp (tree_expression &expr, const std::string maybe_cmd_name = "");
     void maybe_emit_disp_id (tree_expression &expr, const std::string &name, const std::string maybe_cmd_name = "" );
     void maybe_emit_push_and_disp_id (tree_expression &expr, const std::string &name, const std::string maybe_cmd_name = "");
@@ -31,12 +31,19 @@
 
 #include "octave-config.h"
 #include "Cell.h"
+#include "oct-map.h"
+#include "ov-typeinfo.h"
 #include "ov-vm.h"
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
 class tree;
 
+// Increment when the compiler or the VM changes the meaning of the
+// bytecode, e.g. of the stack or the operands of an instruction.  Cached
+// bytecode of other versions is not used, see pt-bytecode-cache.cc.
+static const int bytecode_format_version = 1;
+
 enum class INSTR
 {
   POP,
@@ -180,6 +187,12 @@ enum class INSTR
   NOT_BOOL,
   PUSH_FOLDED_CST,
   SET_FOLDED_CST,
+  // Fused instructions.  They replace the first opcode of a sequence, see
+  // bytecode_walker::maybe_fuse_instructions.
+  SLOT_BINOP_ASSIGN,
+  IDX_BINOP_ASSIGN,
+  SLOT_CMP_JMP_IFN,
+  IDX_CMP_JMP_IFN,
   WIDE,
 };
 
@@ -216,6 +229,53 @@ struct arg_name_entry
   std::string m_obj_name;
 };
 
+// Inline cache for a binary operator instruction.  Remembers the operator
+// functions for the last few pairs of operand types seen by the
+// instruction, so that the lookup in the type_info tables is only done
+// when the types change.
+
+class binary_op_cache
+{
+public:
+
+  binary_op_cache () = default;
+
+  OCTAVE_DEFAULT_COPY_MOVE (binary_op_cache)
+
+  ~binary_op_cache () = default;
+
+  type_info::binary_op_fcn lookup (int t1, int t2) const
+  {
+    for (const auto& e : m_entries)
+      if (e.m_t1 == t1 && e.m_t2 == t2)
+        return e.m_fcn;
+
+    return nullptr;
+  }
+
+  void insert (int t1, int t2, type_info::binary_op_fcn fcn)
+  {
+    m_entries[m_next] = {t1, t2, fcn};
+    m_next = (m_next + 1) % n_entries;
+  }
+
+private:
+
+  static const int n_entries = 4;
+
+  struct entry
+  {
+    int m_t1 = -1;
+    int m_t2 = -1;
+    type_info::binary_op_fcn m_fcn = nullptr;
+  };
+
+  entry m_entries[n_entries];
+
+  // Entry to replace next.
+  int m_next = 0;
+};
+
 struct unwind_data
 {
   std::vector<unwind_entry> m_unwind_entries;
@@ -225,6 +285,13 @@ struct unwind_data
   std::vector<arg_name_entry> m_argname_entries;
   std::map<int,int> m_external_frame_offset_to_internal;
 
+  // Field index caches for the INDEX_STRUCT_NARGOUTN and SUBASSIGN_STRUCT
+  // instructions.  Each instruction has its own cache.
+  std::vector<octave_field_cache> m_field_caches;
+
+  // Inline caches for the binary operator instructions.
+  std::vector<binary_op_cache> m_binary_op_caches;
+
   std::string m_name;
   std::string m_file;
 
@@ -288,6 +355,10 @@ enum class global_type
 // If TRUE, use VM evaluator rather than tree walker.
 extern bool V__enable_vm_eval__;
 
+// If TRUE, the compiler emits fused instructions for frequent
+// instruction sequences.
+extern bool V__vm_fuse_instructions__;
+
 OCTAVE_END_NAMESPACE(octave)
 
 #endif
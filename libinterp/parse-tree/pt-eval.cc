@@ -41,6 +41,8 @@
 #include "file-stat.h"
 #include "lo-array-errwarn.h"
 #include "lo-ieee.h"
+#include "lo-mappers.h"
+#include "nproc-wrapper.h"
 #include "oct-env.h"
 
 #include "bp-table.h"
@@ -66,6 +68,7 @@
 #include "pt-all.h"
 #include "pt-anon-scopes.h"
 #include "pt-eval.h"
+#include "pt-parfor.h"
 #include "pt-tm-const.h"
 #include "stack-frame.h"
 #include "symtab.h"
@@ -3062,6 +3065,90 @@ tree_evaluator::execute_range_loop (const range<T>& rng, int line,
     }
 }
 
+// Execute the iterations of a parfor loop in worker processes.  Returns
+// false if the loop must be executed like a for loop instead.
+
+bool
+tree_evaluator::execute_parfor_loop (tree_simple_for_command& cmd,
+                                     const octave_value& rhs,
+                                     octave_lvalue& ult)
+{
+  if (parfor_loop::in_worker () || m_echo_state || m_debug_mode
+      || application::is_gui_running ())
+    return false;
+
+  int nproc = parfor_loop::default_workers ();
+
+  tree_expression *maxproc_expr = cmd.maxproc_expr ();
+
+  if (maxproc_expr)
+    {
+      octave_value maxproc = maxproc_expr->evaluate (*this);
+
+      double n = maxproc.xdouble_value ("parfor: MAXPROC must be a number");
+
+      if (math::isinf (n))
+        n = octave_num_processors_wrapper (OCTAVE_NPROC_CURRENT_OVERRIDABLE);
+
+      nproc = (math::isnan (n) ? 0 : math::nint (n));
+    }
+
+  if (nproc < 2)
+    return false;
+
+  if (! (rhs.is_range () || rhs.is_matrix_type () || rhs.iscell ()
+         || rhs.is_string () || rhs.isstruct ()))
+    return false;
+
+  dim_vector dv = rhs.dims ().redim (2);
+
+  if (dv(0) < 1 || dv(1) < 2)
+    return false;
+
+  parfor_loop loop (*this, cmd);
+
+  if (! loop.ok ())
+    {
+      warning_with_id ("Octave:parfor-serial",
+                       "parfor: executing loop serially: %s",
+                       loop.reason ().c_str ());
+      return false;
+    }
+
+  octave_value arg = rhs;
+  if (rhs.ndims () > 2)
+    arg = arg.reshape (dv);
+
+  tree_statement_list *loop_body = cmd.body ();
+
+  auto iteration = [&] (const octave_value& val)
+    {
+      ult.assign (octave_value::op_asn_eq, val);
+
+      if (loop_body)
+        loop_body->accept (*this);
+
+      // Decrement the continue state.
+      quit_loop_now ();
+    };
+
+  if (! loop.execute (*this, arg, nproc, iteration))
+    return false;
+
+  // The loop variable has the value of the last iteration, as after a
+  // for loop.
+  octave_value_list idx;
+  if (dv(0) == 1)
+    idx = ovl (static_cast<double> (dv(1)));
+  else
+    idx = ovl (octave_value (octave_value::magic_colon_t),
+               static_cast<double> (dv(1)));
+
+  ult.assign (octave_value::op_asn_eq, arg.index_op (idx));
+
+  return true;
+}
+
 void
 tree_evaluator::visit_simple_for_command (tree_simple_for_command& cmd)
 {
@@ -3078,9 +3165,6 @@ tree_evaluator::visit_simple_for_command (tree_simple_for_command& cmd)
   if (m_debug_mode)
     do_breakpoint (cmd.is_active_breakpoint (*this));
 
-  // FIXME: need to handle PARFOR loops here using cmd.in_parallel ()
-  // and cmd.maxproc_expr ();
-
   unwind_protect_var<bool> upv (m_in_loop_command, true);
 
   tree_expression *expr = cmd.control_expr ();
@@ -3096,6 +3180,9 @@ tree_evaluator::visit_simple_for_command (tree_simple_for_command& cmd)
 
   tree_statement_list *loop_body = cmd.body ();
 
+  if (cmd.in_parallel () && execute_parfor_loop (cmd, rhs, ult))
+    return;
+
   if (rhs.is_range ())
     {
       // FIXME: is there a better way to dispatch here?
@@ -861,6 +861,9 @@ private:
                            octave_lvalue& ult,
                            tree_statement_list *loop_body);
 
+  bool execute_parfor_loop (tree_simple_for_command& cmd,
+                            const octave_value& rhs, octave_lvalue& ult);
+
   void set_echo_state (int type, const std::string& file_name, int pos);
 
   void maybe_set_echo_state ();
@@ -0,0 +1,1609 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <cerrno>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// FIXME: As in oct-procbuf.cc, the worker processes need the system
+// functions for pipes and processes directly.
+
+#if (defined (HAVE_UNISTD_H)                                            \
+     && ! (defined (__CYGWIN__) || defined (__MINGW32__) || defined (_MSC_VER)))
+#  define OCTAVE_PARFOR_USE_FORK 1
+#  include <csignal>
+#  include <poll.h>
+#  if defined (HAVE_SYS_TYPES_H)
+#    include <sys/types.h>
+#  endif
+#  include <unistd.h>
+#endif
+
+#include "lo-mappers.h"
+#include "nproc-wrapper.h"
+#include "oct-rand.h"
+#include "oct-syscalls.h"
+#include "oct-thread-pool.h"
+#include "quit.h"
+#include "unistd-wrappers.h"
+
+#include "defun.h"
+#include "error.h"
+#include "interpreter-private.h"
+#include "interpreter.h"
+#include "ls-oct-binary.h"
+#include "octave.h"
+#include "ov.h"
+#include "ovl.h"
+#include "pager.h"
+#include "pt-all.h"
+#include "pt-eval.h"
+#include "pt-parfor.h"
+#include "pt-walk.h"
+#include "symtab.h"
+#include "variables.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+static int s_default_workers = 0;
+
+static bool s_in_worker = false;
+
+// Check the body of a parfor loop and classify its variables.
+
+class parfor_checker : public tree_walker
+{
+public:
+
+  parfor_checker (const std::string& loop_var)
+    : m_loop_var (loop_var), m_depth (0), m_statement_expr (nullptr)
+  { }
+
+  OCTAVE_DISABLE_COPY_MOVE (parfor_checker)
+
+  ~parfor_checker () = default;
+
+  // Classify the variables once the body has been walked.  Returns an
+  // empty string on success, otherwise the reason for failing.  The
+  // names that are only read are stored in READ_ONLY.
+  std::string finish (std::vector<parfor_loop::sliced_var>& sliced,
+                      std::vector<parfor_loop::reduction_var>& reductions,
+                      std::vector<std::string>& read_only);
+
+  void visit_identifier (tree_identifier& id)
+  {
+    std::string name = id.name ();
+
+    static const std::set<std::string> forbidden
+      = { "assignin", "clear", "clearvars", "eval", "evalc", "evalin",
+          "input", "inputname", "keyboard", "load", "run", "source" };
+
+    if (forbidden.count (name))
+      fail ("'" + name + "' can not be used in the loop body");
+
+    note_read (name);
+  }
+
+  void visit_simple_assignment (tree_simple_assignment& expr);
+
+  void visit_multi_assignment (tree_multi_assignment& expr);
+
+  void visit_statement (tree_statement& stmt)
+  {
+    m_statement_expr = stmt.expression ();
+
+    tree_walker::visit_statement (stmt);
+
+    m_statement_expr = nullptr;
+  }
+
+  void visit_prefix_expression (tree_prefix_expression& expr)
+  {
+    if (! maybe_increment (expr, expr.operand (), expr.op_type ()))
+      tree_walker::visit_prefix_expression (expr);
+  }
+
+  void visit_postfix_expression (tree_postfix_expression& expr)
+  {
+    if (! maybe_increment (expr, expr.operand (), expr.op_type ()))
+      tree_walker::visit_postfix_expression (expr);
+  }
+
+  void visit_simple_for_command (tree_simple_for_command& cmd);
+
+  void visit_complex_for_command (tree_complex_for_command& cmd);
+
+#define NESTED_COMMAND(TYPE)                    \
+  void visit_ ## TYPE (tree_ ## TYPE& cmd)      \
+  {                                             \
+    m_depth++;                                  \
+    tree_walker::visit_ ## TYPE (cmd);          \
+    m_depth--;                                  \
+  }
+
+  NESTED_COMMAND (if_command)
+  NESTED_COMMAND (switch_command)
+  NESTED_COMMAND (while_command)
+  NESTED_COMMAND (do_until_command)
+  NESTED_COMMAND (try_catch_command)
+  NESTED_COMMAND (unwind_protect_command)
+
+#undef NESTED_COMMAND
+
+  void visit_break_command (tree_break_command&)
+  {
+    fail ("'break' can not be used in the loop body");
+  }
+
+  void visit_return_command (tree_return_command&)
+  {
+    fail ("'return' can not be used in the loop body");
+  }
+
+  void visit_decl_command (tree_decl_command&)
+  {
+    fail ("global and persistent variables can not be declared"
+          " in the loop body");
+  }
+
+  void visit_function_def (tree_function_def&)
+  {
+    fail ("functions can not be defined in the loop body");
+  }
+
+private:
+
+  struct var_info
+  {
+    // Read outside of a sliced or reduction assignment.
+    bool m_read = false;
+
+    // Read before the first assignment at the top level of the body.
+    bool m_read_before_set = false;
+
+    // Assigned at the top level of the body.
+    bool m_set_at_top = false;
+
+    // Assigned as a whole.
+    bool m_assigned = false;
+
+    // Assigned as a sliced variable.
+    bool m_sliced = false;
+    parfor_loop::sliced_var m_slice;
+
+    // Updated as a reduction variable.
+    bool m_reduction = false;
+    parfor_loop::reduction_op m_op = parfor_loop::PLUS;
+
+    // Assigned in any other way.
+    std::string m_other;
+  };
+
+  void fail (const std::string& reason)
+  {
+    if (m_reason.empty ())
+      m_reason = reason;
+  }
+
+  void note_read (const std::string& name)
+  {
+    var_info& v = m_vars[name];
+
+    v.m_read = true;
+    if (! v.m_set_at_top)
+      v.m_read_before_set = true;
+  }
+
+  void note_set (const std::string& name, int depth)
+  {
+    var_info& v = m_vars[name];
+
+    v.m_assigned = true;
+    if (depth == 0)
+      v.m_set_at_top = true;
+  }
+
+  void note_reduction (const std::string& name, parfor_loop::reduction_op op)
+  {
+    var_info& v = m_vars[name];
+
+    if (v.m_reduction && v.m_op != op)
+      v.m_other = "it is updated with different reduction operators";
+
+    v.m_reduction = true;
+    v.m_op = op;
+  }
+
+  void note_other (const std::string& name, const std::string& why)
+  {
+    var_info& v = m_vars[name];
+
+    if (v.m_other.empty ())
+      v.m_other = why;
+  }
+
+  void visit_list (const std::vector<tree_expression *>& lst)
+  {
+    for (tree_expression *e : lst)
+      if (e)
+        e->accept (*this);
+  }
+
+  bool maybe_increment (tree_expression& expr, tree_expression *op,
+                        octave_value::unary_op etype);
+
+  bool match_sliced (tree_index_expression& lhs, parfor_loop::sliced_var& s);
+
+  bool match_reduction (const std::string& name, tree_expression *rhs,
+                        parfor_loop::reduction_op& op,
+                        std::vector<tree_expression *>& others);
+
+  std::string m_loop_var;
+
+  std::string m_reason;
+
+  std::map<std::string, var_info> m_vars;
+
+  // Nesting level of control commands in the loop body.
+  int m_depth;
+
+  // Expression of the statement being walked.
+  tree_expression *m_statement_expr;
+};
+
+static bool
+reduction_family (octave_value::binary_op op, parfor_loop::reduction_op& fam)
+{
+  switch (op)
+    {
+    case octave_value::op_add:
+    case octave_value::op_sub:
+      fam = parfor_loop::PLUS;
+      return true;
+
+    case octave_value::op_mul:
+      fam = parfor_loop::MTIMES;
+      return true;
+
+    case octave_value::op_el_mul:
+      fam = parfor_loop::TIMES;
+      return true;
+
+    case octave_value::op_el_and:
+      fam = parfor_loop::AND;
+      return true;
+
+    case octave_value::op_el_or:
+      fam = parfor_loop::OR;
+      return true;
+
+    default:
+      return false;
+    }
+}
+
+static tree_binary_expression *
+simple_binary_expression (tree_expression *e)
+{
+  if (! e || ! e->is_binary_expression () || e->is_boolean_expression ()
+      || dynamic_cast<tree_compound_binary_expression *> (e))
+    return nullptr;
+
+  return static_cast<tree_binary_expression *> (e);
+}
+
+static bool
+is_identifier (tree_expression *e, const std::string& name)
+{
+  return (e && e->is_identifier ()
+          && static_cast<tree_identifier *> (e)->name () == name);
+}
+
+bool
+parfor_checker::match_reduction (const std::string& name,
+                                 tree_expression *rhs,
+                                 parfor_loop::reduction_op& op,
+                                 std::vector<tree_expression *>& others)
+{
+  others.clear ();
+
+  tree_binary_expression *binexp = simple_binary_expression (rhs);
+
+  if (binexp)
+    {
+      parfor_loop::reduction_op fam;
+
+      if (! reduction_family (binexp->op_type (), fam))
+        return false;
+
+      // X = EXPR + X, for commutative operators.
+      octave_value::binary_op top_op = binexp->op_type ();
+
+      if (top_op != octave_value::op_sub && top_op != octave_value::op_mul
+          && is_identifier (binexp->rhs (), name))
+        {
+          others.push_back (binexp->lhs ());
+          op = fam;
+          return true;
+        }
+
+      // X = X + EXPR1 - EXPR2 ...
+      tree_expression *e = rhs;
+
+      while ((binexp = simple_binary_expression (e)))
+        {
+          parfor_loop::reduction_op e_fam;
+
+          if (! reduction_family (binexp->op_type (), e_fam) || e_fam != fam)
+            break;
+
+          others.push_back (binexp->rhs ());
+          e = binexp->lhs ();
+        }
+
+      if (is_identifier (e, name))
+        {
+          op = fam;
+          return true;
+        }
+
+      return false;
+    }
+
+  if (rhs && rhs->is_matrix ())
+    {
+      // X = [X, EXPR, ...] or X = [X; EXPR; ...]
+      tree_matrix *mat = static_cast<tree_matrix *> (rhs);
+
+      if (mat->empty () || ! mat->front () || mat->front ()->empty ())
+        return false;
+
+      tree_argument_list *first_row = mat->front ();
+
+      if (! is_identifier (first_row->front (), name))
+        return false;
+
+      if (mat->size () == 1)
+        {
+          op = parfor_loop::HORZCAT;
+          for (auto it = ++first_row->begin (); it != first_row->end (); it++)
+            others.push_back (*it);
+        }
+      else
+        {
+          if (first_row->size () != 1)
+            return false;
+
+          op = parfor_loop::VERTCAT;
+          for (auto row = ++mat->begin (); row != mat->end (); row++)
+            for (tree_expression *e : **row)
+              others.push_back (e);
+        }
+
+      return true;
+    }
+
+  if (rhs && rhs->is_index_expression ())
+    {
+      // X = min (X, EXPR) or X = max (X, EXPR)
+      tree_index_expression *idx = static_cast<tree_index_expression *> (rhs);
+
+      tree_expression *fcn = idx->expression ();
+
+      if (! fcn || ! fcn->is_identifier () || idx->type_tags () != "(")
+        return false;
+
+      std::string fcn_name = static_cast<tree_identifier *> (fcn)->name ();
+
+      if (fcn_name != "min" && fcn_name != "max")
+        return false;
+
+      tree_argument_list *args = idx->arg_lists ().front ();
+
+      if (! args || args->size () != 2)
+        return false;
+
+      tree_expression *a = args->front ();
+      tree_expression *b = args->back ();
+
+      if (is_identifier (a, name))
+        others.push_back (b);
+      else if (is_identifier (b, name))
+        others.push_back (a);
+      else
+        return false;
+
+      op = (fcn_name == "min" ? parfor_loop::MIN : parfor_loop::MAX);
+      return true;
+    }
+
+  return false;
+}
+
+bool
+parfor_checker::match_sliced (tree_index_expression& lhs,
+                              parfor_loop::sliced_var& s)
+{
+  std::string type = lhs.type_tags ();
+
+  if (type != "(" && type != "{")
+    return false;
+
+  tree_argument_list *args = lhs.arg_lists ().front ();
+
+  if (! args || args->empty ())
+    return false;
+
+  octave_value_list idx (args->size ());
+  int n_loop_var = 0;
+  int i = 0;
+
+  for (tree_expression *arg : *args)
+    {
+      if (is_identifier (arg, m_loop_var))
+        n_loop_var++;
+      else if (arg && arg->is_constant ())
+        {
+          octave_value val = static_cast<tree_constant *> (arg)->value ();
+
+          // A colon in a cell index would assign several cells.
+          if (type == "{" && val.is_magic_colon ())
+            return false;
+
+          idx(i) = val;
+        }
+      else
+        return false;
+
+      i++;
+    }
+
+  if (n_loop_var != 1)
+    return false;
+
+  s.m_type = type;
+  s.m_args = idx;
+
+  return true;
+}
+
+void
+parfor_checker::visit_simple_assignment (tree_simple_assignment& expr)
+{
+  tree_expression *lhs = expr.left_hand_side ();
+  tree_expression *rhs = expr.right_hand_side ();
+  octave_value::assign_op op = expr.op_type ();
+
+  if (lhs && lhs->is_identifier ())
+    {
+      std::string name = static_cast<tree_identifier *> (lhs)->name ();
+
+      parfor_loop::reduction_op red_op;
+      std::vector<tree_expression *> others;
+
+      if (op == octave_value::op_asn_eq)
+        {
+          if (match_reduction (name, rhs, red_op, others))
+            {
+              visit_list (others);
+              note_reduction (name, red_op);
+            }
+          else
+            {
+              if (rhs)
+                rhs->accept (*this);
+              note_set (name, m_depth);
+            }
+        }
+      else
+        {
+          if (rhs)
+            rhs->accept (*this);
+
+          if (reduction_family (octave_value::assign_op_to_binary_op (op),
+                                red_op))
+            note_reduction (name, red_op);
+          else
+            note_other (name, "of an unsupported computed assignment");
+        }
+    }
+  else if (lhs && lhs->is_index_expression ())
+    {
+      tree_index_expression& idx = *static_cast<tree_index_expression *> (lhs);
+
+      tree_expression *base = idx.expression ();
+
+      if (rhs)
+        rhs->accept (*this);
+
+      for (tree_argument_list *args : idx.arg_lists ())
+        if (args)
+          args->accept (*this);
+
+      if (! base || ! base->is_identifier ())
+        {
+          fail ("unsupported assignment in the loop body");
+          return;
+        }
+
+      std::string name = static_cast<tree_identifier *> (base)->name ();
+
+      parfor_loop::sliced_var s;
+
+      if (op != octave_value::op_asn_eq || ! match_sliced (idx, s))
+        {
+          note_other (name, "it is indexed by other values than"
+                      " the loop variable");
+          return;
+        }
+
+      var_info& v = m_vars[name];
+
+      s.m_name = name;
+
+      if (v.m_sliced
+          && (v.m_slice.m_type != s.m_type
+              || v.m_slice.m_args.length () != s.m_args.length ()))
+        note_other (name, "it is indexed in different ways");
+
+      v.m_sliced = true;
+      v.m_slice = s;
+    }
+  else
+    fail ("unsupported assignment in the loop body");
+}
+
+void
+parfor_checker::visit_multi_assignment (tree_multi_assignment& expr)
+{
+  tree_expression *rhs = expr.right_hand_side ();
+
+  if (rhs)
+    rhs->accept (*this);
+
+  tree_argument_list *lhs = expr.left_hand_side ();
+
+  if (! lhs)
+    return;
+
+  for (tree_expression *elt : *lhs)
+    {
+      if (elt && elt->is_identifier ())
+        {
+          tree_identifier *id = static_cast<tree_identifier *> (elt);
+
+          if (! id->is_black_hole ())
+            note_set (id->name (), m_depth);
+        }
+      else
+        fail ("only variables can be assigned by [A, B, ...] = EXPR"
+              " in the loop body");
+    }
+}
+
+bool
+parfor_checker::maybe_increment (tree_expression& expr, tree_expression *op,
+                                 octave_value::unary_op etype)
+{
+  if (etype != octave_value::op_incr && etype != octave_value::op_decr)
+    return false;
+
+  if (! op || ! op->is_identifier ())
+    {
+      fail ("unsupported increment in the loop body");
+      return true;
+    }
+
+  std::string name = static_cast<tree_identifier *> (op)->name ();
+
+  // X++ as a statement is a reduction, but its value is not.
+  if (m_statement_expr == &expr)
+    note_reduction (name, parfor_loop::PLUS);
+  else
+    note_other (name, "its value is used in an increment expression");
+
+  return true;
+}
+
+void
+parfor_checker::visit_simple_for_command (tree_simple_for_command& cmd)
+{
+  tree_expression *expr = cmd.control_expr ();
+
+  if (expr)
+    expr->accept (*this);
+
+  tree_expression *maxproc = cmd.maxproc_expr ();
+
+  if (maxproc)
+    maxproc->accept (*this);
+
+  m_depth++;
+
+  tree_expression *lhs = cmd.left_hand_side ();
+
+  if (lhs && lhs->is_identifier ())
+    note_set (static_cast<tree_identifier *> (lhs)->name (), m_depth);
+  else
+    fail ("unsupported loop variable in the loop body");
+
+  tree_statement_list *body = cmd.body ();
+
+  if (body)
+    body->accept (*this);
+
+  m_depth--;
+}
+
+void
+parfor_checker::visit_complex_for_command (tree_complex_for_command& cmd)
+{
+  tree_expression *expr = cmd.control_expr ();
+
+  if (expr)
+    expr->accept (*this);
+
+  m_depth++;
+
+  tree_argument_list *lhs = cmd.left_hand_side ();
+
+  if (lhs)
+    {
+      for (tree_expression *elt : *lhs)
+        {
+          if (elt && elt->is_identifier ())
+            note_set (static_cast<tree_identifier *> (elt)->name (), m_depth);
+          else
+            fail ("unsupported loop variable in the loop body");
+        }
+    }
+
+  tree_statement_list *body = cmd.body ();
+
+  if (body)
+    body->accept (*this);
+
+  m_depth--;
+}
+
+std::string
+parfor_checker::finish (std::vector<parfor_loop::sliced_var>& sliced,
+                        std::vector<parfor_loop::reduction_var>& reductions,
+                        std::vector<std::string>& read_only)
+{
+  if (! m_reason.empty ())
+    return m_reason;
+
+  for (const auto& kv : m_vars)
+    {
+      const std::string& name = kv.first;
+      const var_info& v = kv.second;
+
+      bool written = (v.m_assigned || v.m_sliced || v.m_reduction
+                      || ! v.m_other.empty ());
+
+      if (! written)
+        {
+          if (name != m_loop_var)
+            read_only.push_back (name);
+
+          continue;
+        }
+
+      if (name == m_loop_var)
+        return "the loop variable '" + name + "' is assigned in the loop body";
+
+      if (! v.m_other.empty ())
+        return "variable '" + name + "' can not be classified because "
+               + v.m_other;
+
+      if (v.m_sliced)
+        {
+          if (v.m_assigned || v.m_reduction || v.m_read)
+            return "variable '" + name + "' is assigned by indexing with the"
+                   " loop variable and also used in another way";
+
+          sliced.push_back (v.m_slice);
+        }
+      else if (v.m_reduction)
+        {
+          if (v.m_assigned || v.m_read)
+            return "reduction variable '" + name
+                   + "' is also used in another way";
+
+          reductions.push_back ({name, v.m_op});
+        }
+      else if (v.m_read_before_set)
+        return "variable '" + name + "' may be used before it is assigned"
+               " in an iteration";
+    }
+
+  return "";
+}
+
+parfor_loop::parfor_loop (tree_evaluator& tw, tree_simple_for_command& cmd)
+  : m_ok (false), m_reason (), m_loop_var (), m_sliced (), m_reductions ()
+{
+  tree_expression *lhs = cmd.left_hand_side ();
+
+  if (! lhs || ! lhs->is_identifier ())
+    {
+      m_reason = "the loop variable must be a simple variable";
+      return;
+    }
+
+  m_loop_var = static_cast<tree_identifier *> (lhs)->name ();
+
+  parfor_checker checker (m_loop_var);
+
+  tree_statement_list *body = cmd.body ();
+
+  if (body)
+    body->accept (checker);
+
+  std::vector<std::string> read_only;
+
+  m_reason = checker.finish (m_sliced, m_reductions, read_only);
+
+  // Names that are not variables are function calls.  Scripts could
+  // assign variables of the workspace, which would be lost in the
+  // workers.
+  if (m_reason.empty ())
+    {
+      symbol_table& symtab = tw.get_interpreter ().get_symbol_table ();
+
+      for (const auto& name : read_only)
+        {
+          if (tw.is_variable (name))
+            continue;
+
+          octave_value fcn = symtab.find_function (name);
+
+          if (fcn.is_defined () && fcn.is_user_script ())
+            {
+              m_reason = "the script '" + name
+                         + "' can not be called in the loop body";
+              break;
+            }
+        }
+    }
+
+  m_ok = m_reason.empty ();
+}
+
+int
+parfor_loop::default_workers ()
+{
+  return s_default_workers;
+}
+
+void
+parfor_loop::default_workers (int n)
+{
+  s_default_workers = (n < 0 ? 0 : n);
+}
+
+bool
+parfor_loop::in_worker ()
+{
+  return s_in_worker;
+}
+
+// Values of the reduction variables before the first iteration of a
+// range of iterations in a worker.  The results for the ranges are
+// combined with the value before the loop in the parent.
+
+static octave_value
+reduction_identity (parfor_loop::reduction_op op, const octave_value& init)
+{
+  switch (op)
+    {
+    case parfor_loop::PLUS:
+      return octave_value (0.0);
+
+    case parfor_loop::MTIMES:
+    case parfor_loop::TIMES:
+      return octave_value (1.0);
+
+    case parfor_loop::HORZCAT:
+    case parfor_loop::VERTCAT:
+      return octave_value (Matrix ());
+
+    default:
+      // AND, OR, MIN, and MAX give the same result if the initial value
+      // is used more than once.
+      return init;
+    }
+}
+
+static octave_value
+reduce (interpreter& interp, parfor_loop::reduction_op op,
+        const octave_value& a, const octave_value& b)
+{
+  switch (op)
+    {
+    case parfor_loop::PLUS:
+      return binary_op (octave_value::op_add, a, b);
+
+    case parfor_loop::MTIMES:
+      return binary_op (octave_value::op_mul, a, b);
+
+    case parfor_loop::TIMES:
+      return binary_op (octave_value::op_el_mul, a, b);
+
+    case parfor_loop::AND:
+      return binary_op (octave_value::op_el_and, a, b);
+
+    case parfor_loop::OR:
+      return binary_op (octave_value::op_el_or, a, b);
+
+    case parfor_loop::MIN:
+      return interp.feval ("min", ovl (a, b), 1)(0);
+
+    case parfor_loop::MAX:
+      return interp.feval ("max", ovl (a, b), 1)(0);
+
+    case parfor_loop::HORZCAT:
+      return interp.feval ("horzcat", ovl (a, b), 1)(0);
+
+    case parfor_loop::VERTCAT:
+      return interp.feval ("vertcat", ovl (a, b), 1)(0);
+    }
+
+  return octave_value ();
+}
+
+static octave_value
+loop_value (const octave_value& arg, octave_idx_type k)
+{
+  octave_value_list idx;
+
+  // Index ARG like the serial loop does, using one-based indices.
+  if (arg.rows () == 1)
+    idx = ovl (static_cast<double> (k + 1));
+  else
+    idx = ovl (octave_value (octave_value::magic_colon_t),
+               static_cast<double> (k + 1));
+
+  return octave_value (arg).index_op (idx);
+}
+
+static std::list<octave_value_list>
+slice_index (const parfor_loop::sliced_var& s, const octave_value& val)
+{
+  octave_value_list idx = s.m_args;
+
+  for (octave_idx_type i = 0; i < idx.length (); i++)
+    if (idx(i).is_undefined ())
+      idx(i) = val;
+
+  return std::list<octave_value_list> (1, idx);
+}
+
+// Messages between the parent and the workers.  A message is its
+// length followed by its contents.  Strings and values in a message are
+// written in the same way.
+
+static void
+write_string (std::ostream& os, const std::string& s)
+{
+  uint64_t len = s.length ();
+
+  os.write (reinterpret_cast<const char *> (&len), sizeof (len));
+  os.write (s.data (), len);
+}
+
+static std::string
+read_string (std::istream& is)
+{
+  uint64_t len = 0;
+
+  is.read (reinterpret_cast<char *> (&len), sizeof (len));
+
+  std::string s (is ? len : 0, '\0');
+
+  if (! s.empty ())
+    is.read (&s[0], len);
+
+  return s;
+}
+
+static void
+write_value (std::ostream& os, const octave_value& val)
+{
+  if (! save_binary_data (os, val, "", "", false, false))
+    error ("parfor: unable to send a value of type %s between processes",
+           val.type_name ().c_str ());
+}
+
+static octave_value
+read_value (std::istream& is)
+{
+  octave_value val;
+  bool global;
+  std::string doc;
+
+  read_binary_data (is, false, mach_info::native_float_format (),
+                    "parfor", global, val, doc);
+
+  return val;
+}
+
+#if defined (OCTAVE_PARFOR_USE_FORK)
+
+static bool
+write_all (int fd, const char *buf, std::size_t n)
+{
+  while (n > 0)
+    {
+      ssize_t status = ::write (fd, buf, n);
+
+      if (status < 0)
+        {
+          if (errno == EINTR)
+            continue;
+
+          return false;
+        }
+
+      buf += status;
+      n -= status;
+    }
+
+  return true;
+}
+
+static bool
+read_all (int fd, char *buf, std::size_t n)
+{
+  while (n > 0)
+    {
+      ssize_t status = ::read (fd, buf, n);
+
+      if (status < 0 && errno == EINTR)
+        continue;
+
+      if (status <= 0)
+        return false;
+
+      buf += status;
+      n -= status;
+    }
+
+  return true;
+}
+
+static bool
+send_message (int fd, const std::string& msg)
+{
+  uint64_t len = msg.length ();
+
+  return (write_all (fd, reinterpret_cast<const char *> (&len), sizeof (len))
+          && write_all (fd, msg.data (), len));
+}
+
+static bool
+receive_message (int fd, std::string& msg)
+{
+  uint64_t len = 0;
+
+  if (! read_all (fd, reinterpret_cast<char *> (&len), sizeof (len)))
+    return false;
+
+  msg.resize (len);
+
+  return len == 0 || read_all (fd, &msg[0], len);
+}
+
+static std::string
+chunk_message (octave_idx_type begin, octave_idx_type end)
+{
+  int64_t bounds[2] = { begin, end };
+
+  return std::string (reinterpret_cast<const char *> (bounds),
+                      sizeof (bounds));
+}
+
+// The worker processes of a parfor loop.  The destructor stops any
+// worker that is still running, for example after an interrupt.
+
+class parfor_workers
+{
+public:
+
+  struct worker
+  {
+    pid_t m_pid = -1;
+    int m_to_fd = -1;
+    int m_from_fd = -1;
+
+    // Range of iterations being executed, or -1 if idle.
+    octave_idx_type m_chunk = -1;
+  };
+
+  parfor_workers () = default;
+
+  OCTAVE_DISABLE_COPY_MOVE (parfor_workers)
+
+  ~parfor_workers ()
+  {
+    for (auto& w : m_workers)
+      {
+        close_fds (w);
+
+        if (w.m_pid > 0)
+          sys::kill (w.m_pid, SIGKILL);
+      }
+
+    wait ();
+  }
+
+  std::vector<worker>& list () { return m_workers; }
+
+  // Close the pipes of a worker.  It exits when it reads the end of its
+  // input.
+  static void close_fds (worker& w)
+  {
+    if (w.m_to_fd >= 0)
+      octave_close_wrapper (w.m_to_fd);
+
+    if (w.m_from_fd >= 0)
+      octave_close_wrapper (w.m_from_fd);
+
+    w.m_to_fd = w.m_from_fd = -1;
+  }
+
+  void wait ()
+  {
+    for (auto& w : m_workers)
+      {
+        if (w.m_pid > 0)
+          {
+            int status;
+            while (sys::waitpid (w.m_pid, &status, 0) < 0 && errno == EINTR)
+              ;
+          }
+
+        w.m_pid = -1;
+      }
+  }
+
+private:
+
+  std::vector<worker> m_workers;
+};
+
+#endif
+
+std::string
+parfor_loop::run_chunk (tree_evaluator& tw, const octave_value& arg,
+                        const iteration_fcn& fcn,
+                        const std::vector<octave_value>& initial,
+                        octave_idx_type begin, octave_idx_type end)
+{
+  interpreter& interp = tw.get_interpreter ();
+
+  std::ostringstream os;
+
+  try
+    {
+      for (std::size_t j = 0; j < m_reductions.size (); j++)
+        tw.assign (m_reductions[j].m_name,
+                   reduction_identity (m_reductions[j].m_op, initial[j]));
+
+      os.put (0);
+
+      for (octave_idx_type k = begin; k < end; k++)
+        {
+          octave_value val = loop_value (arg, k);
+
+          fcn (val);
+
+          for (const auto& s : m_sliced)
+            {
+              octave_value slice;
+
+              // The slice is missing if the iteration did not assign it.
+              try
+                {
+                  octave_value var = tw.varval (s.m_name);
+
+                  if (var.is_defined ())
+                    slice = var.subsref (s.m_type, slice_index (s, val));
+                }
+              catch (const execution_exception&)
+                {
+                  interp.recover_from_exception ();
+                }
+
+              os.put (slice.is_defined () ? 1 : 0);
+              if (slice.is_defined ())
+                write_value (os, slice);
+            }
+        }
+
+      for (const auto& r : m_reductions)
+        write_value (os, tw.varval (r.m_name));
+
+      return os.str ();
+    }
+  catch (const execution_exception& ee)
+    {
+      interp.recover_from_exception ();
+
+      os.str ("");
+      os.put (1);
+      write_string (os, ee.identifier ());
+      write_string (os, ee.message ());
+    }
+  catch (const interrupt_exception&)
+    {
+      interp.recover_from_exception ();
+
+      os.str ("");
+      os.put (1);
+      write_string (os, "Octave:interrupted");
+      write_string (os, "interrupted");
+    }
+  catch (const std::bad_alloc&)
+    {
+      os.str ("");
+      os.put (1);
+      write_string (os, "Octave:bad-alloc");
+      write_string (os, "out of memory or dimension too large"
+                        " for Octave's index type");
+    }
+
+  return os.str ();
+}
+
+#if defined (OCTAVE_PARFOR_USE_FORK)
+
+static const char *rand_distributions[]
+  = { "uniform", "normal", "exponential", "poisson", "gamma" };
+
+// Give the range of iterations starting at BEGIN its own random number
+// generator states, derived from the states STATES of the parent.
+// Otherwise every worker would draw the same numbers as the others.
+
+static void
+seed_random_numbers (const std::vector<uint32NDArray>& states,
+                     octave_idx_type begin)
+{
+  for (std::size_t j = 0; j < states.size (); j++)
+    {
+      const uint32NDArray& s = states[j];
+      octave_idx_type len = s.numel ();
+
+      uint32NDArray key (dim_vector (len + 2, 1));
+
+      std::copy_n (s.data (), len, key.fortran_vec ());
+
+      uint64_t k = begin;
+      key(len) = static_cast<uint32_t> (k);
+      key(len+1) = static_cast<uint32_t> (k >> 32);
+
+      rand::state (key, rand_distributions[j]);
+    }
+}
+
+#endif
+
+void
+parfor_loop::worker_main (tree_evaluator& tw, const octave_value& arg,
+                          const iteration_fcn& fcn, int in_fd, int out_fd)
+{
+#if defined (OCTAVE_PARFOR_USE_FORK)
+
+  s_in_worker = true;
+
+  // The threads of the parent do not exist in this process, and the
+  // workers already use all processors.
+  thread_pool::reset_after_fork ();
+
+  interpreter& interp = tw.get_interpreter ();
+
+  interp.get_output_system ().page_screen_output (false);
+
+  int status = 0;
+
+  try
+    {
+      std::vector<octave_value> initial;
+
+      for (const auto& r : m_reductions)
+        initial.push_back (tw.varval (r.m_name));
+
+      std::vector<uint32NDArray> rand_states;
+
+      for (const char *d : rand_distributions)
+        rand_states.push_back (rand::state (d));
+
+      std::string msg;
+
+      while (receive_message (in_fd, msg) && msg.length () >= 16)
+        {
+          const int64_t *bounds
+            = reinterpret_cast<const int64_t *> (msg.data ());
+
+          seed_random_numbers (rand_states, bounds[0]);
+
+          std::string result
+            = run_chunk (tw, arg, fcn, initial, bounds[0], bounds[1]);
+
+          flush_stdout ();
+
+          if (! send_message (out_fd, result))
+            break;
+        }
+    }
+  catch (...)
+    {
+      status = 1;
+    }
+
+  flush_stdout ();
+
+  // Leave without running any destructors or exit handlers of the
+  // parent's interpreter.
+  ::_exit (status);
+
+#else
+
+  octave_unused_parameter (tw);
+  octave_unused_parameter (arg);
+  octave_unused_parameter (fcn);
+  octave_unused_parameter (in_fd);
+  octave_unused_parameter (out_fd);
+
+#endif
+}
+
+void
+parfor_loop::merge (tree_evaluator& tw, const octave_value& arg,
+                    const std::vector<std::string>& results,
+                    const std::vector<octave_idx_type>& bounds)
+{
+  interpreter& interp = tw.get_interpreter ();
+
+  // Take the sliced variables out of the frame while they are updated,
+  // so that they are not copied for every assignment.
+  std::vector<octave_value> sliced;
+
+  for (const auto& s : m_sliced)
+    {
+      sliced.push_back (tw.varval (s.m_name));
+      tw.clear_variable (s.m_name);
+    }
+
+  std::vector<octave_value> reduced;
+
+  for (const auto& r : m_reductions)
+    reduced.push_back (tw.varval (r.m_name));
+
+  try
+    {
+      for (std::size_t c = 0; c < results.size (); c++)
+        {
+          std::istringstream is (results[c]);
+
+          // Skip the status.
+          is.get ();
+
+          for (octave_idx_type k = bounds[c]; k < bounds[c+1]; k++)
+            {
+              octave_value val = loop_value (arg, k);
+
+              for (std::size_t j = 0; j < m_sliced.size (); j++)
+                {
+                  if (! is.get ())
+                    continue;
+
+                  octave_value slice = read_value (is);
+
+                  sliced[j].assign (octave_value::op_asn_eq,
+                                    m_sliced[j].m_type,
+                                    slice_index (m_sliced[j], val), slice);
+                }
+            }
+
+          for (std::size_t j = 0; j < m_reductions.size (); j++)
+            {
+              octave_value part = read_value (is);
+
+              reduced[j] = reduce (interp, m_reductions[j].m_op,
+                                   reduced[j], part);
+            }
+        }
+    }
+  catch (...)
+    {
+      for (std::size_t j = 0; j < m_sliced.size (); j++)
+        if (sliced[j].is_defined ())
+          tw.assign (m_sliced[j].m_name, sliced[j]);
+
+      throw;
+    }
+
+  for (std::size_t j = 0; j < m_sliced.size (); j++)
+    if (sliced[j].is_defined ())
+      tw.assign (m_sliced[j].m_name, sliced[j]);
+
+  for (std::size_t j = 0; j < m_reductions.size (); j++)
+    tw.assign (m_reductions[j].m_name, reduced[j]);
+}
+
+bool
+parfor_loop::execute (tree_evaluator& tw, const octave_value& arg,
+                      int nproc, const iteration_fcn& fcn)
+{
+#if defined (OCTAVE_PARFOR_USE_FORK)
+
+  octave_idx_type n = arg.columns ();
+
+  if (! m_ok || nproc < 2 || n < 2 || s_in_worker)
+    return false;
+
+  // The reduction variables must have a value to start with.
+  for (const auto& r : m_reductions)
+    if (! tw.is_variable (r.m_name))
+      return false;
+
+  int nworkers = std::min (static_cast<octave_idx_type> (nproc), n);
+
+  // Split the iterations in a few ranges per worker, so that workers
+  // finishing early can take more work.
+  octave_idx_type nchunks
+    = std::min (n, static_cast<octave_idx_type> (4 * nworkers));
+
+  std::vector<octave_idx_type> bounds (nchunks + 1);
+  for (octave_idx_type c = 0; c <= nchunks; c++)
+    bounds[c] = (n * c) / nchunks;
+
+  // Don't let the workers print what is still buffered here.
+  flush_stdout ();
+
+  parfor_workers workers;
+  std::vector<parfor_workers::worker>& wlist = workers.list ();
+
+  for (int i = 0; i < nworkers; i++)
+    {
+      int to_child[2];
+      int from_child[2];
+
+      if (sys::pipe (to_child) < 0)
+        break;
+
+      if (sys::pipe (from_child) < 0)
+        {
+          octave_close_wrapper (to_child[0]);
+          octave_close_wrapper (to_child[1]);
+          break;
+        }
+
+      std::string msg;
+      pid_t pid = sys::fork (msg);
+
+      if (pid == 0)
+        {
+          // Only keep the pipes of this worker.
+          for (auto& w : wlist)
+            parfor_workers::close_fds (w);
+
+          octave_close_wrapper (to_child[1]);
+          octave_close_wrapper (from_child[0]);
+
+          worker_main (tw, arg, fcn, to_child[0], from_child[1]);
+        }
+
+      octave_close_wrapper (to_child[0]);
+      octave_close_wrapper (from_child[1]);
+
+      if (pid < 0)
+        {
+          octave_close_wrapper (to_child[1]);
+          octave_close_wrapper (from_child[0]);
+          break;
+        }
+
+      parfor_workers::worker w;
+      w.m_pid = pid;
+      w.m_to_fd = to_child[1];
+      w.m_from_fd = from_child[0];
+
+      wlist.push_back (w);
+    }
+
+  if (wlist.size () < 2)
+    return false;
+
+  std::vector<std::string> results (nchunks);
+
+  octave_idx_type next = 0;
+  octave_idx_type n_running = 0;
+
+  // Lowest failed range of iterations, as the serial loop would report
+  // the first error.
+  octave_idx_type failed = -1;
+
+  auto dispatch = [&] (parfor_workers::worker& w)
+    {
+      if (next < nchunks && failed < 0)
+        {
+          if (! send_message (w.m_to_fd,
+                              chunk_message (bounds[next], bounds[next+1])))
+            error ("parfor: lost connection to a worker process");
+
+          w.m_chunk = next++;
+          n_running++;
+        }
+    };
+
+  for (auto& w : wlist)
+    dispatch (w);
+
+  std::vector<struct pollfd> fds (wlist.size ());
+
+  while (n_running > 0)
+    {
+      for (std::size_t i = 0; i < wlist.size (); i++)
+        {
+          fds[i].fd = (wlist[i].m_chunk >= 0 ? wlist[i].m_from_fd : -1);
+          fds[i].events = POLLIN;
+          fds[i].revents = 0;
+        }
+
+      int status = ::poll (fds.data (), fds.size (), 100);
+
+      if (status < 0 && errno != EINTR)
+        error ("parfor: unable to wait for the worker processes");
+
+      octave_quit ();
+
+      if (status <= 0)
+        continue;
+
+      for (std::size_t i = 0; i < wlist.size (); i++)
+        {
+          parfor_workers::worker& w = wlist[i];
+
+          if (w.m_chunk < 0 || ! fds[i].revents)
+            continue;
+
+          octave_idx_type c = w.m_chunk;
+
+          if (! receive_message (w.m_from_fd, results[c])
+              || results[c].empty ())
+            error ("parfor: a worker process exited unexpectedly");
+
+          w.m_chunk = -1;
+          n_running--;
+
+          if (results[c][0] != 0 && (failed < 0 || c < failed))
+            failed = c;
+
+          dispatch (w);
+        }
+    }
+
+  // Let the workers exit.
+  for (auto& w : wlist)
+    parfor_workers::close_fds (w);
+
+  workers.wait ();
+
+  if (failed >= 0)
+    {
+      std::istringstream is (results[failed]);
+      is.get ();
+
+      std::string id = read_string (is);
+      std::string msg = read_string (is);
+
+      if (id.empty ())
+        error ("%s", msg.c_str ());
+      else
+        error_with_id (id.c_str (), "%s", msg.c_str ());
+    }
+
+  merge (tw, arg, results, bounds);
+
+  return true;
+
+#else
+
+  octave_unused_parameter (tw);
+  octave_unused_parameter (arg);
+  octave_unused_parameter (nproc);
+  octave_unused_parameter (fcn);
+
+  return false;
+
+#endif
+}
+
+DEFUN (__parfor_workers__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{n} =} __parfor_workers__ ()
+@deftypefnx {} {@var{old_n} =} __parfor_workers__ (@var{n})
+Query or set the number of worker processes for @code{parfor} loops that
+do not specify @var{maxproc}.
+
+The default is 0, so that such loops run like @code{for} loops.  A value
+of @code{Inf} uses @code{nproc ()} workers.
+
+@seealso{parfor, nproc}
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin > 1)
+    print_usage ();
+
+  int old_n = parfor_loop::default_workers ();
+
+  if (nargin == 1)
+    {
+      double n
+        = args(0).xdouble_value ("__parfor_workers__: N must be a number");
+
+      if (math::isnan (n) || n < 0)
+        error ("__parfor_workers__: N must be a non-negative number");
+
+      if (math::isinf (n))
+        n = octave_num_processors_wrapper (OCTAVE_NPROC_CURRENT_OVERRIDABLE);
+
+      parfor_loop::default_workers (math::nint (n));
+    }
+
+  return ovl (old_n);
+}
+
+/*
+%!test
+%! old_n = __parfor_workers__ (2);
+%! unwind_protect
+%!   assert (__parfor_workers__ (), 2);
+%!   x = zeros (1, 5);
+%!   parfor i = 1:5
+%!     x(i) = i;
+%!   endparfor
+%!   assert (x, 1:5);
+%! unwind_protect_cleanup
+%!   __parfor_workers__ (old_n);
+%! end_unwind_protect
+
+%!error <N must be a non-negative number> __parfor_workers__ (-1)
+*/
+
+OCTAVE_END_NAMESPACE(octave)
@@ -0,0 +1,153 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_pt_parfor_h)
+#define octave_pt_parfor_h 1
+
+#include "octave-config.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "ov.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+class tree_evaluator;
+class tree_simple_for_command;
+
+// Parallel execution of parfor loops in worker processes.
+//
+// The variables of the loop body are classified as in Matlab:
+//
+//   * Sliced output variables are only assigned as X(..., I, ...) or
+//     X{..., I, ...}, where I is the loop variable and the other indices
+//     are constants or colons.
+//
+//   * Reduction variables are only used in statements such as
+//     X = X + EXPR, X += EXPR, X = [X, EXPR] or X = max (X, EXPR).
+//
+//   * Temporary variables are assigned in every iteration before they
+//     are used.  They are private to the iteration and are not copied
+//     back.
+//
+//   * All other variables are broadcast variables that are only read.
+//     Loops that call scripts, which could assign variables, are not
+//     executed in parallel.
+//
+// The workers are created with fork, so they start with a copy of the
+// workspace and no input data needs to be sent to them.  The parent
+// sends ranges of iterations to idle workers over pipes, and the
+// workers send back the slices of the sliced output variables and the
+// partial results of the reduction variables.  The results are merged
+// in iteration order.  Each range of iterations draws random numbers
+// from its own generator states, which are derived from the states of
+// the parent.
+
+class parfor_loop
+{
+public:
+
+  typedef std::function<void (const octave_value&)> iteration_fcn;
+
+  parfor_loop (tree_evaluator& tw, tree_simple_for_command& cmd);
+
+  OCTAVE_DISABLE_COPY_MOVE (parfor_loop)
+
+  ~parfor_loop () = default;
+
+  // TRUE if the loop body can be executed in worker processes.
+  bool ok () const { return m_ok; }
+
+  // Why the loop can not be executed in worker processes.
+  std::string reason () const { return m_reason; }
+
+  // Execute FCN for the columns of the 2-D array ARG in up to NPROC
+  // worker processes and merge the results into the current frame of
+  // TW.  Returns false, without executing any iteration, if the workers
+  // could not be started.
+  bool execute (tree_evaluator& tw, const octave_value& arg, int nproc,
+                const iteration_fcn& fcn);
+
+  // Number of workers for parfor loops without a MAXPROC argument.
+  static int default_workers ();
+
+  static void default_workers (int n);
+
+  // TRUE in a worker process.
+  static bool in_worker ();
+
+  enum reduction_op
+  {
+    PLUS, MTIMES, TIMES, AND, OR, MIN, MAX, HORZCAT, VERTCAT
+  };
+
+  struct sliced_var
+  {
+    std::string m_name;
+
+    // "(" or "{".
+    std::string m_type;
+
+    // Constant indices.  The position of the loop variable is undefined.
+    octave_value_list m_args;
+  };
+
+  struct reduction_var
+  {
+    std::string m_name;
+
+    reduction_op m_op;
+  };
+
+private:
+
+  void worker_main (tree_evaluator& tw, const octave_value& arg,
+                    const iteration_fcn& fcn, int in_fd, int out_fd);
+
+  std::string run_chunk (tree_evaluator& tw, const octave_value& arg,
+                         const iteration_fcn& fcn,
+                         const std::vector<octave_value>& initial,
+                         octave_idx_type begin, octave_idx_type end);
+
+  void merge (tree_evaluator& tw, const octave_value& arg,
+              const std::vector<std::string>& results,
+              const std::vector<octave_idx_type>& bounds);
+
+  bool m_ok;
+
+  std::string m_reason;
+
+  std::string m_loop_var;
+
+  std::vector<sliced_var> m_sliced;
+
+  std::vector<reduction_var> m_reductions;
+};
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
@@ -2092,6 +2092,28 @@ Array<T, Alloc>::sort_rows_idx (sortmode mode) const
   return idx;
 }
 
+template <typename T, typename Alloc>
+Array<octave_idx_type>
+Array<T, Alloc>::sort_rows_idx (const Array<bool>& desc) const
+{
+  Array<octave_idx_type> idx;
+
+  octave_sort<T> lsort (safe_comparator (ASCENDING, *this, true));
+
+  octave_idx_type r = rows ();
+  octave_idx_type c = cols ();
+
+  if (desc.numel () != c)
+    (*current_liboctave_error_handler)
+      ("sort_rows_idx: DESC must have one element per column");
+
+  idx = Array<octave_idx_type> (dim_vector (r, 1));
+
+  lsort.sort_rows (data (), idx.fortran_vec (), r, c, desc.data ());
+
+  return idx;
+}
+
 template <typename T, typename Alloc>
 sortmode
 Array<T, Alloc>::is_sorted_rows (sortmode mode) const
@@ -2504,6 +2526,11 @@ Array<T, Alloc>::nth_element (const octave::idx_vector& n, int dim) const
   {                                                                     \
     return Array<octave_idx_type> ();                                   \
   }                                                                     \
+  template <> API Array<octave_idx_type>                                \
+  Array<T>::sort_rows_idx (const Array<bool>&) const                    \
+  {                                                                     \
+    return Array<octave_idx_type> ();                                   \
+  }                                                                     \
   template <> API sortmode                                              \
   Array<T>::is_sorted_rows (sortmode) const                             \
   {                                                                     \
@@ -302,7 +302,9 @@ public:
   // of values.  PTR must be allocated with operator new.  The Array
   // object takes ownership of PTR and will delete it when the Array
   // object is deleted.  The dimension vector DV must be consistent with
-  // the size of the allocated PTR array.
+  // the size of the allocated PTR array.  If XALLOCATOR is given, PTR is
+  // released with it instead, which allows arrays of data that is owned
+  // elsewhere (see the mex interface and sys::mapped_array).
 
   OCTARRAY_OVERRIDABLE_FUNC_API
   explicit Array (T *ptr, const dim_vector& dv,
@@ -809,6 +811,9 @@ public:
   //! Sort by rows returns only indices.
   OCTARRAY_API Array<octave_idx_type> sort_rows_idx (sortmode mode = ASCENDING) const;
 
+  //! Ditto, in ascending order except for the columns j with DESC(j) true.
+  OCTARRAY_API Array<octave_idx_type> sort_rows_idx (const Array<bool>& desc) const;
+
   //! Ordering is auto-detected or can be specified.
   OCTARRAY_API sortmode is_sorted_rows (sortmode mode = UNSORTED) const;
 
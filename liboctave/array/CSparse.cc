@@ -7489,6 +7489,41 @@ operator * (const SparseComplexMatrix& m, const SparseComplexMatrix& a)
   SPARSE_SPARSE_MUL (SparseComplexMatrix, Complex, Complex);
 }
 
+SparseComplexMatrix
+trans_mul (const SparseMatrix& m, const SparseComplexMatrix& a)
+{
+  SPARSE_SPARSE_TRANS_MUL (SparseComplexMatrix, Complex, Complex,
+                           transpose, );
+}
+
+SparseComplexMatrix
+trans_mul (const SparseComplexMatrix& m, const SparseMatrix& a)
+{
+  SPARSE_SPARSE_TRANS_MUL (SparseComplexMatrix, Complex, double,
+                           transpose, );
+}
+
+SparseComplexMatrix
+trans_mul (const SparseComplexMatrix& m, const SparseComplexMatrix& a)
+{
+  SPARSE_SPARSE_TRANS_MUL (SparseComplexMatrix, Complex, Complex,
+                           transpose, );
+}
+
+SparseComplexMatrix
+herm_mul (const SparseComplexMatrix& m, const SparseMatrix& a)
+{
+  SPARSE_SPARSE_TRANS_MUL (SparseComplexMatrix, Complex, double,
+                           hermitian, conj);
+}
+
+SparseComplexMatrix
+herm_mul (const SparseComplexMatrix& m, const SparseComplexMatrix& a)
+{
+  SPARSE_SPARSE_TRANS_MUL (SparseComplexMatrix, Complex, Complex,
+                           hermitian, conj);
+}
+
 ComplexMatrix
 operator * (const ComplexMatrix& m, const SparseMatrix& a)
 {
@@ -7537,12 +7572,30 @@ operator * (const SparseComplexMatrix& m, const ComplexMatrix& a)
   SPARSE_FULL_MUL (ComplexMatrix, Complex);
 }
 
+ComplexMatrix
+trans_mul (const SparseMatrix& m, const ComplexMatrix& a)
+{
+  SPARSE_FULL_TRANS_MUL (ComplexMatrix, Complex, );
+}
+
+ComplexMatrix
+trans_mul (const SparseComplexMatrix& m, const Matrix& a)
+{
+  SPARSE_FULL_TRANS_MUL (ComplexMatrix, Complex, );
+}
+
 ComplexMatrix
 trans_mul (const SparseComplexMatrix& m, const ComplexMatrix& a)
 {
   SPARSE_FULL_TRANS_MUL (ComplexMatrix, Complex, );
 }
 
+ComplexMatrix
+herm_mul (const SparseComplexMatrix& m, const Matrix& a)
+{
+  SPARSE_FULL_TRANS_MUL (ComplexMatrix, Complex, conj);
+}
+
 ComplexMatrix
 herm_mul (const SparseComplexMatrix& m, const ComplexMatrix& a)
 {
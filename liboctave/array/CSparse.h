@@ -482,6 +482,16 @@ extern OCTAVE_API SparseComplexMatrix
 operator * (const SparseComplexMatrix&, const SparseMatrix&);
 extern OCTAVE_API SparseComplexMatrix
 operator * (const SparseComplexMatrix&, const SparseComplexMatrix&);
+extern OCTAVE_API SparseComplexMatrix
+trans_mul (const SparseMatrix&, const SparseComplexMatrix&);
+extern OCTAVE_API SparseComplexMatrix
+trans_mul (const SparseComplexMatrix&, const SparseMatrix&);
+extern OCTAVE_API SparseComplexMatrix
+trans_mul (const SparseComplexMatrix&, const SparseComplexMatrix&);
+extern OCTAVE_API SparseComplexMatrix
+herm_mul (const SparseComplexMatrix&, const SparseMatrix&);
+extern OCTAVE_API SparseComplexMatrix
+herm_mul (const SparseComplexMatrix&, const SparseComplexMatrix&);
 
 extern OCTAVE_API ComplexMatrix
 operator * (const Matrix&, const SparseComplexMatrix&);
@@ -501,8 +511,14 @@ operator * (const SparseComplexMatrix&, const Matrix&);
 extern OCTAVE_API ComplexMatrix
 operator * (const SparseComplexMatrix&, const ComplexMatrix&);
 extern OCTAVE_API ComplexMatrix
+trans_mul (const SparseMatrix&, const ComplexMatrix&);
+extern OCTAVE_API ComplexMatrix
+trans_mul (const SparseComplexMatrix&, const Matrix&);
+extern OCTAVE_API ComplexMatrix
 trans_mul (const SparseComplexMatrix&, const ComplexMatrix&);
 extern OCTAVE_API ComplexMatrix
+herm_mul (const SparseComplexMatrix&, const Matrix&);
+extern OCTAVE_API ComplexMatrix
 herm_mul (const SparseComplexMatrix&, const ComplexMatrix&);
 
 extern OCTAVE_API SparseComplexMatrix
@@ -7508,6 +7508,12 @@ operator * (const SparseMatrix& m, const SparseMatrix& a)
   SPARSE_SPARSE_MUL (SparseMatrix, double, double);
 }
 
+SparseMatrix
+trans_mul (const SparseMatrix& m, const SparseMatrix& a)
+{
+  SPARSE_SPARSE_TRANS_MUL (SparseMatrix, double, double, transpose, );
+}
+
 Matrix
 operator * (const Matrix& m, const SparseMatrix& a)
 {
@@ -473,6 +473,8 @@ extern OCTAVE_API SparseMatrix imag (const SparseComplexMatrix& a);
 
 extern OCTAVE_API SparseMatrix operator * (const SparseMatrix& a,
                                            const SparseMatrix& b);
+extern OCTAVE_API SparseMatrix trans_mul (const SparseMatrix& a,
+                                          const SparseMatrix& b);
 extern OCTAVE_API Matrix operator * (const Matrix& a,
                                      const SparseMatrix& b);
 extern OCTAVE_API Matrix mul_trans (const Matrix& a,
@@ -47,6 +47,7 @@ NUMERIC_INC = \
   %reldir%/lu.h \
   %reldir%/oct-convn.h \
   %reldir%/oct-fftw.h \
+  %reldir%/oct-kdtree.h \
   %reldir%/oct-norm.h \
   %reldir%/oct-rand.h \
   %reldir%/oct-spparms.h \
@@ -83,6 +84,7 @@ NUMERIC_SRC = \
   %reldir%/lu.cc \
   %reldir%/oct-convn.cc \
   %reldir%/oct-fftw.cc \
+  %reldir%/oct-kdtree.cc \
   %reldir%/oct-norm.cc \
   %reldir%/oct-rand.cc \
   %reldir%/oct-spparms.cc \
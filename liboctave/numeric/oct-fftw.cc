@@ -38,7 +38,7 @@
 #include "singleton-cleanup.h"
 
 #if defined (HAVE_FFTW3_THREADS) || defined (HAVE_FFTW3F_THREADS)
-#  include "nproc-wrapper.h"
+#  include "oct-thread-budget.h"
 #endif
 
 OCTAVE_BEGIN_NAMESPACE(octave)
@@ -64,25 +64,93 @@ fftw_planner *fftw_planner::s_instance = nullptr;
 // acceleration.
 
 // Note that it is profitable to store the FFTW3 plans, for small FFTs.
+// Plans are kept in a small cache ordered by last use so that workloads
+// alternating between a few transform sizes do not replan on every call.
 
-fftw_planner::fftw_planner ()
-  : m_meth (ESTIMATE), m_rplan (nullptr), m_rd (0), m_rs (0), m_rr (0),
-    m_rh (0), m_rn (), m_rsimd_align (false), m_nthreads (1)
+// The cache is not guarded by a lock.  Plans must only be created and
+// used from the main thread, since creating a plan may destroy a plan
+// that another thread is executing, and the FFTW planner itself is not
+// thread-safe.
+
+#define CHECK_SIMD_ALIGNMENT(x)                         \
+  (((reinterpret_cast<std::ptrdiff_t> (x)) & 0xF) == 0)
+
+// A cached plan can be reused if everything but the alignment matches.
+// Don't use a SIMD plan for unaligned data, but do reuse a non SIMD plan
+// if the data happens to be aligned.  This prevents endlessly recreating
+// plans if the alignment changes between calls.
+
+template <typename KEY>
+static inline bool
+plan_key_matches (const KEY& cached, const KEY& key)
+{
+  if (cached.dir != key.dir || cached.rank != key.rank
+      || cached.howmany != key.howmany || cached.stride != key.stride
+      || cached.dist != key.dist || cached.inplace != key.inplace
+      || (cached.simd_align && ! key.simd_align))
+    return false;
+
+  for (int i = 0; i < key.rank; i++)
+    if (cached.dims(i) != key.dims(i))
+      return false;
+
+  return true;
+}
+
+template <typename METHOD>
+static inline int
+plan_flags_for_method (METHOD meth, octave_idx_type nn, bool ioalign,
+                       bool& plan_destroys_in)
 {
-  m_plan[0] = m_plan[1] = nullptr;
-  m_d[0] = m_d[1] = m_s[0] = m_s[1] = m_r[0] = m_r[1] = m_h[0] = m_h[1] = 0;
-  m_simd_align[0] = m_simd_align[1] = false;
-  m_inplace[0] = m_inplace[1] = false;
-  m_n[0] = m_n[1] = dim_vector ();
+  int plan_flags = 0;
+  plan_destroys_in = true;
+
+  switch (meth)
+    {
+    case METHOD::UNKNOWN:
+    case METHOD::ESTIMATE:
+      plan_flags |= FFTW_ESTIMATE;
+      plan_destroys_in = false;
+      break;
+    case METHOD::MEASURE:
+      plan_flags |= FFTW_MEASURE;
+      break;
+    case METHOD::PATIENT:
+      plan_flags |= FFTW_PATIENT;
+      break;
+    case METHOD::EXHAUSTIVE:
+      plan_flags |= FFTW_EXHAUSTIVE;
+      break;
+    case METHOD::HYBRID:
+      if (nn < 8193)
+        plan_flags |= FFTW_MEASURE;
+      else
+        {
+          plan_flags |= FFTW_ESTIMATE;
+          plan_destroys_in = false;
+        }
+      break;
+    }
+
+  if (ioalign)
+    plan_flags &= ~FFTW_UNALIGNED;
+  else
+    plan_flags |= FFTW_UNALIGNED;
 
+  return plan_flags;
+}
+
+fftw_planner::fftw_planner ()
+  : m_meth (ESTIMATE), m_plans (), m_cache_size (16), m_hits (0),
+    m_misses (0), m_nthreads (1)
+{
 #if defined (HAVE_FFTW3_THREADS)
   int init_ret = fftw_init_threads ();
   if (! init_ret)
     (*current_liboctave_error_handler) ("Error initializing FFTW threads");
 
-  // Check number of processors available to the current process
-  m_nthreads =
-    octave_num_processors_wrapper (OCTAVE_NPROC_CURRENT_OVERRIDABLE);
+  // Use the number of threads allowed for computations
+  m_nthreads = thread_budget::size ();
 
   // Limit number of threads to 3 by default
   // See: https://octave.discourse.group/t/3121
@@ -99,19 +167,7 @@ fftw_planner::fftw_planner ()
 
 fftw_planner::~fftw_planner ()
 {
-  fftw_plan *plan_p;
-
-  plan_p = reinterpret_cast<fftw_plan *> (&m_rplan);
-  if (*plan_p)
-    fftw_destroy_plan (*plan_p);
-
-  plan_p = reinterpret_cast<fftw_plan *> (&m_plan[0]);
-  if (*plan_p)
-    fftw_destroy_plan (*plan_p);
-
-  plan_p = reinterpret_cast<fftw_plan *> (&m_plan[1]);
-  if (*plan_p)
-    fftw_destroy_plan (*plan_p);
+  do_clear_cache ();
 }
 
 bool
@@ -136,9 +192,8 @@ fftw_planner::threads (int nt)
     {
       s_instance->m_nthreads = nt;
       fftw_plan_with_nthreads (nt);
-      // Clear the current plans.
-      s_instance->m_rplan = nullptr;
-      s_instance->m_plan[0] = s_instance->m_plan[1] = nullptr;
+      // Plans are bound to the number of threads they were created with.
+      s_instance->do_clear_cache ();
     }
 #else
   octave_unused_parameter (nt);
@@ -148,8 +203,67 @@ fftw_planner::threads (int nt)
 #endif
 }
 
-#define CHECK_SIMD_ALIGNMENT(x)                         \
-  (((reinterpret_cast<std::ptrdiff_t> (x)) & 0xF) == 0)
+void
+fftw_planner::cache_size (std::size_t n)
+{
+  if (! instance_ok ())
+    return;
+
+  s_instance->m_cache_size = (n < 1 ? 1 : n);
+
+  s_instance->trim_cache ();
+}
+
+void *
+fftw_planner::lookup_plan (const plan_key& key)
+{
+  for (auto p = m_plans.begin (); p != m_plans.end (); p++)
+    {
+      if (plan_key_matches (p->first, key))
+        {
+          // Keep the list ordered from most to least recently used.
+          if (p != m_plans.begin ())
+            m_plans.splice (m_plans.begin (), m_plans, p);
+
+          m_hits++;
+
+          return m_plans.front ().second;
+        }
+    }
+
+  m_misses++;
+
+  return nullptr;
+}
+
+void
+fftw_planner::insert_plan (const plan_key& key, void *plan)
+{
+  m_plans.emplace_front (key, plan);
+
+  trim_cache ();
+}
+
+// Destroy the least recently used plans beyond the size of the cache.
+
+void
+fftw_planner::trim_cache ()
+{
+  while (m_plans.size () > m_cache_size)
+    {
+      fftw_destroy_plan (reinterpret_cast<fftw_plan> (m_plans.back ().second));
+      m_plans.pop_back ();
+    }
+}
+
+void
+fftw_planner::do_clear_cache ()
+{
+  for (auto& key_plan : m_plans)
+    fftw_destroy_plan (reinterpret_cast<fftw_plan> (key_plan.second));
+
+  m_plans.clear ();
+}
 
 void *
 fftw_planner::do_create_plan (int dir, const int rank,
@@ -159,121 +273,63 @@ fftw_planner::do_create_plan (int dir, const int rank,
                               octave_idx_type dist,
                               const Complex *in, Complex *out)
 {
-  int which = (dir == FFTW_FORWARD) ? 0 : 1;
-  fftw_plan *cur_plan_p = reinterpret_cast<fftw_plan *> (&m_plan[which]);
-  bool create_new_plan = false;
   bool ioalign = CHECK_SIMD_ALIGNMENT (in) && CHECK_SIMD_ALIGNMENT (out);
   bool ioinplace = (in == out);
 
-  // Don't create a new plan if we have a non SIMD plan already but
-  // can do SIMD.  This prevents endlessly recreating plans if we
-  // change the alignment.
+  plan_key key {dir, rank, dims, howmany, stride, dist, ioalign, ioinplace};
 
-  if (m_plan[which] == nullptr || m_d[which] != dist || m_s[which] != stride
-      || m_r[which] != rank || m_h[which] != howmany
-      || ioinplace != m_inplace[which]
-      || ((ioalign != m_simd_align[which]) ? ! ioalign : false))
-    create_new_plan = true;
-  else
-    {
-      // We still might not have the same shape of array.
-
-      for (int i = 0; i < rank; i++)
-        if (dims(i) != m_n[which](i))
-          {
-            create_new_plan = true;
-            break;
-          }
-    }
+  void *plan = lookup_plan (key);
 
-  if (create_new_plan)
-    {
-      m_d[which] = dist;
-      m_s[which] = stride;
-      m_r[which] = rank;
-      m_h[which] = howmany;
-      m_simd_align[which] = ioalign;
-      m_inplace[which] = ioinplace;
-      m_n[which] = dims;
-
-      // Note reversal of dimensions for column major storage in FFTW.
-      octave_idx_type nn = 1;
-      OCTAVE_LOCAL_BUFFER (int, tmp, rank);
-
-      for (int i = 0, j = rank-1; i < rank; i++, j--)
-        {
-          tmp[i] = dims(j);
-          nn *= dims(j);
-        }
+  if (plan)
+    return plan;
 
-      int plan_flags = 0;
-      bool plan_destroys_in = true;
+  // Note reversal of dimensions for column major storage in FFTW.
+  octave_idx_type nn = 1;
+  OCTAVE_LOCAL_BUFFER (int, tmp, rank);
 
-      switch (m_meth)
-        {
-        case UNKNOWN:
-        case ESTIMATE:
-          plan_flags |= FFTW_ESTIMATE;
-          plan_destroys_in = false;
-          break;
-        case MEASURE:
-          plan_flags |= FFTW_MEASURE;
-          break;
-        case PATIENT:
-          plan_flags |= FFTW_PATIENT;
-          break;
-        case EXHAUSTIVE:
-          plan_flags |= FFTW_EXHAUSTIVE;
-          break;
-        case HYBRID:
-          if (nn < 8193)
-            plan_flags |= FFTW_MEASURE;
-          else
-            {
-              plan_flags |= FFTW_ESTIMATE;
-              plan_destroys_in = false;
-            }
-          break;
-        }
+  for (int i = 0, j = rank-1; i < rank; i++, j--)
+    {
+      tmp[i] = dims(j);
+      nn *= dims(j);
+    }
 
-      if (ioalign)
-        plan_flags &= ~FFTW_UNALIGNED;
-      else
-        plan_flags |= FFTW_UNALIGNED;
+  bool plan_destroys_in = true;
+  int plan_flags = plan_flags_for_method (m_meth, nn, ioalign,
+                                          plan_destroys_in);
 
-      if (*cur_plan_p)
-        fftw_destroy_plan (*cur_plan_p);
+  fftw_plan new_plan;
 
-      if (plan_destroys_in)
-        {
-          // Create matrix with the same size and 16-byte alignment as input
-          OCTAVE_LOCAL_BUFFER (Complex, itmp, nn * howmany + 32);
-          itmp = reinterpret_cast<Complex *>
-                 (((reinterpret_cast<std::ptrdiff_t> (itmp) + 15) & ~ 0xF) +
-                  ((reinterpret_cast<std::ptrdiff_t> (in)) & 0xF));
-
-          *cur_plan_p
-            = fftw_plan_many_dft (rank, tmp, howmany,
-                                  reinterpret_cast<fftw_complex *> (itmp),
-                                  nullptr, stride, dist,
-                                  reinterpret_cast<fftw_complex *> (out),
-                                  nullptr, stride, dist, dir, plan_flags);
-        }
-      else
-        {
-          *cur_plan_p
-            = fftw_plan_many_dft (rank, tmp, howmany,
-                                  reinterpret_cast<fftw_complex *> (const_cast<Complex *> (in)),
-                                  nullptr, stride, dist,
-                                  reinterpret_cast<fftw_complex *> (out),
-                                  nullptr, stride, dist, dir, plan_flags);
-        }
-
-      if (*cur_plan_p == nullptr)
-        (*current_liboctave_error_handler) ("Error creating FFTW plan");
+  if (plan_destroys_in)
+    {
+      // Create matrix with the same size and 16-byte alignment as input
+      OCTAVE_LOCAL_BUFFER (Complex, itmp, nn * howmany + 32);
+      itmp = reinterpret_cast<Complex *>
+             (((reinterpret_cast<std::ptrdiff_t> (itmp) + 15) & ~ 0xF) +
+              ((reinterpret_cast<std::ptrdiff_t> (in)) & 0xF));
+
+      new_plan
+        = fftw_plan_many_dft (rank, tmp, howmany,
+                              reinterpret_cast<fftw_complex *> (itmp),
+                              nullptr, stride, dist,
+                              reinterpret_cast<fftw_complex *> (out),
+                              nullptr, stride, dist, dir, plan_flags);
+    }
+  else
+    {
+      new_plan
+        = fftw_plan_many_dft (rank, tmp, howmany,
+                              reinterpret_cast<fftw_complex *> (const_cast<Complex *> (in)),
+                              nullptr, stride, dist,
+                              reinterpret_cast<fftw_complex *> (out),
+                              nullptr, stride, dist, dir, plan_flags);
     }
 
-  return *cur_plan_p;
+  if (new_plan == nullptr)
+    (*current_liboctave_error_handler) ("Error creating FFTW plan");
+
+  insert_plan (key, new_plan);
+
+  return new_plan;
 }
 
 void *
@@ -283,115 +339,61 @@ fftw_planner::do_create_plan (const int rank, const dim_vector& dims,
                               octave_idx_type dist,
                               const double *in, Complex *out)
 {
-  fftw_plan *cur_plan_p = reinterpret_cast<fftw_plan *> (&m_rplan);
-  bool create_new_plan = false;
   bool ioalign = CHECK_SIMD_ALIGNMENT (in) && CHECK_SIMD_ALIGNMENT (out);
 
-  // Don't create a new plan if we have a non SIMD plan already but
-  // can do SIMD.  This prevents endlessly recreating plans if we
-  // change the alignment.
+  plan_key key {0, rank, dims, howmany, stride, dist, ioalign, false};
 
-  if (m_rplan == nullptr || m_rd != dist || m_rs != stride || m_rr != rank
-      || m_rh != howmany || ((ioalign != m_rsimd_align) ? ! ioalign : false))
-    create_new_plan = true;
-  else
-    {
-      // We still might not have the same shape of array.
-
-      for (int i = 0; i < rank; i++)
-        if (dims(i) != m_rn(i))
-          {
-            create_new_plan = true;
-            break;
-          }
-    }
+  void *plan = lookup_plan (key);
 
-  if (create_new_plan)
-    {
-      m_rd = dist;
-      m_rs = stride;
-      m_rr = rank;
-      m_rh = howmany;
-      m_rsimd_align = ioalign;
-      m_rn = dims;
-
-      // Note reversal of dimensions for column major storage in FFTW.
-      octave_idx_type nn = 1;
-      OCTAVE_LOCAL_BUFFER (int, tmp, rank);
-
-      for (int i = 0, j = rank-1; i < rank; i++, j--)
-        {
-          tmp[i] = dims(j);
-          nn *= dims(j);
-        }
+  if (plan)
+    return plan;
 
-      int plan_flags = 0;
-      bool plan_destroys_in = true;
+  // Note reversal of dimensions for column major storage in FFTW.
+  octave_idx_type nn = 1;
+  OCTAVE_LOCAL_BUFFER (int, tmp, rank);
 
-      switch (m_meth)
-        {
-        case UNKNOWN:
-        case ESTIMATE:
-          plan_flags |= FFTW_ESTIMATE;
-          plan_destroys_in = false;
-          break;
-        case MEASURE:
-          plan_flags |= FFTW_MEASURE;
-          break;
-        case PATIENT:
-          plan_flags |= FFTW_PATIENT;
-          break;
-        case EXHAUSTIVE:
-          plan_flags |= FFTW_EXHAUSTIVE;
-          break;
-        case HYBRID:
-          if (nn < 8193)
-            plan_flags |= FFTW_MEASURE;
-          else
-            {
-              plan_flags |= FFTW_ESTIMATE;
-              plan_destroys_in = false;
-            }
-          break;
-        }
+  for (int i = 0, j = rank-1; i < rank; i++, j--)
+    {
+      tmp[i] = dims(j);
+      nn *= dims(j);
+    }
 
-      if (ioalign)
-        plan_flags &= ~FFTW_UNALIGNED;
-      else
-        plan_flags |= FFTW_UNALIGNED;
+  bool plan_destroys_in = true;
+  int plan_flags = plan_flags_for_method (m_meth, nn, ioalign,
+                                          plan_destroys_in);
 
-      if (*cur_plan_p)
-        fftw_destroy_plan (*cur_plan_p);
+  fftw_plan new_plan;
 
-      if (plan_destroys_in)
-        {
-          // Create matrix with the same size and 16-byte alignment as input
-          OCTAVE_LOCAL_BUFFER (double, itmp, nn + 32);
-          itmp = reinterpret_cast<double *>
-                 (((reinterpret_cast<std::ptrdiff_t> (itmp) + 15) & ~ 0xF) +
-                  ((reinterpret_cast<std::ptrdiff_t> (in)) & 0xF));
-
-          *cur_plan_p
-            = fftw_plan_many_dft_r2c (rank, tmp, howmany, itmp,
-                                      nullptr, stride, dist,
-                                      reinterpret_cast<fftw_complex *> (out),
-                                      nullptr, stride, dist, plan_flags);
-        }
-      else
-        {
-          *cur_plan_p
-            = fftw_plan_many_dft_r2c (rank, tmp, howmany,
-                                      (const_cast<double *> (in)),
-                                      nullptr, stride, dist,
-                                      reinterpret_cast<fftw_complex *> (out),
-                                      nullptr, stride, dist, plan_flags);
-        }
-
-      if (*cur_plan_p == nullptr)
-        (*current_liboctave_error_handler) ("Error creating FFTW plan");
+  if (plan_destroys_in)
+    {
+      // Create matrix with the same size and 16-byte alignment as input
+      OCTAVE_LOCAL_BUFFER (double, itmp, nn + 32);
+      itmp = reinterpret_cast<double *>
+             (((reinterpret_cast<std::ptrdiff_t> (itmp) + 15) & ~ 0xF) +
+              ((reinterpret_cast<std::ptrdiff_t> (in)) & 0xF));
+
+      new_plan
+        = fftw_plan_many_dft_r2c (rank, tmp, howmany, itmp,
+                                  nullptr, stride, dist,
+                                  reinterpret_cast<fftw_complex *> (out),
+                                  nullptr, stride, dist, plan_flags);
+    }
+  else
+    {
+      new_plan
+        = fftw_plan_many_dft_r2c (rank, tmp, howmany,
+                                  (const_cast<double *> (in)),
+                                  nullptr, stride, dist,
+                                  reinterpret_cast<fftw_complex *> (out),
+                                  nullptr, stride, dist, plan_flags);
     }
 
-  return *cur_plan_p;
+  if (new_plan == nullptr)
+    (*current_liboctave_error_handler) ("Error creating FFTW plan");
+
+  insert_plan (key, new_plan);
+
+  return new_plan;
 }
 
 fftw_planner::FftwMethod
@@ -411,13 +413,7 @@ fftw_planner::do_method (FftwMethod _meth)
       if (m_meth != _meth)
         {
           m_meth = _meth;
-          if (m_rplan)
-            fftw_destroy_plan (reinterpret_cast<fftw_plan> (m_rplan));
-          if (m_plan[0])
-            fftw_destroy_plan (reinterpret_cast<fftw_plan> (m_plan[0]));
-          if (m_plan[1])
-            fftw_destroy_plan (reinterpret_cast<fftw_plan> (m_plan[1]));
-          m_rplan = m_plan[0] = m_plan[1] = nullptr;
+          do_clear_cache ();
         }
     }
   else
@@ -428,24 +424,17 @@ fftw_planner::do_method (FftwMethod _meth)
 float_fftw_planner *float_fftw_planner::s_instance = nullptr;
 
 float_fftw_planner::float_fftw_planner ()
-  : m_meth (ESTIMATE), m_rplan (nullptr), m_rd (0), m_rs (0), m_rr (0),
-    m_rh (0), m_rn (), m_rsimd_align (false), m_nthreads (1)
+  : m_meth (ESTIMATE), m_plans (), m_cache_size (16), m_hits (0),
+    m_misses (0), m_nthreads (1)
 {
-  m_plan[0] = m_plan[1] = nullptr;
-  m_d[0] = m_d[1] = m_s[0] = m_s[1] = m_r[0] = m_r[1] = m_h[0] = m_h[1] = 0;
-  m_simd_align[0] = m_simd_align[1] = false;
-  m_inplace[0] = m_inplace[1] = false;
-  m_n[0] = m_n[1] = dim_vector ();
-
 #if defined (HAVE_FFTW3F_THREADS)
   int init_ret = fftwf_init_threads ();
   if (! init_ret)
     (*current_liboctave_error_handler) ("Error initializing FFTW3F threads");
 
-  // Use number of processors available to the current process
+  // Use the number of threads allowed for computations
   // This can be later changed with fftw ("threads", nthreads).
-  m_nthreads =
-    octave_num_processors_wrapper (OCTAVE_NPROC_CURRENT_OVERRIDABLE);
+  m_nthreads = thread_budget::size ();
 
   fftwf_plan_with_nthreads (m_nthreads);
 #endif
@@ -456,19 +445,7 @@ float_fftw_planner::float_fftw_planner ()
 
 float_fftw_planner::~float_fftw_planner ()
 {
-  fftwf_plan *plan_p;
-
-  plan_p = reinterpret_cast<fftwf_plan *> (&m_rplan);
-  if (*plan_p)
-    fftwf_destroy_plan (*plan_p);
-
-  plan_p = reinterpret_cast<fftwf_plan *> (&m_plan[0]);
-  if (*plan_p)
-    fftwf_destroy_plan (*plan_p);
-
-  plan_p = reinterpret_cast<fftwf_plan *> (&m_plan[1]);
-  if (*plan_p)
-    fftwf_destroy_plan (*plan_p);
+  do_clear_cache ();
 }
 
 bool
@@ -493,9 +470,8 @@ float_fftw_planner::threads (int nt)
     {
       s_instance->m_nthreads = nt;
       fftwf_plan_with_nthreads (nt);
-      // Clear the current plans.
-      s_instance->m_rplan = nullptr;
-      s_instance->m_plan[0] = s_instance->m_plan[1] = nullptr;
+      // Plans are bound to the number of threads they were created with.
+      s_instance->do_clear_cache ();
     }
 #else
   octave_unused_parameter (nt);
@@ -505,6 +481,68 @@ float_fftw_planner::threads (int nt)
 #endif
 }
 
+void
+float_fftw_planner::cache_size (std::size_t n)
+{
+  if (! instance_ok ())
+    return;
+
+  s_instance->m_cache_size = (n < 1 ? 1 : n);
+
+  s_instance->trim_cache ();
+}
+
+void *
+float_fftw_planner::lookup_plan (const plan_key& key)
+{
+  for (auto p = m_plans.begin (); p != m_plans.end (); p++)
+    {
+      if (plan_key_matches (p->first, key))
+        {
+          // Keep the list ordered from most to least recently used.
+          if (p != m_plans.begin ())
+            m_plans.splice (m_plans.begin (), m_plans, p);
+
+          m_hits++;
+
+          return m_plans.front ().second;
+        }
+    }
+
+  m_misses++;
+
+  return nullptr;
+}
+
+void
+float_fftw_planner::insert_plan (const plan_key& key, void *plan)
+{
+  m_plans.emplace_front (key, plan);
+
+  trim_cache ();
+}
+
+// Destroy the least recently used plans beyond the size of the cache.
+
+void
+float_fftw_planner::trim_cache ()
+{
+  while (m_plans.size () > m_cache_size)
+    {
+      fftwf_destroy_plan (reinterpret_cast<fftwf_plan> (m_plans.back ().second));
+      m_plans.pop_back ();
+    }
+}
+
+void
+float_fftw_planner::do_clear_cache ()
+{
+  for (auto& key_plan : m_plans)
+    fftwf_destroy_plan (reinterpret_cast<fftwf_plan> (key_plan.second));
+
+  m_plans.clear ();
+}
+
 void *
 float_fftw_planner::do_create_plan (int dir, const int rank,
                                     const dim_vector& dims,
@@ -514,121 +552,63 @@ float_fftw_planner::do_create_plan (int dir, const int rank,
                                     const FloatComplex *in,
                                     FloatComplex *out)
 {
-  int which = (dir == FFTW_FORWARD) ? 0 : 1;
-  fftwf_plan *cur_plan_p = reinterpret_cast<fftwf_plan *> (&m_plan[which]);
-  bool create_new_plan = false;
   bool ioalign = CHECK_SIMD_ALIGNMENT (in) && CHECK_SIMD_ALIGNMENT (out);
   bool ioinplace = (in == out);
 
-  // Don't create a new plan if we have a non SIMD plan already but
-  // can do SIMD.  This prevents endlessly recreating plans if we
-  // change the alignment.
+  plan_key key {dir, rank, dims, howmany, stride, dist, ioalign, ioinplace};
 
-  if (m_plan[which] == nullptr || m_d[which] != dist || m_s[which] != stride
-      || m_r[which] != rank || m_h[which] != howmany
-      || ioinplace != m_inplace[which]
-      || ((ioalign != m_simd_align[which]) ? ! ioalign : false))
-    create_new_plan = true;
-  else
-    {
-      // We still might not have the same shape of array.
-
-      for (int i = 0; i < rank; i++)
-        if (dims(i) != m_n[which](i))
-          {
-            create_new_plan = true;
-            break;
-          }
-    }
+  void *plan = lookup_plan (key);
 
-  if (create_new_plan)
-    {
-      m_d[which] = dist;
-      m_s[which] = stride;
-      m_r[which] = rank;
-      m_h[which] = howmany;
-      m_simd_align[which] = ioalign;
-      m_inplace[which] = ioinplace;
-      m_n[which] = dims;
-
-      // Note reversal of dimensions for column major storage in FFTW.
-      octave_idx_type nn = 1;
-      OCTAVE_LOCAL_BUFFER (int, tmp, rank);
-
-      for (int i = 0, j = rank-1; i < rank; i++, j--)
-        {
-          tmp[i] = dims(j);
-          nn *= dims(j);
-        }
+  if (plan)
+    return plan;
 
-      int plan_flags = 0;
-      bool plan_destroys_in = true;
+  // Note reversal of dimensions for column major storage in FFTW.
+  octave_idx_type nn = 1;
+  OCTAVE_LOCAL_BUFFER (int, tmp, rank);
 
-      switch (m_meth)
-        {
-        case UNKNOWN:
-        case ESTIMATE:
-          plan_flags |= FFTW_ESTIMATE;
-          plan_destroys_in = false;
-          break;
-        case MEASURE:
-          plan_flags |= FFTW_MEASURE;
-          break;
-        case PATIENT:
-          plan_flags |= FFTW_PATIENT;
-          break;
-        case EXHAUSTIVE:
-          plan_flags |= FFTW_EXHAUSTIVE;
-          break;
-        case HYBRID:
-          if (nn < 8193)
-            plan_flags |= FFTW_MEASURE;
-          else
-            {
-              plan_flags |= FFTW_ESTIMATE;
-              plan_destroys_in = false;
-            }
-          break;
-        }
+  for (int i = 0, j = rank-1; i < rank; i++, j--)
+    {
+      tmp[i] = dims(j);
+      nn *= dims(j);
+    }
 
-      if (ioalign)
-        plan_flags &= ~FFTW_UNALIGNED;
-      else
-        plan_flags |= FFTW_UNALIGNED;
+  bool plan_destroys_in = true;
+  int plan_flags = plan_flags_for_method (m_meth, nn, ioalign,
+                                          plan_destroys_in);
 
-      if (*cur_plan_p)
-        fftwf_destroy_plan (*cur_plan_p);
+  fftwf_plan new_plan;
 
-      if (plan_destroys_in)
-        {
-          // Create matrix with the same size and 16-byte alignment as input
-          OCTAVE_LOCAL_BUFFER (FloatComplex, itmp, nn * howmany + 32);
-          itmp = reinterpret_cast<FloatComplex *>
-                 (((reinterpret_cast<std::ptrdiff_t> (itmp) + 15) & ~ 0xF) +
-                  ((reinterpret_cast<std::ptrdiff_t> (in)) & 0xF));
-
-          *cur_plan_p
-            = fftwf_plan_many_dft (rank, tmp, howmany,
-                                   reinterpret_cast<fftwf_complex *> (itmp),
-                                   nullptr, stride, dist,
-                                   reinterpret_cast<fftwf_complex *> (out),
-                                   nullptr, stride, dist, dir, plan_flags);
-        }
-      else
-        {
-          *cur_plan_p
-            = fftwf_plan_many_dft (rank, tmp, howmany,
-                                   reinterpret_cast<fftwf_complex *> (const_cast<FloatComplex *> (in)),
-                                   nullptr, stride, dist,
-                                   reinterpret_cast<fftwf_complex *> (out),
-                                   nullptr, stride, dist, dir, plan_flags);
-        }
-
-      if (*cur_plan_p == nullptr)
-        (*current_liboctave_error_handler) ("Error creating FFTW plan");
+  if (plan_destroys_in)
+    {
+      // Create matrix with the same size and 16-byte alignment as input
+      OCTAVE_LOCAL_BUFFER (FloatComplex, itmp, nn * howmany + 32);
+      itmp = reinterpret_cast<FloatComplex *>
+             (((reinterpret_cast<std::ptrdiff_t> (itmp) + 15) & ~ 0xF) +
+              ((reinterpret_cast<std::ptrdiff_t> (in)) & 0xF));
+
+      new_plan
+        = fftwf_plan_many_dft (rank, tmp, howmany,
+                               reinterpret_cast<fftwf_complex *> (itmp),
+                               nullptr, stride, dist,
+                               reinterpret_cast<fftwf_complex *> (out),
+                               nullptr, stride, dist, dir, plan_flags);
     }
+  else
+    {
+      new_plan
+        = fftwf_plan_many_dft (rank, tmp, howmany,
+                               reinterpret_cast<fftwf_complex *> (const_cast<FloatComplex *> (in)),
+                               nullptr, stride, dist,
+                               reinterpret_cast<fftwf_complex *> (out),
+                               nullptr, stride, dist, dir, plan_flags);
+    }
+
+  if (new_plan == nullptr)
+    (*current_liboctave_error_handler) ("Error creating FFTW plan");
 
-  return *cur_plan_p;
+  insert_plan (key, new_plan);
+
+  return new_plan;
 }
 
 void *
@@ -638,115 +618,61 @@ float_fftw_planner::do_create_plan (const int rank, const dim_vector& dims,
                                     octave_idx_type dist,
                                     const float *in, FloatComplex *out)
 {
-  fftwf_plan *cur_plan_p = reinterpret_cast<fftwf_plan *> (&m_rplan);
-  bool create_new_plan = false;
   bool ioalign = CHECK_SIMD_ALIGNMENT (in) && CHECK_SIMD_ALIGNMENT (out);
 
-  // Don't create a new plan if we have a non SIMD plan already but
-  // can do SIMD.  This prevents endlessly recreating plans if we
-  // change the alignment.
-
-  if (m_rplan == nullptr || m_rd != dist || m_rs != stride || m_rr != rank
-      || m_rh != howmany || ((ioalign != m_rsimd_align) ? ! ioalign : false))
-    create_new_plan = true;
-  else
-    {
-      // We still might not have the same shape of array.
-
-      for (int i = 0; i < rank; i++)
-        if (dims(i) != m_rn(i))
-          {
-            create_new_plan = true;
-            break;
-          }
-    }
+  plan_key key {0, rank, dims, howmany, stride, dist, ioalign, false};
 
-  if (create_new_plan)
-    {
-      m_rd = dist;
-      m_rs = stride;
-      m_rr = rank;
-      m_rh = howmany;
-      m_rsimd_align = ioalign;
-      m_rn = dims;
-
-      // Note reversal of dimensions for column major storage in FFTW.
-      octave_idx_type nn = 1;
-      OCTAVE_LOCAL_BUFFER (int, tmp, rank);
-
-      for (int i = 0, j = rank-1; i < rank; i++, j--)
-        {
-          tmp[i] = dims(j);
-          nn *= dims(j);
-        }
+  void *plan = lookup_plan (key);
 
-      int plan_flags = 0;
-      bool plan_destroys_in = true;
+  if (plan)
+    return plan;
 
-      switch (m_meth)
-        {
-        case UNKNOWN:
-        case ESTIMATE:
-          plan_flags |= FFTW_ESTIMATE;
-          plan_destroys_in = false;
-          break;
-        case MEASURE:
-          plan_flags |= FFTW_MEASURE;
-          break;
-        case PATIENT:
-          plan_flags |= FFTW_PATIENT;
-          break;
-        case EXHAUSTIVE:
-          plan_flags |= FFTW_EXHAUSTIVE;
-          break;
-        case HYBRID:
-          if (nn < 8193)
-            plan_flags |= FFTW_MEASURE;
-          else
-            {
-              plan_flags |= FFTW_ESTIMATE;
-              plan_destroys_in = false;
-            }
-          break;
-        }
+  // Note reversal of dimensions for column major storage in FFTW.
+  octave_idx_type nn = 1;
+  OCTAVE_LOCAL_BUFFER (int, tmp, rank);
 
-      if (ioalign)
-        plan_flags &= ~FFTW_UNALIGNED;
-      else
-        plan_flags |= FFTW_UNALIGNED;
+  for (int i = 0, j = rank-1; i < rank; i++, j--)
+    {
+      tmp[i] = dims(j);
+      nn *= dims(j);
+    }
 
-      if (*cur_plan_p)
-        fftwf_destroy_plan (*cur_plan_p);
+  bool plan_destroys_in = true;
+  int plan_flags = plan_flags_for_method (m_meth, nn, ioalign,
+                                          plan_destroys_in);
 
-      if (plan_destroys_in)
-        {
-          // Create matrix with the same size and 16-byte alignment as input
-          OCTAVE_LOCAL_BUFFER (float, itmp, nn + 32);
-          itmp = reinterpret_cast<float *>
-                 (((reinterpret_cast<std::ptrdiff_t> (itmp) + 15) & ~ 0xF) +
-                  ((reinterpret_cast<std::ptrdiff_t> (in)) & 0xF));
-
-          *cur_plan_p
-            = fftwf_plan_many_dft_r2c (rank, tmp, howmany, itmp,
-                                       nullptr, stride, dist,
-                                       reinterpret_cast<fftwf_complex *> (out),
-                                       nullptr, stride, dist, plan_flags);
-        }
-      else
-        {
-          *cur_plan_p
-            = fftwf_plan_many_dft_r2c (rank, tmp, howmany,
-                                       (const_cast<float *> (in)),
-                                       nullptr, stride, dist,
-                                       reinterpret_cast<fftwf_complex *> (out),
-                                       nullptr, stride, dist, plan_flags);
-        }
+  fftwf_plan new_plan;
 
-      if (*cur_plan_p == nullptr)
-        (*current_liboctave_error_handler) ("Error creating FFTW plan");
+  if (plan_destroys_in)
+    {
+      // Create matrix with the same size and 16-byte alignment as input
+      OCTAVE_LOCAL_BUFFER (float, itmp, nn + 32);
+      itmp = reinterpret_cast<float *>
+             (((reinterpret_cast<std::ptrdiff_t> (itmp) + 15) & ~ 0xF) +
+              ((reinterpret_cast<std::ptrdiff_t> (in)) & 0xF));
+
+      new_plan
+        = fftwf_plan_many_dft_r2c (rank, tmp, howmany, itmp,
+                                   nullptr, stride, dist,
+                                   reinterpret_cast<fftwf_complex *> (out),
+                                   nullptr, stride, dist, plan_flags);
     }
+  else
+    {
+      new_plan
+        = fftwf_plan_many_dft_r2c (rank, tmp, howmany,
+                                   (const_cast<float *> (in)),
+                                   nullptr, stride, dist,
+                                   reinterpret_cast<fftwf_complex *> (out),
+                                   nullptr, stride, dist, plan_flags);
+    }
+
+  if (new_plan == nullptr)
+    (*current_liboctave_error_handler) ("Error creating FFTW plan");
+
+  insert_plan (key, new_plan);
 
-  return *cur_plan_p;
+  return new_plan;
 }
 
 float_fftw_planner::FftwMethod
@@ -766,13 +692,7 @@ float_fftw_planner::do_method (FftwMethod _meth)
       if (m_meth != _meth)
         {
           m_meth = _meth;
-          if (m_rplan)
-            fftwf_destroy_plan (reinterpret_cast<fftwf_plan> (m_rplan));
-          if (m_plan[0])
-            fftwf_destroy_plan (reinterpret_cast<fftwf_plan> (m_plan[0]));
-          if (m_plan[1])
-            fftwf_destroy_plan (reinterpret_cast<fftwf_plan> (m_plan[1]));
-          m_rplan = m_plan[0] = m_plan[1] = nullptr;
+          do_clear_cache ();
         }
     }
   else
@@ -30,7 +30,9 @@
 
 #include <cstddef>
 
+#include <list>
 #include <string>
+#include <utility>
 
 #include "dim-vector.h"
 #include "oct-cmplx.h"
@@ -107,6 +109,37 @@ public:
     return instance_ok () ? s_instance->m_nthreads : 0;
   }
 
+  // Maximum number of plans kept in the cache.  Setting a smaller size
+  // destroys the least recently used plans.
+
+  static void cache_size (std::size_t n);
+
+  static std::size_t cache_size ()
+  {
+    return instance_ok () ? s_instance->m_cache_size : 0;
+  }
+
+  static std::size_t cached_plans ()
+  {
+    return instance_ok () ? s_instance->m_plans.size () : 0;
+  }
+
+  static std::size_t cache_hits ()
+  {
+    return instance_ok () ? s_instance->m_hits : 0;
+  }
+
+  static std::size_t cache_misses ()
+  {
+    return instance_ok () ? s_instance->m_misses : 0;
+  }
+
+  static void clear_cache ()
+  {
+    if (instance_ok ())
+      s_instance->do_clear_cache ();
+  }
+
 private:
 
   static fftw_planner *s_instance;
@@ -131,48 +164,39 @@ private:
 
   FftwMethod m_meth;
 
-  // FIXME: perhaps this should be split into two classes?
-
-  // Plan for fft and ifft of complex values
-  void *m_plan[2];
+  // Everything that determines whether a cached plan may be reused.
+  // DIR is FFTW_FORWARD or FFTW_BACKWARD for complex transforms and 0
+  // for real to complex transforms.
 
-  // dist
-  octave_idx_type m_d[2];
-
-  // stride
-  octave_idx_type m_s[2];
-
-  // rank
-  int m_r[2];
-
-  // howmany
-  octave_idx_type m_h[2];
-
-  // dims
-  dim_vector m_n[2];
+  struct plan_key
+  {
+    int dir;
+    int rank;
+    dim_vector dims;
+    octave_idx_type howmany;
+    octave_idx_type stride;
+    octave_idx_type dist;
+    bool simd_align;
+    bool inplace;
+  };
 
-  bool m_simd_align[2];
-  bool m_inplace[2];
+  void * lookup_plan (const plan_key& key);
 
-  // Plan for fft of real values
-  void *m_rplan;
+  void insert_plan (const plan_key& key, void *plan);
 
-  // dist
-  octave_idx_type m_rd;
+  void trim_cache ();
 
-  // stride
-  octave_idx_type m_rs;
+  void do_clear_cache ();
 
-  // rank
-  int m_rr;
+  // Cached plans, most recently used first.  Only used from the main
+  // thread.
+  std::list<std::pair<plan_key, void *>> m_plans;
 
-  // howmany
-  octave_idx_type m_rh;
+  std::size_t m_cache_size;
 
-  // dims
-  dim_vector m_rn;
+  std::size_t m_hits;
 
-  bool m_rsimd_align;
+  std::size_t m_misses;
 
   // number of threads.  Always 1 unless compiled with multi-threading
   // support.
@@ -249,6 +273,37 @@ public:
     return instance_ok () ? s_instance->m_nthreads : 0;
   }
 
+  // Maximum number of plans kept in the cache.  Setting a smaller size
+  // destroys the least recently used plans.
+
+  static void cache_size (std::size_t n);
+
+  static std::size_t cache_size ()
+  {
+    return instance_ok () ? s_instance->m_cache_size : 0;
+  }
+
+  static std::size_t cached_plans ()
+  {
+    return instance_ok () ? s_instance->m_plans.size () : 0;
+  }
+
+  static std::size_t cache_hits ()
+  {
+    return instance_ok () ? s_instance->m_hits : 0;
+  }
+
+  static std::size_t cache_misses ()
+  {
+    return instance_ok () ? s_instance->m_misses : 0;
+  }
+
+  static void clear_cache ()
+  {
+    if (instance_ok ())
+      s_instance->do_clear_cache ();
+  }
+
 private:
 
   static float_fftw_planner *s_instance;
@@ -273,48 +328,39 @@ private:
 
   FftwMethod m_meth;
 
-  // FIXME: perhaps this should be split into two classes?
-
-  // Plan for fft and ifft of complex values
-  void *m_plan[2];
+  // Everything that determines whether a cached plan may be reused.
+  // DIR is FFTW_FORWARD or FFTW_BACKWARD for complex transforms and 0
+  // for real to complex transforms.
 
-  // dist
-  octave_idx_type m_d[2];
-
-  // stride
-  octave_idx_type m_s[2];
-
-  // rank
-  int m_r[2];
-
-  // howmany
-  octave_idx_type m_h[2];
-
-  // dims
-  dim_vector m_n[2];
+  struct plan_key
+  {
+    int dir;
+    int rank;
+    dim_vector dims;
+    octave_idx_type howmany;
+    octave_idx_type stride;
+    octave_idx_type dist;
+    bool simd_align;
+    bool inplace;
+  };
 
-  bool m_simd_align[2];
-  bool m_inplace[2];
+  void * lookup_plan (const plan_key& key);
 
-  // Plan for fft of real values
-  void *m_rplan;
+  void insert_plan (const plan_key& key, void *plan);
 
-  // dist
-  octave_idx_type m_rd;
+  void trim_cache ();
 
-  // stride
-  octave_idx_type m_rs;
+  void do_clear_cache ();
 
-  // rank
-  int m_rr;
+  // Cached plans, most recently used first.  Only used from the main
+  // thread.
+  std::list<std::pair<plan_key, void *>> m_plans;
 
-  // howmany
-  octave_idx_type m_rh;
+  std::size_t m_cache_size;
 
-  // dims
-  dim_vector m_rn;
+  std::size_t m_hits;
 
-  bool m_rsimd_align;
+  std::size_t m_misses;
 
   // number of threads.  Always 1 unless compiled with multi-threading
   // support.
@@ -0,0 +1,340 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "lo-ieee.h"
+#include "lo-mappers.h"
+#include "oct-kdtree.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+kdtree::kdtree (const Matrix& pts, octave_idx_type leaf_size)
+  : m_pts (pts), m_leaf_size (leaf_size < 1 ? 1 : leaf_size), m_perm (),
+    m_nodes ()
+{
+  octave_idx_type n = m_pts.rows ();
+  octave_idx_type np = m_pts.columns ();
+
+  const double *px = m_pts.data ();
+
+  m_perm.reserve (np);
+
+  for (octave_idx_type j = 0; j < np; j++)
+    {
+      bool has_nan = false;
+
+      for (octave_idx_type k = 0; k < n; k++)
+        if (math::isnan (px[j*n+k]))
+          {
+            has_nan = true;
+            break;
+          }
+
+      if (! has_nan)
+        m_perm.push_back (j);
+    }
+
+  if (! m_perm.empty ())
+    {
+      m_nodes.reserve (2 * (m_perm.size () / m_leaf_size) + 1);
+
+      build (0, m_perm.size ());
+    }
+}
+
+octave_idx_type
+kdtree::build (octave_idx_type begin, octave_idx_type end)
+{
+  octave_idx_type nid = m_nodes.size ();
+
+  m_nodes.push_back ({begin, end, -1, 0.0, -1, -1});
+
+  if (end - begin <= m_leaf_size)
+    return nid;
+
+  // Split along the dimension with the largest spread.
+
+  octave_idx_type n = m_pts.rows ();
+  const double *px = m_pts.data ();
+
+  octave_idx_type dim = -1;
+  double max_spread = 0.0;
+
+  for (octave_idx_type k = 0; k < n; k++)
+    {
+      double lo = px[m_perm[begin]*n+k];
+      double hi = lo;
+
+      for (octave_idx_type i = begin + 1; i < end; i++)
+        {
+          double v = px[m_perm[i]*n+k];
+
+          if (v < lo)
+            lo = v;
+          else if (v > hi)
+            hi = v;
+        }
+
+      double spread = hi - lo;
+
+      if (spread > max_spread)
+        {
+          max_spread = spread;
+          dim = k;
+        }
+    }
+
+  // All remaining points coincide.
+  if (dim < 0)
+    return nid;
+
+  octave_idx_type mid = begin + (end - begin) / 2;
+
+  std::nth_element (m_perm.begin () + begin, m_perm.begin () + mid,
+                    m_perm.begin () + end,
+                    [=] (octave_idx_type a, octave_idx_type b)
+                    {
+                      return px[a*n+dim] < px[b*n+dim];
+                    });
+
+  double split = px[m_perm[mid]*n+dim];
+
+  octave_idx_type left = build (begin, mid);
+  octave_idx_type right = build (mid, end);
+
+  node& nd = m_nodes[nid];
+
+  nd.dim = dim;
+  nd.split = split;
+  nd.left = left;
+  nd.right = right;
+
+  return nid;
+}
+
+double
+kdtree::dist2 (const double *q, octave_idx_type j) const
+{
+  octave_idx_type n = m_pts.rows ();
+  const double *px = m_pts.data () + j*n;
+
+  double dd = 0.0;
+
+  for (octave_idx_type k = 0; k < n; k++)
+    {
+      double d = px[k] - q[k];
+      dd += d * d;
+    }
+
+  return dd;
+}
+
+static bool
+any_nan (const double *q, octave_idx_type n)
+{
+  for (octave_idx_type k = 0; k < n; k++)
+    if (math::isnan (q[k]))
+      return true;
+
+  return false;
+}
+
+octave_idx_type
+kdtree::nearest (const double *q, double& dist) const
+{
+  if (m_nodes.empty () || any_nan (q, m_pts.rows ()))
+    {
+      dist = numeric_limits<double>::NaN ();
+      return -1;
+    }
+
+  candidate best {numeric_limits<double>::Inf (),
+                  std::numeric_limits<octave_idx_type>::max ()};
+
+  search_nearest (0, q, best);
+
+  dist = std::sqrt (best.dist2);
+
+  return best.idx;
+}
+
+void
+kdtree::search_nearest (octave_idx_type n, const double *q,
+                        candidate& best) const
+{
+  const node& nd = m_nodes[n];
+
+  if (nd.dim < 0)
+    {
+      for (octave_idx_type i = nd.begin; i < nd.end; i++)
+        {
+          candidate c {dist2 (q, m_perm[i]), m_perm[i]};
+
+          if (c < best)
+            best = c;
+        }
+
+      return;
+    }
+
+  double diff = q[nd.dim] - nd.split;
+
+  // Points equal to the split value may be on either side, so visit the
+  // far side on ties to find the lowest index.
+
+  search_nearest (diff < 0 ? nd.left : nd.right, q, best);
+
+  if (diff * diff <= best.dist2)
+    search_nearest (diff < 0 ? nd.right : nd.left, q, best);
+}
+
+void
+kdtree::knn (const double *q, octave_idx_type k,
+             std::vector<octave_idx_type>& idx,
+             std::vector<double>& dist) const
+{
+  idx.clear ();
+  dist.clear ();
+
+  if (k < 1 || m_nodes.empty () || any_nan (q, m_pts.rows ()))
+    return;
+
+  // Max-heap of the K best candidates found so far.
+  std::vector<candidate> heap;
+  heap.reserve (std::min (k, static_cast<octave_idx_type> (m_perm.size ())));
+
+  search_knn (0, q, k, heap);
+
+  std::sort_heap (heap.begin (), heap.end ());
+
+  idx.reserve (heap.size ());
+  dist.reserve (heap.size ());
+
+  for (const auto& c : heap)
+    {
+      idx.push_back (c.idx);
+      dist.push_back (std::sqrt (c.dist2));
+    }
+}
+
+void
+kdtree::search_knn (octave_idx_type n, const double *q, octave_idx_type k,
+                    std::vector<candidate>& heap) const
+{
+  const node& nd = m_nodes[n];
+
+  if (nd.dim < 0)
+    {
+      for (octave_idx_type i = nd.begin; i < nd.end; i++)
+        {
+          candidate c {dist2 (q, m_perm[i]), m_perm[i]};
+
+          if (static_cast<octave_idx_type> (heap.size ()) < k)
+            {
+              heap.push_back (c);
+              std::push_heap (heap.begin (), heap.end ());
+            }
+          else if (c < heap.front ())
+            {
+              std::pop_heap (heap.begin (), heap.end ());
+              heap.back () = c;
+              std::push_heap (heap.begin (), heap.end ());
+            }
+        }
+
+      return;
+    }
+
+  double diff = q[nd.dim] - nd.split;
+
+  search_knn (diff < 0 ? nd.left : nd.right, q, k, heap);
+
+  if (static_cast<octave_idx_type> (heap.size ()) < k
+      || diff * diff <= heap.front ().dist2)
+    search_knn (diff < 0 ? nd.right : nd.left, q, k, heap);
+}
+
+void
+kdtree::radius (const double *q, double r,
+                std::vector<octave_idx_type>& idx,
+                std::vector<double>& dist) const
+{
+  idx.clear ();
+  dist.clear ();
+
+  if (! (r >= 0) || m_nodes.empty () || any_nan (q, m_pts.rows ()))
+    return;
+
+  std::vector<candidate> found;
+
+  search_radius (0, q, r * r, found);
+
+  std::sort (found.begin (), found.end ());
+
+  idx.reserve (found.size ());
+  dist.reserve (found.size ());
+
+  for (const auto& c : found)
+    {
+      idx.push_back (c.idx);
+      dist.push_back (std::sqrt (c.dist2));
+    }
+}
+
+void
+kdtree::search_radius (octave_idx_type n, const double *q, double r2,
+                       std::vector<candidate>& found) const
+{
+  const node& nd = m_nodes[n];
+
+  if (nd.dim < 0)
+    {
+      for (octave_idx_type i = nd.begin; i < nd.end; i++)
+        {
+          double d2 = dist2 (q, m_perm[i]);
+
+          if (d2 <= r2)
+            found.push_back ({d2, m_perm[i]});
+        }
+
+      return;
+    }
+
+  double diff = q[nd.dim] - nd.split;
+
+  search_radius (diff < 0 ? nd.left : nd.right, q, r2, found);
+
+  if (diff * diff <= r2)
+    search_radius (diff < 0 ? nd.right : nd.left, q, r2, found);
+}
+
+OCTAVE_END_NAMESPACE(octave)
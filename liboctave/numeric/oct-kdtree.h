@@ -0,0 +1,143 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_oct_kdtree_h)
+#define octave_oct_kdtree_h 1
+
+#include "octave-config.h"
+
+#include <vector>
+
+#include "dMatrix.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Static k-d tree over a set of points for nearest neighbor, k nearest
+// neighbor, and fixed radius queries.
+//
+// The points are the columns of an N-by-NP matrix (one point per column,
+// which is the layout used by the geometry functions).  Points with NaN
+// coordinates are never returned.  When two points are at the same
+// distance from a query point, the one with the lower index is reported
+// first so that results match an exhaustive search.
+//
+// All indices are zero-based.
+
+class
+OCTAVE_API
+kdtree
+{
+public:
+
+  kdtree () = default;
+
+  kdtree (const Matrix& pts, octave_idx_type leaf_size = 16);
+
+  OCTAVE_DEFAULT_COPY_MOVE (kdtree)
+
+  ~kdtree () = default;
+
+  octave_idx_type dims () const { return m_pts.rows (); }
+
+  octave_idx_type numel () const { return m_pts.columns (); }
+
+  // Index of the point closest to the N-element query point Q and the
+  // Euclidean distance to it.  Returns -1 and NaN if the tree contains no
+  // points or Q has a NaN coordinate.
+
+  octave_idx_type nearest (const double *q, double& dist) const;
+
+  // Indices of (up to) the K nearest points to Q, ordered by increasing
+  // distance.
+
+  void knn (const double *q, octave_idx_type k,
+            std::vector<octave_idx_type>& idx,
+            std::vector<double>& dist) const;
+
+  // Indices of all points within distance R of Q, ordered by increasing
+  // distance.
+
+  void radius (const double *q, double r,
+               std::vector<octave_idx_type>& idx,
+               std::vector<double>& dist) const;
+
+private:
+
+  struct node
+  {
+    // Range of m_perm covered by this node.
+    octave_idx_type begin;
+    octave_idx_type end;
+
+    // Split dimension and value.  DIM is -1 for leaf nodes.
+    octave_idx_type dim;
+    double split;
+
+    // Children (indices into m_nodes).
+    octave_idx_type left;
+    octave_idx_type right;
+  };
+
+  // A candidate neighbor, ordered by squared distance and then by index.
+
+  struct candidate
+  {
+    double dist2;
+    octave_idx_type idx;
+
+    bool operator < (const candidate& c) const
+    {
+      return dist2 < c.dist2 || (dist2 == c.dist2 && idx < c.idx);
+    }
+  };
+
+  octave_idx_type build (octave_idx_type begin, octave_idx_type end);
+
+  double dist2 (const double *q, octave_idx_type j) const;
+
+  void search_nearest (octave_idx_type n, const double *q,
+                       candidate& best) const;
+
+  void search_knn (octave_idx_type n, const double *q, octave_idx_type k,
+                   std::vector<candidate>& heap) const;
+
+  void search_radius (octave_idx_type n, const double *q, double r2,
+                      std::vector<candidate>& found) const;
+
+  //--------
+
+  Matrix m_pts;
+
+  octave_idx_type m_leaf_size = 16;
+
+  // Permutation of point indices.  Each node covers a contiguous range.
+  std::vector<octave_idx_type> m_perm;
+
+  std::vector<node> m_nodes;
+};
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
@@ -28,10 +28,16 @@
 
 #include "octave-config.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "Array-util.h"
 #include "lo-array-errwarn.h"
 #include "mx-inlines.cc"
 #include "oct-locbuf.h"
+#include "oct-sort.h"
+#include "oct-thread-pool.h"
+#include "quit.h"
 
 // sparse matrix by scalar operations.
 
@@ -1760,6 +1766,41 @@
 
 #define SPARSE_ANY_OP(DIM) SPARSE_ANY_ALL_OP (DIM, false, false, !=, true)
 
+// Sparse matrix products are split across the liboctave thread pool for
+// large operands.  Call FCN (BEGIN, END, CHECK_QUIT) for ranges of a
+// multiple of GRAIN indices covering [0, N), in parallel if WORK (the
+// number of multiplications) is large enough.  Worker threads must not
+// handle interrupts, so CHECK_QUIT is only true if the range is processed
+// by the calling thread, and interrupts are checked once the parallel
+// loop is done.
+
+static const std::size_t sparse_mul_grain = 16;
+
+// Products of the transpose of a sparse matrix with a sparse matrix with
+// more columns than this transpose the first operand explicitly, because
+// computing each column of the result as dot products reads all of the
+// first operand.
+
+static const octave_idx_type sparse_trans_mul_max_cols = 4;
+
+template <typename F>
+inline void
+sparse_mul_parallel_for (octave_idx_type n, std::size_t work,
+                         std::size_t grain, const F& fcn)
+{
+  if (static_cast<std::size_t> (n) > grain
+      && octave::thread_pool::use_threads (work))
+    {
+      octave::thread_pool::parallel_for
+        (n, grain, [&fcn] (std::size_t begin, std::size_t end)
+         { fcn (begin, end, false); });
+
+      octave_quit ();
+    }
+  else
+    fcn (0, n, true);
+}
+
 #define SPARSE_SPARSE_MUL(RET_TYPE, RET_EL_TYPE, EL_TYPE)               \
   octave_idx_type nr = m.rows ();                                       \
   octave_idx_type nc = m.cols ();                                       \
@@ -1810,44 +1851,65 @@
       return r;                                                         \
     }                                                                   \
   else if (nc != a_nr)                                                  \
-    octave::err_nonconformant ("operator *", nr, nc, a_nr, a_nc);               \
+    octave::err_nonconformant ("operator *", nr, nc, a_nr, a_nc);       \
   else                                                                  \
     {                                                                   \
-      OCTAVE_LOCAL_BUFFER (octave_idx_type, w, nr);                     \
-      RET_TYPE retval (nr, a_nc, static_cast<octave_idx_type> (0));     \
-      for (octave_idx_type i = 0; i < nr; i++)                          \
-        w[i] = 0;                                                       \
-      retval.xcidx (0) = 0;                                             \
+      /* The columns of the result are computed in two passes that */   \
+      /* can both be split across threads.  The first one counts the */ \
+      /* nonzero elements of each column and the second one computes */ \
+      /* them.  Each column is computed independently and in the same */ \
+      /* order as in a serial loop. */                                  \
+      const octave_idx_type *m_cidx = m.cidx ();                        \
+      const octave_idx_type *m_ridx = m.ridx ();                        \
+      const octave_idx_type *a_cidx = a.cidx ();                        \
+      const octave_idx_type *a_ridx = a.ridx ();                        \
+                                                                        \
+      std::size_t nflops = 0;                                           \
+      for (octave_idx_type j = 0; j < a_cidx[a_nc]; j++)                \
+        nflops += m_cidx[a_ridx[j]+1] - m_cidx[a_ridx[j]];              \
                                                                         \
-      octave_idx_type nel = 0;                                          \
+      RET_TYPE retval (nr, a_nc, static_cast<octave_idx_type> (0));     \
+      octave_idx_type *r_cidx = retval.xcidx ();                        \
+      r_cidx[0] = 0;                                                    \
+                                                                        \
+      sparse_mul_parallel_for                                           \
+        (a_nc, nflops, sparse_mul_grain,                                \
+         [=] (octave_idx_type begin, octave_idx_type end, bool check_quit) \
+         {                                                              \
+           std::vector<octave_idx_type> w (nr, -1);                     \
+                                                                        \
+           for (octave_idx_type i = begin; i < end; i++)                \
+             {                                                          \
+               if (check_quit)                                          \
+                 octave_quit ();                                        \
+                                                                        \
+               octave_idx_type nel = 0;                                 \
+               for (octave_idx_type j = a_cidx[i]; j < a_cidx[i+1]; j++) \
+                 {                                                      \
+                   octave_idx_type col = a_ridx[j];                     \
+                   for (octave_idx_type k = m_cidx[col];                \
+                        k < m_cidx[col+1]; k++)                         \
+                     {                                                  \
+                       if (w[m_ridx[k]] != i)                           \
+                         {                                              \
+                           w[m_ridx[k]] = i;                            \
+                           nel++;                                       \
+                         }                                              \
+                     }                                                  \
+                 }                                                      \
+               r_cidx[i+1] = nel;                                       \
+             }                                                          \
+         });                                                            \
                                                                         \
       for (octave_idx_type i = 0; i < a_nc; i++)                        \
-        {                                                               \
-          for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++)   \
-            {                                                           \
-              octave_idx_type col = a.ridx (j);                         \
-              for (octave_idx_type k = m.cidx (col) ; k < m.cidx (col+1); k++) \
-                {                                                       \
-                  if (w[m.ridx (k)] < i + 1)                            \
-                    {                                                   \
-                      w[m.ridx (k)] = i + 1;                            \
-                      nel++;                                            \
-                    }                                                   \
-                  octave_quit ();                                       \
-                }                                                       \
-            }                                                           \
-          retval.xcidx (i+1) = nel;                                     \
-        }                                                               \
+        r_cidx[i+1] += r_cidx[i];                                       \
+                                                                        \
+      octave_idx_type nel = r_cidx[a_nc];                               \
                                                                         \
       if (nel == 0)                                                     \
         return RET_TYPE (nr, a_nc);                                     \
       else                                                              \
         {                                                               \
-          for (octave_idx_type i = 0; i < nr; i++)                      \
-            w[i] = 0;                                                   \
-                                                                        \
-          OCTAVE_LOCAL_BUFFER (RET_EL_TYPE, Xcol, nr);                  \
-                                                                        \
           retval.change_capacity (nel);                                 \
           /* The optimal break-point as estimated from simulations */   \
           /* Note that Mergesort is O(nz log(nz)) while searching all */ \
@@ -1862,70 +1924,203 @@
           /* to these breakpoints */                                    \
           octave_idx_type n_per_col = (a_nc > 43000 ? 43000 :           \
                                        (a_nc * a_nc) / 43000);          \
-          octave_idx_type ii = 0;                                       \
-          octave_idx_type *ri = retval.xridx ();                        \
-          octave_sort<octave_idx_type> sort;                            \
+          r_cidx = retval.xcidx ();                                     \
+          octave_idx_type *r_ridx = retval.xridx ();                    \
+          RET_EL_TYPE *r_data = retval.xdata ();                        \
+                                                                        \
+          sparse_mul_parallel_for                                       \
+            (a_nc, nflops, sparse_mul_grain,                            \
+             [=, &m, &a] (octave_idx_type begin, octave_idx_type end,   \
+                          bool check_quit)                              \
+             {                                                          \
+               std::vector<octave_idx_type> w (nr, -1);                 \
+               std::vector<RET_EL_TYPE> Xcol (nr);                      \
+               octave_sort<octave_idx_type> sort;                       \
+                                                                        \
+               for (octave_idx_type i = begin; i < end; i++)            \
+                 {                                                      \
+                   if (check_quit)                                      \
+                     octave_quit ();                                    \
+                                                                        \
+                   octave_idx_type ii = r_cidx[i];                      \
+                                                                        \
+                   if (r_cidx[i+1] - r_cidx[i] > n_per_col)             \
+                     {                                                  \
+                       for (octave_idx_type j = a_cidx[i];              \
+                            j < a_cidx[i+1]; j++)                       \
+                         {                                              \
+                           octave_idx_type col = a_ridx[j];             \
+                           EL_TYPE tmpval = a.data (j);                 \
+                           for (octave_idx_type k = m_cidx[col];        \
+                                k < m_cidx[col+1]; k++)                 \
+                             {                                          \
+                               octave_idx_type row = m_ridx[k];         \
+                               if (w[row] != i)                         \
+                                 {                                      \
+                                   w[row] = i;                          \
+                                   Xcol[row] = tmpval * m.data (k);     \
+                                 }                                      \
+                               else                                     \
+                                 Xcol[row] += tmpval * m.data (k);      \
+                             }                                          \
+                         }                                              \
+                       for (octave_idx_type k = 0; k < nr; k++)         \
+                         if (w[k] == i)                                 \
+                           {                                            \
+                             r_data[ii] = Xcol[k];                      \
+                             r_ridx[ii++] = k;                          \
+                           }                                            \
+                     }                                                  \
+                   else                                                 \
+                     {                                                  \
+                       for (octave_idx_type j = a_cidx[i];              \
+                            j < a_cidx[i+1]; j++)                       \
+                         {                                              \
+                           octave_idx_type col = a_ridx[j];             \
+                           EL_TYPE tmpval = a.data (j);                 \
+                           for (octave_idx_type k = m_cidx[col];        \
+                                k < m_cidx[col+1]; k++)                 \
+                             {                                          \
+                               octave_idx_type row = m_ridx[k];         \
+                               if (w[row] != i)                         \
+                                 {                                      \
+                                   w[row] = i;                          \
+                                   r_ridx[ii++] = row;                  \
+                                   Xcol[row] = tmpval * m.data (k);     \
+                                 }                                      \
+                               else                                     \
+                                 Xcol[row] += tmpval * m.data (k);      \
+                             }                                          \
+                         }                                              \
+                       sort.sort (r_ridx + r_cidx[i], ii - r_cidx[i]);  \
+                       for (octave_idx_type k = r_cidx[i]; k < ii; k++) \
+                         r_data[k] = Xcol[r_ridx[k]];                   \
+                     }                                                  \
+                 }                                                      \
+             });                                                        \
                                                                         \
-          for (octave_idx_type i = 0; i < a_nc ; i++)                   \
-            {                                                           \
-              if (retval.xcidx (i+1) - retval.xcidx (i) > n_per_col)    \
-                {                                                       \
-                  for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++) \
-                    {                                                   \
-                      octave_idx_type col = a.ridx (j);                 \
-                      EL_TYPE tmpval = a.data (j);                      \
-                      for (octave_idx_type k = m.cidx (col) ;           \
-                           k < m.cidx (col+1); k++)                     \
-                        {                                               \
-                          octave_quit ();                               \
-                          octave_idx_type row = m.ridx (k);             \
-                          if (w[row] < i + 1)                           \
-                            {                                           \
-                              w[row] = i + 1;                           \
-                              Xcol[row] = tmpval * m.data (k);          \
-                            }                                           \
-                          else                                          \
-                            Xcol[row] += tmpval * m.data (k);           \
-                        }                                               \
-                    }                                                   \
-                  for (octave_idx_type k = 0; k < nr; k++)              \
-                    if (w[k] == i + 1)                                  \
-                      {                                                 \
-                        retval.xdata (ii) = Xcol[k];                    \
-                        retval.xridx (ii++) = k;                        \
-                      }                                                 \
-                }                                                       \
-              else                                                      \
-                {                                                       \
-                  for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++) \
-                    {                                                   \
-                      octave_idx_type col = a.ridx (j);                 \
-                      EL_TYPE tmpval = a.data (j);                      \
-                      for (octave_idx_type k = m.cidx (col) ;           \
-                           k < m.cidx (col+1); k++)                     \
-                        {                                               \
-                          octave_quit ();                               \
-                          octave_idx_type row = m.ridx (k);             \
-                          if (w[row] < i + 1)                           \
-                            {                                           \
-                              w[row] = i + 1;                           \
-                              retval.xridx (ii++) = row;                \
-                              Xcol[row] = tmpval * m.data (k);          \
-                            }                                           \
-                          else                                          \
-                            Xcol[row] += tmpval * m.data (k);           \
-                        }                                               \
-                    }                                                   \
-                  sort.sort (ri + retval.xcidx (i), ii - retval.xcidx (i)); \
-                  for (octave_idx_type k = retval.xcidx (i); k < ii; k++) \
-                    retval.xdata (k) = Xcol[retval.xridx (k)];          \
-                }                                                       \
-            }                                                           \
           retval.maybe_compress (true);                                 \
           return retval;                                                \
         }                                                               \
     }
 
+#define SPARSE_SPARSE_TRANS_MUL(RET_TYPE, RET_EL_TYPE, EL_TYPE, TRANS_FCN, CONJ_OP) \
+  octave_idx_type nr = m.rows ();                                       \
+  octave_idx_type nc = m.cols ();                                       \
+                                                                        \
+  octave_idx_type a_nr = a.rows ();                                     \
+  octave_idx_type a_nc = a.cols ();                                     \
+                                                                        \
+  if ((nr == 1 && nc == 1) || (a_nr == 1 && a_nc == 1)                  \
+      || a_nc > sparse_trans_mul_max_cols)                              \
+    return m.TRANS_FCN () * a;                                          \
+  else if (nr != a_nr)                                                  \
+    octave::err_nonconformant ("operator *", nc, nr, a_nr, a_nc);       \
+  else                                                                  \
+    {                                                                   \
+      /* Each element of the result is the dot product of a column of */ \
+      /* M with a column of A.  Each column of A is scattered into a */ \
+      /* dense vector, and the columns of M are split across threads */ \
+      /* into ranges with about the same number of nonzero elements. */ \
+      /* The nonzero elements found for each range are then copied to */ \
+      /* the result in order.  The terms of each dot product are summed */ \
+      /* in the same order as when multiplying by the transpose of M. */ \
+      const octave_idx_type *m_cidx = m.cidx ();                        \
+      const octave_idx_type *m_ridx = m.ridx ();                        \
+                                                                        \
+      std::size_t nflops = m_cidx[nc];                                  \
+      octave_idx_type nparts = 1;                                       \
+      if (nc > 0 && octave::thread_pool::use_threads (nflops))          \
+        nparts = std::min (nc, static_cast<octave_idx_type>             \
+                                 (4 * octave::thread_pool::size ()));   \
+                                                                        \
+      std::vector<octave_idx_type> bounds (nparts + 1);                 \
+      for (octave_idx_type p = 0; p < nparts; p++)                      \
+        bounds[p] = std::lower_bound (m_cidx, m_cidx + nc,              \
+                                      (m_cidx[nc] / nparts) * p) - m_cidx; \
+      bounds[nparts] = nc;                                              \
+                                                                        \
+      std::vector<octave_idx_type> w (nr, -1);                          \
+      std::vector<EL_TYPE> x (nr);                                      \
+                                                                        \
+      std::vector<std::vector<octave_idx_type>> part_ridx (nparts);     \
+      std::vector<std::vector<RET_EL_TYPE>> part_data (nparts);         \
+                                                                        \
+      std::vector<octave_idx_type> r_cidx (a_nc + 1, 0);                \
+      std::vector<octave_idx_type> r_ridx;                              \
+      std::vector<RET_EL_TYPE> r_data;                                  \
+                                                                        \
+      for (octave_idx_type j = 0; j < a_nc; j++)                        \
+        {                                                               \
+          for (octave_idx_type k = a.cidx (j); k < a.cidx (j+1); k++)   \
+            {                                                           \
+              w[a.ridx (k)] = j;                                        \
+              x[a.ridx (k)] = a.data (k);                               \
+            }                                                           \
+                                                                        \
+          sparse_mul_parallel_for                                       \
+            (nparts, nflops, 1,                                         \
+             [=, &m, &bounds, &w, &x, &part_ridx, &part_data]           \
+             (octave_idx_type begin, octave_idx_type end, bool check_quit) \
+             {                                                          \
+               for (octave_idx_type p = begin; p < end; p++)            \
+                 {                                                      \
+                   if (check_quit)                                      \
+                     octave_quit ();                                    \
+                                                                        \
+                   std::vector<octave_idx_type>& p_ridx = part_ridx[p]; \
+                   std::vector<RET_EL_TYPE>& p_data = part_data[p];     \
+                   p_ridx.clear ();                                     \
+                   p_data.clear ();                                     \
+                                                                        \
+                   for (octave_idx_type i = bounds[p]; i < bounds[p+1]; i++) \
+                     {                                                  \
+                       bool found = false;                              \
+                       RET_EL_TYPE acc = RET_EL_TYPE ();                \
+                       for (octave_idx_type k = m_cidx[i];              \
+                            k < m_cidx[i+1]; k++)                       \
+                         {                                              \
+                           octave_idx_type row = m_ridx[k];             \
+                           if (w[row] == j)                             \
+                             {                                          \
+                               if (found)                               \
+                                 acc += x[row] * CONJ_OP (m.data (k));  \
+                               else                                     \
+                                 {                                      \
+                                   acc = x[row] * CONJ_OP (m.data (k)); \
+                                   found = true;                        \
+                                 }                                      \
+                             }                                          \
+                         }                                              \
+                       if (found)                                       \
+                         {                                              \
+                           p_ridx.push_back (i);                        \
+                           p_data.push_back (acc);                      \
+                         }                                              \
+                     }                                                  \
+                 }                                                      \
+             });                                                        \
+                                                                        \
+          for (octave_idx_type p = 0; p < nparts; p++)                  \
+            {                                                           \
+              r_ridx.insert (r_ridx.end (), part_ridx[p].begin (),      \
+                             part_ridx[p].end ());                      \
+              r_data.insert (r_data.end (), part_data[p].begin (),      \
+                             part_data[p].end ());                      \
+            }                                                           \
+          r_cidx[j+1] = r_ridx.size ();                                 \
+        }                                                               \
+                                                                        \
+      octave_idx_type nel = r_cidx[a_nc];                               \
+      RET_TYPE retval (nc, a_nc, nel);                                  \
+      std::copy (r_cidx.begin (), r_cidx.end (), retval.xcidx ());      \
+      std::copy (r_ridx.begin (), r_ridx.end (), retval.xridx ());      \
+      std::copy (r_data.begin (), r_data.end (), retval.xdata ());      \
+                                                                        \
+      retval.maybe_compress (true);                                     \
+      return retval;                                                    \
+    }
+
 #define SPARSE_FULL_MUL(RET_TYPE, EL_TYPE)                              \
   octave_idx_type nr = m.rows ();                                       \
   octave_idx_type nc = m.cols ();                                       \
@@ -1939,24 +2134,96 @@
       return retval;                                                    \
     }                                                                   \
   else if (nc != a_nr)                                                  \
-    octave::err_nonconformant ("operator *", nr, nc, a_nr, a_nc);               \
+    octave::err_nonconformant ("operator *", nr, nc, a_nr, a_nc);       \
   else                                                                  \
     {                                                                   \
-      RET_TYPE::element_type zero = RET_TYPE::element_type ();          \
+      typedef RET_TYPE::element_type ret_el_type;                       \
                                                                         \
-      RET_TYPE retval (nr, a_nc, zero);                                 \
+      RET_TYPE retval (nr, a_nc, ret_el_type ());                       \
+                                                                        \
+      const octave_idx_type *m_cidx = m.cidx ();                        \
+      const octave_idx_type *m_ridx = m.ridx ();                        \
+      ret_el_type *r_data = retval.fortran_vec ();                      \
+                                                                        \
+      std::size_t nflops = m_cidx[nc] * static_cast<std::size_t> (a_nc); \
+      int nparts = octave::thread_pool::size ();                        \
                                                                         \
-      for (octave_idx_type i = 0; i < a_nc ; i++)                       \
+      if (a_nc < nparts && m_cidx[nc] > nparts * nr                     \
+          && octave::thread_pool::use_threads (nflops))                 \
         {                                                               \
-          for (octave_idx_type j = 0; j < a_nr; j++)                    \
-            {                                                           \
-              octave_quit ();                                           \
+          /* Too few columns to split, e.g. for a matrix-vector */      \
+          /* product.  Each thread accumulates the products with a */   \
+          /* range of columns of M into its own copy of the result, and */ \
+          /* the copies are summed afterwards. */                       \
+          std::vector<octave_idx_type> bounds (nparts + 1);             \
+          for (int p = 0; p < nparts; p++)                              \
+            bounds[p] = std::lower_bound (m_cidx, m_cidx + nc,          \
+                                          (m_cidx[nc] / nparts) * p)    \
+                        - m_cidx;                                       \
+          bounds[nparts] = nc;                                          \
+                                                                        \
+          std::size_t r_nel = static_cast<std::size_t> (nr) * a_nc;     \
+          OCTAVE_LOCAL_BUFFER (ret_el_type, partial,                    \
+                               (nparts - 1) * r_nel);                   \
+                                                                        \
+          octave::thread_pool::parallel_for                             \
+            (nparts, 1, [=, &m, &a, &bounds] (std::size_t begin,        \
+                                              std::size_t end)          \
+             {                                                          \
+               for (std::size_t p = begin; p < end; p++)                \
+                 {                                                      \
+                   ret_el_type *r = (p == 0 ? r_data                    \
+                                     : partial + (p-1) * r_nel);        \
+                   if (p > 0)                                           \
+                     std::fill_n (r, r_nel, ret_el_type ());            \
+                                                                        \
+                   for (octave_idx_type i = 0; i < a_nc; i++)           \
+                     for (octave_idx_type j = bounds[p];                \
+                          j < bounds[p+1]; j++)                         \
+                       {                                                \
+                         EL_TYPE tmpval = a.elem (j,i);                 \
+                         for (octave_idx_type k = m_cidx[j];            \
+                              k < m_cidx[j+1]; k++)                     \
+                           r[m_ridx[k] + i*nr] += tmpval * m.data (k);  \
+                       }                                                \
+                 }                                                      \
+             });                                                        \
+                                                                        \
+          octave::thread_pool::parallel_for                             \
+            (r_nel, 4096, [=] (std::size_t begin, std::size_t end)      \
+             {                                                          \
+               for (int p = 1; p < nparts; p++)                         \
+                 {                                                      \
+                   const ret_el_type *s = partial + (p-1) * r_nel;      \
+                   for (std::size_t k = begin; k < end; k++)            \
+                     r_data[k] += s[k];                                 \
+                 }                                                      \
+             });                                                        \
                                                                         \
-              EL_TYPE tmpval = a.elem (j,i);                            \
-              for (octave_idx_type k = m.cidx (j) ; k < m.cidx (j+1); k++) \
-                retval.elem (m.ridx (k),i) += tmpval * m.data (k);      \
-            }                                                           \
+          octave_quit ();                                               \
         }                                                               \
+      else                                                              \
+        sparse_mul_parallel_for                                         \
+          (a_nc, nflops, 1,                                             \
+           [=, &m, &a] (octave_idx_type begin, octave_idx_type end,     \
+                        bool check_quit)                                \
+           {                                                            \
+             for (octave_idx_type i = begin; i < end; i++)              \
+               {                                                        \
+                 ret_el_type *r = r_data + i*nr;                        \
+                 for (octave_idx_type j = 0; j < a_nr; j++)             \
+                   {                                                    \
+                     if (check_quit)                                    \
+                       octave_quit ();                                  \
+                                                                        \
+                     EL_TYPE tmpval = a.elem (j,i);                     \
+                     for (octave_idx_type k = m_cidx[j];                \
+                          k < m_cidx[j+1]; k++)                         \
+                       r[m_ridx[k]] += tmpval * m.data (k);             \
+                   }                                                    \
+               }                                                        \
+           });                                                          \
+                                                                        \
       return retval;                                                    \
     }
 
@@ -1973,23 +2240,39 @@
       return retval;                                                    \
     }                                                                   \
   else if (nr != a_nr)                                                  \
-    octave::err_nonconformant ("operator *", nc, nr, a_nr, a_nc);               \
+    octave::err_nonconformant ("operator *", nc, nr, a_nr, a_nc);       \
   else                                                                  \
     {                                                                   \
       RET_TYPE retval (nc, a_nc);                                       \
                                                                         \
-      for (octave_idx_type i = 0; i < a_nc ; i++)                       \
-        {                                                               \
-          for (octave_idx_type j = 0; j < nc; j++)                      \
-            {                                                           \
-              octave_quit ();                                           \
+      const octave_idx_type *m_cidx = m.cidx ();                        \
+      const octave_idx_type *m_ridx = m.ridx ();                        \
+      RET_TYPE::element_type *r_data = retval.fortran_vec ();           \
+                                                                        \
+      /* Each element of the result is the dot product of a column of */ \
+      /* M with a column of A, so the columns of M are split across */  \
+      /* threads. */                                                    \
+      sparse_mul_parallel_for                                           \
+        (nc, m_cidx[nc] * static_cast<std::size_t> (a_nc), sparse_mul_grain, \
+         [=, &m, &a] (octave_idx_type begin, octave_idx_type end,       \
+                      bool check_quit)                                  \
+         {                                                              \
+           for (octave_idx_type i = 0; i < a_nc ; i++)                  \
+             {                                                          \
+               for (octave_idx_type j = begin; j < end; j++)            \
+                 {                                                      \
+                   if (check_quit)                                      \
+                     octave_quit ();                                    \
+                                                                        \
+                   EL_TYPE acc = EL_TYPE ();                            \
+                   for (octave_idx_type k = m_cidx[j];                  \
+                        k < m_cidx[j+1]; k++)                           \
+                     acc += a.elem (m_ridx[k],i) * CONJ_OP (m.data (k)); \
+                   r_data[j + i*nc] = acc;                              \
+                 }                                                      \
+             }                                                          \
+         });                                                            \
                                                                         \
-              EL_TYPE acc = EL_TYPE ();                                 \
-              for (octave_idx_type k = m.cidx (j) ; k < m.cidx (j+1); k++) \
-                acc += a.elem (m.ridx (k),i) * CONJ_OP (m.data (k));    \
-              retval.xelem (j,i) = acc;                                 \
-            }                                                           \
-        }                                                               \
       return retval;                                                    \
     }
 
@@ -2006,25 +2289,39 @@
       return retval;                                                    \
     }                                                                   \
   else if (nc != a_nr)                                                  \
-    octave::err_nonconformant ("operator *", nr, nc, a_nr, a_nc);               \
+    octave::err_nonconformant ("operator *", nr, nc, a_nr, a_nc);       \
   else                                                                  \
     {                                                                   \
       RET_TYPE::element_type zero = RET_TYPE::element_type ();          \
                                                                         \
       RET_TYPE retval (nr, a_nc, zero);                                 \
                                                                         \
-      for (octave_idx_type i = 0; i < a_nc ; i++)                       \
-        {                                                               \
-          octave_quit ();                                               \
-          for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++)   \
-            {                                                           \
-              octave_idx_type col = a.ridx (j);                         \
-              EL_TYPE tmpval = a.data (j);                              \
+      const octave_idx_type *a_cidx = a.cidx ();                        \
+      const octave_idx_type *a_ridx = a.ridx ();                        \
+      RET_TYPE::element_type *r_data = retval.fortran_vec ();           \
+                                                                        \
+      /* Each column of the result only depends on one column of A. */  \
+      sparse_mul_parallel_for                                           \
+        (a_nc, a_cidx[a_nc] * static_cast<std::size_t> (nr), 1,         \
+         [=, &m, &a] (octave_idx_type begin, octave_idx_type end,       \
+                      bool check_quit)                                  \
+         {                                                              \
+           for (octave_idx_type i = begin; i < end; i++)                \
+             {                                                          \
+               if (check_quit)                                          \
+                 octave_quit ();                                        \
+                                                                        \
+               for (octave_idx_type j = a_cidx[i]; j < a_cidx[i+1]; j++) \
+                 {                                                      \
+                   octave_idx_type col = a_ridx[j];                     \
+                   EL_TYPE tmpval = a.data (j);                         \
+                                                                        \
+                   for (octave_idx_type k = 0 ; k < nr; k++)            \
+                     r_data[k + i*nr] += tmpval * m.elem (k,col);       \
+                 }                                                      \
+             }                                                          \
+         });                                                            \
                                                                         \
-              for (octave_idx_type k = 0 ; k < nr; k++)                 \
-                retval.xelem (k,i) += tmpval * m.elem (k,col);          \
-            }                                                           \
-        }                                                               \
       return retval;                                                    \
     }
 
@@ -2041,24 +2338,39 @@
       return retval;                                                    \
     }                                                                   \
   else if (nc != a_nc)                                                  \
-    octave::err_nonconformant ("operator *", nr, nc, a_nc, a_nr);               \
+    octave::err_nonconformant ("operator *", nr, nc, a_nc, a_nr);       \
   else                                                                  \
     {                                                                   \
       RET_TYPE::element_type zero = RET_TYPE::element_type ();          \
                                                                         \
       RET_TYPE retval (nr, a_nr, zero);                                 \
                                                                         \
-      for (octave_idx_type i = 0; i < a_nc ; i++)                       \
-        {                                                               \
-          octave_quit ();                                               \
-          for (octave_idx_type j = a.cidx (i); j < a.cidx (i+1); j++)   \
-            {                                                           \
-              octave_idx_type col = a.ridx (j);                         \
-              EL_TYPE tmpval = CONJ_OP (a.data (j));                    \
-              for (octave_idx_type k = 0 ; k < nr; k++)                 \
-                retval.xelem (k,col) += tmpval * m.elem (k,i);          \
-            }                                                           \
-        }                                                               \
+      const octave_idx_type *a_cidx = a.cidx ();                        \
+      const octave_idx_type *a_ridx = a.ridx ();                        \
+      RET_TYPE::element_type *r_data = retval.fortran_vec ();           \
+                                                                        \
+      /* Several columns of A may add to the same column of the result, */ \
+      /* so the rows of the result are split across threads instead. */ \
+      sparse_mul_parallel_for                                           \
+        (nr, a_cidx[a_nc] * static_cast<std::size_t> (nr), 512,         \
+         [=, &m, &a] (octave_idx_type begin, octave_idx_type end,       \
+                      bool check_quit)                                  \
+         {                                                              \
+           for (octave_idx_type i = 0; i < a_nc ; i++)                  \
+             {                                                          \
+               if (check_quit)                                          \
+                 octave_quit ();                                        \
+                                                                        \
+               for (octave_idx_type j = a_cidx[i]; j < a_cidx[i+1]; j++) \
+                 {                                                      \
+                   octave_idx_type col = a_ridx[j];                     \
+                   EL_TYPE tmpval = CONJ_OP (a.data (j));               \
+                   for (octave_idx_type k = begin; k < end; k++)        \
+                     r_data[k + col*nr] += tmpval * m.elem (k,i);       \
+                 }                                                      \
+             }                                                          \
+         });                                                            \
+                                                                        \
       return retval;                                                    \
     }
 
@@ -56,13 +56,14 @@ LIBOCTAVE_OPERATORS_INC = \
   %reldir%/mx-ext.h \
   %reldir%/mx-op-decl.h \
   %reldir%/mx-op-defs.h \
+  %reldir%/mx-simd.h \
   %reldir%/Sparse-diag-op-defs.h \
   %reldir%/Sparse-op-decls.h \
   %reldir%/Sparse-op-defs.h \
   %reldir%/Sparse-perm-op-defs.h
 
-## There are no distributed source files in this directory
-LIBOCTAVE_OPERATORS_SRC =
+LIBOCTAVE_OPERATORS_SRC = \
+  %reldir%/mx-simd.cc
 
 LIBOCTAVE_TEMPLATE_SRC += \
   %reldir%/mx-inlines.cc
@@ -100,6 +101,7 @@ liboctave_EXTRA_DIST += \
   %reldir%/config-ops.sh \
   %reldir%/mk-ops.awk \
   %reldir%/mx-ops \
+  %reldir%/mx-simd-kernels.h \
   %reldir%/smx-ops \
   %reldir%/vx-ops
 
@@ -37,9 +37,11 @@
 #include "Array-util.h"
 #include "Array.h"
 #include "bsxfun.h"
+#include "mx-simd.h"
 #include "oct-cmplx.h"
 #include "oct-inttypes-fwd.h"
 #include "oct-locbuf.h"
+#include "oct-thread-pool.h"
 
 // Provides some commonly repeated, basic loop templates.
 
@@ -155,6 +157,35 @@ DEFMXCMPOP (mx_inline_ge, >=)
 DEFMXCMPOP (mx_inline_eq, ==)
 DEFMXCMPOP (mx_inline_ne, !=)
 
+// Use the vectorized kernels for comparing real arrays of the same type.
+#define DEFMXCMPOPSPEC(T, F, OP)                                        \
+  template <>                                                           \
+  inline void F<T, T> (std::size_t n, bool *r, const T *x, const T *y)  \
+  {                                                                     \
+    octave::mx_simd::compare (octave::mx_simd::OP, n, r, x, y);         \
+  }                                                                     \
+  template <>                                                           \
+  inline void F<T, T> (std::size_t n, bool *r, const T *x, T y)         \
+  {                                                                     \
+    octave::mx_simd::compare (octave::mx_simd::OP, n, r, x, y);         \
+  }                                                                     \
+  template <>                                                           \
+  inline void F<T, T> (std::size_t n, bool *r, T x, const T *y)         \
+  {                                                                     \
+    octave::mx_simd::compare (octave::mx_simd::OP, n, r, x, y);         \
+  }
+
+#define DEFMXCMPOPSPECS(T)                      \
+  DEFMXCMPOPSPEC (T, mx_inline_lt, cmp_lt)      \
+  DEFMXCMPOPSPEC (T, mx_inline_le, cmp_le)      \
+  DEFMXCMPOPSPEC (T, mx_inline_gt, cmp_gt)      \
+  DEFMXCMPOPSPEC (T, mx_inline_ge, cmp_ge)      \
+  DEFMXCMPOPSPEC (T, mx_inline_eq, cmp_eq)      \
+  DEFMXCMPOPSPEC (T, mx_inline_ne, cmp_ne)
+
+DEFMXCMPOPSPECS (double)
+DEFMXCMPOPSPECS (float)
+
 // Convert to logical value, for logical op purposes.
 template <typename T>
 inline bool
@@ -278,6 +309,34 @@ mx_inline_all_finite (std::size_t n, const T *x)
   return true;
 }
 
+template <>
+inline bool
+mx_inline_any_nan<double> (std::size_t n, const double *x)
+{
+  return octave::mx_simd::any_nan (n, x);
+}
+
+template <>
+inline bool
+mx_inline_any_nan<float> (std::size_t n, const float *x)
+{
+  return octave::mx_simd::any_nan (n, x);
+}
+
+template <>
+inline bool
+mx_inline_all_finite<double> (std::size_t n, const double *x)
+{
+  return octave::mx_simd::all_finite (n, x);
+}
+
+template <>
+inline bool
+mx_inline_all_finite<float> (std::size_t n, const float *x)
+{
+  return octave::mx_simd::all_finite (n, x);
+}
+
 template <typename T>
 inline bool
 mx_inline_any_negative (std::size_t n, const T *x)
@@ -379,31 +438,28 @@ mx_inline_xmax (std::size_t n, T *r, T x, const T *y)
     r[i] = octave::math::max (x, y[i]);
 }
 
-// Specialize array-scalar max/min
-#define DEFMINMAXSPEC(T, F, OP)                                 \
-  template <>                                                   \
-  inline void F<T> (std::size_t n, T *r, const T *x, T y)       \
-  {                                                             \
-    if (octave::math::isnan (y))                                \
-      std::memcpy (r, x, n * sizeof (T));                       \
-    else                                                        \
-      for (std::size_t i = 0; i < n; i++)                       \
-        r[i] = (x[i] OP y ? x[i] : y);                          \
-  }                                                             \
-  template <>                                                   \
-  inline void F<T> (std::size_t n, T *r, T x, const T *y)       \
-  {                                                             \
-    if (octave::math::isnan (x))                                \
-      std::memcpy (r, y, n * sizeof (T));                       \
-    else                                                        \
-      for (std::size_t i = 0; i < n; i++)                       \
-        r[i] = (y[i] OP x ? y[i] : x);                          \
+// Use the vectorized kernels for real max/min.
+#define DEFMINMAXSPEC(T, F, G)                                    \
+  template <>                                                     \
+  inline void F<T> (std::size_t n, T *r, const T *x, const T *y)  \
+  {                                                               \
+    octave::mx_simd::G (n, r, x, y);                              \
+  }                                                               \
+  template <>                                                     \
+  inline void F<T> (std::size_t n, T *r, const T *x, T y)         \
+  {                                                               \
+    octave::mx_simd::G (n, r, x, y);                              \
+  }                                                               \
+  template <>                                                     \
+  inline void F<T> (std::size_t n, T *r, T x, const T *y)         \
+  {                                                               \
+    octave::mx_simd::G (n, r, x, y);                              \
   }
 
-DEFMINMAXSPEC (double, mx_inline_xmin, <=)
-DEFMINMAXSPEC (double, mx_inline_xmax, >=)
-DEFMINMAXSPEC (float, mx_inline_xmin, <=)
-DEFMINMAXSPEC (float, mx_inline_xmax, >=)
+DEFMINMAXSPEC (double, mx_inline_xmin, xmin)
+DEFMINMAXSPEC (double, mx_inline_xmax, xmax)
+DEFMINMAXSPEC (float, mx_inline_xmin, xmin)
+DEFMINMAXSPEC (float, mx_inline_xmax, xmax)
 
 // FIXME: Is this comment correct anymore?  It seems like std::pow is chosen.
 // Let the compiler decide which pow to use, whichever best matches the
@@ -455,6 +511,26 @@ inline void mx_inline_map (std::size_t n, R *r, const X *x)
     r[i] = fcn (x[i]);
 }
 
+// Call FCN (BEGIN, END) for ranges covering [0, N).  The ranges are
+// processed in parallel by the liboctave thread pool if WORK (usually
+// the number of elements touched) is above the pool's threshold.
+// Otherwise, FCN is called once for the whole range.
+
+template <typename F>
+inline void
+mx_inline_parallel_for (std::size_t n, std::size_t work, std::size_t grain,
+                        const F& fcn)
+{
+  if (n > grain && octave::thread_pool::use_threads (work))
+    octave::thread_pool::parallel_for (n, grain, fcn);
+  else
+    fcn (0, n);
+}
+
+// Element-wise operations are split into ranges of a multiple of this
+// many elements, which keeps threads from writing to the same cache line.
+static const std::size_t mx_inline_grain = 4096;
+
 // Appliers.  Since these call the operation just once, we pass it as
 // a pointer, to allow the compiler reduce number of instances.
 
@@ -464,7 +540,12 @@ do_mx_unary_op (const Array<X>& x,
                 void (*op) (std::size_t, R *, const X *))
 {
   Array<R> r (x.dims ());
-  op (r.numel (), r.fortran_vec (), x.data ());
+  std::size_t n = r.numel ();
+  R *pr = r.fortran_vec ();
+  const X *px = x.data ();
+  mx_inline_parallel_for (n, n, mx_inline_grain,
+                          [=] (std::size_t b, std::size_t e)
+                          { op (e - b, pr + b, px + b); });
   return r;
 }
 
@@ -489,7 +570,11 @@ inline Array<R>&
 do_mx_inplace_op (Array<R>& r,
                   void (*op) (std::size_t, R *))
 {
-  op (r.numel (), r.fortran_vec ());
+  std::size_t n = r.numel ();
+  R *pr = r.fortran_vec ();
+  mx_inline_parallel_for (n, n, mx_inline_grain,
+                          [=] (std::size_t b, std::size_t e)
+                          { op (e - b, pr + b); });
   return r;
 }
 
@@ -506,7 +591,13 @@ do_mm_binary_op (const Array<X>& x, const Array<Y>& y,
   if (dx == dy)
     {
       Array<R> r (dx);
-      op (r.numel (), r.fortran_vec (), x.data (), y.data ());
+      std::size_t n = r.numel ();
+      R *pr = r.fortran_vec ();
+      const X *px = x.data ();
+      const Y *py = y.data ();
+      mx_inline_parallel_for (n, n, mx_inline_grain,
+                              [=] (std::size_t b, std::size_t e)
+                              { op (e - b, pr + b, px + b, py + b); });
       return r;
     }
   else if (is_valid_bsxfun (opname, dx, dy))
@@ -523,7 +614,12 @@ do_ms_binary_op (const Array<X>& x, const Y& y,
                  void (*op) (std::size_t, R *, const X *, Y))
 {
   Array<R> r (x.dims ());
-  op (r.numel (), r.fortran_vec (), x.data (), y);
+  std::size_t n = r.numel ();
+  R *pr = r.fortran_vec ();
+  const X *px = x.data ();
+  mx_inline_parallel_for (n, n, mx_inline_grain,
+                          [=, &y] (std::size_t b, std::size_t e)
+                          { op (e - b, pr + b, px + b, y); });
   return r;
 }
 
@@ -533,7 +629,12 @@ do_sm_binary_op (const X& x, const Array<Y>& y,
                  void (*op) (std::size_t, R *, X, const Y *))
 {
   Array<R> r (y.dims ());
-  op (r.numel (), r.fortran_vec (), x, y.data ());
+  std::size_t n = r.numel ();
+  R *pr = r.fortran_vec ();
+  const Y *py = y.data ();
+  mx_inline_parallel_for (n, n, mx_inline_grain,
+                          [=, &x] (std::size_t b, std::size_t e)
+                          { op (e - b, pr + b, x, py + b); });
   return r;
 }
 
@@ -547,7 +648,14 @@ do_mm_inplace_op (Array<R>& r, const Array<X>& x,
   dim_vector dr = r.dims ();
   dim_vector dx = x.dims ();
   if (dr == dx)
-    op (r.numel (), r.fortran_vec (), x.data ());
+    {
+      std::size_t n = r.numel ();
+      R *pr = r.fortran_vec ();
+      const X *px = x.data ();
+      mx_inline_parallel_for (n, n, mx_inline_grain,
+                              [=] (std::size_t b, std::size_t e)
+                              { op (e - b, pr + b, px + b); });
+    }
   else if (is_valid_inplace_bsxfun (opname, dr, dx))
     do_inplace_bsxfun_op (r, x, op, op1);
   else
@@ -561,7 +669,11 @@ inline Array<R>&
 do_ms_inplace_op (Array<R>& r, const X& x,
                   void (*op) (std::size_t, R *, X))
 {
-  op (r.numel (), r.fortran_vec (), x);
+  std::size_t n = r.numel ();
+  R *pr = r.fortran_vec ();
+  mx_inline_parallel_for (n, n, mx_inline_grain,
+                          [=, &x] (std::size_t b, std::size_t e)
+                          { op (e - b, pr + b, x); });
   return r;
 }
 
@@ -1552,7 +1664,11 @@ do_mx_red_op (const Array<T>& src, int dim,
   dims.chop_trailing_singletons ();
 
   Array<R> ret (dims);
-  mx_red_op (src.data (), ret.fortran_vec (), l, n, u);
+  const T *ps = src.data ();
+  R *pr = ret.fortran_vec ();
+  mx_inline_parallel_for (u, l*n*u, 1,
+                          [=] (std::size_t b, std::size_t e)
+                          { mx_red_op (ps + b*l*n, pr + b*l, l, n, e - b); });
 
   return ret;
 }
@@ -1569,7 +1685,11 @@ do_mx_cum_op (const Array<T>& src, int dim,
 
   // Cumulative operation doesn't reduce the array size.
   Array<R> ret (dims);
-  mx_cum_op (src.data (), ret.fortran_vec (), l, n, u);
+  const T *ps = src.data ();
+  R *pr = ret.fortran_vec ();
+  mx_inline_parallel_for (u, l*n*u, 1,
+                          [=] (std::size_t b, std::size_t e)
+                          { mx_cum_op (ps + b*l*n, pr + b*l*n, l, n, e - b); });
 
   return ret;
 }
@@ -1589,7 +1709,11 @@ do_mx_minmax_op (const Array<R>& src, int dim,
   dims.chop_trailing_singletons ();
 
   Array<R> ret (dims);
-  mx_minmax_op (src.data (), ret.fortran_vec (), l, n, u);
+  const R *ps = src.data ();
+  R *pr = ret.fortran_vec ();
+  mx_inline_parallel_for (u, l*n*u, 1,
+                          [=] (std::size_t b, std::size_t e)
+                          { mx_minmax_op (ps + b*l*n, pr + b*l, l, n, e - b); });
 
   return ret;
 }
@@ -1611,8 +1735,15 @@ do_mx_minmax_op (const Array<R>& src, Array<octave_idx_type>& idx, int dim,
   Array<R> ret (dims);
   if (idx.dims () != dims) idx = Array<octave_idx_type> (dims);
 
-  mx_minmax_op (src.data (), ret.fortran_vec (), idx.fortran_vec (),
-                l, n, u);
+  const R *ps = src.data ();
+  R *pr = ret.fortran_vec ();
+  octave_idx_type *pi = idx.fortran_vec ();
+  mx_inline_parallel_for (u, l*n*u, 1,
+                          [=] (std::size_t b, std::size_t e)
+                          {
+                            mx_minmax_op (ps + b*l*n, pr + b*l, pi + b*l,
+                                          l, n, e - b);
+                          });
 
   return ret;
 }
@@ -1628,7 +1759,14 @@ do_mx_cumminmax_op (const Array<R>& src, int dim,
   get_extent_triplet (dims, dim, l, n, u);
 
   Array<R> ret (dims);
-  mx_cumminmax_op (src.data (), ret.fortran_vec (), l, n, u);
+  const R *ps = src.data ();
+  R *pr = ret.fortran_vec ();
+  mx_inline_parallel_for (u, l*n*u, 1,
+                          [=] (std::size_t b, std::size_t e)
+                          {
+                            mx_cumminmax_op (ps + b*l*n, pr + b*l*n,
+                                             l, n, e - b);
+                          });
 
   return ret;
 }
@@ -1646,8 +1784,15 @@ do_mx_cumminmax_op (const Array<R>& src, Array<octave_idx_type>& idx, int dim,
   Array<R> ret (dims);
   if (idx.dims () != dims) idx = Array<octave_idx_type> (dims);
 
-  mx_cumminmax_op (src.data (), ret.fortran_vec (), idx.fortran_vec (),
-                   l, n, u);
+  const R *ps = src.data ();
+  R *pr = ret.fortran_vec ();
+  octave_idx_type *pi = idx.fortran_vec ();
+  mx_inline_parallel_for (u, l*n*u, 1,
+                          [=] (std::size_t b, std::size_t e)
+                          {
+                            mx_cumminmax_op (ps + b*l*n, pr + b*l*n,
+                                             pi + b*l*n, l, n, e - b);
+                          });
 
   return ret;
 }
@@ -1680,7 +1825,14 @@ do_mx_diff_op (const Array<R>& src, int dim, octave_idx_type order,
     }
 
   Array<R> ret (dims);
-  mx_diff_op (src.data (), ret.fortran_vec (), l, n, u, order);
+  const R *ps = src.data ();
+  R *pr = ret.fortran_vec ();
+  mx_inline_parallel_for (u, l*n*u, 1,
+                          [=] (std::size_t b, std::size_t e)
+                          {
+                            mx_diff_op (ps + b*l*n, pr + b*l*(n-order),
+                                        l, n, e - b, order);
+                          });
 
   return ret;
 }
@@ -0,0 +1,201 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+// This file has no include guard.  mx-simd.cc includes it once for each
+// instruction set, inside a namespace that defines the vector traits for
+// that instruction set and with the matching target options in effect.
+//
+// A traits class V provides
+//
+//   value_type, vec, width
+//   load, broadcast, store
+//   nan_mask, nonfinite_mask        (one bit per lane)
+//   min, max                        (octave::math::min/max semantics)
+//   cmp<OP>                         (one bit per lane)
+
+template <typename V>
+static bool
+k_any_nan (std::size_t n, const typename V::value_type *x)
+{
+  const std::size_t w = V::width;
+
+  std::size_t i = 0;
+
+  // Test several vectors at once to keep the early exit off the
+  // critical path.
+  for (; i + 4*w <= n; i += 4*w)
+    if (V::nan_mask (V::load (x+i)) | V::nan_mask (V::load (x+i+w))
+        | V::nan_mask (V::load (x+i+2*w)) | V::nan_mask (V::load (x+i+3*w)))
+      return true;
+
+  for (; i + w <= n; i += w)
+    if (V::nan_mask (V::load (x+i)))
+      return true;
+
+  for (; i < n; i++)
+    if (std::isnan (x[i]))
+      return true;
+
+  return false;
+}
+
+template <typename V>
+static bool
+k_all_finite (std::size_t n, const typename V::value_type *x)
+{
+  const std::size_t w = V::width;
+
+  std::size_t i = 0;
+
+  for (; i + 4*w <= n; i += 4*w)
+    if (V::nonfinite_mask (V::load (x+i))
+        | V::nonfinite_mask (V::load (x+i+w))
+        | V::nonfinite_mask (V::load (x+i+2*w))
+        | V::nonfinite_mask (V::load (x+i+3*w)))
+      return false;
+
+  for (; i + w <= n; i += w)
+    if (V::nonfinite_mask (V::load (x+i)))
+      return false;
+
+  for (; i < n; i++)
+    if (! std::isfinite (x[i]))
+      return false;
+
+  return true;
+}
+
+template <typename V, bool MAX>
+static inline typename V::vec
+k_minmax (typename V::vec x, typename V::vec y)
+{
+  return MAX ? V::max (x, y) : V::min (x, y);
+}
+
+template <typename V, bool MAX>
+static void
+k_minmax_aa (std::size_t n, typename V::value_type *r,
+             const typename V::value_type *x,
+             const typename V::value_type *y)
+{
+  typedef typename V::value_type T;
+
+  const std::size_t w = V::width;
+
+  std::size_t i = 0;
+
+  for (; i + w <= n; i += w)
+    V::store (r+i, k_minmax<V, MAX> (V::load (x+i), V::load (y+i)));
+
+  for (; i < n; i++)
+    r[i] = s_minmax<T, MAX> (x[i], y[i]);
+}
+
+template <typename V, bool MAX>
+static void
+k_minmax_as (std::size_t n, typename V::value_type *r,
+             const typename V::value_type *x, typename V::value_type y)
+{
+  typedef typename V::value_type T;
+
+  const std::size_t w = V::width;
+
+  typename V::vec yv = V::broadcast (y);
+
+  std::size_t i = 0;
+
+  for (; i + w <= n; i += w)
+    V::store (r+i, k_minmax<V, MAX> (V::load (x+i), yv));
+
+  for (; i < n; i++)
+    r[i] = s_minmax<T, MAX> (x[i], y);
+}
+
+template <typename V, int OP>
+static void
+k_cmp_aa (std::size_t n, bool *r, const typename V::value_type *x,
+          const typename V::value_type *y)
+{
+  const std::size_t w = V::width;
+
+  std::size_t i = 0;
+
+  for (; i + w <= n; i += w)
+    store_mask<V::width>
+      (r+i, V::template cmp<OP> (V::load (x+i), V::load (y+i)));
+
+  for (; i < n; i++)
+    r[i] = s_cmp<OP> (x[i], y[i]);
+}
+
+template <typename V, int OP>
+static void
+k_cmp_as (std::size_t n, bool *r, const typename V::value_type *x,
+          typename V::value_type y)
+{
+  const std::size_t w = V::width;
+
+  typename V::vec yv = V::broadcast (y);
+
+  std::size_t i = 0;
+
+  for (; i + w <= n; i += w)
+    store_mask<V::width> (r+i, V::template cmp<OP> (V::load (x+i), yv));
+
+  for (; i < n; i++)
+    r[i] = s_cmp<OP> (x[i], y);
+}
+
+template <typename V>
+static kernels<typename V::value_type>
+make_kernels ()
+{
+  kernels<typename V::value_type> k;
+
+  k.any_nan = k_any_nan<V>;
+  k.all_finite = k_all_finite<V>;
+
+  k.xmin_aa = k_minmax_aa<V, false>;
+  k.xmin_as = k_minmax_as<V, false>;
+
+  k.xmax_aa = k_minmax_aa<V, true>;
+  k.xmax_as = k_minmax_as<V, true>;
+
+  k.cmp_aa[cmp_lt] = k_cmp_aa<V, cmp_lt>;
+  k.cmp_aa[cmp_le] = k_cmp_aa<V, cmp_le>;
+  k.cmp_aa[cmp_gt] = k_cmp_aa<V, cmp_gt>;
+  k.cmp_aa[cmp_ge] = k_cmp_aa<V, cmp_ge>;
+  k.cmp_aa[cmp_eq] = k_cmp_aa<V, cmp_eq>;
+  k.cmp_aa[cmp_ne] = k_cmp_aa<V, cmp_ne>;
+
+  k.cmp_as[cmp_lt] = k_cmp_as<V, cmp_lt>;
+  k.cmp_as[cmp_le] = k_cmp_as<V, cmp_le>;
+  k.cmp_as[cmp_gt] = k_cmp_as<V, cmp_gt>;
+  k.cmp_as[cmp_ge] = k_cmp_as<V, cmp_ge>;
+  k.cmp_as[cmp_eq] = k_cmp_as<V, cmp_eq>;
+  k.cmp_as[cmp_ne] = k_cmp_as<V, cmp_ne>;
+
+  return k;
+}
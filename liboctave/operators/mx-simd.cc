@@ -0,0 +1,730 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <cmath>
+#include <cstring>
+
+#include <atomic>
+#include <limits>
+
+#include "mx-simd.h"
+
+// The vectorized kernels are compiled with per-function target options,
+// so that a generic build can still use the instructions of the CPU it
+// runs on.  This relies on GCC's target pragma.
+
+#if defined (__GNUC__) && ! defined (__clang__) \
+    && (defined (__x86_64__) || defined (__i386__))
+#  define OCTAVE_MX_SIMD_X86 1
+#  include <immintrin.h>
+#endif
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+OCTAVE_BEGIN_NAMESPACE(mx_simd)
+
+// The kernels for one value type and instruction set.
+
+template <typename T>
+struct kernels
+{
+  bool (*any_nan) (std::size_t, const T *);
+  bool (*all_finite) (std::size_t, const T *);
+
+  void (*xmin_aa) (std::size_t, T *, const T *, const T *);
+  void (*xmin_as) (std::size_t, T *, const T *, T);
+
+  void (*xmax_aa) (std::size_t, T *, const T *, const T *);
+  void (*xmax_as) (std::size_t, T *, const T *, T);
+
+  void (*cmp_aa[6]) (std::size_t, bool *, const T *, const T *);
+  void (*cmp_as[6]) (std::size_t, bool *, const T *, T);
+};
+
+// Scalar definitions shared by all instruction sets.  These are used for
+// the elements that don't fill a whole vector.
+
+template <typename T, bool MAX>
+static inline T
+s_minmax (T x, T y)
+{
+  return std::isnan (y) ? x : (MAX ? (x >= y ? x : y) : (x <= y ? x : y));
+}
+
+template <int OP, typename T>
+static inline bool
+s_cmp (T x, T y)
+{
+  switch (OP)
+    {
+    case cmp_lt: return x < y;
+    case cmp_le: return x <= y;
+    case cmp_gt: return x > y;
+    case cmp_ge: return x >= y;
+    case cmp_eq: return x == y;
+    default: return x != y;
+    }
+}
+
+// Bytes for each combination of four mask bits.
+static const unsigned char mask_bytes[16][4] =
+{
+  {0, 0, 0, 0}, {1, 0, 0, 0}, {0, 1, 0, 0}, {1, 1, 0, 0},
+  {0, 0, 1, 0}, {1, 0, 1, 0}, {0, 1, 1, 0}, {1, 1, 1, 0},
+  {0, 0, 0, 1}, {1, 0, 0, 1}, {0, 1, 0, 1}, {1, 1, 0, 1},
+  {0, 0, 1, 1}, {1, 0, 1, 1}, {0, 1, 1, 1}, {1, 1, 1, 1}
+};
+
+// Store the W lowest bits of M as bool values.
+template <std::size_t W>
+static inline void
+store_mask (bool *r, unsigned m)
+{
+  for (std::size_t k = 0; k < W; k += 4)
+    std::memcpy (r + k, mask_bytes[(m >> k) & 0xf], W - k < 4 ? W - k : 4);
+}
+
+// Generic code, one element at a time.
+
+OCTAVE_BEGIN_NAMESPACE(scalar_isa)
+
+template <typename T>
+struct traits
+{
+  typedef T value_type;
+  typedef T vec;
+
+  static const std::size_t width = 1;
+
+  static vec load (const T *p) { return *p; }
+  static vec broadcast (T x) { return x; }
+  static void store (T *p, vec v) { *p = v; }
+
+  static unsigned nan_mask (vec a) { return std::isnan (a); }
+  static unsigned nonfinite_mask (vec a) { return ! std::isfinite (a); }
+
+  static vec min (vec x, vec y) { return s_minmax<T, false> (x, y); }
+  static vec max (vec x, vec y) { return s_minmax<T, true> (x, y); }
+
+  template <int OP>
+  static unsigned cmp (vec x, vec y) { return s_cmp<OP> (x, y); }
+};
+
+typedef traits<double> vd;
+typedef traits<float> vf;
+
+#include "mx-simd-kernels.h"
+
+OCTAVE_END_NAMESPACE(scalar_isa)
+
+#if defined (OCTAVE_MX_SIMD_X86)
+
+#pragma GCC push_options
+#pragma GCC target ("sse2")
+
+OCTAVE_BEGIN_NAMESPACE(sse2_isa)
+
+struct vd
+{
+  typedef double value_type;
+  typedef __m128d vec;
+
+  static const std::size_t width = 2;
+
+  static vec load (const double *p) { return _mm_loadu_pd (p); }
+  static vec broadcast (double x) { return _mm_set1_pd (x); }
+  static void store (double *p, vec v) { _mm_storeu_pd (p, v); }
+
+  static vec abs (vec a) { return _mm_andnot_pd (_mm_set1_pd (-0.0), a); }
+
+  static vec select (vec m, vec a, vec b)
+  { return _mm_or_pd (_mm_and_pd (m, a), _mm_andnot_pd (m, b)); }
+
+  static unsigned nan_mask (vec a)
+  { return _mm_movemask_pd (_mm_cmpunord_pd (a, a)); }
+
+  static unsigned nonfinite_mask (vec a)
+  {
+    vec inf = _mm_set1_pd (std::numeric_limits<double>::infinity ());
+    return _mm_movemask_pd (_mm_cmpnlt_pd (abs (a), inf));
+  }
+
+  static vec min (vec x, vec y)
+  {
+    vec t = select (_mm_cmple_pd (x, y), x, y);
+    return select (_mm_cmpunord_pd (y, y), x, t);
+  }
+
+  static vec max (vec x, vec y)
+  {
+    vec t = select (_mm_cmpge_pd (x, y), x, y);
+    return select (_mm_cmpunord_pd (y, y), x, t);
+  }
+
+  template <int OP>
+  static unsigned cmp (vec x, vec y)
+  {
+    switch (OP)
+      {
+      case cmp_lt: return _mm_movemask_pd (_mm_cmplt_pd (x, y));
+      case cmp_le: return _mm_movemask_pd (_mm_cmple_pd (x, y));
+      case cmp_gt: return _mm_movemask_pd (_mm_cmpgt_pd (x, y));
+      case cmp_ge: return _mm_movemask_pd (_mm_cmpge_pd (x, y));
+      case cmp_eq: return _mm_movemask_pd (_mm_cmpeq_pd (x, y));
+      default: return _mm_movemask_pd (_mm_cmpneq_pd (x, y));
+      }
+  }
+};
+
+struct vf
+{
+  typedef float value_type;
+  typedef __m128 vec;
+
+  static const std::size_t width = 4;
+
+  static vec load (const float *p) { return _mm_loadu_ps (p); }
+  static vec broadcast (float x) { return _mm_set1_ps (x); }
+  static void store (float *p, vec v) { _mm_storeu_ps (p, v); }
+
+  static vec abs (vec a) { return _mm_andnot_ps (_mm_set1_ps (-0.0f), a); }
+
+  static vec select (vec m, vec a, vec b)
+  { return _mm_or_ps (_mm_and_ps (m, a), _mm_andnot_ps (m, b)); }
+
+  static unsigned nan_mask (vec a)
+  { return _mm_movemask_ps (_mm_cmpunord_ps (a, a)); }
+
+  static unsigned nonfinite_mask (vec a)
+  {
+    vec inf = _mm_set1_ps (std::numeric_limits<float>::infinity ());
+    return _mm_movemask_ps (_mm_cmpnlt_ps (abs (a), inf));
+  }
+
+  static vec min (vec x, vec y)
+  {
+    vec t = select (_mm_cmple_ps (x, y), x, y);
+    return select (_mm_cmpunord_ps (y, y), x, t);
+  }
+
+  static vec max (vec x, vec y)
+  {
+    vec t = select (_mm_cmpge_ps (x, y), x, y);
+    return select (_mm_cmpunord_ps (y, y), x, t);
+  }
+
+  template <int OP>
+  static unsigned cmp (vec x, vec y)
+  {
+    switch (OP)
+      {
+      case cmp_lt: return _mm_movemask_ps (_mm_cmplt_ps (x, y));
+      case cmp_le: return _mm_movemask_ps (_mm_cmple_ps (x, y));
+      case cmp_gt: return _mm_movemask_ps (_mm_cmpgt_ps (x, y));
+      case cmp_ge: return _mm_movemask_ps (_mm_cmpge_ps (x, y));
+      case cmp_eq: return _mm_movemask_ps (_mm_cmpeq_ps (x, y));
+      default: return _mm_movemask_ps (_mm_cmpneq_ps (x, y));
+      }
+  }
+};
+
+#include "mx-simd-kernels.h"
+
+OCTAVE_END_NAMESPACE(sse2_isa)
+
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target ("avx2")
+
+OCTAVE_BEGIN_NAMESPACE(avx2_isa)
+
+// Comparison predicates with the same NaN behavior as the C++ operators.
+template <int OP>
+struct avx_pred
+{
+  static const int value
+    = (OP == cmp_lt ? _CMP_LT_OQ : OP == cmp_le ? _CMP_LE_OQ
+       : OP == cmp_gt ? _CMP_GT_OQ : OP == cmp_ge ? _CMP_GE_OQ
+       : OP == cmp_eq ? _CMP_EQ_OQ : _CMP_NEQ_UQ);
+};
+
+struct vd
+{
+  typedef double value_type;
+  typedef __m256d vec;
+
+  static const std::size_t width = 4;
+
+  static vec load (const double *p) { return _mm256_loadu_pd (p); }
+  static vec broadcast (double x) { return _mm256_set1_pd (x); }
+  static void store (double *p, vec v) { _mm256_storeu_pd (p, v); }
+
+  static vec abs (vec a)
+  { return _mm256_andnot_pd (_mm256_set1_pd (-0.0), a); }
+
+  static unsigned nan_mask (vec a)
+  { return _mm256_movemask_pd (_mm256_cmp_pd (a, a, _CMP_UNORD_Q)); }
+
+  static unsigned nonfinite_mask (vec a)
+  {
+    vec inf = _mm256_set1_pd (std::numeric_limits<double>::infinity ());
+    return _mm256_movemask_pd (_mm256_cmp_pd (abs (a), inf, _CMP_NLT_UQ));
+  }
+
+  static vec min (vec x, vec y)
+  {
+    vec t = _mm256_blendv_pd (y, x, _mm256_cmp_pd (x, y, _CMP_LE_OQ));
+    return _mm256_blendv_pd (t, x, _mm256_cmp_pd (y, y, _CMP_UNORD_Q));
+  }
+
+  static vec max (vec x, vec y)
+  {
+    vec t = _mm256_blendv_pd (y, x, _mm256_cmp_pd (x, y, _CMP_GE_OQ));
+    return _mm256_blendv_pd (t, x, _mm256_cmp_pd (y, y, _CMP_UNORD_Q));
+  }
+
+  template <int OP>
+  static unsigned cmp (vec x, vec y)
+  { return _mm256_movemask_pd (_mm256_cmp_pd (x, y, avx_pred<OP>::value)); }
+};
+
+struct vf
+{
+  typedef float value_type;
+  typedef __m256 vec;
+
+  static const std::size_t width = 8;
+
+  static vec load (const float *p) { return _mm256_loadu_ps (p); }
+  static vec broadcast (float x) { return _mm256_set1_ps (x); }
+  static void store (float *p, vec v) { _mm256_storeu_ps (p, v); }
+
+  static vec abs (vec a)
+  { return _mm256_andnot_ps (_mm256_set1_ps (-0.0f), a); }
+
+  static unsigned nan_mask (vec a)
+  { return _mm256_movemask_ps (_mm256_cmp_ps (a, a, _CMP_UNORD_Q)); }
+
+  static unsigned nonfinite_mask (vec a)
+  {
+    vec inf = _mm256_set1_ps (std::numeric_limits<float>::infinity ());
+    return _mm256_movemask_ps (_mm256_cmp_ps (abs (a), inf, _CMP_NLT_UQ));
+  }
+
+  static vec min (vec x, vec y)
+  {
+    vec t = _mm256_blendv_ps (y, x, _mm256_cmp_ps (x, y, _CMP_LE_OQ));
+    return _mm256_blendv_ps (t, x, _mm256_cmp_ps (y, y, _CMP_UNORD_Q));
+  }
+
+  static vec max (vec x, vec y)
+  {
+    vec t = _mm256_blendv_ps (y, x, _mm256_cmp_ps (x, y, _CMP_GE_OQ));
+    return _mm256_blendv_ps (t, x, _mm256_cmp_ps (y, y, _CMP_UNORD_Q));
+  }
+
+  template <int OP>
+  static unsigned cmp (vec x, vec y)
+  { return _mm256_movemask_ps (_mm256_cmp_ps (x, y, avx_pred<OP>::value)); }
+};
+
+#include "mx-simd-kernels.h"
+
+OCTAVE_END_NAMESPACE(avx2_isa)
+
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target ("avx512f")
+
+OCTAVE_BEGIN_NAMESPACE(avx512_isa)
+
+using avx2_isa::avx_pred;
+
+struct vd
+{
+  typedef double value_type;
+  typedef __m512d vec;
+
+  static const std::size_t width = 8;
+
+  static vec load (const double *p) { return _mm512_loadu_pd (p); }
+  static vec broadcast (double x) { return _mm512_set1_pd (x); }
+  static void store (double *p, vec v) { _mm512_storeu_pd (p, v); }
+
+  static unsigned nan_mask (vec a)
+  { return _mm512_cmp_pd_mask (a, a, _CMP_UNORD_Q); }
+
+  static unsigned nonfinite_mask (vec a)
+  {
+    vec inf = _mm512_set1_pd (std::numeric_limits<double>::infinity ());
+    return _mm512_cmp_pd_mask (_mm512_abs_pd (a), inf, _CMP_NLT_UQ);
+  }
+
+  static vec min (vec x, vec y)
+  {
+    vec t = _mm512_mask_blend_pd (_mm512_cmp_pd_mask (x, y, _CMP_LE_OQ),
+                                  y, x);
+    return _mm512_mask_blend_pd (_mm512_cmp_pd_mask (y, y, _CMP_UNORD_Q),
+                                 t, x);
+  }
+
+  static vec max (vec x, vec y)
+  {
+    vec t = _mm512_mask_blend_pd (_mm512_cmp_pd_mask (x, y, _CMP_GE_OQ),
+                                  y, x);
+    return _mm512_mask_blend_pd (_mm512_cmp_pd_mask (y, y, _CMP_UNORD_Q),
+                                 t, x);
+  }
+
+  template <int OP>
+  static unsigned cmp (vec x, vec y)
+  { return _mm512_cmp_pd_mask (x, y, avx_pred<OP>::value); }
+};
+
+struct vf
+{
+  typedef float value_type;
+  typedef __m512 vec;
+
+  static const std::size_t width = 16;
+
+  static vec load (const float *p) { return _mm512_loadu_ps (p); }
+  static vec broadcast (float x) { return _mm512_set1_ps (x); }
+  static void store (float *p, vec v) { _mm512_storeu_ps (p, v); }
+
+  static unsigned nan_mask (vec a)
+  { return _mm512_cmp_ps_mask (a, a, _CMP_UNORD_Q); }
+
+  static unsigned nonfinite_mask (vec a)
+  {
+    vec inf = _mm512_set1_ps (std::numeric_limits<float>::infinity ());
+    return _mm512_cmp_ps_mask (_mm512_abs_ps (a), inf, _CMP_NLT_UQ);
+  }
+
+  static vec min (vec x, vec y)
+  {
+    vec t = _mm512_mask_blend_ps (_mm512_cmp_ps_mask (x, y, _CMP_LE_OQ),
+                                  y, x);
+    return _mm512_mask_blend_ps (_mm512_cmp_ps_mask (y, y, _CMP_UNORD_Q),
+                                 t, x);
+  }
+
+  static vec max (vec x, vec y)
+  {
+    vec t = _mm512_mask_blend_ps (_mm512_cmp_ps_mask (x, y, _CMP_GE_OQ),
+                                  y, x);
+    return _mm512_mask_blend_ps (_mm512_cmp_ps_mask (y, y, _CMP_UNORD_Q),
+                                 t, x);
+  }
+
+  template <int OP>
+  static unsigned cmp (vec x, vec y)
+  { return _mm512_cmp_ps_mask (x, y, avx_pred<OP>::value); }
+};
+
+#include "mx-simd-kernels.h"
+
+OCTAVE_END_NAMESPACE(avx512_isa)
+
+#pragma GCC pop_options
+
+#endif
+
+// Dispatch.
+
+static isa
+detect_level ()
+{
+#if defined (OCTAVE_MX_SIMD_X86)
+  __builtin_cpu_init ();
+
+  if (__builtin_cpu_supports ("avx512f"))
+    return avx512;
+  else if (__builtin_cpu_supports ("avx2"))
+    return avx2;
+  else if (__builtin_cpu_supports ("sse2"))
+    return sse2;
+#endif
+
+  return scalar;
+}
+
+template <typename T>
+static const kernels<T> *
+kernels_for_level (isa l);
+
+#define KERNELS_FOR_LEVEL(T, V)                                         \
+  template <>                                                           \
+  const kernels<T> *                                                    \
+  kernels_for_level<T> (isa l)                                          \
+  {                                                                     \
+    switch (l)                                                          \
+      {                                                                 \
+      KERNELS_FOR_X86_LEVELS (V)                                        \
+      default:                                                          \
+        {                                                               \
+          static const kernels<T> k = scalar_isa::make_kernels<scalar_isa::V> (); \
+          return &k;                                                    \
+        }                                                               \
+      }                                                                 \
+  }
+
+#if defined (OCTAVE_MX_SIMD_X86)
+#  define KERNELS_FOR_X86_LEVELS(V)                                     \
+  case avx512:                                                          \
+    {                                                                   \
+      static const auto k = avx512_isa::make_kernels<avx512_isa::V> (); \
+      return &k;                                                        \
+    }                                                                   \
+  case avx2:                                                            \
+    {                                                                   \
+      static const auto k = avx2_isa::make_kernels<avx2_isa::V> ();     \
+      return &k;                                                        \
+    }                                                                   \
+  case sse2:                                                            \
+    {                                                                   \
+      static const auto k = sse2_isa::make_kernels<sse2_isa::V> ();     \
+      return &k;                                                        \
+    }
+#else
+#  define KERNELS_FOR_X86_LEVELS(V)
+#endif
+
+KERNELS_FOR_LEVEL (double, vd)
+KERNELS_FOR_LEVEL (float, vf)
+
+#undef KERNELS_FOR_LEVEL
+#undef KERNELS_FOR_X86_LEVELS
+
+class
+dispatcher
+{
+public:
+
+  dispatcher ()
+    : m_max_level (detect_level ()), m_level (m_max_level),
+      m_double (kernels_for_level<double> (m_max_level)),
+      m_float (kernels_for_level<float> (m_max_level))
+  { }
+
+  OCTAVE_DISABLE_COPY_MOVE (dispatcher)
+
+  ~dispatcher () = default;
+
+  isa max_level () const { return m_max_level; }
+
+  isa level () const { return m_level; }
+
+  isa set_level (isa l)
+  {
+    if (l > m_max_level)
+      l = m_max_level;
+
+    m_double = kernels_for_level<double> (l);
+    m_float = kernels_for_level<float> (l);
+    m_level = l;
+
+    return l;
+  }
+
+  const kernels<double>& get (const double *) const { return *m_double; }
+
+  const kernels<float>& get (const float *) const { return *m_float; }
+
+private:
+
+  isa m_max_level;
+
+  std::atomic<isa> m_level;
+
+  std::atomic<const kernels<double> *> m_double;
+  std::atomic<const kernels<float> *> m_float;
+};
+
+static dispatcher&
+instance ()
+{
+  static dispatcher d;
+
+  return d;
+}
+
+template <typename T>
+static inline const kernels<T>&
+get_kernels ()
+{
+  return instance ().get (static_cast<const T *> (nullptr));
+}
+
+isa
+level ()
+{
+  return instance ().level ();
+}
+
+isa
+max_level ()
+{
+  return instance ().max_level ();
+}
+
+isa
+set_level (isa l)
+{
+  return instance ().set_level (l);
+}
+
+std::string
+level_name (isa l)
+{
+  switch (l)
+    {
+    case sse2:
+      return "sse2";
+    case avx2:
+      return "avx2";
+    case avx512:
+      return "avx512";
+    default:
+      return "scalar";
+    }
+}
+
+bool
+level_from_name (const std::string& name, isa& l)
+{
+  for (isa x : {scalar, sse2, avx2, avx512})
+    {
+      if (name == level_name (x))
+        {
+          l = x;
+          return true;
+        }
+    }
+
+  return false;
+}
+
+bool
+any_nan (std::size_t n, const double *x)
+{
+  return get_kernels<double> ().any_nan (n, x);
+}
+
+bool
+any_nan (std::size_t n, const float *x)
+{
+  return get_kernels<float> ().any_nan (n, x);
+}
+
+bool
+all_finite (std::size_t n, const double *x)
+{
+  return get_kernels<double> ().all_finite (n, x);
+}
+
+bool
+all_finite (std::size_t n, const float *x)
+{
+  return get_kernels<float> ().all_finite (n, x);
+}
+
+// The scalar-array forms use the array-scalar kernels with the arguments
+// swapped, which gives the same result for ties (such as 0 and -0) as the
+// specializations they replace in mx-inlines.cc.
+
+#define DEFINE_MINMAX(F, T)                             \
+  void                                                  \
+  F (std::size_t n, T *r, const T *x, const T *y)       \
+  {                                                     \
+    get_kernels<T> ().F ## _aa (n, r, x, y);            \
+  }                                                     \
+                                                        \
+  void                                                  \
+  F (std::size_t n, T *r, const T *x, T y)              \
+  {                                                     \
+    get_kernels<T> ().F ## _as (n, r, x, y);            \
+  }                                                     \
+                                                        \
+  void                                                  \
+  F (std::size_t n, T *r, T x, const T *y)              \
+  {                                                     \
+    get_kernels<T> ().F ## _as (n, r, y, x);            \
+  }
+
+DEFINE_MINMAX (xmin, double)
+DEFINE_MINMAX (xmin, float)
+DEFINE_MINMAX (xmax, double)
+DEFINE_MINMAX (xmax, float)
+
+#undef DEFINE_MINMAX
+
+// X OP Y[i] is the same as Y[i] OP' X with OP' the reversed comparison.
+static cmp_op
+reverse_cmp (cmp_op op)
+{
+  switch (op)
+    {
+    case cmp_lt: return cmp_gt;
+    case cmp_le: return cmp_ge;
+    case cmp_gt: return cmp_lt;
+    case cmp_ge: return cmp_le;
+    default: return op;
+    }
+}
+
+#define DEFINE_COMPARE(T)                                               \
+  void                                                                  \
+  compare (cmp_op op, std::size_t n, bool *r, const T *x, const T *y)   \
+  {                                                                     \
+    get_kernels<T> ().cmp_aa[op] (n, r, x, y);                          \
+  }                                                                     \
+                                                                        \
+  void                                                                  \
+  compare (cmp_op op, std::size_t n, bool *r, const T *x, T y)          \
+  {                                                                     \
+    get_kernels<T> ().cmp_as[op] (n, r, x, y);                          \
+  }                                                                     \
+                                                                        \
+  void                                                                  \
+  compare (cmp_op op, std::size_t n, bool *r, T x, const T *y)          \
+  {                                                                     \
+    get_kernels<T> ().cmp_as[reverse_cmp (op)] (n, r, y, x);            \
+  }
+
+DEFINE_COMPARE (double)
+DEFINE_COMPARE (float)
+
+#undef DEFINE_COMPARE
+
+OCTAVE_END_NAMESPACE(mx_simd)
+
+OCTAVE_END_NAMESPACE(octave)
@@ -0,0 +1,138 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_mx_simd_h)
+#define octave_mx_simd_h 1
+
+#include "octave-config.h"
+
+#include <cstddef>
+
+#include <string>
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+OCTAVE_BEGIN_NAMESPACE(mx_simd)
+
+// Explicitly vectorized kernels for the loops in mx-inlines.cc that
+// compilers fail to vectorize, either because of early exits or because
+// of the NaN handling required by Octave's min and max.
+//
+// The instruction set is chosen at run time from what the CPU supports.
+// All levels produce exactly the same results as the generic loops.
+
+enum isa
+{
+  scalar,
+  sse2,
+  avx2,
+  avx512
+};
+
+// The instruction set currently in use.
+extern OCTAVE_API isa level ();
+
+// The best instruction set supported by this CPU and build.
+extern OCTAVE_API isa max_level ();
+
+// Use instruction set L, or the best supported one if L is not
+// available.  Returns the level in effect afterward.
+extern OCTAVE_API isa set_level (isa l);
+
+extern OCTAVE_API std::string level_name (isa l);
+
+// Return true and set L if NAME is the name of an instruction set level.
+extern OCTAVE_API bool level_from_name (const std::string& name, isa& l);
+
+enum cmp_op
+{
+  cmp_lt,
+  cmp_le,
+  cmp_gt,
+  cmp_ge,
+  cmp_eq,
+  cmp_ne
+};
+
+extern OCTAVE_API bool any_nan (std::size_t n, const double *x);
+extern OCTAVE_API bool any_nan (std::size_t n, const float *x);
+
+extern OCTAVE_API bool all_finite (std::size_t n, const double *x);
+extern OCTAVE_API bool all_finite (std::size_t n, const float *x);
+
+// Element-wise min and max with the semantics of octave::math::min and
+// octave::math::max (a NaN is ignored in favor of the other argument).
+// The scalar-array forms return the same as the array-scalar forms with
+// the arguments swapped.
+
+extern OCTAVE_API void
+xmin (std::size_t n, double *r, const double *x, const double *y);
+extern OCTAVE_API void
+xmin (std::size_t n, double *r, const double *x, double y);
+extern OCTAVE_API void
+xmin (std::size_t n, double *r, double x, const double *y);
+
+extern OCTAVE_API void
+xmin (std::size_t n, float *r, const float *x, const float *y);
+extern OCTAVE_API void
+xmin (std::size_t n, float *r, const float *x, float y);
+extern OCTAVE_API void
+xmin (std::size_t n, float *r, float x, const float *y);
+
+extern OCTAVE_API void
+xmax (std::size_t n, double *r, const double *x, const double *y);
+extern OCTAVE_API void
+xmax (std::size_t n, double *r, const double *x, double y);
+extern OCTAVE_API void
+xmax (std::size_t n, double *r, double x, const double *y);
+
+extern OCTAVE_API void
+xmax (std::size_t n, float *r, const float *x, const float *y);
+extern OCTAVE_API void
+xmax (std::size_t n, float *r, const float *x, float y);
+extern OCTAVE_API void
+xmax (std::size_t n, float *r, float x, const float *y);
+
+// Element-wise comparisons.
+
+extern OCTAVE_API void
+compare (cmp_op op, std::size_t n, bool *r, const double *x, const double *y);
+extern OCTAVE_API void
+compare (cmp_op op, std::size_t n, bool *r, const double *x, double y);
+extern OCTAVE_API void
+compare (cmp_op op, std::size_t n, bool *r, double x, const double *y);
+
+extern OCTAVE_API void
+compare (cmp_op op, std::size_t n, bool *r, const float *x, const float *y);
+extern OCTAVE_API void
+compare (cmp_op op, std::size_t n, bool *r, const float *x, float y);
+extern OCTAVE_API void
+compare (cmp_op op, std::size_t n, bool *r, float x, const float *y);
+
+OCTAVE_END_NAMESPACE(mx_simd)
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
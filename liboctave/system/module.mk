@@ -8,6 +8,7 @@ SYSTEM_INC = \
   %reldir%/mach-info.h \
   %reldir%/oct-env.h \
   %reldir%/oct-group.h \
+  %reldir%/oct-mmap.h \
   %reldir%/oct-password.h \
   %reldir%/oct-syscalls.h \
   %reldir%/oct-time.h \
@@ -24,6 +25,7 @@ SYSTEM_SRC = \
   %reldir%/mach-info.cc \
   %reldir%/oct-env.cc \
   %reldir%/oct-group.cc \
+  %reldir%/oct-mmap.cc \
   %reldir%/oct-password.cc \
   %reldir%/oct-syscalls.cc \
   %reldir%/oct-time.cc \
@@ -0,0 +1,269 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <new>
+
+#if defined (HAVE_SYS_MMAN_H)
+#  include <sys/mman.h>
+#endif
+
+#include "fcntl-wrappers.h"
+#include "file-stat.h"
+#include "lo-sysdep.h"
+#include "oct-mmap.h"
+#include "unistd-wrappers.h"
+
+#if defined (HAVE_SYS_MMAN_H) && defined (HAVE_MMAP) && defined (HAVE_MUNMAP)
+#  define USE_MMAP 1
+#endif
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+OCTAVE_BEGIN_NAMESPACE(sys)
+
+mapped_file::~mapped_file ()
+{
+#if defined (USE_MMAP)
+  if (m_data)
+    ::munmap (m_data, m_size);
+#else
+  if (m_writable)
+    {
+      std::string msg;
+      write_back (msg);
+    }
+
+  delete [] m_data;
+#endif
+}
+
+std::shared_ptr<mapped_file>
+mapped_file::open (const std::string& name, bool writable, std::string& msg)
+{
+  msg = "";
+
+#if defined (USE_MMAP)
+
+  int flags = (writable ? octave_o_rdwr_wrapper ()
+               : octave_o_rdonly_wrapper ());
+
+  int fd = octave_open_wrapper (name.c_str (), flags, 0);
+
+  if (fd < 0)
+    {
+      msg = std::strerror (errno);
+      return std::shared_ptr<mapped_file> ();
+    }
+
+  file_fstat fs (fd);
+
+  if (! fs)
+    {
+      msg = fs.error ();
+      octave_close_wrapper (fd);
+      return std::shared_ptr<mapped_file> ();
+    }
+
+  std::size_t size = fs.size ();
+
+  char *data = nullptr;
+
+  // mmap fails for empty files.
+  if (size > 0)
+    {
+      // Read-only files are mapped copy-on-write so that arrays that
+      // refer to the data can be changed like any other array.
+      int map_flags = MAP_SHARED;
+
+      if (! writable)
+        {
+          map_flags = MAP_PRIVATE;
+#if defined (MAP_NORESERVE)
+          map_flags |= MAP_NORESERVE;
+#endif
+        }
+
+      void *addr = ::mmap (nullptr, size, PROT_READ | PROT_WRITE,
+                           map_flags, fd, 0);
+
+      if (addr == MAP_FAILED)
+        {
+          msg = std::strerror (errno);
+          octave_close_wrapper (fd);
+          return std::shared_ptr<mapped_file> ();
+        }
+
+      data = static_cast<char *> (addr);
+    }
+
+  // The mapping does not need the file descriptor.
+  octave_close_wrapper (fd);
+
+#else
+
+  file_stat fs (name);
+
+  if (! fs)
+    {
+      msg = fs.error ();
+      return std::shared_ptr<mapped_file> ();
+    }
+
+  std::size_t size = fs.size ();
+
+  std::ifstream is = sys::ifstream (name, std::ios::in | std::ios::binary);
+
+  if (! is)
+    {
+      msg = "unable to open file";
+      return std::shared_ptr<mapped_file> ();
+    }
+
+  char *data = new char [size];
+
+  if (! is.read (data, size))
+    {
+      delete [] data;
+      msg = "unable to read file";
+      return std::shared_ptr<mapped_file> ();
+    }
+
+#endif
+
+  return std::shared_ptr<mapped_file> (new mapped_file (name, writable,
+                                                        data, size));
+}
+
+bool
+mapped_file::is_supported ()
+{
+#if defined (USE_MMAP)
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool
+mapped_file::arrays_are_supported ()
+{
+#if defined (OCTAVE_HAVE_STD_PMR_POLYMORPHIC_ALLOCATOR)
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool
+mapped_file::flush (std::string& msg)
+{
+  msg = "";
+
+  if (! m_writable || ! m_data)
+    return true;
+
+#if defined (USE_MMAP)
+#  if defined (HAVE_MSYNC)
+  if (::msync (m_data, m_size, MS_SYNC) < 0)
+    {
+      msg = std::strerror (errno);
+      return false;
+    }
+#  endif
+
+  return true;
+#else
+  return write_back (msg);
+#endif
+}
+
+bool
+mapped_file::write_back (std::string& msg)
+{
+  std::ofstream os = sys::ofstream (m_name, (std::ios::in | std::ios::out
+                                             | std::ios::binary));
+
+  if (! os || ! os.write (m_data, m_size) || ! os.flush ())
+    {
+      msg = "unable to write file";
+      return false;
+    }
+
+  return true;
+}
+
+#if defined (OCTAVE_HAVE_STD_PMR_POLYMORPHIC_ALLOCATOR)
+
+// The resource of one array that refers to mapped data.  Destroying
+// the array releases the reference to the file and the resource.
+
+class mapped_file_memory_resource : public std::pmr::memory_resource
+{
+public:
+
+  mapped_file_memory_resource (const std::shared_ptr<mapped_file>& file)
+    : m_file (file)
+  { }
+
+private:
+
+  void * do_allocate (std::size_t /*bytes*/, size_t /*alignment*/)
+  {
+    // Arrays only use the resource to release their data.
+    throw std::bad_alloc ();
+  }
+
+  void do_deallocate (void * /*ptr*/, std::size_t /*bytes*/,
+                      std::size_t /*alignment*/)
+  {
+    delete this;
+  }
+
+  bool do_is_equal (const std::pmr::memory_resource& other) const noexcept
+  {
+    return this == &other;
+  }
+
+  std::shared_ptr<mapped_file> m_file;
+};
+
+std::pmr::memory_resource *
+mapped_file_resource (const std::shared_ptr<mapped_file>& file)
+{
+  return new mapped_file_memory_resource (file);
+}
+
+#endif
+
+OCTAVE_END_NAMESPACE(sys)
+
+OCTAVE_END_NAMESPACE(octave)
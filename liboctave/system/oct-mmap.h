@@ -0,0 +1,155 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_oct_mmap_h)
+#define octave_oct_mmap_h 1
+
+#include "octave-config.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "Array.h"
+#include "dim-vector.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+OCTAVE_BEGIN_NAMESPACE(sys)
+
+// A file mapped into memory.
+//
+// Files that are not writable are mapped copy-on-write, so changes to
+// the mapped data are private to the process and are never written to
+// the file.  Writable files are mapped shared and changes are written
+// to the file by the operating system or by flush.  The size of the
+// file is fixed when it is mapped.
+//
+// On systems without mmap, the contents of the file are read into
+// memory instead, and the contents of writable files are written back
+// by flush and when the object is destroyed.
+
+class
+OCTAVE_API
+mapped_file
+{
+public:
+
+  mapped_file () = delete;
+
+  OCTAVE_DISABLE_COPY_MOVE (mapped_file)
+
+  ~mapped_file ();
+
+  // Map the file NAME into memory.  Returns an empty pointer and sets
+  // MSG if the file can not be mapped.
+  static std::shared_ptr<mapped_file>
+  open (const std::string& name, bool writable, std::string& msg);
+
+  // TRUE if files are mapped instead of read into memory.
+  static bool is_supported ();
+
+  // TRUE if arrays can refer to mapped data without copying it.
+  static bool arrays_are_supported ();
+
+  std::string name () const { return m_name; }
+
+  bool writable () const { return m_writable; }
+
+  std::size_t size () const { return m_size; }
+
+  char * data () const { return m_data; }
+
+  // Write changes to the file.  Returns false and sets MSG on failure.
+  bool flush (std::string& msg);
+
+private:
+
+  mapped_file (const std::string& name, bool writable, char *data,
+               std::size_t size)
+    : m_name (name), m_writable (writable), m_data (data), m_size (size)
+  { }
+
+  bool write_back (std::string& msg);
+
+  std::string m_name;
+
+  bool m_writable;
+
+  char *m_data;
+
+  std::size_t m_size;
+};
+
+#if defined (OCTAVE_HAVE_STD_PMR_POLYMORPHIC_ALLOCATOR)
+
+// Return a memory resource that does not free the data of FILE but
+// keeps FILE mapped until an array that uses it is destroyed.  Each
+// resource may only be used for one array.
+
+extern OCTAVE_API std::pmr::memory_resource *
+mapped_file_resource (const std::shared_ptr<mapped_file>& file);
+
+#endif
+
+// Return an array with dimensions DV that refers to the data of FILE
+// starting at byte OFFSET.  If arrays_are_supported is true, the data
+// is not copied and FILE stays mapped as long as the array or any
+// shallow copy of it exists.  Changes to the array are then changes to
+// the mapped data.  Otherwise, or if OFFSET is not suitably aligned for
+// T, the data is copied.  The mapped data must contain all elements of
+// the array.
+
+template <typename T>
+Array<T>
+mapped_array (const std::shared_ptr<mapped_file>& file,
+              std::size_t offset, const dim_vector& dv)
+{
+  if (dv.safe_numel () == 0)
+    return Array<T> (dv);
+
+  char *src = file->data () + offset;
+
+#if defined (OCTAVE_HAVE_STD_PMR_POLYMORPHIC_ALLOCATOR)
+  if (reinterpret_cast<std::uintptr_t> (src) % alignof (T) == 0)
+    return Array<T> (reinterpret_cast<T *> (src), dv,
+                     mapped_file_resource (file));
+#endif
+
+  Array<T> retval (dv);
+
+  std::copy_n (src, retval.numel () * sizeof (T),
+               reinterpret_cast<char *> (retval.fortran_vec ()));
+
+  return retval;
+}
+
+OCTAVE_END_NAMESPACE(sys)
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
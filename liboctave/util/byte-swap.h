@@ -28,6 +28,9 @@
 
 #include "octave-config.h"
 
+#include <cstdint>
+#include <cstring>
+
 static inline void
 swap_bytes (void *ptr, unsigned int i, unsigned int j)
 {
@@ -78,11 +81,11 @@ swap_bytes<8> (void *ptr)
 
 template <int n>
 void
-swap_bytes (void *ptr, int len)
+swap_bytes (void *ptr, octave_idx_type len)
 {
   char *t = static_cast<char *> (ptr);
 
-  for (int i = 0; i < len; i++)
+  for (octave_idx_type i = 0; i < len; i++)
     {
       swap_bytes<n> (t);
       t += n;
@@ -91,7 +94,68 @@ swap_bytes (void *ptr, int len)
 
 template <>
 inline void
-swap_bytes<1> (void *, int)
+swap_bytes<1> (void *, octave_idx_type)
 { }
 
+// Compilers recognize these expressions as byte swaps, and vectorize
+// the loops over arrays below with byte shuffle instructions.
+
+inline std::uint16_t
+byte_swap (std::uint16_t x)
+{
+  return static_cast<std::uint16_t> ((x >> 8) | (x << 8));
+}
+
+inline std::uint32_t
+byte_swap (std::uint32_t x)
+{
+  return (((x & 0xff000000u) >> 24) | ((x & 0x00ff0000u) >> 8)
+          | ((x & 0x0000ff00u) << 8) | ((x & 0x000000ffu) << 24));
+}
+
+inline std::uint64_t
+byte_swap (std::uint64_t x)
+{
+  std::uint64_t lo = byte_swap (static_cast<std::uint32_t> (x));
+  std::uint64_t hi = byte_swap (static_cast<std::uint32_t> (x >> 32));
+
+  return (lo << 32) | hi;
+}
+
+template <typename T>
+inline void
+swap_word_bytes (void *ptr, octave_idx_type len)
+{
+  char *t = static_cast<char *> (ptr);
+
+  for (octave_idx_type i = 0; i < len; i++)
+    {
+      T x;
+      std::memcpy (&x, t + i * sizeof (T), sizeof (T));
+      x = byte_swap (x);
+      std::memcpy (t + i * sizeof (T), &x, sizeof (T));
+    }
+}
+
+template <>
+inline void
+swap_bytes<2> (void *ptr, octave_idx_type len)
+{
+  swap_word_bytes<std::uint16_t> (ptr, len);
+}
+
+template <>
+inline void
+swap_bytes<4> (void *ptr, octave_idx_type len)
+{
+  swap_word_bytes<std::uint32_t> (ptr, len);
+}
+
+template <>
+inline void
+swap_bytes<8> (void *ptr, octave_idx_type len)
+{
+  swap_word_bytes<std::uint64_t> (ptr, len);
+}
+
 #endif
@@ -32,6 +32,8 @@ UTIL_INC = \
   %reldir%/oct-rl-hist.h \
   %reldir%/oct-shlib.h \
   %reldir%/oct-sort.h \
+  %reldir%/oct-thread-budget.h \
+  %reldir%/oct-thread-pool.h \
   %reldir%/oct-string.h \
   %reldir%/pathsearch.h \
   %reldir%/singleton-cleanup.h \
@@ -80,6 +82,8 @@ UTIL_SRC = \
   %reldir%/oct-shlib.cc \
   %reldir%/oct-sparse.cc \
   %reldir%/oct-string.cc \
+  %reldir%/oct-thread-budget.cc \
+  %reldir%/oct-thread-pool.cc \
   %reldir%/pathsearch.cc \
   %reldir%/singleton-cleanup.cc \
   %reldir%/sparse-util.cc \
@@ -109,14 +109,18 @@
 
 #include <cassert>
 #include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <memory>
 #include <stack>
+#include <vector>
 
 #include "lo-error.h"
 #include "lo-mappers.h"
 #include "quit.h"
 #include "oct-sort.h"
 #include "oct-locbuf.h"
+#include "oct-thread-pool.h"
 
 template <typename T>
 octave_sort<T>::octave_sort () :
@@ -1398,7 +1402,7 @@ octave_sort<T>::merge_compute_minrun (octave_idx_type n)
 template <typename T>
 template <typename Comp>
 void
-octave_sort<T>::sort (T *data, octave_idx_type nel, Comp comp)
+octave_sort<T>::timsort (T *data, octave_idx_type nel, Comp comp)
 {
   /* Re-initialize the Mergestate as this might be the second time called */
   if (! m_ms) m_ms = new MergeState;
@@ -1454,8 +1458,8 @@ octave_sort<T>::sort (T *data, octave_idx_type nel, Comp comp)
 template <typename T>
 template <typename Comp>
 void
-octave_sort<T>::sort (T *data, octave_idx_type *idx, octave_idx_type nel,
-                      Comp comp)
+octave_sort<T>::timsort (T *data, octave_idx_type *idx, octave_idx_type nel,
+                         Comp comp)
 {
   /* Re-initialize the Mergestate as this might be the second time called */
   if (! m_ms) m_ms = new MergeState;
@@ -1511,6 +1515,212 @@ octave_sort<T>::sort (T *data, octave_idx_type *idx, octave_idx_type nel,
     }
 }
 
+// Find the number of elements of A among the first D elements of the
+// stable merge of A and B.  This is the "merge path" split that lets
+// several threads merge disjoint parts of the output.
+
+template <typename T, typename Comp>
+static octave_idx_type
+merge_path_split (const T *a, octave_idx_type na,
+                  const T *b, octave_idx_type nb,
+                  octave_idx_type d, Comp comp)
+{
+  octave_idx_type lo = std::max (static_cast<octave_idx_type> (0), d - nb);
+  octave_idx_type hi = std::min (d, na);
+
+  while (lo < hi)
+    {
+      octave_idx_type mid = lo + (hi - lo) / 2;
+
+      // A[mid] comes before B[d-mid-1] unless B[d-mid-1] is smaller.
+      if (comp (b[d-mid-1], a[mid]))
+        hi = mid;
+      else
+        lo = mid + 1;
+    }
+
+  return lo;
+}
+
+// Merge elements D0 to D1-1 of the stable merge of A and B into R.
+// IA, IB and IR are the indices that go along, or null.
+
+template <typename T, typename Comp>
+static void
+merge_range (const T *a, const octave_idx_type *ia, octave_idx_type na,
+             const T *b, const octave_idx_type *ib, octave_idx_type nb,
+             T *r, octave_idx_type *ir,
+             octave_idx_type d0, octave_idx_type d1, Comp comp)
+{
+  octave_idx_type i = merge_path_split (a, na, b, nb, d0, comp);
+  octave_idx_type j = d0 - i;
+  octave_idx_type i1 = merge_path_split (a, na, b, nb, d1, comp);
+  octave_idx_type j1 = d1 - i1;
+
+  octave_idx_type k = d0;
+
+  while (i < i1 && j < j1)
+    {
+      if (comp (b[j], a[i]))
+        {
+          if (ir)
+            ir[k] = ib[j];
+          r[k++] = b[j++];
+        }
+      else
+        {
+          if (ir)
+            ir[k] = ia[i];
+          r[k++] = a[i++];
+        }
+    }
+
+  if (ir)
+    {
+      std::copy (ia + i, ia + i1, ir + k);
+      std::copy (ib + j, ib + j1, ir + k + (i1 - i));
+    }
+
+  std::copy (a + i, a + i1, r + k);
+  std::copy (b + j, b + j1, r + k + (i1 - i));
+}
+
+// Minimum number of elements merged by one task.
+static const octave_idx_type parallel_merge_grain = 16384;
+
+template <typename T>
+template <typename Comp>
+void
+octave_sort<T>::parallel_sort (T *data, octave_idx_type *idx,
+                               octave_idx_type nel, Comp comp)
+{
+  const int nthreads = octave::thread_pool::size ();
+
+  // Use a power of two number of parts so that they can be merged in
+  // pairs.
+  octave_idx_type nparts = 1;
+  while (nparts < nthreads)
+    nparts *= 2;
+
+  std::vector<octave_idx_type> bounds (nparts + 1);
+  for (octave_idx_type k = 0; k <= nparts; k++)
+    bounds[k] = (nel / nparts) * k + std::min (k, nel % nparts);
+
+  // Sort the parts.  Each thread needs its own merge state.
+
+  const compare_fcn_type& part_compare = m_compare;
+
+  octave::thread_pool::parallel_for
+    (nparts, 1, [=, &bounds, &part_compare] (std::size_t begin, std::size_t end)
+     {
+       octave_sort<T> part_sort (part_compare);
+
+       for (std::size_t k = begin; k < end; k++)
+         {
+           octave_idx_type lo = bounds[k];
+           octave_idx_type n = bounds[k+1] - lo;
+
+           if (idx)
+             part_sort.timsort (data + lo, idx + lo, n, comp);
+           else
+             part_sort.timsort (data + lo, n, comp);
+         }
+     });
+
+  // Merge pairs of sorted parts, alternating between DATA and a buffer.
+  // Each merge is split into tasks by merge_path_split so that all
+  // threads are busy even in the last rounds.
+
+  std::unique_ptr<T[]> tbuf (new T [nel]);
+  std::unique_ptr<octave_idx_type[]> ibuf (idx ? new octave_idx_type [nel]
+                                               : nullptr);
+
+  T *src = data;
+  T *dst = tbuf.get ();
+  octave_idx_type *isrc = idx;
+  octave_idx_type *idst = ibuf.get ();
+
+  const octave_idx_type chunk
+    = std::max (parallel_merge_grain, (nel + 4*nthreads - 1) / (4*nthreads));
+
+  struct merge_task
+  {
+    octave_idx_type lo, mid, hi, d0, d1;
+  };
+
+  std::vector<merge_task> tasks;
+
+  for (octave_idx_type w = 1; w < nparts; w *= 2)
+    {
+      tasks.clear ();
+
+      for (octave_idx_type k = 0; k < nparts; k += 2*w)
+        {
+          octave_idx_type lo = bounds[k];
+          octave_idx_type mid = bounds[k+w];
+          octave_idx_type hi = bounds[k+2*w];
+
+          for (octave_idx_type d = 0; d < hi - lo; d += chunk)
+            tasks.push_back ({lo, mid, hi, d, std::min (d + chunk, hi - lo)});
+        }
+
+      octave::thread_pool::parallel_for
+        (tasks.size (), 1, [&] (std::size_t begin, std::size_t end)
+         {
+           for (std::size_t t = begin; t < end; t++)
+             {
+               const merge_task& mt = tasks[t];
+
+               octave_idx_type lo = mt.lo;
+
+               merge_range (src + lo, isrc ? isrc + lo : nullptr,
+                            mt.mid - lo,
+                            src + mt.mid, isrc ? isrc + mt.mid : nullptr,
+                            mt.hi - mt.mid,
+                            dst + lo, idst ? idst + lo : nullptr,
+                            mt.d0, mt.d1, comp);
+             }
+         });
+
+      std::swap (src, dst);
+      std::swap (isrc, idst);
+    }
+
+  if (src != data)
+    {
+      octave::thread_pool::parallel_for
+        (nel, chunk, [=] (std::size_t begin, std::size_t end)
+         {
+           std::copy (src + begin, src + end, data + begin);
+           if (idx)
+             std::copy (isrc + begin, isrc + end, idx + begin);
+         });
+    }
+}
+
+template <typename T>
+template <typename Comp>
+void
+octave_sort<T>::sort (T *data, octave_idx_type nel, Comp comp)
+{
+  if (octave::thread_pool::use_threads (nel))
+    parallel_sort (data, nullptr, nel, comp);
+  else
+    timsort (data, nel, comp);
+}
+
+template <typename T>
+template <typename Comp>
+void
+octave_sort<T>::sort (T *data, octave_idx_type *idx, octave_idx_type nel,
+                      Comp comp)
+{
+  if (octave::thread_pool::use_threads (nel))
+    parallel_sort (data, idx, nel, comp);
+  else
+    timsort (data, idx, nel, comp);
+}
+
 template <typename T>
 using compare_fcn_ptr = bool (*) (typename ref_param<T>::type,
                                   typename ref_param<T>::type);
@@ -1556,6 +1766,24 @@ template <typename Comp>
 bool
 octave_sort<T>::issorted (const T *data, octave_idx_type nel, Comp comp)
 {
+  if (octave::thread_pool::use_threads (nel))
+    {
+      std::atomic<bool> sorted (true);
+
+      octave::thread_pool::parallel_for
+        (nel - 1, parallel_merge_grain,
+         [=, &sorted] (std::size_t begin, std::size_t end)
+         {
+           for (std::size_t i = begin; i < end && sorted; i++)
+             {
+               if (comp (data[i+1], data[i]))
+                 sorted = false;
+             }
+         });
+
+      return sorted;
+    }
+
   const T *end = data + nel;
   if (data != end)
     {
@@ -1593,90 +1821,94 @@ octave_sort<T>::issorted (const T *data, octave_idx_type nel)
   return retval;
 }
 
-struct sortrows_run_t
-{
-public:
-  sortrows_run_t (octave_idx_type c, octave_idx_type o, octave_idx_type n)
-    : col (c), ofs (o), nel (n) { }
-  //--------
-  octave_idx_type col, ofs, nel;
-};
-
 template <typename T>
 template <typename Comp>
 void
 octave_sort<T>::sort_rows (const T *data, octave_idx_type *idx,
                            octave_idx_type rows, octave_idx_type cols,
-                           Comp comp)
+                           const bool *desc, Comp comp)
 {
-  OCTAVE_LOCAL_BUFFER (T, buf, rows);
   for (octave_idx_type i = 0; i < rows; i++)
     idx[i] = i;
 
   if (cols == 0 || rows <= 1)
     return;
 
-  // This is a breadth-first traversal.
-  typedef sortrows_run_t run_t;
-  std::stack<run_t> runs;
+  // Sort the rows in a single pass, as keys consisting of the element in
+  // the first column and the row index.  Ties in the first column are
+  // broken by comparing the remaining columns of the two rows.  The sort
+  // is stable, so equal rows keep their order.
 
-  runs.push (run_t (0, 0, rows));
+  typedef vec_index<T> key_type;
 
-  while (! runs.empty ())
+  OCTAVE_LOCAL_BUFFER (key_type, keys, rows);
+  for (octave_idx_type i = 0; i < rows; i++)
     {
-      octave_idx_type col = runs.top ().col;
-      octave_idx_type ofs = runs.top ().ofs;
-      octave_idx_type nel = runs.top ().nel;
-      runs.pop ();
-      assert (nel > 1);
+      keys[i].m_vec = data[i];
+      keys[i].m_indx = i;
+    }
 
-      T *lbuf = buf + ofs;
-      const T *ldata = data + rows*col;
-      octave_idx_type *lidx = idx + ofs;
+  auto col_compare = [desc, &comp] (octave_idx_type j,
+                                    typename ref_param<T>::type x,
+                                    typename ref_param<T>::type y)
+  {
+    return (desc && desc[j]) ? comp (y, x) : comp (x, y);
+  };
 
-      // Gather.
-      for (octave_idx_type i = 0; i < nel; i++)
-        lbuf[i] = ldata[lidx[i]];
+  auto row_compare = [=, &col_compare] (const key_type& a, const key_type& b)
+  {
+    if (col_compare (0, a.m_vec, b.m_vec))
+      return true;
+    else if (col_compare (0, b.m_vec, a.m_vec))
+      return false;
 
-      // Sort.
-      sort (lbuf, lidx, nel, comp);
+    for (octave_idx_type j = 1; j < cols; j++)
+      {
+        const T *col = data + rows*j;
 
-      // Identify constant runs and schedule subsorts.
-      if (col < cols-1)
-        {
-          octave_idx_type lst = 0;
-          for (octave_idx_type i = 0; i < nel; i++)
-            {
-              if (comp (lbuf[lst], lbuf[i]))
-                {
-                  if (i > lst + 1)
-                    runs.push (run_t (col+1, ofs + lst, i - lst));
-                  lst = i;
-                }
-            }
-          if (nel > lst + 1)
-            runs.push (run_t (col+1, ofs + lst, nel - lst));
-        }
-    }
+        if (col_compare (j, col[a.m_indx], col[b.m_indx]))
+          return true;
+        else if (col_compare (j, col[b.m_indx], col[a.m_indx]))
+          return false;
+      }
+
+    return false;
+  };
+
+  octave_sort<key_type> key_sort (row_compare);
+
+  key_sort.sort (keys, rows, row_compare);
+
+  for (octave_idx_type i = 0; i < rows; i++)
+    idx[i] = keys[i].m_indx;
 }
 
 template <typename T>
 void
 octave_sort<T>::sort_rows (const T *data, octave_idx_type *idx,
                            octave_idx_type rows, octave_idx_type cols)
+{
+  sort_rows (data, idx, rows, cols, nullptr);
+}
+
+template <typename T>
+void
+octave_sort<T>::sort_rows (const T *data, octave_idx_type *idx,
+                           octave_idx_type rows, octave_idx_type cols,
+                           const bool *desc)
 {
 #if defined (INLINE_ASCENDING_SORT)
   if (*m_compare.template target<compare_fcn_ptr<T>> () == ascending_compare)
-    sort_rows (data, idx, rows, cols, std::less<T> ());
+    sort_rows (data, idx, rows, cols, desc, std::less<T> ());
   else
 #endif
 #if defined (INLINE_DESCENDING_SORT)
     if (*m_compare.template target<compare_fcn_ptr<T>> () == descending_compare)
-      sort_rows (data, idx, rows, cols, std::greater<T> ());
+      sort_rows (data, idx, rows, cols, desc, std::greater<T> ());
     else
 #endif
       if (m_compare)
-        sort_rows (data, idx, rows, cols, m_compare);
+        sort_rows (data, idx, rows, cols, desc, m_compare);
 }
 
 template <typename T>
@@ -118,7 +118,9 @@ public:
 
   void set_compare (sortmode mode);
 
-  // Sort an array in-place.
+  // Sort an array in-place.  Large arrays are split into parts that are
+  // sorted in parallel by the threads of octave::thread_pool and then
+  // merged.  The result is the same as for a serial sort.
   void sort (T *data, octave_idx_type nel);
 
   // Ditto, but also permute the passed indices (may not be valid indices).
@@ -132,6 +134,11 @@ public:
   void sort_rows (const T *data, octave_idx_type *idx,
                   octave_idx_type rows, octave_idx_type cols);
 
+  // Ditto, but reverse the order for the columns j with DESC[j] true.
+  void sort_rows (const T *data, octave_idx_type *idx,
+                  octave_idx_type rows, octave_idx_type cols,
+                  const bool *desc);
+
   // Determine whether a matrix (as a contiguous block) is sorted by rows.
   bool is_sorted_rows (const T *data,
                        octave_idx_type rows, octave_idx_type cols);
@@ -164,6 +171,9 @@ public:
 
 private:
 
+  // For sorting the row keys in sort_rows.
+  template <typename U> friend class octave_sort;
+
   // The maximum number of entries in a MergeState's pending-runs stack.
   // This is enough to sort arrays of size up to about
   //     32 * phi ** MAX_MERGE_PENDING
@@ -300,6 +310,17 @@ private:
 
   octave_idx_type merge_compute_minrun (octave_idx_type n);
 
+  template <typename Comp>
+  void timsort (T *data, octave_idx_type nel, Comp comp);
+
+  template <typename Comp>
+  void timsort (T *data, octave_idx_type *idx, octave_idx_type nel,
+                Comp comp);
+
+  template <typename Comp>
+  void parallel_sort (T *data, octave_idx_type *idx, octave_idx_type nel,
+                      Comp comp);
+
   template <typename Comp>
   void sort (T *data, octave_idx_type nel, Comp comp);
 
@@ -312,7 +333,7 @@ private:
   template <typename Comp>
   void sort_rows (const T *data, octave_idx_type *idx,
                   octave_idx_type rows, octave_idx_type cols,
-                  Comp comp);
+                  const bool *desc, Comp comp);
 
   template <typename Comp>
   bool is_sorted_rows (const T *data, octave_idx_type rows,
@@ -0,0 +1,268 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+
+#include "nproc-wrapper.h"
+#include "oct-env.h"
+#include "oct-fftw.h"
+#include "oct-shlib.h"
+#include "oct-thread-budget.h"
+#include "oct-thread-pool.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// The budget, or 0 before it is first used.
+static std::atomic<int> s_size (0);
+
+// Serializes changes of the budget.
+static std::mutex s_mutex;
+
+// Number of BLAS threads before Octave first changed it, or 0 if it is
+// not known yet or can not be queried.
+static int s_blas_default = 0;
+static std::once_flag s_blas_default_flag;
+
+static int
+env_size ()
+{
+  std::string val = sys::env::getenv ("OCTAVE_NUM_THREADS");
+
+  if (val.empty ())
+    return 0;
+
+  char *end;
+  long int n = std::strtol (val.c_str (), &end, 10);
+
+  return (*end == '\0' && n > 0 && n < 1 << 20) ? static_cast<int> (n) : 0;
+}
+
+// Functions to set the number of threads of the BLAS libraries that
+// have one, looked up by name in the loaded libraries as in
+// sys::blas_version.
+
+typedef void (*blas_threads_fcn) (int);
+typedef int (*blas_get_threads_fcn) ();
+
+static const struct
+{
+  const char *set_symbol;
+  const char *get_symbol;
+  const char *name;
+} blas_threads_fcns[] =
+  {
+    // FlexiBLAS passes the setting on to the selected backend.
+    { "flexiblas_set_num_threads", "flexiblas_get_num_threads", "FlexiBLAS" },
+    { "openblas_set_num_threads", "openblas_get_num_threads", "OpenBLAS" },
+    { "MKL_Set_Num_Threads", "MKL_Get_Max_Threads", "Intel MKL" },
+  };
+
+static blas_threads_fcn
+find_blas_threads_fcn (std::string& name,
+                       blas_get_threads_fcn *get_fcn = nullptr)
+{
+  dynamic_library dyn_libs ("");
+
+  if (dyn_libs)
+    {
+      for (const auto& f : blas_threads_fcns)
+        {
+          void *ptr = dyn_libs.search (f.set_symbol);
+
+          if (ptr)
+            {
+              name = f.name;
+
+              if (get_fcn)
+                *get_fcn = reinterpret_cast<blas_get_threads_fcn>
+                             (dyn_libs.search (f.get_symbol));
+
+              return reinterpret_cast<blas_threads_fcn> (ptr);
+            }
+        }
+    }
+
+  name = "";
+
+  if (get_fcn)
+    *get_fcn = nullptr;
+
+  return nullptr;
+}
+
+static int
+get_blas_threads ()
+{
+  std::string name;
+  blas_get_threads_fcn get_fcn;
+
+  find_blas_threads_fcn (name, &get_fcn);
+
+  return get_fcn ? get_fcn () : 0;
+}
+
+// Remember the number of BLAS threads before it is first changed, so
+// that the default of the BLAS library (for example from
+// OPENBLAS_NUM_THREADS or MKL_NUM_THREADS) can be restored.
+
+static void
+save_blas_default ()
+{
+  std::call_once (s_blas_default_flag,
+                  [] () { s_blas_default = get_blas_threads (); });
+}
+
+static void
+set_blas_threads (int n)
+{
+  save_blas_default ();
+
+  std::string name;
+  blas_threads_fcn fcn = find_blas_threads_fcn (name);
+
+  if (fcn)
+    fcn (n);
+}
+
+// Restore the number of BLAS threads that was in effect at startup.
+
+static void
+reset_blas_threads ()
+{
+  int n = env_size ();
+
+  save_blas_default ();
+
+  if (n == 0)
+    n = s_blas_default;
+
+  if (n > 0)
+    set_blas_threads (n);
+}
+
+int
+thread_budget::size ()
+{
+  int n = s_size;
+
+  if (n > 0)
+    return n;
+
+  std::lock_guard<std::mutex> lock (s_mutex);
+
+  if (s_size == 0)
+    s_size = default_size ();
+
+  return s_size;
+}
+
+void
+thread_budget::size (int n)
+{
+  std::lock_guard<std::mutex> lock (s_mutex);
+
+  bool reset = n < 1;
+
+  if (reset)
+    n = default_size ();
+
+  s_size = n;
+
+  thread_pool::size (n);
+
+#if defined (HAVE_FFTW3_THREADS)
+  // The double precision planner keeps its own limit of 3 threads.
+  fftw_planner::threads (std::min (n, 3));
+#endif
+
+#if defined (HAVE_FFTW3F_THREADS)
+  float_fftw_planner::threads (n);
+#endif
+
+  if (reset)
+    reset_blas_threads ();
+  else
+    set_blas_threads (n);
+}
+
+int
+thread_budget::default_size ()
+{
+  int n = env_size ();
+
+  if (n > 0)
+    return n;
+
+  unsigned long int nproc
+    = octave_num_processors_wrapper (OCTAVE_NPROC_CURRENT_OVERRIDABLE);
+
+  return nproc < 1 ? 1 : static_cast<int> (nproc);
+}
+
+void
+thread_budget::init ()
+{
+  save_blas_default ();
+
+  int n = env_size ();
+
+  if (n > 0)
+    set_blas_threads (n);
+}
+
+int
+thread_budget::blas_threads ()
+{
+  return get_blas_threads ();
+}
+
+void
+thread_budget::blas_threads (int n)
+{
+  if (n < 1)
+    reset_blas_threads ();
+  else
+    set_blas_threads (n);
+}
+
+std::string
+thread_budget::blas_library ()
+{
+  std::string name;
+
+  find_blas_threads_fcn (name);
+
+  return name;
+}
+
+OCTAVE_END_NAMESPACE(octave)
@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_oct_thread_budget_h)
+#define octave_oct_thread_budget_h 1
+
+#include "octave-config.h"
+
+#include <string>
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Number of threads that Octave may use for computations.
+//
+// The budget is shared by the internal thread pool, FFTW, and the BLAS
+// library.  Its initial value is taken from the environment variable
+// OCTAVE_NUM_THREADS, or else is the number of processors available to
+// the process (see nproc).  Setting the budget sets the number of
+// threads of all three, so that several Octave processes on one machine
+// can be limited to their share of the processors.
+
+class
+OCTAVE_API
+thread_budget
+{
+public:
+
+  static int size ();
+
+  // Set the budget and pass it on to the thread pool, FFTW, and BLAS.
+  // A value less than 1 restores the default, and restores the number
+  // of BLAS threads that was in effect at startup.
+
+  static void size (int n);
+
+  // Initial value of the budget.
+
+  static int default_size ();
+
+  // Record the number of BLAS threads at startup and pass the budget to
+  // BLAS if it was set by OCTAVE_NUM_THREADS.  BLAS libraries otherwise
+  // keep their own default.
+
+  static void init ();
+
+  // Number of threads of the BLAS library, or 0 if it can not be
+  // queried.
+
+  static int blas_threads ();
+
+  // Set the number of threads of the BLAS library only.  A value less
+  // than 1 restores the number that was in effect at startup.
+
+  static void blas_threads (int n);
+
+  // Name of the BLAS library whose number of threads is set, or an
+  // empty string if the BLAS library can not be controlled.
+
+  static std::string blas_library ();
+};
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
@@ -0,0 +1,369 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "oct-thread-budget.h"
+#include "oct-thread-pool.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Default minimum number of elements for splitting a loop.  Below this,
+// the cost of waking up the workers outweighs the gain for simple
+// element-wise operations.
+static const std::size_t default_threshold = 131072;
+
+// Set while the current thread is executing the body of a parallel loop.
+static thread_local bool in_loop_body = false;
+
+static int
+default_size ()
+{
+  return thread_budget::size ();
+}
+
+class
+pool_impl
+{
+public:
+
+  pool_impl ()
+    : m_size (default_size ()), m_threshold (default_threshold),
+      m_run_mutex (), m_mutex (), m_work_cv (), m_done_cv (), m_workers (),
+      m_stop (false), m_generation (0), m_active (0), m_fcn (nullptr),
+      m_n (0), m_chunk (0), m_nchunks (0), m_next (0), m_error ()
+  { }
+
+  OCTAVE_DISABLE_COPY_MOVE (pool_impl)
+
+  ~pool_impl ()
+  {
+    stop_workers ();
+  }
+
+  int size () const { return m_size; }
+
+  void size (int n)
+  {
+    std::lock_guard<std::mutex> run_lock (m_run_mutex);
+
+    stop_workers ();
+
+    m_size = (n < 1 ? default_size () : n);
+  }
+
+  std::size_t threshold () const { return m_threshold; }
+
+  void threshold (std::size_t n) { m_threshold = n; }
+
+  void parallel_for (std::size_t n, std::size_t grain,
+                     const thread_pool::range_fcn& fcn);
+
+  void reset_after_fork ()
+  {
+    // The worker threads do not exist in the child and can not be
+    // joined.  Their handles are leaked instead of being destroyed.
+    new std::vector<std::thread> (std::move (m_workers));
+
+    m_workers.clear ();
+    m_size = 1;
+  }
+
+private:
+
+  void start_workers (int n);
+
+  void stop_workers ();
+
+  void worker_main (std::size_t generation);
+
+  void work ();
+
+  //--------
+
+  std::atomic<int> m_size;
+
+  std::atomic<std::size_t> m_threshold;
+
+  // Held by the thread running a parallel loop.
+  std::mutex m_run_mutex;
+
+  // Protects the worker state below.
+  std::mutex m_mutex;
+
+  std::condition_variable m_work_cv;
+  std::condition_variable m_done_cv;
+
+  std::vector<std::thread> m_workers;
+
+  bool m_stop;
+
+  // Incremented for every new loop.
+  std::size_t m_generation;
+
+  // Number of workers that have not finished the current loop.
+  std::size_t m_active;
+
+  // The current loop.
+  const thread_pool::range_fcn *m_fcn;
+  std::size_t m_n;
+  std::size_t m_chunk;
+  std::size_t m_nchunks;
+  std::atomic<std::size_t> m_next;
+
+  std::exception_ptr m_error;
+};
+
+void
+pool_impl::parallel_for (std::size_t n, std::size_t grain,
+                         const thread_pool::range_fcn& fcn)
+{
+  if (n == 0)
+    return;
+
+  if (grain < 1)
+    grain = 1;
+
+  std::size_t nthreads = m_size;
+
+  if (nthreads <= 1 || n <= grain || in_loop_body)
+    {
+      fcn (0, n);
+      return;
+    }
+
+  std::unique_lock<std::mutex> run_lock (m_run_mutex, std::try_to_lock);
+
+  if (! run_lock.owns_lock ())
+    {
+      // Another thread is running a parallel loop.
+      fcn (0, n);
+      return;
+    }
+
+  start_workers (nthreads - 1);
+
+  // Use a few chunks per thread so that threads finishing early can
+  // pick up more work.
+  std::size_t chunk = (n + 4 * nthreads - 1) / (4 * nthreads);
+  chunk = ((chunk + grain - 1) / grain) * grain;
+
+  m_fcn = &fcn;
+  m_n = n;
+  m_chunk = chunk;
+  m_nchunks = (n + chunk - 1) / chunk;
+  m_next = 0;
+  m_error = nullptr;
+
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+
+    m_active = m_workers.size ();
+    m_generation++;
+  }
+
+  m_work_cv.notify_all ();
+
+  work ();
+
+  {
+    std::unique_lock<std::mutex> lock (m_mutex);
+
+    m_done_cv.wait (lock, [this] () { return m_active == 0; });
+  }
+
+  m_fcn = nullptr;
+
+  if (m_error)
+    {
+      std::exception_ptr err = m_error;
+      m_error = nullptr;
+      std::rethrow_exception (err);
+    }
+}
+
+void
+pool_impl::start_workers (int n)
+{
+  if (static_cast<int> (m_workers.size ()) == n)
+    return;
+
+  stop_workers ();
+
+  m_workers.reserve (n);
+
+  for (int i = 0; i < n; i++)
+    m_workers.emplace_back (&pool_impl::worker_main, this, m_generation);
+}
+
+void
+pool_impl::stop_workers ()
+{
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+
+    m_stop = true;
+  }
+
+  m_work_cv.notify_all ();
+
+  for (auto& t : m_workers)
+    t.join ();
+
+  m_workers.clear ();
+
+  m_stop = false;
+}
+
+void
+pool_impl::worker_main (std::size_t generation)
+{
+  while (true)
+    {
+      {
+        std::unique_lock<std::mutex> lock (m_mutex);
+
+        m_work_cv.wait (lock, [&] ()
+                        { return m_stop || m_generation != generation; });
+
+        if (m_stop)
+          return;
+
+        generation = m_generation;
+      }
+
+      work ();
+
+      {
+        std::lock_guard<std::mutex> lock (m_mutex);
+
+        if (--m_active == 0)
+          m_done_cv.notify_one ();
+      }
+    }
+}
+
+void
+pool_impl::work ()
+{
+  in_loop_body = true;
+
+  std::size_t c;
+
+  while ((c = m_next++) < m_nchunks)
+    {
+      std::size_t begin = c * m_chunk;
+      std::size_t end = std::min (m_n, begin + m_chunk);
+
+      try
+        {
+          (*m_fcn) (begin, end);
+        }
+      catch (...)
+        {
+          std::lock_guard<std::mutex> lock (m_mutex);
+
+          if (! m_error)
+            m_error = std::current_exception ();
+
+          // Skip the remaining chunks.
+          m_next = m_nchunks;
+        }
+    }
+
+  in_loop_body = false;
+}
+
+static pool_impl&
+instance ()
+{
+  static pool_impl pool;
+
+  return pool;
+}
+
+int
+thread_pool::size ()
+{
+  return instance ().size ();
+}
+
+void
+thread_pool::size (int n)
+{
+  instance ().size (n);
+}
+
+void
+thread_pool::reset_after_fork ()
+{
+  instance ().reset_after_fork ();
+}
+
+std::size_t
+thread_pool::threshold ()
+{
+  return instance ().threshold ();
+}
+
+void
+thread_pool::threshold (std::size_t n)
+{
+  instance ().threshold (n);
+}
+
+bool
+thread_pool::in_parallel_loop ()
+{
+  return in_loop_body;
+}
+
+bool
+thread_pool::use_threads (std::size_t work)
+{
+  pool_impl& pool = instance ();
+
+  return (work >= pool.threshold () && pool.size () > 1
+          && ! in_loop_body);
+}
+
+void
+thread_pool::parallel_for (std::size_t n, std::size_t grain,
+                           const range_fcn& fcn)
+{
+  instance ().parallel_for (n, grain, fcn);
+}
+
+OCTAVE_END_NAMESPACE(octave)
@@ -0,0 +1,94 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2023 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_oct_thread_pool_h)
+#define octave_oct_thread_pool_h 1
+
+#include "octave-config.h"
+
+#include <cstddef>
+
+#include <functional>
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Work-sharing thread pool for data parallel loops in liboctave.
+//
+// The pool has a fixed number of worker threads that are started the
+// first time they are needed.  A parallel loop splits an index range
+// into chunks that are processed by the workers and by the calling
+// thread.  Only one parallel loop runs at a time.  A loop started while
+// another one is running (including from inside a loop body) simply runs
+// serially in the calling thread.
+
+class
+OCTAVE_API
+thread_pool
+{
+public:
+
+  typedef std::function<void (std::size_t, std::size_t)> range_fcn;
+
+  // Number of threads used for parallel loops, including the calling
+  // thread.  Setting it to a value less than 1 restores the default,
+  // which is the thread budget (see thread_budget).
+
+  static int size ();
+
+  static void size (int n);
+
+  // Minimum amount of work (usually the number of array elements) for
+  // which a loop is split across threads.
+
+  static std::size_t threshold ();
+
+  static void threshold (std::size_t n);
+
+  // True if a loop with WORK units of work should be run in parallel.
+
+  static bool use_threads (std::size_t work);
+
+  // True in the body of a parallel loop, in the calling thread as well
+  // as in the workers.
+
+  static bool in_parallel_loop ();
+
+  // Call FCN (BEGIN, END) for consecutive ranges that cover [0, N).
+  // Ranges contain a multiple of GRAIN indices (except possibly the last
+  // one).  If FCN throws an exception, the remaining ranges are skipped
+  // and the first exception is rethrown in the calling thread.
+
+  static void parallel_for (std::size_t n, std::size_t grain,
+                            const range_fcn& fcn);
+
+  // Forget the workers of the parent process in a child created by
+  // fork and run all loops serially in the child.
+
+  static void reset_after_fork ();
+};
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
@@ -209,15 +209,26 @@ function A = accumarray (subs, vals, sz = [], fcn = [], fillval = [], issparse =
       ## Reduce values.  This is not needed if we're about to sum them,
       ## because "sparse" can do that.
 
-      ## Sort indices.
-      [subs, idx] = sortrows (subs);
-      n = rows (subs);
-      ## Identify runs.
-      jdx = find (any (diff (subs, 1, 1), 2));
-      jdx = [jdx; n];
+      op = reduce_op (fcn, vals);
+      if (! isempty (op))
+        ## Number the distinct subscripts and reduce the values in
+        ## compiled code.
+        [subs, ~, j] = unique (subs, "rows");
+        if (any (strcmp (op, {"any", "all"})))
+          vals = (vals != 0);
+        endif
+        vals = __accumarray_reduce__ (j, vals, op, rows (subs));
+      else
+        ## Sort indices.
+        [subs, idx] = sortrows (subs);
+        n = rows (subs);
+        ## Identify runs.
+        jdx = find (any (diff (subs, 1, 1), 2));
+        jdx = [jdx; n];
 
-      vals = cellfun (fcn, mat2cell (vals(:)(idx), diff ([0; jdx])));
-      subs = subs(jdx, :);
+        vals = cellfun (fcn, mat2cell (vals(:)(idx), diff ([0; jdx])));
+        subs = subs(jdx, :);
+      endif
       mode = "unique";
     else
       mode = "sum";
@@ -267,6 +278,12 @@ function A = accumarray (subs, vals, sz = [], fcn = [], fillval = [], issparse =
 
     ## Some built-in reductions handled efficiently.
 
+    if (fcn == @sum || fcn == @max || fcn == @min)
+      op = "";
+    else
+      op = reduce_op (fcn, vals);
+    endif
+
     if (fcn == @sum)
       ## Fast summation.
       if (isempty (sz))
@@ -337,6 +354,29 @@ function A = accumarray (subs, vals, sz = [], fcn = [], fillval = [], issparse =
         mask(subs) = false;
         A(mask) = fillval;
       endif
+    elseif (! isempty (op))
+      ## Other common reductions in a single pass over the values.
+      if (any (strcmp (op, {"any", "all"})))
+        vals = (vals != 0);
+      endif
+
+      if (isempty (sz))
+        A = __accumarray_reduce__ (subs, vals, op);
+      else
+        A = __accumarray_reduce__ (subs, vals, op, prod (sz));
+        A = reshape (A, sz);
+      endif
+
+      ## Fill in the positions without values.
+      mask = true (size (A));
+      mask(subs) = false;
+      if (any (mask(:)))
+        if (islogical (A) && fillval == 0)
+          A(mask) = false;
+        else
+          A(mask) = fillval;
+        endif
+      endif
     else
 
       ## The general case.  Reduce values.
@@ -388,6 +428,43 @@ function A = accumarray (subs, vals, sz = [], fcn = [], fillval = [], issparse =
 
 endfunction
 
+## Return the name of the reduction done by FCN if __accumarray_reduce__
+## implements it for values like VALS, or an empty string.
+function op = reduce_op (fcn, vals)
+
+  persistent first_str = func2str (@(x) x(1));
+  persistent last_str = func2str (@(x) x(end));
+
+  op = "";
+
+  if (! (isnumeric (vals) || islogical (vals) || ischar (vals)))
+    return;
+  endif
+
+  if (fcn == @numel || fcn == @length)
+    op = "count";
+  elseif (fcn == @any)
+    op = "any";
+  elseif (fcn == @all)
+    op = "all";
+  elseif (strcmp (func2str (fcn), first_str))
+    op = "first";
+  elseif (strcmp (func2str (fcn), last_str))
+    op = "last";
+  elseif (isfloat (vals) && isreal (vals))
+    if (fcn == @mean)
+      op = "mean";
+    elseif (fcn == @prod)
+      op = "prod";
+    elseif (fcn == @var)
+      op = "var";
+    elseif (fcn == @std)
+      op = "std";
+    endif
+  endif
+
+endfunction
+
 
 %!assert (accumarray ([1; 2; 4; 2; 4], 101:105), [101; 206; 0; 208])
 %!assert (accumarray ([1 1 1; 2 1 2; 2 3 2; 2 1 2; 2 3 2], 101:105),
@@ -445,6 +522,48 @@ endfunction
 %! assert (accumarray (subsc, vals, [], @max),
 %!         accumarray (subs, vals, [], @max));
 
+## Reductions done by __accumarray_reduce__
+%!test
+%! subs = [1; 3; 1; 3; 3; 5];
+%! vals = [2; 4; 6; 1; 7; 3];
+%! assert (accumarray (subs, vals, [6 1], @numel, -1), [2; -1; 3; -1; 1; -1]);
+%! assert (accumarray (subs, vals, [6 1], @length, -1), [2; -1; 3; -1; 1; -1]);
+%! assert (accumarray (subs, vals, [6 1], @mean, -1), [4; -1; 4; -1; 3; -1]);
+%! assert (accumarray (subs, vals, [6 1], @prod, -1), [12; -1; 28; -1; 3; -1]);
+%! assert (accumarray (subs, vals, [6 1], @var, -1), [8; -1; 9; -1; 0; -1]);
+%! assert (accumarray (subs, vals, [6 1], @std, -1),
+%!         [sqrt(8); -1; 3; -1; 0; -1], eps);
+%! assert (accumarray (subs, vals, [6 1], @(x) x(1), -1),
+%!         [2; -1; 4; -1; 3; -1]);
+%! assert (accumarray (subs, vals, [6 1], @(x) x(end), -1),
+%!         [6; -1; 7; -1; 3; -1]);
+%! assert (accumarray (subs, vals, [], @mean, 0, true),
+%!         sparse ([4; 0; 4; 0; 3]));
+%! assert (accumarray (subs, vals, [], @var, 0, true),
+%!         sparse ([8; 0; 9; 0; 0]));
+%! assert (accumarray (subs, vals, [], @(x) x(end), 0, true),
+%!         sparse ([6; 0; 7; 0; 3]));
+
+%!test
+%! subs = [1; 3; 1; 3; 3; 5];
+%! vals = [0; 2; 0; 0; 5; 1];
+%! assert (accumarray (subs, vals, [], @any),
+%!         logical ([0; 0; 1; 0; 1]));
+%! assert (accumarray (subs, vals, [], @all),
+%!         logical ([0; 0; 0; 0; 1]));
+%! assert (accumarray (subs, vals, [], @any, 0, true),
+%!         sparse (logical ([0; 0; 1; 0; 1])));
+
+%!assert (accumarray ([1 1; 2 2; 1 1], [3; 4; 5], [2 2], @prod), [15 0; 0 4])
+%!assert (accumarray ([1; 1; 2], [1; NaN; 3], [], @mean), [NaN; 3])
+%!assert (accumarray ([2; 2], 3, [], @prod), [0; 9])
+%!assert (accumarray (zeros (0, 1), [], [3 1], @(x) x(1), 7), [7; 7; 7])
+%!assert (accumarray (zeros (0, 1), [], [3 1], @(x) x(end)), [0; 0; 0])
+%!assert (accumarray (zeros (0, 1), [], [2 1], @mean, 7), [7; 7])
+%!assert (accumarray ([1; 3], single ([2; 4]), [], @mean), single ([2; 0; 4]))
+%!assert (accumarray ([1; 3; 1], [false; true; false], [], @any),
+%!        [false; false; true])
+
 %!error accumarray (1:5)
 %!error accumarray ([1,2,3],1:2)
 
@@ -83,8 +83,8 @@ function [s, i] = sortrows (A, c)
   elseif (all (c < 0))
     i = __sort_rows_idx__ (A(:,-c), reverse_mode);
   else
-    ## Otherwise, fall back to the old algorithm.
-    i = sort_rows_idx_generic (default_mode, reverse_mode, A, c);
+    ## Mixed ascending and descending columns.
+    i = __sort_rows_idx__ (A(:,abs (c)), c < 0);
   endif
 
   ## Only bother to compute s if needed.
@@ -151,6 +151,16 @@ endfunction
 %! assert (x, full (sx));
 %! assert (idx, sidx);
 
+%!test
+%! A = randi (3, 200, 4);
+%! c = [2, -1, 4, -3];
+%! [s, i] = sortrows (A, c);
+%! [ss, si] = sortrows (sparse (A), c);
+%! assert (i, si);
+%! assert (s, full (ss));
+%! [~, i8] = sortrows (int8 (randi (9, 50, 2)), [-2, 1]);
+%! assert (numel (unique (i8)), 50);
+
 %!test <*42523>
 %! C = {1, 2, "filename1";
 %!      3, 4, "filename2";
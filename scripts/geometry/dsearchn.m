@@ -38,7 +38,10 @@
 ## The optional output @var{d} contains a column vector of distances between
 ## the query points @var{xi} and the nearest simplex points @var{x}.
 ##
-## @seealso{dsearch, tsearch}
+## Query points with a NaN coordinate have no closest point.  Their
+## @var{idx} and @var{d} are NaN.
+##
+## @seealso{dsearch, tsearch, kdtree}
 ## @end deftypefn
 
 function [idx, d] = dsearchn (x, tri, xi, outval)
@@ -70,3 +73,4 @@ endfunction
 %!assert (dsearchn (x,tri,[1/3,1]), 2)
 %!assert (dsearchn (x,tri,[1/3,1],NaN), NaN)
 %!assert (dsearchn (x,tri,[1/3,1],NA), NA)
+%!assert (dsearchn (x,[NaN,0]), NaN)
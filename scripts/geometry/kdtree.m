@@ -0,0 +1,220 @@
+########################################################################
+##
+## Copyright (C) 2023 The Octave Project Developers
+##
+## See the file COPYRIGHT.md in the top-level directory of this
+## distribution or <https://octave.org/copyright/>.
+##
+## This file is part of Octave.
+##
+## Octave is free software: you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation, either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <https://www.gnu.org/licenses/>.
+##
+########################################################################
+
+classdef kdtree
+
+  ## -*- texinfo -*-
+  ## @deftypefn  {} {@var{t} =} kdtree (@var{x})
+  ## @deftypefnx {} {[@var{idx}, @var{d}] =} knnsearch (@var{t}, @var{xi})
+  ## @deftypefnx {} {[@var{idx}, @var{d}] =} knnsearch (@var{t}, @var{xi}, @var{k})
+  ## @deftypefnx {} {[@var{idx}, @var{d}] =} rangesearch (@var{t}, @var{xi}, @var{r})
+  ## Build a k-d tree over the points @var{x} for repeated nearest neighbor
+  ## and range searches.
+  ##
+  ## @var{x} is an @var{np}-by-@var{n} matrix with one @var{n}-dimensional
+  ## point per row.  The points are available in the read-only property
+  ## @code{@var{t}.X}.  Points with NaN coordinates are never found.
+  ##
+  ## @code{knnsearch} finds the @var{k} nearest points of @var{x} to each row
+  ## of the @var{nxi}-by-@var{n} matrix @var{xi}.  Row @var{i} of the
+  ## @var{nxi}-by-@var{k} matrices @var{idx} and @var{d} holds the indices of
+  ## and the Euclidean distances to the neighbors of
+  ## @code{@var{xi}(@var{i},:)}, ordered by increasing distance.  When two
+  ## points are equally far away the one with the lower index comes first.  If
+  ## @var{x} has fewer than @var{k} points, or a query point has a NaN
+  ## coordinate, the missing entries are NaN.  The default for @var{k} is 1.
+  ##
+  ## @code{rangesearch} finds all points of @var{x} within distance @var{r}
+  ## of each row of @var{xi}.  @var{idx} and @var{d} are @var{nxi}-by-1 cell
+  ## arrays of row vectors, ordered by increasing distance.
+  ##
+  ## Building the tree takes
+  ## @tex
+  ## $O(n_p \log n_p)$
+  ## @end tex
+  ## @ifnottex
+  ## O(@var{np} log @var{np})
+  ## @end ifnottex
+  ## time, and a search for a few neighbors of a query point typically takes
+  ## logarithmic time in low dimensions.
+  ##
+  ## Example:
+  ##
+  ## @example
+  ## @group
+  ## t = kdtree (rand (1000, 2));
+  ## [idx, d] = knnsearch (t, [0.5, 0.5], 3);
+  ## @end group
+  ## @end example
+  ##
+  ## @seealso{dsearchn, dsearch, delaunayn}
+  ## @end deftypefn
+
+  properties (SetAccess = private)
+    X = [];
+  endproperties
+
+  properties (Access = private)
+    ## Handle returned by __kdtree_build__.
+    tree = [];
+  endproperties
+
+  methods
+
+    function this = kdtree (x)
+
+      if (nargin != 1)
+        print_usage ();
+      endif
+
+      if (! (isnumeric (x) || islogical (x)) || ! isreal (x) || ndims (x) != 2
+          || columns (x) < 1)
+        error ("kdtree: X must be a real matrix with at least one column");
+      endif
+
+      this.X = x;
+      this.tree = __kdtree_build__ (double (x));
+
+    endfunction
+
+    function [idx, d] = knnsearch (this, xi, k = 1)
+
+      if (nargin < 2)
+        print_usage ();
+      endif
+
+      xi = check_query_points (this, xi, "knnsearch");
+
+      if (! (isscalar (k) && isreal (k) && k >= 1 && k == fix (k)))
+        error ("knnsearch: K must be a positive integer");
+      endif
+
+      [idx, d] = __kdtree_knn__ (this.tree, xi, double (k));
+
+    endfunction
+
+    function [idx, d] = rangesearch (this, xi, r)
+
+      if (nargin != 3)
+        print_usage ();
+      endif
+
+      xi = check_query_points (this, xi, "rangesearch");
+
+      if (! (isscalar (r) && isreal (r) && r >= 0))
+        error ("rangesearch: R must be a non-negative scalar");
+      endif
+
+      [idx, d] = __kdtree_radius__ (this.tree, xi, double (r));
+
+    endfunction
+
+    function disp (this)
+
+      if (nargin != 1)
+        print_usage ();
+      endif
+
+      printf ("  kdtree with properties:\n\n");
+      printf ("    X: [%dx%d %s]\n\n", rows (this.X), columns (this.X),
+              class (this.X));
+
+    endfunction
+
+  endmethods
+
+  methods (Access = private)
+
+    function xi = check_query_points (this, xi, who)
+
+      if (! (isnumeric (xi) || islogical (xi)) || ! isreal (xi)
+          || ndims (xi) != 2 || columns (xi) != columns (this.X))
+        error ("%s: XI must be a real matrix with as many columns as X", who);
+      endif
+
+      xi = double (xi);
+
+    endfunction
+
+  endmethods
+
+endclassdef
+
+
+%!shared x, xi
+%! x = [0, 0; 1, 0; 0, 1; 1, 1; 0.5, 0.5];
+%! xi = [0.1, 0.1; 0.9, 0.8; 2, 2];
+
+%!test
+%! t = kdtree (x);
+%! assert (t.X, x);
+%! [idx, d] = knnsearch (t, xi);
+%! assert (idx, [1; 4; 4]);
+%! assert (d, [sqrt(0.02); sqrt(0.05); sqrt(2)], eps);
+%! [idx, d] = knnsearch (t, xi(1,:), 2);
+%! assert (idx, [1, 5]);
+%! assert (d, [sqrt(0.02), sqrt(0.32)], eps);
+
+%!test
+%! t = kdtree (x);
+%! [idx, d] = rangesearch (t, xi, 0.6);
+%! assert (idx, {[1, 5]; [4, 5]; zeros(1, 0)});
+%! assert (d, {[sqrt(0.02), sqrt(0.32)]; [sqrt(0.05), 0.5]; zeros(1, 0)}, eps);
+
+## Missing neighbors and NaN query points
+%!test
+%! t = kdtree ([0; 1]);
+%! [idx, d] = knnsearch (t, [0.2; NaN], 3);
+%! assert (idx, [1, 2, NaN; NaN, NaN, NaN]);
+%! assert (d, [0.2, 0.8, NaN; NaN, NaN, NaN], eps);
+
+## Compare with an exhaustive search
+%!test
+%! x = rand (200, 3);
+%! xi = rand (20, 3);
+%! t = kdtree (x);
+%! r = 0.3;
+%! [idx, d] = knnsearch (t, xi, 5);
+%! [ridx, rd] = rangesearch (t, xi, r);
+%! for i = 1:rows (xi)
+%!   [d0, i0] = sort (sqrt (sumsq (x - xi(i,:), 2)));
+%!   assert (idx(i,:), i0(1:5).');
+%!   assert (d(i,:), d0(1:5).', 2*eps);
+%!   n = nnz (d0 <= r);
+%!   assert (ridx{i}, i0(1:n).');
+%!   assert (rd{i}, d0(1:n).', 2*eps);
+%! endfor
+
+## Test input validation
+%!error <Invalid call> kdtree ()
+%!error <X must be a real matrix> kdtree ({1, 2})
+%!error <X must be a real matrix> kdtree (zeros (2, 0))
+%!error <Invalid call> knnsearch (kdtree (x))
+%!error <XI must be a real matrix with as many columns as X>
+%! knnsearch (kdtree (x), [1, 2, 3]);
+%!error <K must be a positive integer> knnsearch (kdtree (x), xi, 0)
+%!error <K must be a positive integer> knnsearch (kdtree (x), xi, 1.5)
+%!error <Invalid call> rangesearch (kdtree (x), xi)
+%!error <R must be a non-negative scalar> rangesearch (kdtree (x), xi, -1)
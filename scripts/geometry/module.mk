@@ -11,6 +11,7 @@ FCN_FILE_DIRS += %reldir%
   %reldir%/griddata3.m \
   %reldir%/griddatan.m \
   %reldir%/inpolygon.m \
+  %reldir%/kdtree.m \
   %reldir%/rectint.m \
   %reldir%/rotx.m \
   %reldir%/roty.m \
@@ -702,7 +702,6 @@ function rlist = missing_functions ()
   "ddensd",
   "ddesd",
   "ddeset",
-  "decomposition",
   "degree",
   "delaunayTriangulation",
   "deleteCol",
@@ -837,7 +836,6 @@ function rlist = missing_functions ()
   "h5create",
   "h5disp",
   "h5info",
-  "h5read",
   "h5readatt",
   "h5write",
   "h5writeatt",
@@ -979,7 +977,6 @@ function rlist = missing_functions ()
   "maxflow",
   "MaximizeCommandWindow",
   "maxk",
-  "memmapfile",
   "MemoizedFunction",
   "mergecats",
   "meta.abstractDetails",
@@ -0,0 +1,497 @@
+########################################################################
+##
+## Copyright (C) 2023 The Octave Project Developers
+##
+## See the file COPYRIGHT.md in the top-level directory of this
+## distribution or <https://octave.org/copyright/>.
+##
+## This file is part of Octave.
+##
+## Octave is free software: you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation, either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <https://www.gnu.org/licenses/>.
+##
+########################################################################
+
+classdef memmapfile < handle
+
+  ## -*- texinfo -*-
+  ## @deftypefn  {} {@var{m} =} memmapfile (@var{filename})
+  ## @deftypefnx {} {@var{m} =} memmapfile (@var{filename}, @var{name1}, @var{value1}, @dots{})
+  ##
+  ## Map the binary file @var{filename} into memory.
+  ##
+  ## The contents of the file are accessed through the @qcode{"Data"}
+  ## property of the object @var{m}.  Only the parts of the file that are
+  ## used are read from disk, so files that are much larger than the
+  ## available memory can be indexed.
+  ##
+  ## The following properties may be given as name and value pairs and may
+  ## be changed later:
+  ##
+  ## @table @asis
+  ## @item @qcode{"Writable"}
+  ## If true, assignments to @qcode{"Data"} change the file.  The default is
+  ## false.
+  ##
+  ## @item @qcode{"Offset"}
+  ## The number of bytes at the beginning of the file that are skipped.  The
+  ## default is 0.
+  ##
+  ## @item @qcode{"Format"}
+  ## The name of a numeric type (@qcode{"int8"}, @qcode{"uint8"},
+  ## @qcode{"int16"}, @qcode{"uint16"}, @qcode{"int32"}, @qcode{"uint32"},
+  ## @qcode{"int64"}, @qcode{"uint64"}, @qcode{"single"}, or
+  ## @qcode{"double"}) or an N-by-3 cell array that describes the fields of
+  ## records.  Each row of the cell array holds the type, the dimensions,
+  ## and the name of one field.  The default is @qcode{"uint8"}.
+  ##
+  ## @item @qcode{"Repeat"}
+  ## The number of elements or records.  The default, @code{Inf}, uses as
+  ## many as fit in the file.
+  ## @end table
+  ##
+  ## For a type name, @qcode{"Data"} is a column vector.  For records, it is
+  ## a column vector struct array with one field for each row of
+  ## @qcode{"Format"}.  The data are in the native byte order.
+  ##
+  ## The file is mapped copy-on-write when @qcode{"Writable"} is false, and
+  ## the values of @qcode{"Data"} for a type name refer to the mapped data
+  ## without copying it.  Changing such a value makes a copy in memory and
+  ## never changes the file.
+  ##
+  ## When @qcode{"Writable"} is true, indexed assignments such as
+  ## @code{@var{m}.Data(@var{idx}) = @var{val}} write directly to the file.
+  ## Values read from @qcode{"Data"} are copies.  Assignments must not
+  ## change the number of elements of @qcode{"Data"}.
+  ##
+  ## Example:
+  ##
+  ## @example
+  ## @group
+  ## m = memmapfile ("capture.bin", "Format", "int16", "Offset", 512);
+  ## peak = max (abs (m.Data(1e9:2e9)));
+  ## @end group
+  ## @end example
+  ##
+  ## Programming Note: On systems without @code{mmap}, the file is read into
+  ## memory, and changes to writable files are written back when the object
+  ## is deleted.
+  ##
+  ## @seealso{fread, fwrite}
+  ## @end deftypefn
+
+  properties (SetAccess = private)
+    Filename = "";
+  endproperties
+
+  properties
+    Writable = false;
+    Offset = 0;
+    Format = "uint8";
+    Repeat = Inf;
+  endproperties
+
+  properties (Dependent)
+    Data;
+  endproperties
+
+  properties (Access = private)
+    ## Identifier of the mapping returned by __memmapfile_open__.
+    id = [];
+  endproperties
+
+  methods
+
+    function this = memmapfile (filename, varargin)
+
+      if (nargin < 1)
+        print_usage ();
+      endif
+
+      if (! ischar (filename) || ! isrow (filename))
+        error ("memmapfile: FILENAME must be a string");
+      endif
+
+      if (mod (numel (varargin), 2) != 0)
+        error ("memmapfile: property names and values must be given in pairs");
+      endif
+
+      fname = make_absolute_filename (tilde_expand (filename));
+      if (! isfile (fname))
+        error ("memmapfile: file '%s' not found", filename);
+      endif
+      this.Filename = fname;
+
+      writable = false;
+      for i = 1:2:numel (varargin)
+        name = varargin{i};
+        val = varargin{i+1};
+        if (! ischar (name))
+          error ("memmapfile: property names must be strings");
+        endif
+        switch (lower (name))
+          case "writable"
+            writable = val;
+          case "offset"
+            this.Offset = val;
+          case "format"
+            this.Format = val;
+          case "repeat"
+            this.Repeat = val;
+          otherwise
+            error ("memmapfile: unknown property '%s'", name);
+        endswitch
+      endfor
+
+      ## Maps the file.
+      this.Writable = writable;
+
+    endfunction
+
+    function delete (this)
+
+      if (! isempty (this.id))
+        id = this.id;
+        this.id = [];
+        __memmapfile_close__ (id);
+      endif
+
+    endfunction
+
+    function this = set.Writable (this, val)
+
+      if (! isscalar (val) || ! (islogical (val) || isnumeric (val)))
+        error ("memmapfile: Writable must be a logical value");
+      endif
+
+      val = logical (val);
+      id = __memmapfile_open__ (this.Filename, val);
+      if (! isempty (this.id))
+        __memmapfile_close__ (this.id);
+      endif
+      this.id = id;
+      this.Writable = val;
+
+    endfunction
+
+    function this = set.Offset (this, val)
+
+      if (! isscalar (val) || ! isreal (val) || ! isnumeric (val)
+          || val < 0 || val != fix (val) || isinf (val))
+        error ("memmapfile: Offset must be a non-negative integer");
+      endif
+
+      this.Offset = double (val);
+
+    endfunction
+
+    function this = set.Format (this, val)
+
+      types = {"int8", "uint8", "int16", "uint16", "int32", "uint32", ...
+               "int64", "uint64", "single", "double"};
+
+      if (ischar (val))
+        if (! any (strcmp (val, types)))
+          error ("memmapfile: invalid type '%s' in Format", val);
+        endif
+      elseif (iscell (val) && ismatrix (val) && columns (val) == 3
+              && rows (val) > 0)
+        for i = 1:rows (val)
+          if (! ischar (val{i,1}) || ! any (strcmp (val{i,1}, types)))
+            error ("memmapfile: invalid type in row %d of Format", i);
+          endif
+          dims = val{i,2};
+          if (! isnumeric (dims) || ! isvector (dims) || numel (dims) < 2
+              || any (dims < 0) || any (dims != fix (dims)))
+            error ("memmapfile: invalid dimensions in row %d of Format", i);
+          endif
+          if (! ischar (val{i,3}) || ! isvarname (val{i,3}))
+            error ("memmapfile: invalid field name in row %d of Format", i);
+          endif
+        endfor
+      else
+        error ("memmapfile: Format must be a type name or an N-by-3 cell array");
+      endif
+
+      this.Format = val;
+
+    endfunction
+
+    function this = set.Repeat (this, val)
+
+      if (! isscalar (val) || ! isreal (val) || ! isnumeric (val)
+          || ! (val >= 1 && (val == fix (val) || val == Inf)))
+        error ("memmapfile: Repeat must be a positive integer or Inf");
+      endif
+
+      this.Repeat = double (val);
+
+    endfunction
+
+    function data = get.Data (this)
+
+      data = __memmapfile_read__ (this.id, this.Offset, this.Format,
+                                  this.Repeat);
+
+    endfunction
+
+    function this = set.Data (this, val)
+
+      __memmapfile_write__ (this.id, this.Offset, this.Format, this.Repeat,
+                            val);
+
+    endfunction
+
+    function varargout = subsref (this, s)
+
+      if (! strcmp (s(1).type, "."))
+        error ("memmapfile: only property access is supported");
+      endif
+
+      switch (s(1).subs)
+        case "Data"
+          ## Index the mapped data without reading all of it.
+          if (numel (s) > 1 && strcmp (s(2).type, "()")
+              && ischar (this.Format))
+            val = __memmapfile_index__ (this.id, this.Offset, this.Format,
+                                        this.Repeat, s(2).subs);
+            s = s(3:end);
+          else
+            val = this.Data;
+            s = s(2:end);
+          endif
+        case {"Filename", "Writable", "Offset", "Format", "Repeat"}
+          val = this.(s(1).subs);
+          s = s(2:end);
+        otherwise
+          error ("memmapfile: unknown property '%s'", s(1).subs);
+      endswitch
+
+      if (! isempty (s))
+        val = subsref (val, s);
+      endif
+
+      varargout{1} = val;
+
+    endfunction
+
+    function this = subsasgn (this, s, val)
+
+      if (! strcmp (s(1).type, "."))
+        error ("memmapfile: only property assignment is supported");
+      endif
+
+      name = s(1).subs;
+      switch (name)
+        case {"Writable", "Offset", "Format", "Repeat", "Data"}
+          ## Valid property.
+        case "Filename"
+          error ("memmapfile: Filename can not be changed");
+        otherwise
+          error ("memmapfile: unknown property '%s'", name);
+      endswitch
+
+      if (numel (s) == 1)
+        this.(name) = val;
+      elseif (strcmp (name, "Data") && numel (s) == 2
+              && strcmp (s(2).type, "()") && ischar (this.Format))
+        ## Change the mapped data in place.
+        __memmapfile_assign__ (this.id, this.Offset, this.Format,
+                               this.Repeat, s(2).subs, val);
+      else
+        this.(name) = subsasgn (this.(name), s(2:end), val);
+      endif
+
+    endfunction
+
+    function disp (this)
+
+      if (ischar (this.Format))
+        fmt = ["'" this.Format "'"];
+      else
+        fmt = sprintf ("{%dx3 cell}", rows (this.Format));
+      endif
+
+      printf ("  memmapfile object with properties:\n\n");
+      printf ("    Filename: '%s'\n", this.Filename);
+      printf ("    Writable: %s\n", ifelse (this.Writable, "true", "false"));
+      printf ("      Offset: %d\n", this.Offset);
+      printf ("      Format: %s\n", fmt);
+      printf ("      Repeat: %g\n", this.Repeat);
+      printf ("\n");
+
+    endfunction
+
+  endmethods
+
+endclassdef
+
+
+%!shared fname
+%! fname = tempname ();
+
+%!test
+%! unwind_protect
+%!   fid = fopen (fname, "wb");
+%!   fwrite (fid, 0:255, "uint8");
+%!   fclose (fid);
+%!   m = memmapfile (fname);
+%!   assert (m.Data, uint8 (0:255)');
+%!   assert (m.Data(3:5), uint8 ([2; 3; 4]));
+%!   assert (m.Writable, false);
+%!   m.Offset = 16;
+%!   m.Repeat = 4;
+%!   assert (m.Data, uint8 (16:19)');
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect
+
+## Copies of Data of a read-only file are independent of the file
+%!test
+%! unwind_protect
+%!   fid = fopen (fname, "wb");
+%!   fwrite (fid, [1.5, 2.5, 3.5, 4.5], "double");
+%!   fclose (fid);
+%!   m = memmapfile (fname, "Format", "double");
+%!   d = m.Data;
+%!   d(1) = 7;
+%!   assert (d, [7; 2.5; 3.5; 4.5]);
+%!   assert (m.Data, [1.5; 2.5; 3.5; 4.5]);
+%!   fail ("m.Data(1) = 1", "Writable");
+%!   clear m;
+%!   d(2) = 8;
+%!   fid = fopen (fname, "rb");
+%!   assert (fread (fid, Inf, "double"), [1.5; 2.5; 3.5; 4.5]);
+%!   fclose (fid);
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect
+
+## Unaligned offsets
+%!test
+%! unwind_protect
+%!   fid = fopen (fname, "wb");
+%!   fwrite (fid, 9, "uint8");
+%!   fwrite (fid, [1, -2, 3], "int32");
+%!   fclose (fid);
+%!   m = memmapfile (fname, "Format", "int32", "Offset", 1);
+%!   assert (m.Data, int32 ([1; -2; 3]));
+%!   m.Repeat = 2;
+%!   assert (m.Data, int32 ([1; -2]));
+%!   m.Repeat = 4;
+%!   fail ("m.Data", "exceed the size of the file");
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect
+
+## Views that are no longer cached do not share data
+%!test
+%! unwind_protect
+%!   fid = fopen (fname, "wb");
+%!   fwrite (fid, 1:4, "double");
+%!   fclose (fid);
+%!   m = memmapfile (fname, "Format", "double");
+%!   a = m.Data;
+%!   m.Offset = 8;
+%!   b = m.Data;
+%!   m.Offset = 0;
+%!   c = m.Data;
+%!   a(2) = 99;
+%!   assert (b, [2; 3; 4]);
+%!   assert (c, [1; 2; 3; 4]);
+%!   assert (m.Data, [1; 2; 3; 4]);
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect
+
+## Writable files
+%!test
+%! unwind_protect
+%!   fid = fopen (fname, "wb");
+%!   fwrite (fid, 1:4, "uint16");
+%!   fclose (fid);
+%!   m = memmapfile (fname, "Format", "uint16", "Writable", true);
+%!   d = m.Data;
+%!   m.Data(2) = 20;
+%!   m.Data(3:4) = [30, 40];
+%!   assert (d, uint16 ([1; 2; 3; 4]));
+%!   assert (m.Data, uint16 ([1; 20; 30; 40]));
+%!   m.Data = uint16 ([5; 6; 7; 8]);
+%!   assert (m.Data(4), uint16 (8));
+%!   fail ("m.Data(5) = 1", "must not change");
+%!   fail ("m.Data = [1; 2]", "must not change the number of elements");
+%!   x = m.Data(2:3);
+%!   y = m.Data(:);
+%!   m.Data(2:3) = [60, 70];
+%!   assert (x, uint16 ([6; 7]));
+%!   assert (y, uint16 ([5; 6; 7; 8]));
+%!   clear m;
+%!   fid = fopen (fname, "rb");
+%!   assert (fread (fid, Inf, "uint16"), [5; 6; 7; 8]);
+%!   fclose (fid);
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect
+
+## Records
+%!test
+%! unwind_protect
+%!   fid = fopen (fname, "wb");
+%!   for i = 1:3
+%!     fwrite (fid, i, "uint16");
+%!     fwrite (fid, [i, -i], "single");
+%!   endfor
+%!   fclose (fid);
+%!   m = memmapfile (fname, "Format", {"uint16", [1, 1], "n";
+%!                                     "single", [1, 2], "x"});
+%!   assert (size (m.Data), [3, 1]);
+%!   assert (m.Data(2).n, uint16 (2));
+%!   assert (m.Data(3).x, single ([3, -3]));
+%!   m.Writable = true;
+%!   m.Data(1).x = [10, 20];
+%!   assert (m.Data(1).x, single ([10, 20]));
+%!   assert (m.Data(2).x, single ([2, -2]));
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect
+
+## Empty files
+%!test
+%! unwind_protect
+%!   fclose (fopen (fname, "wb"));
+%!   m = memmapfile (fname);
+%!   assert (m.Data, zeros (0, 1, "uint8"));
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect
+
+## Test input validation
+%!error <Invalid call> memmapfile ()
+%!error <FILENAME must be a string> memmapfile (1)
+%!error <not found> memmapfile (tempname ())
+%!error <given in pairs> memmapfile (fname, "Offset")
+%!test
+%! unwind_protect
+%!   fclose (fopen (fname, "wb"));
+%!   fail ("memmapfile (fname, 'Format', 'char')", "invalid type");
+%!   fail ("memmapfile (fname, 'Format', {'double', 1, 'x'})",
+%!         "invalid dimensions");
+%!   fail ("memmapfile (fname, 'Offset', -1)", "non-negative integer");
+%!   fail ("memmapfile (fname, 'Repeat', 0)", "positive integer or Inf");
+%!   fail ("memmapfile (fname, 'Foo', 1)", "unknown property");
+%!   m = memmapfile (fname);
+%!   fail ("m.Filename = 'x'", "can not be changed");
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect
@@ -0,0 +1,326 @@
+########################################################################
+##
+## Copyright (C) 2023 The Octave Project Developers
+##
+## See the file COPYRIGHT.md in the top-level directory of this
+## distribution or <https://octave.org/copyright/>.
+##
+## This file is part of Octave.
+##
+## Octave is free software: you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation, either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <https://www.gnu.org/licenses/>.
+##
+########################################################################
+
+classdef decomposition
+
+  ## -*- texinfo -*-
+  ## @deftypefn  {} {@var{dA} =} decomposition (@var{A})
+  ## @deftypefnx {} {@var{dA} =} decomposition (@var{A}, @var{type})
+  ## Compute a factorization of the matrix @var{A} that can be used to solve
+  ## several linear systems with @var{A}.
+  ##
+  ## The systems are solved with the backslash operator, as with @var{A}
+  ## itself:
+  ##
+  ## @example
+  ## @group
+  ## dA = decomposition (A);
+  ## for k = 1:nsteps
+  ##   x = dA \ b;
+  ##   @dots{}
+  ## endfor
+  ## @end group
+  ## @end example
+  ##
+  ## @noindent
+  ## Each solve only applies the stored factors, so the cost of the
+  ## factorization is paid once instead of once per @code{A \ b}.
+  ##
+  ## @var{A} may be full or sparse.  The optional argument @var{type} selects
+  ## the factorization:
+  ##
+  ## @table @asis
+  ## @item @qcode{"auto"} (default)
+  ## Use @qcode{"chol"} if @var{A} is Hermitian with a positive real diagonal
+  ## and the Cholesky factorization succeeds, @qcode{"lu"} for other square
+  ## matrices, and @qcode{"qr"} for rectangular matrices.
+  ##
+  ## @item @qcode{"chol"}
+  ## Cholesky factorization of a Hermitian positive definite matrix.  For
+  ## sparse @var{A} a fill-reducing permutation is used.
+  ##
+  ## @item @qcode{"lu"}
+  ## LU@tie{}factorization of a square matrix.  For sparse @var{A} this uses
+  ## the row and column permutations and the row scaling of @sc{umfpack}.
+  ##
+  ## @item @qcode{"qr"}
+  ## QR@tie{}factorization with column pivoting.  Overdetermined systems are
+  ## solved in the least squares sense.  Underdetermined systems give the
+  ## basic solution for full @var{A} and the minimum norm solution for sparse
+  ## @var{A}.  Sparse systems are solved with the corrected seminormal
+  ## equations, which only store the triangular factor.
+  ## @end table
+  ##
+  ## The factorization used is available in the read-only property
+  ## @code{@var{dA}.Type}.
+  ##
+  ## @seealso{mldivide, lu, chol, qr, linsolve}
+  ## @end deftypefn
+
+  properties (SetAccess = private)
+    Type = "";
+    MatrixSize = [0, 0];
+    IsSparse = false;
+  endproperties
+
+  properties (Access = private)
+    ## Factors with their matrix type set, so that mldivide does not have
+    ## to detect their structure again.  The meaning depends on Type.
+    L = [];
+    U = [];
+    P = [];
+    Q = [];
+    S = [];
+    ## Matrix kept for the iterative refinement of sparse QR solutions.
+    A = [];
+  endproperties
+
+  methods
+
+    function this = decomposition (A, type = "auto")
+
+      if (nargin < 1)
+        print_usage ();
+      endif
+
+      if (! (isnumeric (A) || islogical (A)) || ndims (A) != 2)
+        error ("decomposition: A must be a 2-D numeric matrix");
+      endif
+      if (! ischar (type))
+        error ("decomposition: TYPE must be a string");
+      endif
+
+      if (! isfloat (A))
+        A = double (A);
+      endif
+
+      [m, n] = size (A);
+      this.MatrixSize = [m, n];
+      this.IsSparse = issparse (A);
+
+      type = lower (type);
+      auto = strcmp (type, "auto");
+      if (auto)
+        if (m != n)
+          type = "qr";
+        elseif (ishermitian (A) && all (real (diag (A)) > 0))
+          type = "chol";
+        else
+          type = "lu";
+        endif
+      endif
+
+      if (strcmp (type, "chol"))
+        if (m != n)
+          error ('decomposition: "chol" requires a square matrix');
+        endif
+
+        if (this.IsSparse)
+          [R, p, Q] = chol (A);
+        else
+          [R, p] = chol (A);
+          Q = [];
+        endif
+
+        if (p == 0)
+          this.Type = "chol";
+          this.U = matrix_type (R, "upper");
+          this.L = matrix_type (R', "lower");
+          this.Q = Q;
+        elseif (auto)
+          type = "lu";
+        else
+          error ('decomposition: A must be Hermitian positive definite for "chol"');
+        endif
+      endif
+
+      switch (type)
+        case "chol"
+          ## Done above.
+
+        case "lu"
+          if (m != n)
+            error ('decomposition: "lu" requires a square matrix');
+          endif
+
+          this.Type = "lu";
+          if (this.IsSparse)
+            [L, U, this.P, this.Q, this.S] = lu (A);
+          else
+            [L, U, this.P] = lu (A);
+          endif
+          this.L = matrix_type (L, "lower");
+          this.U = matrix_type (U, "upper");
+
+        case "qr"
+          this.Type = "qr";
+          if (this.IsSparse)
+            ## Only the triangular factor of A (or A' for underdetermined
+            ## systems) is kept, with a fill-reducing column ordering.
+            if (m >= n)
+              p = colamd (A);
+              R = qr (A(:,p), 0);
+            else
+              p = colamd (A.');
+              R = qr (A(p,:)', 0);
+            endif
+            this.A = A;
+            this.P = p;
+            this.L = matrix_type (R', "lower");
+          else
+            [this.Q, R, this.P] = qr (A, 0);
+          endif
+          this.U = matrix_type (R, "upper");
+
+        otherwise
+          error ('decomposition: TYPE must be "auto", "chol", "lu", or "qr"');
+      endswitch
+
+    endfunction
+
+    function x = mldivide (this, b)
+
+      if (! isa (this, "decomposition"))
+        error ("decomposition: the decomposition must be the left operand of '\\'");
+      endif
+
+      m = this.MatrixSize(1);
+      n = this.MatrixSize(2);
+      if (rows (b) != m)
+        error ("decomposition: nonconformant arguments (op1 is %dx%d, op2 is %dx%d)",
+               m, n, rows (b), columns (b));
+      endif
+
+      switch (this.Type)
+        case "chol"
+          if (this.IsSparse)
+            x = this.Q * (this.U \ (this.L \ (this.Q' * b)));
+          else
+            x = this.U \ (this.L \ b);
+          endif
+
+        case "lu"
+          if (this.IsSparse)
+            x = this.Q * (this.U \ (this.L \ (this.P * (this.S \ b))));
+          else
+            x = this.U \ (this.L \ (this.P * b));
+          endif
+
+        case "qr"
+          p = this.P;
+          if (! this.IsSparse)
+            k = min (m, n);
+            x = zeros (n, columns (b), class (this.U));
+            x(p(1:k),:) = this.U(1:k,1:k) \ (this.Q' * b);
+          elseif (m >= n)
+            ## Seminormal equations R'*R*x = A'*b with one step of
+            ## iterative refinement.
+            x = zeros (n, columns (b));
+            c = this.A' * b;
+            x(p,:) = this.U \ (this.L \ c(p,:));
+            c = this.A' * (b - this.A * x);
+            x(p,:) += this.U \ (this.L \ c(p,:));
+          else
+            ## Minimum norm solution x = A'*y with A*A'*y = b.
+            y = zeros (m, columns (b));
+            y(p,:) = this.U \ (this.L \ b(p,:));
+            x = this.A' * y;
+          endif
+      endswitch
+
+    endfunction
+
+    function disp (this)
+
+      if (nargin != 1)
+        print_usage ();
+      endif
+
+      if (this.IsSparse)
+        kind = "sparse";
+      else
+        kind = "full";
+      endif
+      printf ("  decomposition with properties:\n\n");
+      printf ("    MatrixSize: [%d %d]\n", this.MatrixSize);
+      printf ("          Type: %s (%s)\n\n", this.Type, kind);
+
+    endfunction
+
+  endmethods
+
+endclassdef
+
+
+%!shared b
+%! b = (1:25)';
+
+%!test
+%! A = gallery ("poisson", 5);
+%! dA = decomposition (A);
+%! assert (dA.Type, "chol");
+%! assert (dA.IsSparse);
+%! assert (dA \ b, A \ b, -1e-10);
+%! assert (dA \ [b, 2*b], A \ [b, 2*b], -1e-10);
+%! dA = decomposition (full (A));
+%! assert (dA.Type, "chol");
+%! assert (dA \ b, full (A) \ b, -1e-10);
+
+%!test
+%! A = gallery ("tridiag", 25, -1, 4, -2);
+%! dA = decomposition (A);
+%! assert (dA.Type, "lu");
+%! assert (dA \ b, A \ b, -1e-10);
+%! dA = decomposition (full (A), "lu");
+%! assert (dA \ b, full (A) \ b, -1e-10);
+
+%!test
+%! A = gallery ("poisson", 5);
+%! A(1,1) = -A(1,1);
+%! dA = decomposition (A);
+%! assert (dA.Type, "lu");
+%! assert (dA \ b, A \ b, -1e-10);
+
+%!test
+%! A = [speye(25); sparse(ones (5, 25))];
+%! c = [b; (1:5)'];
+%! dA = decomposition (A);
+%! assert (dA.Type, "qr");
+%! assert (dA \ c, full (A) \ c, -1e-10);
+%! dA = decomposition (full (A));
+%! assert (dA \ c, full (A) \ c, -1e-10);
+
+%!test
+%! A = sparse ([1 0 2 0; 0 1 0 3]);
+%! x = decomposition (A) \ [1; 2];
+%! assert (A * x, [1; 2], 1e-12);
+%! assert (x, pinv (full (A)) * [1; 2], 1e-12);
+
+%!error <Invalid call> decomposition ()
+%!error <A must be a 2-D numeric matrix> decomposition ({1})
+%!error <TYPE must be> decomposition (1, "svd")
+%!error <"lu" requires a square matrix> decomposition (ones (2, 3), "lu")
+%!error <positive definite> decomposition ([1 2; 2 1], "chol")
+%!error <nonconformant arguments> decomposition ([2 1; 1 2]) \ ones (3, 1)
@@ -98,6 +98,7 @@ function [c, ia, ib] = intersect (a, b, varargin)
     b = unique (b, varargin{:});
   endif
 
+  hashed = false;
   if (by_rows)
     c = [a; b];
     if (nargout > 1 || ! optsorted)
@@ -114,6 +115,24 @@ function [c, ia, ib] = intersect (a, b, varargin)
       c = c(sort (ic(match)), :);
     endif
     len_a = rows (a);
+  elseif (strcmp (class (a), class (b)) && ! issparse (a) && ! issparse (b)
+          && ((isreal (a) && isreal (b))
+              || (iscellstr (a) && iscellstr (b))))
+    ## Look up the unique elements of a in b with a hash table.  The result
+    ## is in the order of a, which is sorted or stable as requested.
+    hashed = true;
+    [tf, ib_a] = ismember (a(:), b(:));
+    c = a(tf);
+    c = c(:);
+    if (nargout > 1)
+      ia = ia(tf);
+      ib = ib(ib_a(tf));
+    endif
+
+    ## Adjust output orientation for Matlab compatibility
+    if (isrowvec)
+      c = c.';
+    endif
   else
     c = [a(:); b(:)];
     if (nargout > 1 || ! optsorted)
@@ -142,13 +161,15 @@ function [c, ia, ib] = intersect (a, b, varargin)
   endif
 
   if (nargout > 1)
-    ia = ia(ic(match));            # a(ia) == c
-    ib = ib(ic(match+1) - len_a);  # b(ib) == c
-    if (! optsorted)
-      ## FIXME: Is there a way to avoid a call to sort?
-      ia = sort (ia);
-      [~, idx] = min (ib);
-      ib = [ib(idx:end); ib(1:idx-1)];
+    if (! hashed)
+      ia = ia(ic(match));            # a(ia) == c
+      ib = ib(ic(match+1) - len_a);  # b(ib) == c
+      if (! optsorted)
+        ## FIXME: Is there a way to avoid a call to sort?
+        ia = sort (ia);
+        [~, idx] = min (ib);
+        ib = [ib(idx:end); ib(1:idx-1)];
+      endif
     endif
     if (optlegacy && isrowvec && ! by_rows)
       ia = ia.';
@@ -286,3 +307,10 @@ endfunction
 %!assert (intersect ([], ['a', 'b']), "")
 %!assert (intersect ({}, []), {})
 %!assert (intersect (['a', 'b'], []), "")
+
+## Test real and complex inputs
+%!test
+%! [c, ia, ib] = intersect ([1, 2, 3], [3, 2i, 1]);
+%! assert (c, [1, 3]);
+%! assert (ia, [1; 3]);
+%! assert (ib, [3; 1]);
@@ -124,7 +124,13 @@ function [tf, s_idx] = ismember (a, s, varargin)
   ## FIXME: uncomment if bug #56692 is addressed.
   ## optlegacy = any (strcmp ("legacy", varargin));
 
-  if (! by_rows)
+  if (! by_rows && strcmp (class (a), class (s)) && ! issparse (a)
+      && ! issparse (s)
+      && ((isreal (a) && isreal (s)) || (iscellstr (a) && iscellstr (s))))
+    ## Hash lookup of each element, in linear time.
+    [tf, s_idx] = __ismember__ (a, s);
+
+  elseif (! by_rows)
     s = s(:);
     ## Check sort status, because we expect the array will often be sorted.
     if (issorted (s))
@@ -301,6 +307,10 @@ endfunction
 %! [tf, s_idx] = ismember (-1-1j, [-1-1j, -1+3j, -1+1j]);
 %! assert (tf, true);
 %! assert (s_idx, 1);
+%!
+%! [tf, s_idx] = ismember ([1, 2], [1, 2i]);
+%! assert (tf, logical ([1, 0]));
+%! assert (s_idx, [1, 0]);
 
 ## Test input validation
 %!error <Invalid call> ismember ()
@@ -94,16 +94,24 @@ function [c, ia] = setdiff (a, b, varargin)
       c = unique (a, varargin{:});
     endif
     if (! isempty (c) && ! isempty (b))
-      ## Form a and b into combined set.
-      b = unique (b);
-      [csort, idx] = sort ([c(:); b(:)]);
-      ## Eliminate those elements of a that are the same as in b.
-      if (iscellstr (csort))
-        dups = find (strcmp (csort(1:end-1), csort(2:end)));
+      if (strcmp (class (c), class (b)) && ! issparse (c) && ! issparse (b)
+          && ((isreal (c) && isreal (b))
+              || (iscellstr (c) && iscellstr (b))))
+        ## Eliminate those elements of a that are in b with a hash lookup.
+        dups = ismember (c, b);
       else
-        dups = find (csort(1:end-1) == csort(2:end));
+        ## Form a and b into combined set.
+        b = unique (b);
+        [csort, idx] = sort ([c(:); b(:)]);
+        ## Eliminate those elements of a that are the same as in b.
+        if (iscellstr (csort))
+          dups = find (strcmp (csort(1:end-1), csort(2:end)));
+        else
+          dups = find (csort(1:end-1) == csort(2:end));
+        endif
+        dups = idx(dups);
       endif
-      c(idx(dups)) = [];
+      c(dups) = [];
 
       ## Reshape if necessary for Matlab compatibility.
       if (isrowvec)
@@ -113,7 +121,7 @@ function [c, ia] = setdiff (a, b, varargin)
       endif
 
       if (nargout > 1)
-        ia(idx(dups)) = [];
+        ia(dups) = [];
         if (optlegacy && isrowvec)
           ia = ia(:).';
         endif
@@ -204,3 +212,7 @@ endfunction
 %!assert (size (setdiff ([1:5]', [2:3], "legacy")), [1, 3])
 %!assert (size (setdiff ([1:5], [2:3]', "legacy")), [1, 3])
 %!assert (size (setdiff ([1:5]', [2:3]', "legacy")), [3, 1])
+
+## Test real and complex inputs
+%!assert (setdiff ([1, 2, 3], [2, 1i]), [1, 3])
+%!assert (setdiff ([1i, 2, 3], [2, 4]), [1i, 3])
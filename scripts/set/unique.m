@@ -85,7 +85,7 @@
 ## than always being column vectors.
 ##
 ## The third output, @var{j}, has not been implemented yet when the sort
-## order is @qcode{"stable"}.
+## order is @qcode{"stable"} and the @qcode{"rows"} option is used.
 ##
 ## @seealso{union, intersect, setdiff, setxor, ismember}
 ## @end deftypefn
@@ -186,6 +186,26 @@ function [y, i, j] = unique (x, varargin)
     return;
   endif
 
+  ## Use hash tables for everything but rows and sparse or complex values.
+  ## This takes linear time apart from sorting the unique values.
+  if (! optrows && ! issparse (x) && (isreal (x) || iscellstr (x)))
+    if (nargout > 2)
+      [y, i, j] = __unique__ (x, optsorted, ! optfirst || optlegacy);
+    else
+      [y, i] = __unique__ (x, optsorted, ! optfirst || optlegacy);
+    endif
+    if (isrowvec)
+      y = y.';
+      if (optlegacy)
+        i = i.';
+        if (nargout > 2)
+          j = j.';
+        endif
+      endif
+    endif
+    return;
+  endif
+
   ## Calculate y output
   if (optrows)
     if (nargout > 1 || ! optsorted)
@@ -302,11 +322,10 @@ endfunction
 %! assert (j, [1;1;2;3;3;3;4]);
 
 %!test
-%! [y,i,~] = unique ([4,4,2,2,2,3,1], "stable");
+%! [y,i,j] = unique ([4,4,2,2,2,3,1], "stable");
 %! assert (y, [4,2,3,1]);
 %! assert (i, [1;3;6;7]);
-%! ## FIXME: 'j' input not calculated with stable
-%! ##assert (j, []);
+%! assert (j, [1;1;2;2;2;3;4]);
 
 %!test
 %! [y,i,j] = unique ([1,1,2,3,3,3,4]', "last");
@@ -322,9 +341,10 @@ endfunction
 %! assert (j, [1;1;1]);
 
 %!test
-%! [y,i,~] = unique ({"B"; "A"; "B"}, "stable");
+%! [y,i,j] = unique ({"B"; "A"; "B"}, "stable");
 %! assert (y, {"B"; "A"});
 %! assert (i, [1; 2]);
+%! assert (j, [1; 2; 1]);
 
 %!test
 %! A = [1,2,3; 1,2,3];
@@ -341,6 +361,18 @@ endfunction
 %! ## FIXME: 'j' output not calculated correctly with "stable"
 %! ##assert (y(j,:), A);
 
+%!test
+%! x = int64 (randi (50, 200, 3));
+%! for opt = {"sorted", "stable", "first", "last"}
+%!   [y, i, j] = unique (x, opt{1});
+%!   assert (x(i), y);
+%!   assert (y(j), x(:));
+%!   assert (numel (y), numel (unique (double (x))));
+%! endfor
+%! [~, i] = unique (x, "last");
+%! [~, i2] = unique (flipud (x(:)));
+%! assert (i, numel (x) + 1 - i2);
+
 ## Test "legacy" option
 %!test
 %! [y,i,j] = unique ([1,1,2,3,3,3,4], "legacy");
@@ -348,6 +380,12 @@ endfunction
 %! assert (i, [2,3,6,7]);
 %! assert (j, [1,1,2,3,3,3,4]);
 
+%!test
+%! assert (unique ([1, 2, 1], "legacy"), [1, 2]);
+%! [y, i] = unique ([1, 2, 1], "legacy");
+%! assert (y, [1, 2]);
+%! assert (i, [3, 2]);
+
 %!test
 %! A = [7 9 7; 0 0 0; 7 9 7; 5 5 5; 1 4 5];
 %! [y,i,j] = unique (A, "rows", "legacy");
@@ -377,5 +415,5 @@ endfunction
 %!error <invalid option> unique ({"a", "b", "c"}, "UnknownOption1", "last")
 %!warning <"rows" is ignored for cell arrays> unique ({"1"}, "rows");
 %!warning <third output J is not yet implemented>
-%! [y,i,j] = unique ([2,1], "stable");
+%! [y,i,j] = unique ([2;1], "rows", "stable");
 %! assert (j, []);
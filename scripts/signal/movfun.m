@@ -212,8 +212,20 @@ function y = movfun (fcn, x, wlen, varargin)
   endif
   N = szx(dim);
 
+  ## Common statistics are computed in a single pass over each column,
+  ## without slicing the data into windows.
+  stat = "";
+  if (isfloat (x) && isreal (x) && ! issparse (x)
+      && (isempty (outdim) || isequal (outdim, 1)))
+    [stat, opt] = builtin_stat (fcn);
+  endif
+
   ## Calculate slicing indices.  This call also validates WLEN input.
-  [slc, C, Cpre, Cpos, win] = movslice (N, wlen);
+  if (isempty (stat))
+    [slc, C, Cpre, Cpos, win] = movslice (N, wlen);
+  else
+    [~, C, Cpre, Cpos, win] = movslice (N, wlen);
+  endif
 
   ## Use [nb, na] format which makes replaceval_bc() simpler.
   if (isscalar (wlen))
@@ -261,36 +273,41 @@ function y = movfun (fcn, x, wlen, varargin)
     endswitch
   endif
 
-  ## FIXME: Validation doesn't seem to work correctly (noted 12/16/2018).
-  ## Validate that outdim makes sense
-  fout = fcn (zeros (length (win), 1, class (x)));  # output for window
-  yclass = class (fout);                    # record class of fcn output
-  noutdim = length (fout);                  # number of output dimensions
-  if (! isempty (outdim))
-    if (max (outdim) > noutdim)
-      error ("Octave:invalid-input-arg", ...
-             "movfun: output dimension OUTDIM (%d) is larger than largest available dimension (%d)", ...
-             max (outdim), noutdim);
-    endif
-  else
-    outdim = 1:noutdim;
-  endif
-  soutdim = length (outdim);  # length of selected output dimensions
-  ## If noutdim is not one then modify function to handle multiple outputs
-  if (noutdim > 1)
-    fcn_ = @(x) reshape (fcn (x), columns (x), noutdim)(:, outdim);
+  if (! isempty (stat))
+    y = __movfun__ (stat, x, -win(1), win(end), bc, opt);
+    soutdim = 1;
   else
-    fcn_ = fcn;
-  endif
+    ## FIXME: Validation doesn't seem to work correctly (noted 12/16/2018).
+    ## Validate that outdim makes sense
+    fout = fcn (zeros (length (win), 1, class (x)));  # output for window
+    yclass = class (fout);                    # record class of fcn output
+    noutdim = length (fout);                  # number of output dimensions
+    if (! isempty (outdim))
+      if (max (outdim) > noutdim)
+        error ("Octave:invalid-input-arg", ...
+               "movfun: output dimension OUTDIM (%d) is larger than largest available dimension (%d)", ...
+               max (outdim), noutdim);
+      endif
+    else
+      outdim = 1:noutdim;
+    endif
+    soutdim = length (outdim);  # length of selected output dimensions
+    ## If noutdim is not one then modify function to handle multiple outputs
+    if (noutdim > 1)
+      fcn_ = @(x) reshape (fcn (x), columns (x), noutdim)(:, outdim);
+    else
+      fcn_ = fcn;
+    endif
 
-  ## Initialize output array of appropriate size and class.
-  y = zeros (N, ncols, soutdim, yclass);
-  ## Apply processing to each column
-  ## FIXME: Is it faster with cellfun?  Don't think so, but needs testing.
-  parfor i = 1:ncols
-    y(:,i,:) = movfun_oncol (fcn_, yclass, x(:,i), wlen, bcfcn,
-                             slc, C, Cpre, Cpos, win, soutdim);
-  endparfor
+    ## Initialize output array of appropriate size and class.
+    y = zeros (N, ncols, soutdim, yclass);
+    ## Apply processing to each column
+    ## FIXME: Is it faster with cellfun?  Don't think so, but needs testing.
+    parfor i = 1:ncols
+      y(:,i,:) = movfun_oncol (fcn_, yclass, x(:,i), wlen, bcfcn,
+                               slc, C, Cpre, Cpos, win, soutdim);
+    endparfor
+  endif
 
   ## Restore shape
   y = reshape (y, [szx(dperm), soutdim]);
@@ -333,6 +350,31 @@ function y = movfun_oncol (fcn, yclass, x, wlen, bcfcn, slcidx, C, Cpre, Cpos, w
 
 endfunction
 
+## Return the name of the statistic computed by FCN if __movfun__ implements
+## it, and the normalization option for var and std.
+function [stat, opt] = builtin_stat (fcn)
+
+  stat = "";
+  opt = 0;
+
+  if (! is_function_handle (fcn))
+    return;
+  endif
+
+  name = func2str (fcn);
+  switch (name)
+    case {"sum", "mean", "prod", "min", "max", "median", "var", "std"}
+      stat = name;
+
+    case {"@(x) var (x, 1)", "@(x) std (x, 1)"}
+      ## Handles created by movvar and movstd.
+      stat = name(6:8);
+      opt = 1;
+
+  endswitch
+
+endfunction
+
 ## Apply "shrink" boundary conditions
 ## Function is not applied to any window elements outside the original data.
 function y = shrink_bc (fcn, x, idxp, win, wlen, odim)
@@ -645,6 +687,27 @@ endfunction
 %!assert <*63802> (movfun (@mean, zeros (2,0,3, 'uint8'), 3, 'dim', 2),
 %!                 zeros (2,0,3, 'double'))
 
+## Compiled statistics agree with evaluating the function on each window
+%!test
+%! x = [randn(20, 2); NaN, Inf; -Inf, 3; 4, 4; 4, 4];
+%! x = reshape (x, 12, 2, 2);
+%! fcns = {@sum, @mean, @prod, @min, @max, @median, @var, @std, ...
+%!         @(x) var (x, 1), @(x) std (x, 1)};
+%! for i = 1:numel (fcns)
+%!   fcn = fcns{i};
+%!   slow = @(x) fcn (x);
+%!   for bc = {"shrink", "discard", "fill", "same", "periodic", 0}
+%!     for wlen = {3, 4, [2, 0], [0, 5]}
+%!       for dim = [1, 3]
+%!         args = {wlen{1}, "Endpoints", bc{1}, "dim", dim};
+%!         y = movfun (fcn, x, args{:});
+%!         assert (y, movfun (slow, x, args{:}), 1e-10);
+%!       endfor
+%!     endfor
+%!   endfor
+%!   assert (class (movfun (fcn, single (x), 3)), "single");
+%! endfor
+
 ## Test input validation
 %!error <Invalid call> movfun ()
 %!error <Invalid call> movfun (@min)
@@ -125,7 +125,12 @@ function [slcidx, C, Cpre, Cpost, win] = movslice (N, wlen)
     C = uint64 (C);
   endif
   win   = (-wlen(1):wlen(2)).';
-  slcidx = C + win;
+  ## Skip the (potentially large) index array when the caller ignores it.
+  if (isargout (1))
+    slcidx = C + win;
+  else
+    slcidx = [];
+  endif
 
 endfunction
 
@@ -0,0 +1,61 @@
+function bench_fused (n_factor = 1, reps = 5)
+  % Time compiled loops with the fused instructions of the bytecode
+  % compiler relative to the same loops compiled without them.
+  %
+  % bench_fused ()
+  % bench_fused (n_factor, reps)
+  %
+  % Each test is compiled with and without fused instructions and run
+  % REPS times in alternation.  The fastest run of each is used.
+
+  % {name, {arg_type, n}}
+  tests = {
+    {"for_sum_1", {"rand rowvec", 19267692}},
+    {"for_sum_2", {"rand rowvec", 8742659}},
+    {"for_loop_binop_2", {"n", 5000000}},
+    {"for_loop_ifs", {"n", 5874007}},
+    {"while_loop_empty", {"n", 24237997}},
+    {"qsort_iterative", {"rand rowvec", 344418}},
+  };
+
+  old_fuse = __vm_fuse_instructions__ ();
+  old_cache = __vm_bytecode_cache__ ("");
+
+  unwind_protect
+    printf ("%-20s %12s %12s %10s\n", "", "unfused [s]", "fused [s]",
+            "speedup");
+
+    for i = 1:numel (tests)
+      name = tests{i}{1};
+      conf = tests{i}{2};
+      fn = str2func (name);
+
+      n = round (conf{2} * n_factor);
+      if strcmp (conf{1}, "n")
+        arg = n;
+      else
+        rng (0); % Reset rng
+        arg = randn (n, 1);
+      end
+
+      t = Inf (1, 2);
+      for k = 1:reps
+        for fuse = [false, true]
+          __vm_fuse_instructions__ (fuse);
+          __compile (name, "clear");
+          assert (__compile (name));
+          tic;
+          fn (arg);
+          t(fuse + 1) = min (t(fuse + 1), toc);
+        end
+      end
+
+      printf ("%-20s %12.3f %12.3f %10.3f\n", name, t(1), t(2), t(1) / t(2));
+    end
+  unwind_protect_cleanup
+    __vm_fuse_instructions__ (old_fuse);
+    __vm_bytecode_cache__ (old_cache);
+  end_unwind_protect
+
+  printf ("\nFastest of %d runs, n_factor = %g.\n", reps, n_factor);
+end
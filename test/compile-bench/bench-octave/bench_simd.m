@@ -0,0 +1,63 @@
+function bench_simd (n = 1e6, reps = 200)
+  % Time the vectorized kernels of __mx_simd__ at every supported level
+  % relative to the scalar level.
+  %
+  % bench_simd ()
+  % bench_simd (n, reps)
+
+  rng (0); % Reset rng
+  x = randn (n, 1);
+  y = randn (n, 1);
+  xs = single (x);
+  ys = single (y);
+
+  kernels = {
+    {"x < y", @() x < y},
+    {"x >= 0.5", @() x >= 0.5},
+    {"x == y", @() x == y},
+    {"min (x, y)", @() min (x, y)},
+    {"max (x, 0)", @() max (x, 0)},
+    {"any (isnan (x))", @() any (isnan (x))},
+    {"all (isfinite (x))", @() all (isfinite (x))},
+    {"single x < y", @() xs < ys},
+    {"single min (x, y)", @() min (xs, ys)},
+    {"single max (x, 0)", @() max (xs, 0)},
+  };
+
+  [old_level, max_level] = __mx_simd__ ();
+
+  levels = {"scalar", "sse2", "avx2", "avx512"};
+  levels = levels(1:find (strcmp (levels, max_level)));
+
+  unwind_protect
+    printf ("%-20s", "");
+    printf ("%12s", levels{:});
+    printf ("\n");
+
+    for i = 1:numel (kernels)
+      name = kernels{i}{1};
+      fn = kernels{i}{2};
+
+      printf ("%-20s", name);
+
+      t = zeros (1, numel (levels));
+      for j = 1:numel (levels)
+        __mx_simd__ (levels{j});
+        fn ();
+        tic;
+        for k = 1:reps
+          fn ();
+        end
+        t(j) = toc;
+      end
+
+      printf ("%12.3g", t(1) ./ t);
+      printf ("\n");
+    end
+  unwind_protect_cleanup
+    __mx_simd__ (old_level);
+  end_unwind_protect
+
+  printf ("\nSpeedup relative to the scalar kernels, n = %d, %d repetitions.\n",
+          n, reps);
+end
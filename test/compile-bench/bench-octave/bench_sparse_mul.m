@@ -0,0 +1,61 @@
+function bench_sparse_mul (n = 2e5, reps = 10)
+  % Time sparse matrix products with an increasing number of threads
+  % relative to a single thread.
+  %
+  % bench_sparse_mul ()
+  % bench_sparse_mul (n, reps)
+
+  rand ("seed", 0); % Reset rng
+  A = sprand (n, n, 10 / n) + speye (n);
+  B = sprand (n, n, 10 / n);
+  Ac = A + 1i * B;
+  x = rand (n, 1);
+  X = rand (n, 8);
+  y = rand (1, n);
+
+  kernels = {
+    {"A * B", @() A * B},
+    {"Ac * B", @() Ac * B},
+    {"A * x", @() A * x},
+    {"A * X", @() A * X},
+    {"A' * x", @() A' * x},
+    {"y * A", @() y * A},
+    {"X' * A'", @() X' * A'},
+  };
+
+  old_n = __thread_pool__ ("threads");
+  nthreads = unique ([1, 2, 4, nproc ()]);
+  nthreads(nthreads > nproc ()) = [];
+
+  unwind_protect
+    printf ("%-12s", "threads");
+    printf ("%10d", nthreads);
+    printf ("\n");
+
+    for i = 1:numel (kernels)
+      name = kernels{i}{1};
+      fn = kernels{i}{2};
+
+      printf ("%-12s", name);
+
+      t = zeros (1, numel (nthreads));
+      for j = 1:numel (nthreads)
+        __thread_pool__ ("threads", nthreads(j));
+        fn ();
+        tic;
+        for k = 1:reps
+          fn ();
+        end
+        t(j) = toc;
+      end
+
+      printf ("%10.3g", t(1) ./ t);
+      printf ("\n");
+    end
+  unwind_protect_cleanup
+    __thread_pool__ ("threads", old_n);
+  end_unwind_protect
+
+  printf ("\nSpeedup relative to one thread, n = %d, nnz (A) = %d, %d repetitions.\n",
+          n, nnz (A), reps);
+end
@@ -1,7 +1,10 @@
 compile_bench_TEST_FILES = \
   %reldir%/bench-octave/bench.m \
   %reldir%/bench-octave/bench_cov.m \
+  %reldir%/bench-octave/bench_fused.m \
   %reldir%/bench-octave/bench_median.m \
+  %reldir%/bench-octave/bench_simd.m \
+  %reldir%/bench-octave/bench_sparse_mul.m \
   %reldir%/bench-octave/do_until_loop_empty.m \
   %reldir%/bench-octave/fib.m \
   %reldir%/bench-octave/for_loop_binop_1.m \
@@ -49,6 +49,45 @@
 %! bytecode_binops ();
 %! assert (__prog_output_assert__ (key));
 
+## Test binary operators whose operand types change
+%!test
+%! __enable_vm_eval__ (0, "local");
+%! clear all
+%!
+%! key = "int32 14 6 1 single 5 1.5 1 double 6 2 1 double 2 6 4 8 0 2 1 3 1 1 0 1 double 4 1 0 uint8 255 199 1 int32 14 6 1 single 5 1.5 1 double 6 2 1 double 2 6 4 8 0 2 1 3 1 1 0 1 double 4 1 0 uint8 255 199 1 56 int32 ";
+%!
+%! __compile bytecode_binop_cache clear;
+%! bytecode_binop_cache ();
+%! assert (__prog_output_assert__ (key));
+%!
+%! __enable_vm_eval__ (1, "local");
+%! assert (__compile ("bytecode_binop_cache"));
+%! bytecode_binop_cache ();
+%! assert (__prog_output_assert__ (key));
+
+## Test fused instructions
+%!test
+%! __enable_vm_eval__ (0, "local");
+%! clear all
+%!
+%! key = "15 6 int32 8 1 10 8 6 ne 1.5 2.5 Octave:index-out-of-bounds ";
+%!
+%! __compile bytecode_fused clear;
+%! bytecode_fused ();
+%! assert (__prog_output_assert__ (key));
+%!
+%! __enable_vm_eval__ (1, "local");
+%! assert (__compile ("bytecode_fused"));
+%! bytecode_fused ();
+%! assert (__prog_output_assert__ (key));
+%!
+%! ## The same results without the fused instructions
+%! __compile bytecode_fused clear;
+%! __vm_fuse_instructions__ (false, "local");
+%! assert (__compile ("bytecode_fused"));
+%! bytecode_fused ();
+%! assert (__prog_output_assert__ (key));
+
 ## Test subfunctions
 %!test
 %! __enable_vm_eval__ (0, "local");
@@ -523,7 +562,7 @@
 %!test
 %! __enable_vm_eval__ (0, "local");
 %! clear all
-%! key = "1 2 double 1 1 struct 3 4 ";
+%! key = "1 2 double 1 1 struct 3 4 1 4 1 3 4 2 2 130 20 ";
 %! __compile bytecode_struct clear;
 %! bytecode_struct;
 %! assert (__prog_output_assert__ (key));
@@ -661,3 +700,37 @@
 %!
 %! assert (n_c == __ref_count (c))
 %! assert (n_d == __ref_count (d))
+
+## Test loading functions from the bytecode cache
+%!test
+%! __enable_vm_eval__ (0, "local");
+%! clear all
+%! key = "2 2 2 11 30 10 30 5  0 0 double 1 2 1 2 double 30 11 5  0 0 double 1 2 1 2 double 11 11 12 13 1 1 double 14 1 1 double 11 11 5 13 1 1 double 14 1 1 double 11 3 3 3 2 2 2 313 ret32:1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20 21 22 23 24 25 26 27 28 29 30 31 32 ret32:1 ret32:ret32:1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20 21 22 23 24 25 26 27 28 29 30 31 32 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20 21 22 23 24 25 26 27 28 29 30 31 32 take32:1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20 21 22 23 24 25 26 27 28 29 30 31 32 1 18 59 64 ";
+%! a = 313;
+%! h = @() __printf_assert__ ("%d ", a);
+%!
+%! cache_dir = tempname ();
+%! old_dir = __vm_bytecode_cache__ (cache_dir);
+%! unwind_protect
+%!   [~, s0] = __vm_bytecode_cache__ ();
+%!   __compile bytecode_subfuncs clear;
+%!   assert (__compile ("bytecode_subfuncs"));
+%!   [~, s1] = __vm_bytecode_cache__ ();
+%!   assert (s1.writes, s0.writes + 1);
+%!   assert (numel (glob (fullfile (cache_dir, "*.obc"))), 1);
+%!
+%!   clear bytecode_subfuncs
+%!   assert (__compile ("bytecode_subfuncs"));
+%!   [~, s2] = __vm_bytecode_cache__ ();
+%!   assert (s2.hits, s1.hits + 1);
+%!   assert (s2.writes, s1.writes);
+%!
+%!   __enable_vm_eval__ (1, "local");
+%!   bytecode_subfuncs (h);
+%!   assert (__prog_output_assert__ (key));
+%! unwind_protect_cleanup
+%!   __compile bytecode_subfuncs clear;
+%!   __vm_bytecode_cache__ (old_dir);
+%!   confirm_recursive_rmdir (false, "local");
+%!   rmdir (cache_dir, "s");
+%! end_unwind_protect
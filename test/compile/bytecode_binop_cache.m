@@ -0,0 +1,27 @@
+function bytecode_binop_cache ()
+  % The operators below see more operand types than fit in
+  % the cache for each operator, so entries get replaced.
+
+  vals = {int32(7), single(2.5), 3+4i, [1 2; 3 4], 2, uint8(200)};
+
+  for rep = 1:2
+    for i = 1:numel (vals)
+      x = vals{i};
+      y = x + x;
+      __printf_assert__ ("%s ", class (y));
+      __printf_assert__ ("%g ", real (y));
+      y = x - 1;
+      __printf_assert__ ("%g ", real (y));
+      y = x ~= 2;
+      __printf_assert__ ("%d ", y);
+    end
+  end
+
+  % A specialized double operator that later sees an integer
+  s = 0;
+  for i = 1:10
+    s = s + i;
+  end
+  s = s + int32 (1);
+  __printf_assert__ ("%d %s ", s, class (s));
+endfunction
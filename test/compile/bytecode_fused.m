@@ -0,0 +1,72 @@
+function bytecode_fused ()
+  % Instruction sequences that the compiler fuses
+
+  x = [1 2 3 4 5];
+  s = 0;
+  for i = 1:numel (x)
+    s = s + x(i);
+  end
+  __printf_assert__ ("%g ", s);
+
+  % The same code with other types takes the slow path
+  s = int32 (0);
+  x = int32 ([1 2 3]);
+  for i = 1:numel (x)
+    s = s + x(i);
+  end
+  __printf_assert__ ("%d %s ", s, class (s));
+
+  % Shared values are not changed in place
+  a = 1;
+  b = a;
+  for i = 1:3
+    a = a * 2;
+  end
+  __printf_assert__ ("%g %g ", a, b);
+
+  % Comparisons followed by jumps
+  i = 0;
+  n = 10;
+  while i < n
+    i = i + 1;
+  end
+  __printf_assert__ ("%g ", i);
+
+  k = 0;
+  do
+    k = k + 2;
+  until k >= 7
+  __printf_assert__ ("%g ", k);
+
+  x = [3 -1 4 -1 5 -9 2 6];
+  m = -Inf;
+  for i = 1:numel (x)
+    if x(i) > m
+      m = x(i);
+    end
+  end
+  __printf_assert__ ("%g ", m);
+
+  a = NaN;
+  if a == a
+    __printf_assert__ ("eq ");
+  end
+  if a ~= a
+    __printf_assert__ ("ne ");
+  end
+
+  % Constant operands
+  y = 3;
+  z = y / 2;
+  w = y - 0.5;
+  __printf_assert__ ("%g %g ", z, w);
+
+  % Errors are thrown by the slow path
+  x = [1 2 3];
+  i = 4;
+  try
+    s = y + x(i);
+  catch e
+    __printf_assert__ ("%s ", e.identifier);
+  end
+endfunction
@@ -17,6 +17,37 @@ function bytecode_struct ()
   % Test word command struct subref
 
   __printf_assert__ ("%d ", suby.b);
+
+  % Same instructions used with structs with different fields
+  s1 = struct ('a', 1, 'b', 2);
+  s2 = struct ('b', 3, 'a', 4);
+  c = {s1, s2, s1};
+  for i = 1:3
+    t = c{i};
+    __printf_assert__ ("%d ", t.a);
+  end
+
+  for i = 1:3
+    q.x = i;
+    q.(sprintf ("f%d", i)) = i;
+  end
+  __printf_assert__ ("%d ", q.x);
+  __printf_assert__ ("%d ", numfields (q));
+
+  p = struct ('a', 1, 'b', 2);
+  for i = 1:2
+    __printf_assert__ ("%d ", p.b);
+    p = rmfield (p, 'a');
+  end
+
+  % Many fields
+  w = struct ();
+  for i = 1:20
+    w.(sprintf ("f%d", i)) = i;
+  end
+  w.f13 = 130;
+  __printf_assert__ ("%d ", w.f13);
+  __printf_assert__ ("%d ", w.f20);
 end
 
 function a = suby ()
@@ -3,6 +3,7 @@ compile_TEST_FILES = \
   %reldir%/bytecode_ans.m \
   %reldir%/bytecode_assign.m \
   %reldir%/bytecode_binops.m \
+  %reldir%/bytecode_binop_cache.m \
   %reldir%/bytecode_anon_handles.m \
   %reldir%/bytecode_cdef_use.m \
   %reldir%/bytecode_cell.m \
@@ -13,6 +14,7 @@ compile_TEST_FILES = \
   %reldir%/bytecode_evalin_1.m \
   %reldir%/bytecode_evalin_2.m \
   %reldir%/bytecode_for.m \
+  %reldir%/bytecode_fused.m \
   %reldir%/bytecode_global_1.m \
   %reldir%/bytecode_if.m \
   %reldir%/bytecode_index_obj.m \
@@ -130,6 +130,88 @@
 %! __printf_assert__ ("\n");
 %! assert (__prog_output_assert__ ("1234"));
 
+%!test
+%! x = zeros (1, 20);
+%! c = cell (2, 20);
+%! s = 0;
+%! p = 1;
+%! m = -Inf;
+%! v = [];
+%! a = 3;
+%! parfor (i = 1:20, 2)
+%!   t = a * i;
+%!   x(i) = t;
+%!   c{2,i} = sprintf ("%d", i);
+%!   s += t;
+%!   p = p * 2;
+%!   m = max (m, i);
+%!   v = [v, i];
+%! endparfor
+%! assert (x, 3 * (1:20));
+%! assert (c(2,:), strsplit (num2str (1:20)));
+%! assert (c(1,:), cell (1, 20));
+%! assert (s, 630);
+%! assert (p, 2^20);
+%! assert (m, 20);
+%! assert (v, 1:20);
+%! assert (i, 20);
+
+%!test
+%! y = zeros (2, 3);
+%! parfor (j = 1:3, Inf)
+%!   y(:,j) = 2 * [j; j+3];
+%! endparfor
+%! assert (y, [2, 4, 6; 8, 10, 12]);
+%! s = zeros (2, 1);
+%! parfor (k = [1, 2, 3; 4, 5, 6], 2)
+%!   s += k;
+%! endparfor
+%! assert (s, [6; 15]);
+%! assert (k, [3; 6]);
+
+%!error <iteration 3>
+%! parfor (i = 1:4, 2)
+%!   if (i == 3)
+%!     error ("iteration %d", i);
+%!   endif
+%! endparfor
+
+%!warning <executing loop serially>
+%! parfor (i = 1:4, 2)
+%!   if (i == 2)
+%!     break;
+%!   endif
+%! endparfor
+
+## Workers draw different random numbers
+%!test
+%! r = zeros (2, 8);
+%! parfor (i = 1:8, 2)
+%!   r(:,i) = [rand(); randn()];
+%! endparfor
+%! assert (numel (unique (r(1,:))), 8);
+%! assert (numel (unique (r(2,:))), 8);
+
+## Scripts may assign variables, so loops that call them are serial
+%!warning <the script '__parfor_script__' can not be called>
+%! dname = tempname ();
+%! mkdir (dname);
+%! unwind_protect
+%!   fid = fopen (fullfile (dname, "__parfor_script__.m"), "w");
+%!   fprintf (fid, "y = i;\n");
+%!   fclose (fid);
+%!   addpath (dname);
+%!   y = 0;
+%!   parfor (i = 1:4, 2)
+%!     __parfor_script__;
+%!   endparfor
+%!   assert (y, 4);
+%! unwind_protect_cleanup
+%!   rmpath (dname);
+%!   unlink (fullfile (dname, "__parfor_script__.m"));
+%!   rmdir (dname);
+%! end_unwind_protect
+
 %!test <*50893>
 %! cnt = 0;
 %! for k = zeros (0,3)
@@ -861,6 +861,53 @@
 %!   unlink (nm);
 %! endif
 
+## Reads without type conversion
+%!test
+%! nm = tempname ();
+%! [id, err] = fopen (nm, "wb+");
+%! if (id < 0)
+%!   __printf_assert__ ("open failed: %s (wb+): %s\n", nm, err);
+%! else
+%!   unwind_protect
+%!     x = [1.5, -2, pi, 1e300, 7];
+%!     fwrite (id, x, "double");
+%!     fwrite (id, uint8 ([1, 2, 3]));
+%!     frewind (id);
+%!     [data, count] = fread (id, Inf, "double=>double");
+%!     assert (data, x(:));
+%!     assert (count, 5);
+%!     assert (feof (id));
+%!     frewind (id);
+%!     [data, count] = fread (id, [2, Inf], "*double");
+%!     assert (data, reshape ([x, 0], 2, 3));
+%!     assert (count, 5);
+%!     frewind (id);
+%!     [data, count] = fread (id, [4, 2], "*double");
+%!     assert (data, [x(1:4)', [x(5); 0; 0; 0]]);
+%!     assert (count, 5);
+%!     frewind (id);
+%!     [data, count] = fread (id, 2, "*int32");
+%!     assert (data, typecast (x(1), "int32")(:));
+%!     assert (count, 2);
+%!     frewind (id);
+%!     fwrite (id, int16 ([1, -2, 300]), "int16", 0, "ieee-be");
+%!     fwrite (id, single ([1.5, -3]), "single", 0, "ieee-be");
+%!     frewind (id);
+%!     assert (fread (id, 3, "*int16", 0, "ieee-be"), int16 ([1; -2; 300]));
+%!     assert (fread (id, 2, "*single", 0, "ieee-be"), single ([1.5; -3]));
+%!     frewind (id);
+%!     assert (fread (id, [1, 4], "*char"), char ([0, 1, 255, 254]));
+%!     ## The result only grows to the size of the data that is read.
+%!     frewind (id);
+%!     [data, count] = fread (id, 1e10, "*uint8");
+%!     assert (size (data), [43, 1]);
+%!     assert (count, 43);
+%!   unwind_protect_cleanup
+%!     fclose (id);
+%!     unlink (nm);
+%!   end_unwind_protect
+%! endif
+
 %!test <54386>
 %! x = char (128:255)';
 %! nm = tempname ();
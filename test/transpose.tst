@@ -90,3 +90,38 @@
 %!test
 %! matrix = single ([1,2;3,4]*i);
 %! assert (matrix', single ([-1i,-3i;-2i,-4i]));
+
+%% Products with the transpose of a sparse matrix
+%!test
+%! A = sprand (30, 20, 0.2);
+%! B = sprand (30, 3, 0.3);
+%! C = sprand (30, 10, 0.3);
+%! Ac = A + 1i * sprand (30, 20, 0.2);
+%! Bc = B - 2i * sprand (30, 3, 0.3);
+%! x = rand (30, 2);
+%! xc = x + 1i;
+%! At = A.';
+%! Act = Ac.';
+%! Ach = Ac';
+%! assert (A' * B, At * B);
+%! assert (A' * C, At * C);
+%! assert (A.' * Bc, At * Bc);
+%! assert (Ac.' * B, Act * B);
+%! assert (Ac' * B, Ach * B);
+%! assert (Ac' * Bc, Ach * Bc);
+%! assert (Ac.' * Bc, Act * Bc);
+%! assert (issparse (Ac' * Bc));
+%! assert (A' * xc, At * xc, -eps);
+%! assert (Ac.' * x, Act * x, -eps);
+%! assert (Ac' * x, Ach * x, -eps);
+%! assert (Ac' * xc, Ach * xc, -eps);
+
+%!test
+%! A = sparse ([1 0; 0 2; 3 0]);
+%! assert (A' * sparse ([1; 1; 0]), sparse ([1; 2]));
+%! assert (A' * sparse (3, 2), sparse (2, 2));
+%! assert (sparse (2)' * A, 2 * A);
+%! assert (A' * sparse (2), 2 * A');
+
+%!error <operator \*: nonconformant arguments \(op1 is 2x3, op2 is 2x1\)>
+%! sparse (ones (3, 2))' * sparse (ones (2, 1))